@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "aggregateRFM69.h"
+
+
+
+/*
+        Public Methods
+*/
+
+aggregateRFM69::aggregateRFM69(uint8_t capacity, uint16_t deadline_ms){
+    this->capacity = (capacity > RFM69_AGGREGATE_MAX_FRAME) ? RFM69_AGGREGATE_MAX_FRAME : capacity;
+    this->deadline = deadline_ms;
+    this->first_time = 0;
+    this->clear();
+}
+
+bool aggregateRFM69::add(const void* message, uint8_t len, uint32_t now){
+    if ((len == 0) || ((this->length + 1 + len) > this->capacity)){
+        return false;
+    }
+    if (this->count == 0){
+        this->first_time = now;
+    }
+    this->frame[this->length] = len;
+    memcpy(&(this->frame[this->length + 1]), message, len);
+    this->length += len + 1;
+    this->count++;
+    this->last_len = len;
+    return true;
+}
+
+bool aggregateRFM69::due(uint32_t now){
+    if (this->count == 0){
+        return false;
+    }
+    // readings tend to have the same length, do not wait for the deadline
+    // if the next one will not fit.
+    return ((now - this->first_time) >= this->deadline) || ((this->length + 1 + this->last_len) > this->capacity);
+}
+
+void aggregateRFM69::clear(){
+    this->length = 0;
+    this->count = 0;
+    this->last_len = 0;
+}
+
+uint8_t aggregateRFM69::unpack(const uint8_t* frame, uint8_t len, uint8_t* offset, const uint8_t** message){
+    if ((*offset + 1) >= len){
+        return 0;
+    }
+    uint8_t message_len = frame[*offset];
+    if ((message_len == 0) || ((*offset + 1 + message_len) > len)){
+        return 0; // malformed, never read past the frame.
+    }
+    *message = &(frame[*offset + 1]);
+    *offset += 1 + message_len;
+    return message_len;
+}
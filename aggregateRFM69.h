@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef AGGREGATE_RFM69_H
+#define AGGREGATE_RFM69_H
+
+/*
+    Packs several small messages in one frame, and unpacks them again.
+
+    Every frame costs the preamble, sync word, length byte and CRC, 10 bytes
+    with the defaults, which is more than the message itself for readings of
+    a few bytes. Packed, every message only costs a length byte:
+        [length, message, length, message, ...]
+
+    The sender adds messages until one does not fit or the oldest message
+    has waited for the deadline, then sends the frame with sendVariable():
+
+        if (!aggregate.add(&reading, sizeof(reading), millis())){
+            rfm.sendVariable((void*) aggregate.getFrame(), aggregate.getLength());
+            aggregate.clear();
+            aggregate.add(&reading, sizeof(reading), millis());
+        }
+        ...
+        if (aggregate.due(millis()) && rfm.canSend()){
+            rfm.sendVariable((void*) aggregate.getFrame(), aggregate.getLength());
+            aggregate.clear();
+        }
+
+    The receiver walks through the messages of a frame with unpack().
+*/
+
+// the largest variable length payload that fits in the FIFO.
+#ifndef RFM69_AGGREGATE_MAX_FRAME
+#define RFM69_AGGREGATE_MAX_FRAME 64
+#endif
+
+class aggregateRFM69{
+    protected:
+        uint8_t frame[RFM69_AGGREGATE_MAX_FRAME];
+        uint8_t capacity;
+        uint8_t length;
+        uint8_t count;
+        uint8_t last_len;
+
+        uint16_t deadline;
+        uint32_t first_time; // when the first message was added.
+
+    public:
+        aggregateRFM69(uint8_t capacity, uint16_t deadline_ms);
+        /*
+            capacity is the largest frame, normally the packet length given
+            to plainRFM69::setPacketLength(), at most RFM69_AGGREGATE_MAX_FRAME.
+            deadline_ms is the longest time a message waits to be sent.
+        */
+
+        bool add(const void* message, uint8_t len, uint32_t now);
+        /*
+            Adds a message of 1 up to capacity - 1 bytes, now is the time in
+            milliseconds. Returns false if it does not fit in the frame; send
+            and clear the frame before adding it again.
+        */
+
+        bool due(uint32_t now);
+        /*
+            Returns true if the frame holds messages, and the oldest one has
+            waited for the deadline or a message as long as the last one
+            does not fit anymore.
+        */
+
+        const uint8_t* getFrame(){return this->frame;};
+        uint8_t getLength(){return this->length;};
+        uint8_t getCount(){return this->count;};
+        /*
+            The frame to send, its length in bytes and the number of messages
+            in it.
+        */
+
+        void clear();
+        /*
+            Empties the frame, after it was sent.
+        */
+
+        static uint8_t unpack(const uint8_t* frame, uint8_t len, uint8_t* offset, const uint8_t** message);
+        /*
+            Returns the length of the message at offset in the received frame
+            and points message to it, offset is then advanced to the next one.
+            Start with offset zero, returns zero after the last message or if
+            the frame is malformed:
+
+                uint8_t offset = 0;
+                const uint8_t* message;
+                uint8_t message_len;
+                while ((message_len = aggregateRFM69::unpack(buffer, len, &offset, &message))){
+                    ...
+                }
+        */
+};
+
+//AGGREGATE_RFM69_H
+#endif
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include "bareRFM69_const.h"
+
+#ifndef AIRTIME_RFM69_H
+#define AIRTIME_RFM69_H
+
+/*
+    Time on the air of a packet, and what follows from it: the maximum packet
+    rate and the interval between packets for a duty cycle limit.
+
+    A packet on the air consists of:
+        preamble        RegPreamble bytes.
+        sync word       SyncSize + 1 bytes, if SyncOn.
+        length byte     with variable length.
+        address byte    with address filtering.
+        message         with AES padded to a multiple of 16 bytes.
+        CRC             2 bytes, if CrcOn.
+    Manchester encoding doubles the bits after the sync word. A bit lasts
+    RegBitrate / FXOSC seconds.
+
+    The functions are constexpr, so a timeout or schedule for a fixed format
+    costs nothing at runtime:
+        constexpr airtimeRFM69Format f = airtimeRFM69Profile(RFM69_AIRTIME_BITRATE_300000, true, true, false);
+        const uint32_t timeout_us = 2 * airtimeRFM69Microseconds(f, 64) + 1000;
+    plainRFM69::getAirtimeFormat() reads the format from the registers.
+
+    The packet length 'len' is that of the payload given to the send methods,
+    without the length and address bytes.
+*/
+
+#define RFM69_AIRTIME_FXOSC 32000000ULL
+
+// RegBitrate of the profiles of plainRFM69.
+#define RFM69_AIRTIME_BITRATE_4800 0x1a0b
+#define RFM69_AIRTIME_BITRATE_9600 (0x1a0b/2)
+#define RFM69_AIRTIME_BITRATE_153600 (0x1a0b/32)
+#define RFM69_AIRTIME_BITRATE_300000 0x006b
+
+// Standby to Tx: the synthesizer and the PA ramp in us.
+#define RFM69_AIRTIME_TX_START (RFM69_TS_FS + RFM69_TS_TR)
+
+struct airtimeRFM69Format {
+    uint16_t bitrate;       // RegBitrate.
+    uint16_t preamble;      // bytes.
+    uint8_t sync;           // bytes, zero if off.
+    bool variable_length;
+    bool addressing;
+    bool aes;
+    bool crc;
+    bool manchester;
+};
+
+constexpr airtimeRFM69Format airtimeRFM69Profile(uint16_t bitrate, bool variable_length, bool addressing, bool aes){
+    return airtimeRFM69Format{bitrate, 3, 4, variable_length, addressing, aes, true, false};
+}
+/*
+    The format with the preamble, sync word and CRC of setRecommended() and
+    setPacketType().
+*/
+
+constexpr uint32_t airtimeRFM69Bitrate(const airtimeRFM69Format& format){
+    return RFM69_AIRTIME_FXOSC / format.bitrate;
+}
+/*
+    Bits per second.
+*/
+
+constexpr uint32_t airtimeRFM69Bytes(const airtimeRFM69Format& format, uint8_t len){
+    return format.variable_length + format.addressing + ((format.aes) ? ((len + 15) / 16 * 16) : len) + ((format.crc) ? 2 : 0);
+}
+/*
+    Bytes after the sync word.
+*/
+
+constexpr uint32_t airtimeRFM69Bits(const airtimeRFM69Format& format, uint8_t len){
+    return (format.preamble + format.sync) * 8 + airtimeRFM69Bytes(format, len) * ((format.manchester) ? 16 : 8);
+}
+
+constexpr uint32_t airtimeRFM69Microseconds(const airtimeRFM69Format& format, uint8_t len){
+    return ((uint64_t) airtimeRFM69Bits(format, len) * format.bitrate * 1000000 + RFM69_AIRTIME_FXOSC - 1) / RFM69_AIRTIME_FXOSC;
+}
+/*
+    Time on the air, rounded up.
+*/
+
+constexpr uint32_t airtimeRFM69PacketsPerSecond(const airtimeRFM69Format& format, uint8_t len, uint32_t overhead=RFM69_AIRTIME_TX_START){
+    return 1000000UL / (airtimeRFM69Microseconds(format, len) + overhead);
+}
+/*
+    Upper limit on the packets per second of a single sender, with overhead
+    microseconds between packets; by default the start of the transmitter.
+    SPI transfers and interrupt handling come on top of that.
+*/
+
+constexpr uint32_t airtimeRFM69Interval(const airtimeRFM69Format& format, uint8_t len, uint16_t duty_permille){
+    return ((uint64_t) airtimeRFM69Microseconds(format, len) * 1000 + duty_permille - 1) / duty_permille;
+}
+/*
+    Shortest interval in microseconds between the starts of packets to stay
+    within a duty cycle, in tenths of a percent; 10 for the 1% of the 868 MHz
+    band.
+*/
+
+constexpr uint32_t airtimeRFM69PacketsPerHour(const airtimeRFM69Format& format, uint8_t len, uint16_t duty_permille){
+    return 3600000000ULL * duty_permille / 1000 / airtimeRFM69Microseconds(format, len);
+}
+/*
+    Packets per hour within a duty cycle, in tenths of a percent.
+*/
+
+//AIRTIME_RFM69_H
+#endif
@@ -0,0 +1,226 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "asyncRFM69.h"
+
+#ifdef RFM69_ASYNC_AVAILABLE
+
+// the pool of coroutine frames.
+alignas(__BIGGEST_ALIGNMENT__) static uint8_t frames[RFM69_ASYNC_FRAMES][RFM69_ASYNC_FRAME_SIZE];
+static bool frame_used[RFM69_ASYNC_FRAMES] = {false};
+
+// wraps around, like millis().
+static bool reached(uint32_t now, uint32_t deadline){
+    return ((int32_t) (now - deadline)) >= 0;
+}
+
+void* asyncRFM69Task::promise_type::operator new(size_t size) noexcept{
+    if (size > RFM69_ASYNC_FRAME_SIZE){
+        return 0;
+    }
+    for (uint8_t i=0; i < RFM69_ASYNC_FRAMES; i++){
+        if (!frame_used[i]){
+            frame_used[i] = true;
+            return frames[i];
+        }
+    }
+    return 0;
+}
+
+void asyncRFM69Task::promise_type::operator delete(void* frame){
+    for (uint8_t i=0; i < RFM69_ASYNC_FRAMES; i++){
+        if (frame == frames[i]){
+            frame_used[i] = false;
+        }
+    }
+}
+
+asyncRFM69Operation::asyncRFM69Operation(asyncRFM69* async, uint8_t type, uint8_t address, void* buffer, uint8_t len, void* response, uint16_t timeout, uint8_t retries, asyncRFM69Match match, void* match_context){
+    this->async = async;
+    this->next = 0;
+    this->type = type;
+    this->state = ((type == RFM69_ASYNC_SEND) || (type == RFM69_ASYNC_SEND_ACK)) ? RFM69_ASYNC_QUEUED : RFM69_ASYNC_WAITING;
+    this->result = 0;
+    this->address = address;
+    this->buffer = buffer;
+    this->len = len;
+    this->response = response;
+    this->timeout = timeout;
+    this->retries = retries;
+    this->match = match;
+    this->match_context = match_context;
+    // receives and delays count from the co_await.
+    this->deadline = millis() + timeout;
+}
+
+void asyncRFM69Operation::await_suspend(std::coroutine_handle<> handle){
+    this->handle = handle;
+    this->async->add(this);
+}
+
+
+
+/*
+        Public Methods
+*/
+
+asyncRFM69::asyncRFM69(plainRFM69* rfm){
+    this->rfm = rfm;
+    this->first = 0;
+    this->last = 0;
+    this->transmitting = 0;
+    this->unclaimed = 0;
+}
+
+void asyncRFM69::add(asyncRFM69Operation* operation){
+    operation->next = 0;
+    if (this->last){
+        this->last->next = operation;
+    } else {
+        this->first = operation;
+    }
+    this->last = operation;
+}
+
+bool asyncRFM69::run(){
+    bool resumed = false;
+
+    // the packet being sent is on the air, or in the FIFO of the radio.
+    if ((this->transmitting != 0) && this->rfm->canSend()){
+        asyncRFM69Operation* operation = this->transmitting;
+        this->transmitting = 0;
+        if (operation->type == RFM69_ASYNC_SEND){
+            this->complete(operation, operation->len);
+            resumed = true;
+        } else {
+            operation->state = RFM69_ASYNC_WAITING;
+            operation->deadline = millis() + operation->timeout;
+        }
+    }
+
+    // start the first send that waits.
+    if ((this->transmitting == 0) && this->rfm->canSend()){
+        for (asyncRFM69Operation* operation = this->first; operation != 0; operation = operation->next){
+            if (operation->state == RFM69_ASYNC_QUEUED){
+                this->transmit(operation);
+                break;
+            }
+        }
+    }
+
+    // packets stay in the buffer of plainRFM69 until a receive waits.
+    while (this->hasReceiver() && this->rfm->available()){
+        uint8_t length = this->rfm->read(this->packet);
+        if (this->deliver(length)){
+            resumed = true;
+        } else {
+            this->unclaimed++;
+        }
+    }
+
+    // a completed operation changes the list, start over after each.
+    uint32_t now = millis();
+    bool expired = true;
+    while (expired){
+        expired = false;
+        for (asyncRFM69Operation* operation = this->first; operation != 0; operation = operation->next){
+            if ((operation->state != RFM69_ASYNC_WAITING) || !reached(now, operation->deadline)){
+                continue;
+            }
+            if ((operation->type == RFM69_ASYNC_SEND_ACK) && (operation->retries > 0)){
+                operation->retries--;
+                operation->state = RFM69_ASYNC_QUEUED;
+                continue;
+            }
+            this->complete(operation, 0);
+            resumed = true;
+            expired = true;
+            break;
+        }
+    }
+
+    return resumed;
+}
+
+asyncRFM69Operation asyncRFM69::send(uint8_t address, void* buffer, uint8_t len){
+    return asyncRFM69Operation(this, RFM69_ASYNC_SEND, address, buffer, len, 0, 0, 0, 0, 0);
+}
+
+asyncRFM69Operation asyncRFM69::receive(void* buffer, uint16_t timeout_ms, asyncRFM69Match match, void* match_context){
+    return asyncRFM69Operation(this, RFM69_ASYNC_RECEIVE, 0, 0, 0, buffer, timeout_ms, 0, match, match_context);
+}
+
+asyncRFM69Operation asyncRFM69::sendAndWaitAck(uint8_t address, void* buffer, uint8_t len, void* response, uint16_t timeout_ms, uint8_t retries, asyncRFM69Match match, void* match_context){
+    return asyncRFM69Operation(this, RFM69_ASYNC_SEND_ACK, address, buffer, len, response, timeout_ms, retries, match, match_context);
+}
+
+asyncRFM69Operation asyncRFM69::delay(uint16_t ms){
+    return asyncRFM69Operation(this, RFM69_ASYNC_DELAY, 0, 0, 0, 0, ms, 0, 0, 0);
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+void asyncRFM69::remove(asyncRFM69Operation* operation){
+    asyncRFM69Operation* previous = 0;
+    for (asyncRFM69Operation* current = this->first; current != 0; current = current->next){
+        if (current == operation){
+            if (previous){
+                previous->next = current->next;
+            } else {
+                this->first = current->next;
+            }
+            if (this->last == current){
+                this->last = previous;
+            }
+            return;
+        }
+        previous = current;
+    }
+}
+
+void asyncRFM69::complete(asyncRFM69Operation* operation, uint8_t result){
+    this->remove(operation);
+    operation->result = result;
+    // the operation is gone after this, it lived in the frame of the coroutine.
+    operation->handle.resume();
+}
+
+void asyncRFM69::transmit(asyncRFM69Operation* operation){
+    operation->state = RFM69_ASYNC_TRANSMITTING;
+    this->transmitting = operation;
+    this->rfm->sendAny(operation->address, operation->buffer, operation->len);
+}
+
+bool asyncRFM69::deliver(uint8_t length){
+    for (asyncRFM69Operation* operation = this->first; operation != 0; operation = operation->next){
+        if ((operation->state != RFM69_ASYNC_WAITING) || (operation->type == RFM69_ASYNC_DELAY)){
+            continue;
+        }
+        if ((operation->match != 0) && !operation->match(operation->match_context, this->packet, length)){
+            continue;
+        }
+        memcpy(operation->response, this->packet, length);
+        this->complete(operation, length);
+        return true;
+    }
+    return false;
+}
+
+bool asyncRFM69::hasReceiver(){
+    for (asyncRFM69Operation* operation = this->first; operation != 0; operation = operation->next){
+        if ((operation->state == RFM69_ASYNC_WAITING) && (operation->type != RFM69_ASYNC_DELAY)){
+            return true;
+        }
+    }
+    return false;
+}
+
+// RFM69_ASYNC_AVAILABLE
+#endif
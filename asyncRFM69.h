@@ -0,0 +1,250 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <plainRFM69.h>
+
+#ifndef ASYNC_RFM69_H
+#define ASYNC_RFM69_H
+
+/*
+    Awaitable sends and receives on a plainRFM69, for request and response
+    protocols written as C++20 coroutines instead of state machines around
+    canSend(), available() and millis():
+
+        asyncRFM69Task ping(asyncRFM69& async){
+            uint8_t request[4] = {...};
+            uint8_t response[66];
+            uint8_t len = co_await async.sendAndWaitAck(0x01, request, 4, response, 100, 3);
+            if (len == 0){
+                // no response after three retries.
+            }
+        }
+
+        void loop(){
+            async.run();
+        }
+
+    A function that uses co_await and returns asyncRFM69Task starts when it is
+    called and runs up to the first co_await. The operations are queued in
+    the asyncRFM69 object, run() is the executor: from loop() it starts the
+    queued sends one at a time once canSend() allows it, hands received
+    packets to the receives that wait for them and resumes the coroutines
+    whose operation completed. Everything happens in run(), poll() is called
+    from the interrupt as usual; several coroutines can wait at the same time.
+
+    The operations are linked in a list through the awaiters, which live in
+    the frame of the coroutine, so an operation does not allocate. The frames
+    come from a static pool of RFM69_ASYNC_FRAMES slots; calling a coroutine
+    when none is free, or whose frame is larger than RFM69_ASYNC_FRAME_SIZE,
+    returns a task that converts to false and does not run.
+
+    This needs C++20 coroutines (-std=c++20, or -fcoroutines with -std=c++17
+    on GCC 10), on other compilers this file is empty. The Arduino AVR
+    compiler does not have them, the ARM and ESP32 compilers do with the
+    flag added to the build, and so does the host.
+*/
+
+#if defined(__cpp_impl_coroutine)
+#define RFM69_ASYNC_AVAILABLE
+
+#include <coroutine>
+
+// coroutine frames in the static pool.
+#ifndef RFM69_ASYNC_FRAMES
+#define RFM69_ASYNC_FRAMES 4
+#endif
+
+// frames hold the awaiters and the local variables, 384 bytes is enough for a
+// few buffers of a packet on the host; on 32 bit processors they are smaller.
+#ifndef RFM69_ASYNC_FRAME_SIZE
+#define RFM69_ASYNC_FRAME_SIZE 384
+#endif
+
+// the largest packet read() writes, variable length with addressing.
+#define RFM69_ASYNC_MAX_PACKET 66
+
+#define RFM69_ASYNC_SEND 0
+#define RFM69_ASYNC_RECEIVE 1
+#define RFM69_ASYNC_SEND_ACK 2
+#define RFM69_ASYNC_DELAY 3
+
+#define RFM69_ASYNC_QUEUED 0        // waiting to be sent.
+#define RFM69_ASYNC_TRANSMITTING 1
+#define RFM69_ASYNC_WAITING 2       // for a packet or the deadline.
+
+typedef bool (*asyncRFM69Match)(void* context, const uint8_t* packet, uint8_t length);
+/*
+    Returns whether a received packet, as read() writes it, is the one a
+    receive waits for.
+*/
+
+class asyncRFM69;
+
+class asyncRFM69Task {
+    protected:
+        bool started;
+
+    public:
+        struct promise_type {
+            asyncRFM69Task get_return_object(){return asyncRFM69Task(true);};
+            static asyncRFM69Task get_return_object_on_allocation_failure(){return asyncRFM69Task(false);};
+            std::suspend_never initial_suspend() noexcept {return {};};
+            std::suspend_never final_suspend() noexcept {return {};};
+            void return_void(){};
+            void unhandled_exception(){};
+
+            static void* operator new(size_t size) noexcept;
+            static void operator delete(void* frame);
+            /*
+                Frames come from the pool, not the heap.
+            */
+        };
+
+        asyncRFM69Task(bool started){this->started = started;};
+
+        explicit operator bool() const {return this->started;};
+        /*
+            False if there was no frame for the coroutine and it did not run.
+        */
+};
+
+class asyncRFM69Operation {
+    friend class asyncRFM69;
+    protected:
+        asyncRFM69* async;
+        asyncRFM69Operation* next;
+        std::coroutine_handle<> handle;
+
+        uint8_t type;
+        uint8_t state;
+        uint8_t result;
+
+        // packet to send.
+        uint8_t address;
+        void* buffer;
+        uint8_t len;
+
+        // where the received packet goes, and which one.
+        void* response;
+        asyncRFM69Match match;
+        void* match_context;
+
+        uint16_t timeout;
+        uint32_t deadline;
+        uint8_t retries;
+
+    public:
+        asyncRFM69Operation(asyncRFM69* async, uint8_t type, uint8_t address, void* buffer, uint8_t len, void* response, uint16_t timeout, uint8_t retries, asyncRFM69Match match, void* match_context);
+        asyncRFM69Operation(const asyncRFM69Operation&) = delete;
+
+        bool await_ready(){return false;};
+        void await_suspend(std::coroutine_handle<> handle);
+        uint8_t await_resume(){return this->result;};
+        /*
+            The awaiter interface; await_suspend() adds the operation to the
+            queue of run(), co_await returns the result.
+        */
+};
+
+class asyncRFM69 {
+    protected:
+        plainRFM69* rfm;
+
+        // operations in the order they were awaited.
+        asyncRFM69Operation* first;
+        asyncRFM69Operation* last;
+
+        // the operation whose packet is being sent.
+        asyncRFM69Operation* transmitting;
+
+        // packets received while receives were waiting, that none of them took.
+        uint32_t unclaimed;
+
+        uint8_t packet[RFM69_ASYNC_MAX_PACKET];
+
+        void remove(asyncRFM69Operation* operation);
+        void complete(asyncRFM69Operation* operation, uint8_t result);
+        /*
+            Removes the operation from the queue, complete() also resumes its
+            coroutine with the result.
+        */
+
+        void transmit(asyncRFM69Operation* operation);
+
+        bool deliver(uint8_t length);
+        /*
+            Completes the first waiting receive that matches the packet in
+            the packet buffer. Returns false if none matched.
+        */
+
+        bool hasReceiver();
+
+    public:
+        asyncRFM69(plainRFM69* rfm);
+        /*
+            The plainRFM69 has to be set up as normal, with poll() attached
+            to the interrupt or called before run().
+        */
+
+        void add(asyncRFM69Operation* operation);
+        /*
+            Called by the awaiters.
+        */
+
+        bool run();
+        /*
+            The executor, call from loop(). Returns whether a coroutine was
+            resumed.
+        */
+
+        bool idle(){return this->first == 0;};
+        /*
+            Returns whether no coroutine waits for an operation.
+        */
+
+        uint32_t getUnclaimed(){return this->unclaimed;};
+        /*
+            Packets dropped because no waiting receive matched them. Packets
+            that arrive while nothing waits stay in the buffer of plainRFM69.
+        */
+
+        asyncRFM69Operation send(uint8_t address, void* buffer, uint8_t len);
+        /*
+            Sends the packet with plainRFM69::sendAny(), co_await returns
+            once it is sent. The buffer is read when the send starts, which
+            is after the sends awaited before it.
+        */
+
+        asyncRFM69Operation receive(void* buffer, uint16_t timeout_ms, asyncRFM69Match match=0, void* match_context=0);
+        /*
+            Receives the next packet, or the next packet match returns true
+            for, into buffer as read() writes it. Returns the length, zero if
+            none arrived within timeout_ms.
+
+            With several receives waiting, the packet goes to the first one
+            that matches; a packet no receive matches is dropped. To keep
+            several transactions in flight, give each its own match.
+        */
+
+        asyncRFM69Operation sendAndWaitAck(uint8_t address, void* buffer, uint8_t len, void* response, uint16_t timeout_ms, uint8_t retries, asyncRFM69Match match=0, void* match_context=0);
+        /*
+            Sends the packet, then receives the response as receive() does,
+            with the timeout starting after the packet was sent. Without a
+            response it is sent again, up to retries more times. Returns the
+            length of the response, zero if there was none.
+        */
+
+        asyncRFM69Operation delay(uint16_t ms);
+        /*
+            Resumes after ms milliseconds, without blocking the others.
+        */
+};
+
+// RFM69_ASYNC_AVAILABLE
+#endif
+
+//ASYNC_RFM69_H
+#endif
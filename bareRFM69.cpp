@@ -12,49 +12,131 @@ void inline bareRFM69::chipSelect(bool enable){
     digitalWrite(this->cs_pin, (enable) ? LOW : HIGH );
 }
 
-void bareRFM69::writeRegister(uint8_t reg, uint8_t data){
+void bareRFM69::transaction(uint8_t address, void* buffer, uint8_t len, bool reverse){
+    uint8_t* r = reinterpret_cast<uint8_t*>(buffer);
+    bool write = (address & RFM69_WRITE_REG_MASK) != 0;
+    if (this->batch != 0){
+        if (write && this->record(address, buffer, len, reverse, 0)){
+            return;
+        }
+        // the value is needed now, after the writes before it.
+        this->perform();
+    }
     SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
     this->chipSelect(true); // assert chip select
-    SPI.transfer(RFM69_WRITE_REG_MASK | (reg & RFM69_READ_REG_MASK)); 
-    SPI.transfer(data);
+#ifdef RFM69_SPI_BLOCK
+    // the whole transaction in one block transfer.
+    uint8_t frame[RFM69_SPI_BLOCK_MAX + 1];
+    len = (len > RFM69_SPI_BLOCK_MAX) ? RFM69_SPI_BLOCK_MAX : len;
+    frame[0] = address;
+    for (uint8_t i=0; i < len ; i++){
+        frame[i + 1] = (write) ? r[(reverse) ? (len - i - 1) : i] : 0;
+    }
+    SPI.transfer(frame, len + 1);
+    for (uint8_t i=0; (i < len) && !write; i++){
+        r[(reverse) ? (len - i - 1) : i] = frame[i + 1];
+    }
+#else
+    SPI.transfer(address);
+    for (uint8_t i=0; i < len ; i++){
+        uint8_t index = (reverse) ? (len - i - 1) : i;
+        if (write){
+            SPI.transfer(r[index]);
+        } else {
+            r[index] = SPI.transfer(0);
+        }
+    }
+#endif
     this->chipSelect(false);// deassert chip select
     SPI.endTransaction();    // release the SPI bus
 }
 
-uint8_t bareRFM69::readRegister(uint8_t reg){
-    uint8_t foo;
+bool bareRFM69::record(uint8_t address, void* buffer, uint8_t len, bool reverse, void* output){
+    bareRFM69Batch* b = this->batch;
+    if (len >= RFM69_BATCH_BYTES){
+        return false;
+    }
+    if ((b->count == RFM69_BATCH_TRANSACTIONS) || (b->used + len + 1 > RFM69_BATCH_BYTES)){
+        this->perform();
+    }
+    uint8_t* frame = &(b->frames[b->used]);
+    uint8_t* r = reinterpret_cast<uint8_t*>(buffer);
+    frame[0] = address;
+    for (uint8_t i=0; i < len ; i++){
+        // writes are stored in the order they go over the bus.
+        frame[i + 1] = (output == 0) ? r[(reverse) ? (len - i - 1) : i] : 0;
+    }
+    b->size[b->count] = len + 1;
+    b->output[b->count] = output;
+    b->reverse[b->count] = reverse;
+    b->count++;
+    b->used += len + 1;
+    return true;
+}
+
+void bareRFM69::perform(){
+    bareRFM69Batch* b = this->batch;
+    if ((b == 0) || (b->count == 0)){
+        return;
+    }
     SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
-    this->chipSelect(true); // assert chip select
-    SPI.transfer((reg % RFM69_READ_REG_MASK));
-    foo = SPI.transfer(0);
-    this->chipSelect(false);// deassert chip select
+#ifdef RFM69_SPI_BATCH
+    // all transactions in one block transfer, the chip select is released
+    // between them by the SPI library.
+    this->chipSelect(true);
+    SPI.transferFrames(b->frames, b->size, b->count);
+    this->chipSelect(false);
+#else
+    uint8_t* frame = b->frames;
+    for (uint8_t i=0; i < b->count; i++){
+        this->chipSelect(true);
+        for (uint8_t j=0; j < b->size[i]; j++){
+            frame[j] = SPI.transfer(frame[j]);
+        }
+        this->chipSelect(false);
+        frame += b->size[i];
+    }
+#endif
     SPI.endTransaction();    // release the SPI bus
+
+    uint8_t* data = b->frames;
+    for (uint8_t i=0; i < b->count; i++){
+        uint8_t len = b->size[i] - 1;
+        uint8_t* r = reinterpret_cast<uint8_t*>(b->output[i]);
+        for (uint8_t j=0; (r != 0) && (j < len); j++){
+            r[(b->reverse[i]) ? (len - j - 1) : j] = data[j + 1];
+        }
+        data += b->size[i];
+    }
+    b->count = 0;
+    b->used = 0;
+}
+
+void bareRFM69::writeRegister(uint8_t reg, uint8_t data){
+    this->transaction(RFM69_WRITE_REG_MASK | (reg & RFM69_READ_REG_MASK), &data, 1, false);
+}
+
+uint8_t bareRFM69::readRegister(uint8_t reg){
+    uint8_t foo;
+    this->transaction(reg % RFM69_READ_REG_MASK, &foo, 1, false);
     return foo;
 }
 
 void bareRFM69::writeMultiple(uint8_t reg, void* data, uint8_t len){
-    SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
-    this->chipSelect(true); // assert chip select
-    SPI.transfer(RFM69_WRITE_REG_MASK | (reg & RFM69_READ_REG_MASK)); 
-    uint8_t* r = reinterpret_cast<uint8_t*>(data);
-    for (uint8_t i=0; i < len ; i++){
-        SPI.transfer(r[len - i - 1]);
-    }
-    this->chipSelect(false);// deassert chip select
-    SPI.endTransaction();    // release the SPI bus
+    // the most significant byte comes first.
+    this->transaction(RFM69_WRITE_REG_MASK | (reg & RFM69_READ_REG_MASK), data, len, true);
 }
 
 void bareRFM69::readMultiple(uint8_t reg, void* data, uint8_t len){
-    SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
-    this->chipSelect(true); // assert chip select
-    
-    SPI.transfer((reg % RFM69_READ_REG_MASK));
-    uint8_t* r = reinterpret_cast<uint8_t*>(data);
-    for (uint8_t i=0; i < len ; i++){
-        r[len - i - 1] = SPI.transfer(0);
-    }
-    this->chipSelect(false);// deassert chip select
-    SPI.endTransaction();    // release the SPI bus
+    this->transaction(reg % RFM69_READ_REG_MASK, data, len, true);
+}
+
+void bareRFM69::readRawRegisters(uint8_t reg, void* buffer, uint8_t len){
+    this->transaction(reg % RFM69_READ_REG_MASK, buffer, len, false);
+}
+
+void bareRFM69::writeRawRegisters(uint8_t reg, void* buffer, uint8_t len){
+    this->transaction(RFM69_WRITE_REG_MASK | (reg & RFM69_READ_REG_MASK), buffer, len, false);
 }
 
 uint32_t bareRFM69::readRegister32(uint8_t reg){
@@ -74,34 +156,55 @@ uint16_t bareRFM69::readRegister16(uint8_t reg){
 }
 
 void bareRFM69::writeFIFO(void* buffer, uint8_t len){
-    uint8_t* r = reinterpret_cast<uint8_t*>(buffer);
-    SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
-    this->chipSelect(true); // assert chip select
-    SPI.transfer(RFM69_WRITE_REG_MASK | (RFM69_FIFO & RFM69_READ_REG_MASK)); 
-    for (uint8_t i=0; i < len ; i++){
-        // Serial.print("Writing to FIFO: "); Serial.println(r[i]);
-        SPI.transfer(r[i]);
-    }
-    this->chipSelect(false);// deassert chip select
-    SPI.endTransaction();    // release the SPI bus
+    this->transaction(RFM69_WRITE_REG_MASK | (RFM69_FIFO & RFM69_READ_REG_MASK), buffer, len, false);
 }
 
 void bareRFM69::readFIFO(void* buffer, uint8_t len){
-    uint8_t* r = reinterpret_cast<uint8_t*>(buffer);
-    SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
-    this->chipSelect(true); // assert chip select
-    
-    SPI.transfer((RFM69_FIFO % RFM69_READ_REG_MASK));
-    for (uint8_t i=0; i < len ; i++){
-        r[i] = SPI.transfer(0);
+    this->transaction(RFM69_FIFO % RFM69_READ_REG_MASK, buffer, len, false);
+}
+
+void bareRFM69::beginBatch(bareRFM69Batch* batch){
+    this->submitBatch();
+    // an interrupt calling poll() would record into the batch.
+    uint8_t state = RFM69_INTERRUPTS_SAVE();
+    noInterrupts();
+    this->batch_interrupts = state;
+    this->batch = batch;
+}
+
+void bareRFM69::queueRead(uint8_t reg, uint8_t* value){
+    this->queueReadRawRegisters(reg, value, 1);
+}
+
+void bareRFM69::queueReadRawRegisters(uint8_t reg, void* buffer, uint8_t len){
+    if ((this->batch == 0) || !this->record(reg % RFM69_READ_REG_MASK, 0, len, false, buffer)){
+        this->readRawRegisters(reg, buffer, len);
     }
-    this->chipSelect(false);// deassert chip select
-    SPI.endTransaction();    // release the SPI bus
+}
+
+void bareRFM69::submitBatch(){
+    if (this->batch == 0){
+        return;
+    }
+    this->perform();
+    this->batch = 0;
+    RFM69_INTERRUPTS_RESTORE(this->batch_interrupts);
 }
 
 uint8_t bareRFM69::readVariableFIFO(void* buffer, uint8_t max_length){
     uint8_t* r = reinterpret_cast<uint8_t*>(buffer);
 
+#ifdef RFM69_SPI_BLOCK
+    // The length is needed before the payload is read, so these are two
+    // transactions; every byte read from the FIFO removes it, also when the
+    // chip select is released in between.
+    this->transaction(RFM69_FIFO % RFM69_READ_REG_MASK, r, 1, false);
+    uint8_t len = r[0] > (max_length-1) ? (max_length-1) : r[0];
+    this->transaction(RFM69_FIFO % RFM69_READ_REG_MASK, &(r[1]), len, false);
+    return len;
+#else
+    this->perform(); // a recorded batch goes first.
+
     SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0));  // gain control of SPI bus
     this->chipSelect(true); // assert chip select
     
@@ -118,6 +221,7 @@ uint8_t bareRFM69::readVariableFIFO(void* buffer, uint8_t max_length){
     this->chipSelect(false);// deassert chip select
     SPI.endTransaction();    // release the SPI bus
     return len;
+#endif
 }
 
  void bareRFM69::reset(uint8_t pin){ // function to send the RFM69 a hardware reset.
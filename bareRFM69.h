@@ -31,10 +31,63 @@
 #error "https://github.com/PaulStoffregen/SPI/blob/master/SPI.cpp"
 #endif
 
+// transactions and bytes a bareRFM69Batch holds; a full FIFO with its address
+// byte, and the mode and PA registers that sendPacket() writes before it.
+#ifndef RFM69_BATCH_TRANSACTIONS
+#define RFM69_BATCH_TRANSACTIONS 8
+#endif
+#ifndef RFM69_BATCH_BYTES
+#define RFM69_BATCH_BYTES 80
+#endif
+
+// the interrupt state saved by beginBatch() and restored by submitBatch(); the
+// status register on the AVR, PRIMASK on ARM. Where noInterrupts() nests, as
+// on the Linux backend, interrupts() undoes it.
+#ifndef RFM69_INTERRUPTS_SAVE
+#if defined(__AVR__)
+    #define RFM69_INTERRUPTS_SAVE() SREG
+    #define RFM69_INTERRUPTS_RESTORE(state) (SREG = (state))
+#elif defined(__arm__)
+    static inline uint8_t bareRFM69Primask(){
+        uint32_t primask;
+        __asm__ volatile ("mrs %0, primask" : "=r" (primask));
+        return primask & 1;
+    }
+    #define RFM69_INTERRUPTS_SAVE() bareRFM69Primask()
+    #define RFM69_INTERRUPTS_RESTORE(state) do {if ((state) == 0){interrupts();}} while (0)
+#else
+    #define RFM69_INTERRUPTS_SAVE() 0
+    #define RFM69_INTERRUPTS_RESTORE(state) interrupts()
+#endif
+#endif
+
+class bareRFM69Batch {
+    friend class bareRFM69;
+    protected:
+        // the transactions back to back, each the address byte then the data.
+        uint8_t frames[RFM69_BATCH_BYTES];
+        uint8_t size[RFM69_BATCH_TRANSACTIONS];
+        void* output[RFM69_BATCH_TRANSACTIONS];  // where a read goes, or 0.
+        bool reverse[RFM69_BATCH_TRANSACTIONS];
+        uint8_t count;
+        uint8_t used;
+
+    public:
+        bareRFM69Batch(){this->count = 0; this->used = 0;};
+
+        uint8_t getCount(){return this->count;};
+        /*
+            Transactions recorded and not yet performed.
+        */
+};
+
 class bareRFM69 {
     private:
         uint8_t cs_pin; // chip select pin.
 
+        bareRFM69Batch* batch; // recording into, or 0.
+        uint8_t batch_interrupts; // RFM69_INTERRUPTS_SAVE() before it.
+
 
         // SPI relevant stuff
         void writeRegister(uint8_t reg, uint8_t data);
@@ -48,9 +101,39 @@ class bareRFM69 {
 
         void inline chipSelect(bool enable);
 
+        void transaction(uint8_t address, void* buffer, uint8_t len, bool reverse);
+        /*
+            One transaction of len bytes after the address byte, the bytes
+            are written from buffer if the write bit is set in address, else
+            they are read into it. With reverse, the last byte of the buffer
+            goes over the bus first.
+
+            If the SPI library defines RFM69_SPI_BLOCK, the transaction is a
+            single block transfer of at most RFM69_SPI_BLOCK_MAX bytes after
+            the address, as the Linux backend in extras/linux/ needs.
+
+            While a batch is recorded, writes are added to it; a read first
+            performs what was recorded, such that it sees the writes.
+        */
+
+        bool record(uint8_t address, void* buffer, uint8_t len, bool reverse, void* output);
+        /*
+            Adds a transaction to the batch, performing the batch first if
+            it is full. Returns false if the transaction alone does not fit.
+        */
+
+        void perform();
+        /*
+            Performs the transactions in the batch in one bus transaction,
+            with one block transfer of them all if the SPI library defines
+            RFM69_SPI_BATCH. The reads are copied to their output after.
+        */
+
     public:
         bareRFM69(uint8_t cs_pin){
             this->cs_pin = cs_pin;
+            this->batch = 0;
+            this->batch_interrupts = 0;
             pinMode(this->cs_pin, OUTPUT);
             digitalWrite(this->cs_pin, HIGH);
 
@@ -63,6 +146,15 @@ class bareRFM69 {
         uint8_t readRawRegister(uint8_t reg){return this->readRegister(reg);}
         // used for debugging.
 
+        void readRawRegisters(uint8_t reg, void* buffer, uint8_t len);
+        // Reads len consecutive registers starting at reg in a single SPI
+        // transaction, buffer[0] holds reg. Unlike the multi byte values, the
+        // bytes are not reversed.
+
+        void writeRawRegisters(uint8_t reg, void* buffer, uint8_t len);
+        // Writes len consecutive registers starting at reg in a single SPI
+        // transaction, in the same order as readRawRegisters().
+
 
         //#####################################################################
         // Generic stuff
@@ -95,6 +187,57 @@ class bareRFM69 {
         // this byte is also placed in the buffer. The max_length argument can
         // be used to limit the number of bytes.
 
+
+        //#####################################################################
+        // Batches
+        //#####################################################################
+
+        void beginBatch(bareRFM69Batch* batch);
+        /*
+            Until submitBatch(), the writes of all methods are recorded in
+            batch instead of performed, for example those of sendPacket():
+
+                bareRFM69Batch batch;
+                uint8_t flags;
+                rfm.beginBatch(&batch);
+                rfm.setMode(RFM69_MODE_SEQUENCER_ON | RFM69_MODE_STANDBY);
+                rfm.setAutoMode(...);
+                rfm.writeFIFO(buffer, len);
+                rfm.queueRead(RFM69_IRQ_FLAGS1, &flags);
+                rfm.submitBatch(); // flags is valid after this.
+
+            The data is copied, the buffers may go out of scope before the
+            batch is submitted. submitBatch() performs the transactions, with
+            the chip select released between them as always, but with the SPI
+            bus taken once; on the Linux backend they are one ioctl.
+
+            Reads can only be recorded with the queue methods, because the
+            value is not known until the submit. Any other read performs what
+            was recorded first, and then itself. A full batch is performed
+            when the next transaction is recorded.
+
+            Interrupts are disabled from beginBatch() until submitBatch() has
+            returned, such that poll() in an interrupt neither records into
+            the batch nor sees half of it performed. submitBatch() restores
+            the state beginBatch() found, so a batch in an interrupt or within
+            noInterrupts() leaves them disabled. Keep batches short: the one
+            of sendPacket() writes up to a full FIFO, 67 bytes with the
+            address, with the interrupts disabled; some 70 us at 8 MHz.
+        */
+
+        void queueRead(uint8_t reg, uint8_t* value);
+        void queueReadRawRegisters(uint8_t reg, void* buffer, uint8_t len);
+        /*
+            Records a read of one register, or of len consecutive registers
+            in the order of readRawRegisters(). The output is written by
+            submitBatch(). Without a batch, these read immediately.
+        */
+
+        void submitBatch();
+        /*
+            Performs the recorded transactions and stops recording.
+        */
+
         
         //#####################################################################
         // Operating stuff
@@ -170,6 +313,34 @@ class bareRFM69 {
                 450 MHz; 450e6/FSTEP = 7372800 = 0x708000 (outside of ISM)
         */
 
+        static uint32_t frequencyToFrf(uint32_t freq){
+            return ((freq / 31250) << 9) + (((freq % 31250) << 9) + 15625) / 31250;};
+        /*
+            Converts a frequency in Hz to the Frf register value, rounded to
+            the nearest step. Exact, as FSTEP = 31250/512 Hz; it splits the
+            division such that no 64 bit arithmetic is necessary.
+
+            Example:
+                frequencyToFrf(434000000) = 7110656 = 0x6c8000
+        */
+
+        void hopFrf(uint32_t Frf, uint8_t mode){
+            this->setFrf(Frf);
+            this->setMode(RFM69_MODE_SEQUENCER_ON | RFM69_MODE_FREQ_SYNTH);
+            this->setMode(mode);};
+        /*
+            Changes the carrier frequency as fast as possible, following the
+            optimized frequency hopping sequence from the datasheet:
+                The new Frf is written in a single burst, it is taken into
+                account when the LSB is written. Then the radio is sent through
+                the frequency synthesizer mode, which only relocks the PLL,
+                before it is returned to 'mode'.
+
+            Mode is the mode to return to, as with setMode(), for example:
+                RFM69_MODE_SEQUENCER_ON | RFM69_MODE_RECEIVER
+            Any AutoMode configuration is left untouched.
+        */
+
 
         // Frequency Deviation
         void setFdev(uint16_t Fdev){
@@ -486,6 +657,62 @@ class bareRFM69 {
         */
 
 
+        void setOokPeak(uint8_t OokThreshType, uint8_t OokPeakThreshStep, uint8_t OokPeakThreshDec){
+            this->writeRegister(RFM69_OOK_PEAK, OokThreshType | OokPeakThreshStep | OokPeakThreshDec);};
+        /*
+            OOK demodulator threshold, only used with OOK modulation.
+
+            OokThreshType:
+                RFM69_OOK_THRESH_TYPE_FIXED
+                    Threshold set with setOokFixedThreshold().
+                RFM69_OOK_THRESH_TYPE_PEAK (default)
+                    Follows the peak of the signal, decays with the step and
+                    rate below, never below the fixed threshold.
+                RFM69_OOK_THRESH_TYPE_AVERAGE
+                    Average of the signal, filtered as set by setOokAvg().
+            OokPeakThreshStep:
+                RFM69_OOK_PEAK_STEP_#_DB, decrement per step of the peak
+                threshold, with # from {0_5, 1_0, 1_5, 2_0, 3_0, 4_0, 5_0, 6_0}
+                Default: 0_5.
+            OokPeakThreshDec:
+                RFM69_OOK_PEAK_DEC_#, rate of the decrements, from once per 8
+                chips to 16 times per chip. Default: RFM69_OOK_PEAK_DEC_1_PER_CHIP
+        */
+
+        void setOokAvg(uint8_t OokAverageThreshFilt){this->writeRegister(RFM69_OOK_AVG, OokAverageThreshFilt);};
+        /*
+            Filter of the average threshold, RFM69_OOK_AVG_FILT_#PI: cutoff
+            frequency of chip rate / (# pi), with # from {32, 8, 4, 2}.
+            Default: RFM69_OOK_AVG_FILT_4PI
+        */
+
+        void setOokFixedThreshold(uint8_t OokFixedThresh){this->writeRegister(RFM69_OOK_FIX, OokFixedThresh);};
+        /*
+            Fixed threshold in dB, or the floor of the peak threshold.
+            Default: 6 dB.
+        */
+
+        void setAfcFei(uint8_t modifiers){this->writeRegister(RFM69_AFC_FEI, modifiers);};
+        /*
+            OR-ed statements of:
+                RFM69_AFC_FEI_FEI_START
+                    Triggers a FEI measurement.
+                RFM69_AFC_FEI_AFC_AUTOCLEAR_ON
+                    Clears the AFC value before a new AFC phase.
+                RFM69_AFC_FEI_AFC_AUTO_ON
+                    Performs AFC (and FEI) each time Rx mode is entered.
+                RFM69_AFC_FEI_AFC_CLEAR
+                    Clears the AFC value.
+                RFM69_AFC_FEI_AFC_START
+                    Triggers an AFC.
+        */
+
+        int16_t getFei(){return this->readRegister16(RFM69_FEI_MSB);};
+        /*
+            Measured frequency offset, in steps of FSTEP (61 Hz), two's
+            complement.
+        */
+
         void startRssi(){
             this->writeRegister(RFM69_RSSI_CONFIG, 1);};
         bool completedRssi(){
@@ -134,6 +134,12 @@
 #define RFM69_MODE_LISTEN_OFF 0
 #define RFM69_MODE_LISTEN_ABORT (1<<5)
 
+// start up times in us, typical values from the datasheet with the default
+// PaRamp: the oscillator (TS_OSC), synthesizer (TS_FS) and PA ramp (TS_TR).
+#define RFM69_TS_OSC 250
+#define RFM69_TS_FS 60
+#define RFM69_TS_TR 55
+
 
 #define RFM69_DATAMODUL_PROCESSING_PACKET 0b00
 #define RFM69_DATAMODUL_PROCESSING_CONT_SYNCRHONISER 0b10
@@ -150,6 +156,33 @@
 #define RFM69_DATAMODUL_SHAPING_OOK_FCUTOFF_BR 0b01
 #define RFM69_DATAMODUL_SHAPING_OOK_FCUTOFF_2BR 0b10
 
+#define RFM69_OOK_THRESH_TYPE_FIXED (0b00<<6)
+#define RFM69_OOK_THRESH_TYPE_PEAK (0b01<<6)
+#define RFM69_OOK_THRESH_TYPE_AVERAGE (0b10<<6)
+
+#define RFM69_OOK_PEAK_STEP_0_5_DB (0b000<<3)
+#define RFM69_OOK_PEAK_STEP_1_0_DB (0b001<<3)
+#define RFM69_OOK_PEAK_STEP_1_5_DB (0b010<<3)
+#define RFM69_OOK_PEAK_STEP_2_0_DB (0b011<<3)
+#define RFM69_OOK_PEAK_STEP_3_0_DB (0b100<<3)
+#define RFM69_OOK_PEAK_STEP_4_0_DB (0b101<<3)
+#define RFM69_OOK_PEAK_STEP_5_0_DB (0b110<<3)
+#define RFM69_OOK_PEAK_STEP_6_0_DB (0b111<<3)
+
+#define RFM69_OOK_PEAK_DEC_1_PER_CHIP 0b000
+#define RFM69_OOK_PEAK_DEC_1_PER_2_CHIPS 0b001
+#define RFM69_OOK_PEAK_DEC_1_PER_4_CHIPS 0b010
+#define RFM69_OOK_PEAK_DEC_1_PER_8_CHIPS 0b011
+#define RFM69_OOK_PEAK_DEC_2_PER_CHIP 0b100
+#define RFM69_OOK_PEAK_DEC_4_PER_CHIP 0b101
+#define RFM69_OOK_PEAK_DEC_8_PER_CHIP 0b110
+#define RFM69_OOK_PEAK_DEC_16_PER_CHIP 0b111
+
+#define RFM69_OOK_AVG_FILT_32PI (0b00<<6)
+#define RFM69_OOK_AVG_FILT_8PI (0b01<<6)
+#define RFM69_OOK_AVG_FILT_4PI (0b10<<6)
+#define RFM69_OOK_AVG_FILT_2PI (0b11<<6)
+
 #define RFM69_PA_LEVEL_PA0_ON 0b10000000
 #define RFM69_PA_LEVEL_PA1_ON 0b01000000
 #define RFM69_PA_LEVEL_PA2_ON 0b00100000
@@ -191,6 +224,14 @@
 #define RFM69_AFC_CTRL_STANDARD 0
 #define RFM69_AFC_CTRL_IMPROVED 1
 
+#define RFM69_AFC_FEI_FEI_DONE (1<<6)
+#define RFM69_AFC_FEI_FEI_START (1<<5)
+#define RFM69_AFC_FEI_AFC_DONE (1<<4)
+#define RFM69_AFC_FEI_AFC_AUTOCLEAR_ON (1<<3)
+#define RFM69_AFC_FEI_AFC_AUTO_ON (1<<2)
+#define RFM69_AFC_FEI_AFC_CLEAR (1<<1)
+#define RFM69_AFC_FEI_AFC_START (1<<0)
+
 
 #define RFM69_LISTEN_RESOL_IDLE_64US (0b01<<6)
 #define RFM69_LISTEN_RESOL_IDLE_4_1MS (0b10<<6)
@@ -255,6 +296,9 @@
 
 #define RFM69_PACKET_DIO_3_FIFO_FULL (0b00 << RFM69_DIO_3_MAP_SHIFT)
 
+#define RFM69_CONTINUOUS_DIO_1_DCLK (0b00 << RFM69_DIO_1_MAP_SHIFT)
+#define RFM69_CONTINUOUS_DIO_2_DATA (0b00 << RFM69_DIO_2_MAP_SHIFT)
+
 
 // the above DIO constants are not extensive!
 // only the ones which were deemed useful in packet mode are listed.
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+#include "bareRFM69_const.h"
+
+#ifndef CODEC_RFM69_H
+#define CODEC_RFM69_H
+
+/*
+    Software versions of the CRC, data whitening and Manchester encoding done
+    by the packet engine of the radio.
+
+    These allow decoding packets received with the CRC check disabled or kept
+    on failure (RFM69_PACKET_CONFIG_CRC_FAIL_KEEP), or bits captured in
+    continuous mode, and producing the exact bytes on the air for simulations
+    on the host. This file does not depend on Arduino.
+
+    CRC:
+        CRC-16 CCITT, polynomial 0x1021, register initialised to 0x1D0F and
+        inverted at the end, transmitted MSB first. It covers the length byte,
+        address byte and payload, after AES encryption. These parameters were
+        verified on the packets captured in extras/check_crypto_mode.py.
+
+        Table driven, a byte wide table (512 bytes) is used on the host and
+        a nibble wide table (32 bytes) on AVR, where RAM is scarce.
+
+    Whitening:
+        XOR with a PN9 sequence (x^9 + x^5 + 1, seeded with 0x1FF) over the
+        bytes after the sync word, CRC included. The LFSR is advanced eight
+        bits at once, so it needs no table.
+
+    Manchester:
+        Every bit becomes two chips, a 1 as 10 and a 0 as 01, MSB first, over
+        the bytes after the sync word. Decoding reports invalid chip pairs.
+*/
+
+#define RFM69_CODEC_CRC_INIT 0x1D0F
+#define RFM69_CODEC_CRC_XOROUT 0xFFFF
+#define RFM69_CODEC_WHITENING_INIT 0x1FF
+
+// length of the CRC on the air.
+#define RFM69_CODEC_CRC_LENGTH 2
+
+uint16_t codecRFM69CrcUpdate(uint16_t crc, const uint8_t* data, uint16_t len);
+/*
+    Updates a CRC register with len bytes, to calculate the CRC over data
+    that is not contiguous. Start with RFM69_CODEC_CRC_INIT and XOR the
+    result with RFM69_CODEC_CRC_XOROUT.
+*/
+
+uint16_t codecRFM69Crc(const uint8_t* data, uint16_t len);
+/*
+    CRC of len bytes, as appended by the radio.
+*/
+
+bool codecRFM69CheckCrc(const uint8_t* frame, uint16_t len);
+/*
+    Returns true if the last two bytes of the frame hold the CRC over the
+    bytes before it.
+*/
+
+uint16_t codecRFM69Whiten(uint8_t* data, uint16_t len, uint16_t state=RFM69_CODEC_WHITENING_INIT);
+/*
+    Whitens or dewhitens len bytes in place. Returns the state of the LFSR,
+    which can be passed in to continue with the next bytes of the same frame.
+*/
+
+void codecRFM69ManchesterEncode(const uint8_t* in, uint16_t len, uint8_t* out);
+/*
+    Encodes len bytes, out should hold 2*len bytes.
+*/
+
+bool codecRFM69ManchesterDecode(const uint8_t* in, uint16_t len, uint8_t* out);
+/*
+    Decodes len bytes, len should be even and out should hold len/2 bytes.
+    Returns false if an invalid chip pair (00 or 11) was found, out is
+    completely written regardless.
+*/
+
+uint16_t codecRFM69EncodeAir(const uint8_t* frame, uint16_t len, uint8_t dc_free, bool use_crc, uint8_t* out);
+/*
+    Produces the bytes sent after the sync word for a frame, which consists of
+    the length byte (if variable length), address byte (if addressing) and
+    payload, as they are written to the FIFO. The CRC is appended if use_crc
+    is set, dc_free is one of the RFM69_PACKET_CONFIG_DC_FREE_* values.
+
+    out should hold len + 2 bytes, or twice that with Manchester encoding.
+    Returns the number of bytes written to out.
+*/
+
+bool codecRFM69DecodeAir(const uint8_t* in, uint16_t len, uint8_t dc_free, bool use_crc, uint8_t* out);
+/*
+    Reverses codecRFM69EncodeAir(), out receives the frame followed by the
+    CRC, if used. Returns false if the CRC or Manchester encoding is invalid.
+    Decoding in place (out == in) is allowed without Manchester.
+*/
+
+//CODEC_RFM69_H
+#endif
@@ -0,0 +1,228 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "compressRFM69.h"
+
+
+
+/*
+        Public Methods
+*/
+
+void compressRFM69::setDictionary(const void* dictionary, uint8_t len){
+    this->dictionary_length = (len > RFM69_COMPRESS_MAX_DICTIONARY) ? RFM69_COMPRESS_MAX_DICTIONARY : len;
+    // stays in front of the window, the payloads are placed after it.
+    memcpy(this->window, dictionary, this->dictionary_length);
+}
+
+uint8_t compressRFM69::compress(uint8_t peer, const void* payload, uint8_t len, uint8_t* out){
+    if (len > RFM69_COMPRESS_MAX_FRAME){
+        return 0;
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(payload);
+
+    compressRFM69Peer* p = this->findPeer(this->tx_peers, &(this->tx_victim), peer);
+    uint8_t sequence = (p->used) ? ((p->sequence + 1) & RFM69_COMPRESS_SEQUENCE_MASK) : 0;
+    bool key = (!p->used) || ((sequence % RFM69_COMPRESS_KEY_INTERVAL) == 0) || (p->length != len);
+
+    uint8_t header = 0;
+    uint8_t size = len;
+
+    uint8_t n = this->lz(data, len, this->tokens, size);
+    if (n){
+        memcpy(&(out[1]), this->tokens, n);
+        header = RFM69_COMPRESS_LZ;
+        size = n;
+    }
+
+    if (!key){
+        for (uint8_t i=0; i < len; i++){
+            this->delta[i] = data[i] ^ p->frame[i];
+        }
+        n = this->lz(this->delta, len, this->tokens, size);
+        if (n){
+            memcpy(&(out[1]), this->tokens, n);
+            header = RFM69_COMPRESS_DELTA | RFM69_COMPRESS_LZ;
+            size = n;
+        }
+    }
+
+    if (header == 0){
+        memcpy(&(out[1]), data, len);
+    }
+    out[0] = header | sequence;
+
+    p->used = true;
+    p->address = peer;
+    p->sequence = sequence;
+    p->length = len;
+    memcpy(p->frame, data, len);
+
+    this->raw_bytes += len;
+    this->compressed_bytes += size + RFM69_COMPRESS_OVERHEAD;
+    return size + RFM69_COMPRESS_OVERHEAD;
+}
+
+uint8_t compressRFM69::decompress(uint8_t peer, const uint8_t* in, uint8_t len, uint8_t* out){
+    if ((len < RFM69_COMPRESS_OVERHEAD) || (len > (RFM69_COMPRESS_MAX_FRAME + RFM69_COMPRESS_OVERHEAD))){
+        this->rejected++;
+        return 0;
+    }
+    uint8_t header = in[0];
+    uint8_t sequence = header & RFM69_COMPRESS_SEQUENCE_MASK;
+
+    uint8_t n = len - RFM69_COMPRESS_OVERHEAD;
+    if (header & RFM69_COMPRESS_LZ){
+        n = this->unlz(&(in[1]), n, out);
+        if (n == 0){
+            this->rejected++;
+            return 0;
+        }
+    } else {
+        memcpy(out, &(in[1]), n);
+    }
+
+    compressRFM69Peer* p = this->findPeer(this->rx_peers, &(this->rx_victim), peer);
+    if (header & RFM69_COMPRESS_DELTA){
+        // only valid on top of the directly preceding payload.
+        if ((!p->used) || (p->sequence != ((sequence - 1) & RFM69_COMPRESS_SEQUENCE_MASK)) || (p->length != n)){
+            this->rejected++;
+            return 0;
+        }
+        for (uint8_t i=0; i < n; i++){
+            out[i] ^= p->frame[i];
+        }
+    }
+
+    p->used = true;
+    p->address = peer;
+    p->sequence = sequence;
+    p->length = n;
+    memcpy(p->frame, out, n);
+    return n;
+}
+
+void compressRFM69::forgetPeers(){
+    memset(this->tx_peers, 0, sizeof(this->tx_peers));
+    memset(this->rx_peers, 0, sizeof(this->rx_peers));
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+uint8_t compressRFM69::lz(const uint8_t* data, uint8_t len, uint8_t* out, uint8_t limit){
+    uint8_t* window = this->window;
+    memcpy(&(window[this->dictionary_length]), data, len);
+    uint16_t total = this->dictionary_length + len;
+
+    uint8_t o = 0;
+    uint8_t flags = 0;
+    uint8_t bit = 8;
+    uint16_t i = this->dictionary_length;
+    while (i < total){
+        if (bit == 8){
+            if ((o + 1) >= limit){
+                return 0;
+            }
+            flags = o++;
+            out[flags] = 0;
+            bit = 0;
+        }
+
+        // longest match, the nearest if there are several; it may overlap
+        // the bytes being encoded, which repeats them.
+        uint8_t best_length = 0;
+        uint8_t best_distance = 0;
+        uint16_t start = (i > 0xFF) ? (i - 0xFF) : 0;
+        for (uint16_t j=start; j < i; j++){
+            uint8_t k = 0;
+            while (((i + k) < total) && (window[j + k] == window[i + k])){
+                k++;
+            }
+            if ((k >= best_length) && (k >= RFM69_COMPRESS_MIN_MATCH)){
+                best_length = k;
+                best_distance = i - j;
+            }
+        }
+
+        if (best_length){
+            if ((o + 2) >= limit){
+                return 0;
+            }
+            out[flags] |= 1 << bit;
+            out[o++] = best_distance;
+            out[o++] = best_length - RFM69_COMPRESS_MIN_MATCH;
+            i += best_length;
+        } else {
+            if ((o + 1) >= limit){
+                return 0;
+            }
+            out[o++] = window[i++];
+        }
+        bit++;
+    }
+    return o;
+}
+
+uint8_t compressRFM69::unlz(const uint8_t* in, uint8_t len, uint8_t* out){
+    uint8_t* window = this->window;
+    uint16_t pos = this->dictionary_length;
+    uint16_t end = this->dictionary_length + RFM69_COMPRESS_MAX_FRAME;
+
+    uint8_t i = 0;
+    while (i < len){
+        uint8_t flags = in[i++];
+        for (uint8_t bit=0; (bit < 8) && (i < len); bit++){
+            if (flags & (1 << bit)){
+                if ((i + 1) >= len){
+                    return 0;
+                }
+                uint8_t distance = in[i];
+                uint16_t length = in[i + 1] + RFM69_COMPRESS_MIN_MATCH;
+                i += 2;
+                if ((distance == 0) || (distance > pos) || ((pos + length) > end)){
+                    return 0;
+                }
+                // byte by byte, such that overlapping matches repeat.
+                for (uint16_t k=0; k < length; k++){
+                    window[pos + k] = window[pos - distance + k];
+                }
+                pos += length;
+            } else {
+                if (pos >= end){
+                    return 0;
+                }
+                window[pos++] = in[i++];
+            }
+        }
+    }
+    uint8_t n = pos - this->dictionary_length;
+    memcpy(out, &(window[this->dictionary_length]), n);
+    return n;
+}
+
+compressRFM69Peer* compressRFM69::findPeer(compressRFM69Peer* peers, uint8_t* victim, uint8_t address){
+    compressRFM69Peer* free = 0;
+    for (uint8_t i=0; i < RFM69_COMPRESS_MAX_PEERS; i++){
+        if (peers[i].used && (peers[i].address == address)){
+            return &(peers[i]);
+        }
+        if ((!peers[i].used) && (free == 0)){
+            free = &(peers[i]);
+        }
+    }
+    if (free == 0){
+        // replace them in turn, the replaced one starts with a key frame.
+        free = &(peers[*victim]);
+        *victim = (*victim + 1) % RFM69_COMPRESS_MAX_PEERS;
+        free->used = false;
+    }
+    free->address = address;
+    return free;
+}
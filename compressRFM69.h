@@ -0,0 +1,172 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef COMPRESS_RFM69_H
+#define COMPRESS_RFM69_H
+
+/*
+    Compresses payloads before sending, and decompresses them after reading,
+    for telemetry that changes little from one frame to the next.
+
+    Two stages are used:
+
+    Delta:
+        The payload is XOR'ed with the previous payload sent to the same
+        peer, unchanged bytes become zero. The receiver keeps the previous
+        payload of every sender to undo this. If a frame is lost, deltas
+        can not be decoded until the next key frame, a frame that is not a
+        delta; every RFM69_COMPRESS_KEY_INTERVAL-th frame is one.
+
+    LZ:
+        LZSS over a small static dictionary followed by the payload; bytes
+        are either copied literally or as a match of 3 or more bytes earlier
+        in the dictionary or payload. The dictionary should hold byte
+        sequences that are common in the payloads, for example the names of
+        fields, and must be the same on all nodes. Runs of zeros from the
+        delta stage are encoded as overlapping matches.
+
+    The smaller of LZ and delta with LZ is sent; if neither is smaller than
+    the payload itself, it is sent raw with only the header.
+
+    Compressed layout:
+        0       header, RFM69_COMPRESS_DELTA and RFM69_COMPRESS_LZ flags and
+                a 6 bit sequence number.
+        1...    raw payload, or LZ tokens: a flag byte for every 8 tokens,
+                LSB first, a set bit is a match of two bytes [distance,
+                length - 3], a cleared bit a literal byte.
+
+    All state is allocated in the object, the size depends on
+    RFM69_COMPRESS_MAX_PEERS and RFM69_COMPRESS_MAX_FRAME.
+*/
+
+// the largest payload, before compression.
+#ifndef RFM69_COMPRESS_MAX_FRAME
+#define RFM69_COMPRESS_MAX_FRAME 64
+#endif
+
+#ifndef RFM69_COMPRESS_MAX_DICTIONARY
+#define RFM69_COMPRESS_MAX_DICTIONARY 64
+#endif
+
+// number of peers for which the previous payload is kept, per direction.
+#ifndef RFM69_COMPRESS_MAX_PEERS
+#define RFM69_COMPRESS_MAX_PEERS 4
+#endif
+
+#ifndef RFM69_COMPRESS_KEY_INTERVAL
+#define RFM69_COMPRESS_KEY_INTERVAL 8
+#endif
+
+#define RFM69_COMPRESS_DELTA (1<<7)
+#define RFM69_COMPRESS_LZ (1<<6)
+#define RFM69_COMPRESS_SEQUENCE_MASK 0b111111
+
+#define RFM69_COMPRESS_MIN_MATCH 3
+
+// the compressed payload is at most one byte longer.
+#define RFM69_COMPRESS_OVERHEAD 1
+
+struct compressRFM69Peer {
+    uint8_t address;
+    bool used;
+    uint8_t sequence; // of the payload in frame.
+    uint8_t length;
+    uint8_t frame[RFM69_COMPRESS_MAX_FRAME];
+};
+
+class compressRFM69{
+    protected:
+        uint8_t dictionary_length;
+
+        // the dictionary followed by the payload being (de)compressed.
+        uint8_t window[RFM69_COMPRESS_MAX_DICTIONARY + RFM69_COMPRESS_MAX_FRAME];
+
+        // the delta and its LZ tokens.
+        uint8_t delta[RFM69_COMPRESS_MAX_FRAME];
+        uint8_t tokens[RFM69_COMPRESS_MAX_FRAME + RFM69_COMPRESS_OVERHEAD];
+
+        compressRFM69Peer tx_peers[RFM69_COMPRESS_MAX_PEERS];
+        compressRFM69Peer rx_peers[RFM69_COMPRESS_MAX_PEERS];
+        uint8_t tx_victim;
+        uint8_t rx_victim;
+
+        uint32_t raw_bytes;
+        uint32_t compressed_bytes;
+        uint16_t rejected;
+
+        uint8_t lz(const uint8_t* data, uint8_t len, uint8_t* out, uint8_t limit);
+        /*
+            Writes the LZ tokens of data to out, returns their length or zero
+            if that would be limit bytes or more.
+        */
+
+        uint8_t unlz(const uint8_t* in, uint8_t len, uint8_t* out);
+        /*
+            Decodes LZ tokens, returns the length written to out or zero if
+            the tokens are invalid.
+        */
+
+        compressRFM69Peer* findPeer(compressRFM69Peer* peers, uint8_t* victim, uint8_t address);
+        /*
+            Returns the peer with this address, replaces one if not found.
+        */
+
+    public:
+        compressRFM69(){
+            this->dictionary_length = 0;
+            this->tx_victim = 0;
+            this->rx_victim = 0;
+            this->raw_bytes = 0;
+            this->compressed_bytes = 0;
+            this->rejected = 0;
+            this->forgetPeers();
+        };
+
+        void setDictionary(const void* dictionary, uint8_t len);
+        /*
+            Sets the static dictionary, up to RFM69_COMPRESS_MAX_DICTIONARY
+            bytes. Should be identical on all nodes.
+        */
+
+        uint8_t compress(uint8_t peer, const void* payload, uint8_t len, uint8_t* out);
+        /*
+            Compresses up to RFM69_COMPRESS_MAX_FRAME bytes of payload for peer,
+            which is the destination or any other identifier of the link.
+            out should hold len + RFM69_COMPRESS_OVERHEAD bytes. Returns the
+            length written to out.
+        */
+
+        uint8_t decompress(uint8_t peer, const uint8_t* in, uint8_t len, uint8_t* out);
+        /*
+            Decompresses a payload from peer, which should be the same
+            identifier as used by the sender. out should hold
+            RFM69_COMPRESS_MAX_FRAME bytes. Returns the length of the
+            payload, zero if it is invalid or a delta on a lost frame.
+        */
+
+        void forgetPeers();
+        /*
+            Clears the previous payloads, the next frames are key frames.
+        */
+
+        uint32_t getRawBytes(){return this->raw_bytes;};
+        uint32_t getCompressedBytes(){return this->compressed_bytes;};
+        /*
+            Total bytes given to compress() and returned by it, the ratio of
+            these is the compression ratio.
+        */
+
+        uint16_t getRejected(){return this->rejected;};
+        /*
+            Payloads that could not be decompressed.
+        */
+};
+
+//COMPRESS_RFM69_H
+#endif
@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "continuousRFM69.h"
+
+
+
+/*
+        Public Methods
+*/
+
+void continuousRFM69::setContinuous(bool use_ook, bool use_synchroniser){
+    uint8_t processing = (use_synchroniser) ? RFM69_DATAMODUL_PROCESSING_CONT_SYNCRHONISER : RFM69_DATAMODUL_PROCESSING_CONT;
+    this->setDataModul(processing, use_ook, RFM69_DATAMODUL_SHAPING_GFSK_NONE);
+    this->setDioMapping1(RFM69_CONTINUOUS_DIO_1_DCLK | RFM69_CONTINUOUS_DIO_2_DATA);
+}
+
+void continuousRFM69::ookSensor(){
+    this->setContinuous(true, false);
+
+    // Without synchroniser the DATA pin follows the demodulator directly,
+    // the bit rate only sets the rate of the threshold decay. The highest
+    // OOK bit rate, FXO_SC / 0x03d1 = 32768 bps, ~30 us per chip.
+    this->setBitRate(0x03d1);
+
+    // RxBwMant=0b10; RxBwExp=0b001; FXO_SC/((RxBwMant*4+16)*2**(RxBwExp+3))= 83333 Hz
+    this->setRxBw(0b010, 0b10, 0b001);
+
+    // The gap after the sync pulse lasts up to ~10 ms, decay 0.5 dB every
+    // eight chips (2 dB/ms) such that the threshold stays above the noise.
+    this->setOokPeak(RFM69_OOK_THRESH_TYPE_PEAK, RFM69_OOK_PEAK_STEP_0_5_DB, RFM69_OOK_PEAK_DEC_1_PER_8_CHIPS);
+    this->setOokFixedThreshold(12);
+}
+
+void continuousRFM69::receive(){
+    this->setMode(RFM69_MODE_SEQUENCER_ON | RFM69_MODE_STANDBY);
+
+    // DATA is an output of the radio in Rx.
+    pinMode(this->data_pin, INPUT);
+    this->rx_bits = 0;
+    this->transmitting = false;
+
+    this->setMode(RFM69_MODE_SEQUENCER_ON | RFM69_MODE_RECEIVER);
+}
+
+void continuousRFM69::transmit(){
+    this->setMode(RFM69_MODE_SEQUENCER_ON | RFM69_MODE_STANDBY);
+
+    // DATA is an input of the radio in Tx, start at the idle level.
+    digitalWrite(this->data_pin, LOW);
+    pinMode(this->data_pin, OUTPUT);
+    this->tx_bits = 0;
+    this->tx_idle = false;
+    this->underruns = 0;
+    this->transmitting = true;
+
+    this->setMode(RFM69_MODE_SEQUENCER_ON | RFM69_MODE_TRANSMITTER);
+}
+
+void continuousRFM69::clock(){
+    if (this->transmitting){
+        if (this->tx_bits == 0){
+            if (this->tx_read == this->tx_write){
+                // nothing to send, stay at the idle level.
+                *(this->data_out) &= ~(this->data_mask);
+                this->underruns++;
+                this->tx_idle = true;
+                return;
+            }
+            this->tx_idle = false;
+            this->tx_shift = this->tx_ring[this->tx_read];
+            this->tx_read = (this->tx_read + 1) & RFM69_CONTINUOUS_RING_MASK;
+            this->tx_bits = 8;
+        }
+        if (this->tx_shift & 0x80){
+            *(this->data_out) |= this->data_mask;
+        } else {
+            *(this->data_out) &= ~(this->data_mask);
+        }
+        this->tx_shift <<= 1;
+        this->tx_bits--;
+    } else {
+        this->rx_shift = (this->rx_shift << 1) | ((*(this->data_in) & this->data_mask) ? 1 : 0);
+        if (++(this->rx_bits) == 8){
+            this->rx_bits = 0;
+            uint8_t next = (this->rx_write + 1) & RFM69_CONTINUOUS_RING_MASK;
+            if (next == this->rx_read){
+                this->overruns++;
+                return;
+            }
+            this->rx_ring[this->rx_write] = this->rx_shift;
+            this->rx_write = next;
+        }
+    }
+}
+
+uint8_t continuousRFM69::available(){
+    return (this->rx_write - this->rx_read) & RFM69_CONTINUOUS_RING_MASK;
+}
+
+uint8_t continuousRFM69::read(void* buffer, uint8_t len){
+    uint8_t* r = reinterpret_cast<uint8_t*>(buffer);
+    uint8_t count = 0;
+    uint8_t index = this->rx_read;
+    while ((count < len) && (index != this->rx_write)){
+        r[count++] = this->rx_ring[index];
+        index = (index + 1) & RFM69_CONTINUOUS_RING_MASK;
+    }
+    // only now the bytes can be overwritten by clock().
+    this->rx_read = index;
+    return count;
+}
+
+uint8_t continuousRFM69::write(const void* buffer, uint8_t len){
+    const uint8_t* r = reinterpret_cast<const uint8_t*>(buffer);
+    uint8_t count = 0;
+    uint8_t index = this->tx_write;
+    while (count < len){
+        uint8_t next = (index + 1) & RFM69_CONTINUOUS_RING_MASK;
+        if (next == this->tx_read){
+            break; // full.
+        }
+        this->tx_ring[index] = r[count++];
+        index = next;
+    }
+    // only now the bytes can be sent by clock().
+    this->tx_write = index;
+    return count;
+}
+
+bool continuousRFM69::sent(){
+    // the last bit is sampled on the edge at which the idle level is set.
+    return (this->tx_read == this->tx_write) && this->tx_idle;
+}
@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <Arduino.h>
+#include <bareRFM69.h>
+
+#ifndef CONTINUOUS_RFM69_H
+#define CONTINUOUS_RFM69_H
+
+/*
+    The continuousRFM69 object uses the radio in continuous mode, without the
+    packet engine. Every bit is received or transmitted on the DIO2 (DATA)
+    pin, such that protocols other than that of the packet engine can be
+    used, for example those of OOK sensors.
+
+    With the bit synchroniser (the default), the radio provides the bit clock
+    on DIO1 (DCLK) and clock() should be attached to its rising edge:
+        attachInterrupt(DCLK_PIN, interrupt_clock, RISING);
+    In Rx, the data is valid on the rising edge. In Tx, the radio samples the
+    data on the rising edge, clock() then sets the bit for the next edge.
+
+    Without the bit synchroniser there is no clock, call clock() from a timer
+    running at the bit rate instead; the bits are then sampled asynchronously.
+
+    The bits are kept in two rings of bytes, the oldest bit in the most
+    significant bit of each byte. clock() only shifts a bit and stores a byte
+    every eighth call, the pin is accessed through its port register, which is
+    much faster than digitalRead() and digitalWrite().
+*/
+
+// size of the Rx and Tx ring in bytes, a power of two up to 256.
+#ifndef RFM69_CONTINUOUS_RING_SIZE
+#define RFM69_CONTINUOUS_RING_SIZE 64
+#endif
+
+#define RFM69_CONTINUOUS_RING_MASK (RFM69_CONTINUOUS_RING_SIZE - 1)
+
+class continuousRFM69 : public bareRFM69{
+    protected:
+        typedef decltype(portInputRegister(digitalPinToPort(0))) port_t;
+        typedef decltype(digitalPinToBitMask(0)) mask_t;
+
+        uint8_t data_pin;
+        port_t data_in;
+        port_t data_out;
+        mask_t data_mask;
+
+        volatile bool transmitting;
+
+        uint8_t rx_ring[RFM69_CONTINUOUS_RING_SIZE];
+        volatile uint8_t rx_read;
+        volatile uint8_t rx_write;
+        uint8_t rx_shift; // bits being collected.
+        uint8_t rx_bits;
+
+        uint8_t tx_ring[RFM69_CONTINUOUS_RING_SIZE];
+        volatile uint8_t tx_read;
+        volatile uint8_t tx_write;
+        uint8_t tx_shift; // bits being sent.
+        uint8_t tx_bits;
+        volatile bool tx_idle; // the idle level was set, all bits are sent.
+
+        volatile uint16_t overruns;
+        volatile uint16_t underruns;
+
+    public:
+        continuousRFM69(uint8_t cs_pin, uint8_t data_pin) : bareRFM69(cs_pin){
+            this->data_pin = data_pin;
+            this->data_in = portInputRegister(digitalPinToPort(data_pin));
+            this->data_out = portOutputRegister(digitalPinToPort(data_pin));
+            this->data_mask = digitalPinToBitMask(data_pin);
+            this->transmitting = false;
+            this->rx_read = 0;
+            this->rx_write = 0;
+            this->rx_shift = 0;
+            this->rx_bits = 0;
+            this->tx_read = 0;
+            this->tx_write = 0;
+            this->tx_shift = 0;
+            this->tx_bits = 0;
+            this->tx_idle = true;
+            this->overruns = 0;
+            this->underruns = 0;
+        };
+
+        void setContinuous(bool use_ook, bool use_synchroniser=true);
+        /*
+            Switches to continuous mode, with FSK or OOK modulation and with
+            or without bit synchroniser. Maps DCLK to DIO1 and DATA to DIO2.
+            The bit rate should be set as well, for example with setBitRate().
+        */
+
+        void ookSensor();
+        /*
+            Continuous OOK without bit synchroniser, as used by 433 MHz remote
+            controls and sensors. Instead of clock(), the edges of the DATA pin
+            are timestamped and decoded, see pulseRFM69.h. The filter is wide
+            for the frequency error of cheap transmitters. Raise the floor
+            with setOokFixedThreshold() if noise pulses appear in the gaps.
+        */
+
+        void receive();
+        /*
+            Starts receiving, the bits appear in the Rx ring.
+        */
+
+        void transmit();
+        /*
+            Starts transmitting the bits in the Tx ring, the first bit on the
+            air is the idle (low) level of the data pin.
+        */
+
+        void clock();
+        /*
+            To be called on the rising edge of DCLK, or from a timer.
+        */
+
+        uint8_t available();
+        /*
+            Number of complete bytes in the Rx ring.
+        */
+
+        uint8_t read(void* buffer, uint8_t len);
+        /*
+            Reads up to len bytes from the Rx ring, returns the number read.
+        */
+
+        uint8_t write(const void* buffer, uint8_t len);
+        /*
+            Adds up to len bytes to the Tx ring, returns the number added.
+        */
+
+        bool sent();
+        /*
+            Returns true if all bits in the Tx ring are sent.
+        */
+
+        uint16_t getOverruns(){return this->overruns;};
+        uint16_t getUnderruns(){return this->underruns;};
+        /*
+            Bytes lost because the Rx ring was full, and idle bits sent
+            because the Tx ring was empty since transmit(), the latter
+            includes the bits after the last byte until receive() is called.
+        */
+};
+
+//CONTINUOUS_RFM69_H
+#endif
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <plainRFM69.h>
+#include <aggregateRFM69.h>
+
+// slave select pin.
+#define SLAVE_SELECT_PIN 10
+
+// connected to the reset pin of the RFM69.
+#define RESET_PIN 23
+
+// tie this pin down on the receiver.
+#define SENDER_DETECT_PIN 15
+
+// Pin DIO 2 on the RFM69 is attached to this digital pin.
+// Pin should have interrupt capability.
+#define DIO2_PIN 0
+
+/*
+    The sender takes a 6 byte reading every 10 ms and packs them, a frame is
+    sent when it is full or after 100 ms. The receiver unpacks the frames and
+    prints every reading.
+*/
+
+plainRFM69 rfm = plainRFM69(SLAVE_SELECT_PIN);
+
+typedef struct {
+    uint32_t counter;
+    int16_t value;
+} __attribute__((packed)) reading_t;
+
+void sender(){
+    aggregateRFM69 aggregate(64, 100);
+
+    uint32_t sample_time = millis();
+    reading_t reading = {0, 0};
+
+    while(true){
+        if ((millis() - sample_time) >= 10){
+            sample_time = millis();
+            reading.counter++;
+            reading.value = analogRead(A0);
+
+            if (!aggregate.add(&reading, sizeof(reading), millis())){
+                // no room, send what we have and start a new frame.
+                while (!rfm.canSend()){
+                }
+                rfm.sendVariable((void*) aggregate.getFrame(), aggregate.getLength());
+                aggregate.clear();
+                aggregate.add(&reading, sizeof(reading), millis());
+            }
+        }
+
+        if (aggregate.due(millis()) && rfm.canSend()){
+            Serial.print("Sending readings: "); Serial.println(aggregate.getCount());
+            rfm.sendVariable((void*) aggregate.getFrame(), aggregate.getLength());
+            aggregate.clear();
+        }
+    }
+}
+
+void receiver(){
+    uint8_t rx_buffer[64] = {0};
+
+    while(true){
+        while(rfm.available()){
+            uint8_t len = rfm.read(&rx_buffer);
+
+            uint8_t offset = 0;
+            const uint8_t* message;
+            uint8_t message_len;
+            while ((message_len = aggregateRFM69::unpack(rx_buffer, len, &offset, &message))){
+                if (message_len != sizeof(reading_t)){
+                    continue;
+                }
+                reading_t reading;
+                memcpy(&reading, message, sizeof(reading));
+                Serial.print("Reading "); Serial.print(reading.counter);
+                Serial.print(": "); Serial.println(reading.value);
+            }
+        }
+    }
+}
+
+void interrupt_RFM(){
+    rfm.poll(); // in the interrupt, call the poll function.
+}
+
+void setup(){
+    Serial.begin(115200);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN); // sent the RFM69 a hard-reset.
+
+    rfm.setRecommended(); // set recommended paramters in RFM69.
+    rfm.setPacketType(true, false); // variable length, no addressing.
+
+    rfm.setBufferSize(5);   // set the internal buffer size.
+    rfm.setPacketLength(64); // the largest frame.
+    rfm.setFrequency((uint32_t) 434*1000*1000); // set the frequency.
+
+    rfm.baud9600();
+
+    pinMode(SENDER_DETECT_PIN, INPUT_PULLUP);
+    delay(5);
+
+    // tell the RFM to represent whether we are in automode on DIO 2.
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+
+    pinMode(DIO2_PIN, INPUT);
+    SPI.usingInterrupt(DIO2_PIN);
+    attachInterrupt(DIO2_PIN, interrupt_RFM, CHANGE);
+
+    rfm.receive();
+}
+
+void loop(){
+    if (digitalRead(SENDER_DETECT_PIN) == LOW){
+        Serial.println("Going Receiver!");
+        receiver();
+        // this function never returns and contains an infinite loop.
+    } else {
+        Serial.println("Going sender!");
+        sender();
+        // idem.
+    }
+}
@@ -0,0 +1,250 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <plainRFM69.h>
+
+// slave select pin.
+#define SLAVE_SELECT_PIN 10
+
+// connected to the reset pin of the RFM69.
+#define RESET_PIN 23
+
+// tie this pin down on the receiver.
+#define SENDER_DETECT_PIN 15
+
+// Pin DIO 2 on the RFM69 is attached to this digital pin.
+// Pin should have interrupt capability.
+#define DIO2_PIN 0
+
+// the packet format and length to benchmark.
+#define BENCH_VARIABLE_LENGTH true
+#define BENCH_ADDRESSING true
+#define BENCH_AES false
+#define BENCH_LENGTH 60
+
+#define BENCH_PACKETS 2000
+#define BENCH_PINGS 200
+
+/*
+    The on target counterpart of extras/host/plain_bench, with the same
+    measurements and JSON fields where they can be measured on the target.
+
+    The sender first sends BENCH_PACKETS packets as fast as possible, then
+    pings the receiver BENCH_PINGS times. The receiver counts the packets and
+    echoes the pings. Both print one line of JSON with their results, the
+    sender with the ping percentiles, the receiver with the throughput. The
+    time spent in the interrupt is measured with micros() around poll().
+*/
+
+plainRFM69 rfm = plainRFM69(SLAVE_SELECT_PIN);
+
+#define PHASE_THROUGHPUT 'T'
+#define PHASE_PING 'P'
+
+volatile uint32_t isr_calls = 0;
+volatile uint32_t isr_time = 0;
+
+uint8_t tx_buffer[BENCH_LENGTH] = {0};
+uint8_t rx_buffer[BENCH_LENGTH + 1] = {0};
+
+void sendBench(uint8_t address){
+#if BENCH_VARIABLE_LENGTH && BENCH_ADDRESSING
+    rfm.sendAddressedVariable(address, tx_buffer, BENCH_LENGTH);
+#elif BENCH_VARIABLE_LENGTH
+    rfm.sendVariable(tx_buffer, BENCH_LENGTH);
+#elif BENCH_ADDRESSING
+    rfm.sendAddressed(address, tx_buffer);
+#else
+    rfm.send(tx_buffer);
+#endif
+}
+
+// payload of the packet in rx_buffer, after the address byte.
+uint8_t* payload(){
+    return &(rx_buffer[(BENCH_ADDRESSING) ? 1 : 0]);
+}
+
+void printCommon(){
+    Serial.print("\"format\": {\"variable_length\": "); Serial.print(BENCH_VARIABLE_LENGTH ? "true" : "false");
+    Serial.print(", \"addressing\": "); Serial.print(BENCH_ADDRESSING ? "true" : "false");
+    Serial.print(", \"aes\": "); Serial.print(BENCH_AES ? "true" : "false");
+    Serial.print("}, \"length\": "); Serial.print(BENCH_LENGTH);
+    Serial.print(", \"object_bytes\": "); Serial.print(sizeof(rfm));
+}
+
+void sender(){
+    rfm.setNodeAddress(0x02);
+
+    // throughput, back to back.
+    uint32_t start = micros();
+    tx_buffer[0] = PHASE_THROUGHPUT;
+    for (uint32_t i=0; i < BENCH_PACKETS; i++){
+        while (!rfm.canSend()){
+        }
+        *((uint32_t*) &(tx_buffer[1])) = i;
+        sendBench(0x01);
+    }
+    while (!rfm.canSend()){
+    }
+    uint32_t elapsed = micros() - start;
+    uint32_t tx_isr_calls = isr_calls;
+    uint32_t tx_isr_time = isr_time;
+
+    // ping, give the receiver some time to print.
+    delay(100);
+    static uint16_t rtt[BENCH_PINGS];
+    uint16_t pongs = 0;
+    uint16_t timeouts = 0;
+    tx_buffer[0] = PHASE_PING;
+    for (uint16_t i=0; i < BENCH_PINGS; i++){
+        while (!rfm.canSend()){
+        }
+        *((uint32_t*) &(tx_buffer[1])) = i;
+        uint32_t sent_at = micros();
+        sendBench(0x01);
+        while (true){
+            if (rfm.available()){
+                rfm.read(rx_buffer);
+                if (*((uint32_t*) &(payload()[1])) == i){
+                    rtt[pongs++] = micros() - sent_at;
+                    break;
+                }
+            }
+            if ((micros() - sent_at) > 500000){
+                timeouts++;
+                break;
+            }
+        }
+    }
+
+    // sort, for the percentiles.
+    for (uint16_t i=1; i < pongs; i++){
+        uint16_t value = rtt[i];
+        uint16_t j = i;
+        while ((j > 0) && (rtt[j - 1] > value)){
+            rtt[j] = rtt[j - 1];
+            j--;
+        }
+        rtt[j] = value;
+    }
+    uint32_t sum = 0;
+    for (uint16_t i=0; i < pongs; i++){
+        sum += rtt[i];
+    }
+
+    Serial.print("{\"role\": \"sender\", ");
+    printCommon();
+    Serial.print(", \"throughput\": {\"packets\": "); Serial.print(BENCH_PACKETS);
+    Serial.print(", \"packets_per_second\": "); Serial.print(BENCH_PACKETS * 1e6 / elapsed);
+    Serial.print("}, \"ping\": {\"count\": "); Serial.print(pongs);
+    Serial.print(", \"timeouts\": "); Serial.print(timeouts);
+    if (pongs){
+        Serial.print(", \"mean_us\": "); Serial.print(sum / pongs);
+        Serial.print(", \"p50_us\": "); Serial.print(rtt[(pongs - 1) * 50 / 100]);
+        Serial.print(", \"p90_us\": "); Serial.print(rtt[(pongs - 1) * 90 / 100]);
+        Serial.print(", \"p99_us\": "); Serial.print(rtt[(pongs - 1) * 99 / 100]);
+        Serial.print(", \"max_us\": "); Serial.print(rtt[pongs - 1]);
+    }
+    Serial.print("}, \"isr\": {\"tx_calls_per_packet\": "); Serial.print((float) tx_isr_calls / BENCH_PACKETS);
+    Serial.print(", \"tx_us_per_packet\": "); Serial.print((float) tx_isr_time / BENCH_PACKETS);
+    Serial.println("}}");
+
+    while (true){
+    }
+}
+
+void receiver(){
+    rfm.setNodeAddress(0x01);
+
+    uint32_t received = 0;
+    uint32_t lost = 0;
+    uint32_t expected = 0;
+    uint32_t first = 0;
+    uint32_t last = 0;
+    bool printed = false;
+
+    while(true){
+        while(rfm.available()){
+            rfm.read(rx_buffer);
+            uint32_t counter = *((uint32_t*) &(payload()[1]));
+
+            if (payload()[0] == PHASE_THROUGHPUT){
+                if (received == 0){
+                    first = micros();
+                    isr_calls = 0;
+                    isr_time = 0;
+                }
+                last = micros();
+                lost += counter - expected;
+                expected = counter + 1;
+                received++;
+                continue;
+            }
+
+            // a ping, echo it.
+            memcpy(tx_buffer, payload(), BENCH_LENGTH);
+            sendBench(0x02);
+
+            if (!printed){
+                printed = true;
+                Serial.print("{\"role\": \"receiver\", ");
+                printCommon();
+                Serial.print(", \"throughput\": {\"received\": "); Serial.print(received);
+                Serial.print(", \"lost\": "); Serial.print(lost);
+                Serial.print(", \"packets_per_second\": "); Serial.print((received - 1) * 1e6 / (last - first));
+                Serial.print("}, \"isr\": {\"rx_calls_per_packet\": "); Serial.print((float) isr_calls / received);
+                Serial.print(", \"rx_us_per_packet\": "); Serial.print((float) isr_time / received);
+                Serial.println("}}");
+            }
+        }
+    }
+}
+
+void interrupt_RFM(){
+    uint32_t start = micros();
+    rfm.poll(); // in the interrupt, call the poll function.
+    isr_time += micros() - start;
+    isr_calls++;
+}
+
+void setup(){
+    Serial.begin(9600);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN); // sent the RFM69 a hard-reset.
+
+    uint8_t key[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    rfm.setRecommended();
+    rfm.setAES(BENCH_AES);
+    rfm.setAesKey(key, sizeof(key));
+    rfm.setPacketType(BENCH_VARIABLE_LENGTH, BENCH_ADDRESSING);
+
+    rfm.setBufferSize(4);
+    rfm.setPacketLength(BENCH_LENGTH);
+    rfm.setFrequency((uint32_t) 434*1000*1000);
+
+    rfm.baud300000();
+
+    // tell the RFM to represent whether we are in automode on DIO 2.
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+    pinMode(DIO2_PIN, INPUT);
+    SPI.usingInterrupt(DIO2_PIN);
+    attachInterrupt(DIO2_PIN, interrupt_RFM, CHANGE);
+
+    rfm.receive();
+
+    pinMode(SENDER_DETECT_PIN, INPUT_PULLUP);
+    delay(5);
+}
+
+void loop(){
+    if (digitalRead(SENDER_DETECT_PIN) == LOW){
+        receiver();
+    } else {
+        delay(2000); // let the receiver start first.
+        sender();
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <plainRFM69.h>
+#include <surveyRFM69.h>
+
+// slave select pin.
+#define SLAVE_SELECT_PIN 10
+
+// connected to the reset pin of the RFM69.
+#define RESET_PIN 23
+
+/*
+    This example surveys 16 channels of 100 kHz every 10 seconds and prints
+    the occupancy and average signal strength of every channel, together with
+    the quietest channel and the speed of the sweep.
+
+    Afterwards the radio is tuned to the quietest channel.
+*/
+
+#define CHANNEL_COUNT 16
+
+plainRFM69 rfm = plainRFM69(SLAVE_SELECT_PIN);
+
+surveyRFM69 survey = surveyRFM69(&rfm);
+
+void setup(){
+    Serial.begin(9600);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN); // sent the RFM69 a hard-reset.
+
+    rfm.setRecommended(); // set recommended paramters in RFM69.
+    rfm.setPacketType(false, false); // set the used packet type.
+
+    rfm.setBufferSize(2);   // set the internal buffer size.
+    rfm.setPacketLength(4); // set the packet length.
+    rfm.setFrequency((uint32_t) 434*1000*1000); // set the frequency.
+
+    rfm.receive();
+
+    // channels from 433.1 MHz up to 434.6 MHz.
+    survey.setChannels((uint32_t) 433100000, 100000, CHANNEL_COUNT);
+}
+
+void loop(){
+    survey.sweep(32); // take 32 samples per channel.
+
+    for (uint8_t channel=0; channel < CHANNEL_COUNT; channel++){
+        Serial.print("Channel "); Serial.print(channel);
+        Serial.print(" occupancy: "); Serial.print(survey.getOccupancy(channel));
+        Serial.print(" RSSI: -"); Serial.print(survey.getAverageRssi(channel) / 2);
+        Serial.println(" dBm");
+    }
+
+    uint8_t quietest = survey.quietestChannel();
+    Serial.print("Quietest channel: "); Serial.println(quietest);
+    Serial.print("Channels per second: "); Serial.println(survey.channelsPerSecond());
+
+    // move to the quietest channel and continue receiving.
+    rfm.setFrf(survey.getChannelFrf(quietest));
+    rfm.receive();
+
+    delay(10000);
+}
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <bareRFM69.h>
+#include <continuousRFM69.h>
+
+// slave select pin.
+#define SLAVE_SELECT_PIN 10
+
+// connected to the reset pin of the RFM69.
+#define RESET_PIN 23
+
+// tie this pin down on the receiver.
+#define SENDER_DETECT_PIN 15
+
+// Pin DIO 1 (DCLK) on the RFM69 is attached to this digital pin.
+// Pin should have interrupt capability.
+#define DCLK_PIN 1
+
+// Pin DIO 2 (DATA) on the RFM69 is attached to this digital pin.
+#define DATA_PIN 0
+
+/*
+    Uses the radio in continuous mode, the sender transmits a fixed pattern
+    and the receiver prints the raw bits it receives, in hex.
+
+    The receiver has no sync word, so the bytes it prints are not aligned with
+    those of the sender, and noise is printed when nothing is sent.
+*/
+
+continuousRFM69 rfm = continuousRFM69(SLAVE_SELECT_PIN, DATA_PIN);
+
+void interrupt_clock(){
+    rfm.clock(); // one bit for every rising edge of DCLK.
+}
+
+void sender(){
+    const uint8_t pattern[] = {0xAA, 0xAA, 0xAA, 0xAA, 0x2D, 0xD4, 0x01, 0x02, 0x03, 0x04};
+
+    while(true){
+        rfm.write(pattern, sizeof(pattern));
+        rfm.transmit();
+        while (!rfm.sent()){
+        }
+        rfm.receive(); // leave Tx mode.
+
+        Serial.print("Sent pattern, idle bits: "); Serial.println(rfm.getUnderruns());
+        delay(500);
+    }
+}
+
+void receiver(){
+    rfm.receive();
+
+    uint8_t buffer[16];
+    while(true){
+        if (rfm.available() >= sizeof(buffer)){
+            rfm.read(buffer, sizeof(buffer));
+            for (uint8_t i=0; i < sizeof(buffer); i++){
+                if (buffer[i] < 0x10){
+                    Serial.print("0");
+                }
+                Serial.print(buffer[i], HEX);
+            }
+            Serial.print(" overruns: "); Serial.println(rfm.getOverruns());
+        }
+    }
+}
+
+void setup(){
+    Serial.begin(115200);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN); // sent the RFM69 a hard-reset.
+
+    rfm.setContinuous(false); // FSK, with bit synchroniser.
+    rfm.setFrf(bareRFM69::frequencyToFrf((uint32_t) 434*1000*1000));
+
+    // 9600 bps, as plainRFM69::baud9600().
+    rfm.setBitRate(0x1a0b/2);
+    rfm.setFdev(0x52*2);
+    rfm.setRxBw(0b010, 0b00, 0b101);
+
+    pinMode(SENDER_DETECT_PIN, INPUT_PULLUP);
+    // clock() does not use SPI, so SPI.usingInterrupt() is not necessary.
+    pinMode(DCLK_PIN, INPUT);
+    attachInterrupt(DCLK_PIN, interrupt_clock, RISING);
+}
+
+void loop(){
+    if (digitalRead(SENDER_DETECT_PIN) == LOW){
+        Serial.println("Going Receiver!");
+        receiver();
+        // this function never returns and contains an infinite loop.
+    } else {
+        Serial.println("Going sender!");
+        sender();
+        // idem.
+    }
+}
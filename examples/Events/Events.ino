@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <plainRFM69.h>
+
+// slave select pin.
+#define SLAVE_SELECT_PIN 10
+
+// connected to the reset pin of the RFM69.
+#define RESET_PIN 23
+
+// tie this pin down on the receiver.
+#define SENDER_DETECT_PIN 15
+
+// Pin DIO 2 on the RFM69 is attached to this digital pin.
+// Pin should have interrupt capability.
+#define DIO2_PIN 0
+
+/*
+    The MinimalInterrupt example with event handlers instead of checking
+    available() and canSend() in a loop.
+
+    The sender transmits a 4 byte integer every 500 ms, the receiver prints
+    it. The handlers are called by dispatch() from loop(); the processor
+    could sleep while there is nothing to dispatch.
+
+    The handlers set with onCrcError() and onOverflow() show the packets that
+    the receiver lost.
+*/
+
+plainRFM69 rfm = plainRFM69(SLAVE_SELECT_PIN);
+
+bool is_sender = false;
+bool sending = false;
+uint32_t counter = 0;
+uint32_t last_sent = 0;
+
+void onReceived(void* context, uint8_t* packet, uint8_t length){
+    // the packet is in the buffer of rfm, copy what is needed.
+    uint32_t received_count;
+    memcpy(&received_count, packet, sizeof(received_count));
+
+    Serial.print("Packet ("); Serial.print(length); Serial.print("): "); Serial.println(received_count);
+
+    if (counter+1 != received_count){
+        Serial.println("Packetloss detected!");
+    }
+    counter = received_count;
+}
+
+void onSent(void* context){
+    sending = false;
+}
+
+void onCrcError(void* context){
+    Serial.println("CRC error!");
+}
+
+void onOverflow(void* context){
+    Serial.println("Buffer full, packet dropped!");
+}
+
+void interrupt_RFM(){
+    rfm.poll(); // in the interrupt, call the poll function.
+}
+
+void setup(){
+    Serial.begin(9600);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN); // sent the RFM69 a hard-reset.
+
+    // the CRC error handler has to be set before setPacketType().
+    rfm.onReceived(onReceived);
+    rfm.onSent(onSent);
+    rfm.onCrcError(onCrcError);
+    rfm.onOverflow(onOverflow);
+
+    rfm.setRecommended(); // set recommended paramters in RFM69.
+    rfm.setPacketType(false, false); // set the used packet type.
+
+    rfm.setBufferSize(2);   // set the internal buffer size.
+    rfm.setPacketLength(4); // set the packet length.
+    rfm.setFrequency((uint32_t) 434*1000*1000); // set the frequency.
+
+    // tell the RFM to represent whether we are in automode on DIO 2.
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+    pinMode(DIO2_PIN, INPUT);
+    SPI.usingInterrupt(DIO2_PIN);
+    attachInterrupt(DIO2_PIN, interrupt_RFM, CHANGE);
+
+    rfm.receive();
+
+    pinMode(SENDER_DETECT_PIN, INPUT_PULLUP);
+    delay(5);
+    is_sender = (digitalRead(SENDER_DETECT_PIN) != LOW);
+    Serial.println((is_sender) ? "Going sender!" : "Going Receiver!");
+}
+
+void loop(){
+    // call the handlers of the events raised in the interrupt.
+    rfm.dispatch();
+
+    if (is_sender && !sending && ((millis() - last_sent) > 500)){ // every 500 ms.
+        last_sent = millis();
+        Serial.print("Send:"); Serial.println(counter);
+        sending = true;
+        rfm.send(&counter);
+        counter++;
+    }
+}
@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <plainRFM69.h>
+#include <hopRFM69.h>
+
+// slave select pin.
+#define SLAVE_SELECT_PIN 10     
+
+// connected to the reset pin of the RFM69.
+#define RESET_PIN 23
+
+// tie this pin down on the receiver.
+#define SENDER_DETECT_PIN 15
+
+// Pin DIO 2 on the RFM69 is attached to this digital pin.
+// Pin should have interrupt capability.
+#define DIO2_PIN 0
+
+/*
+    This is the MinimalInterrupt example with frequency hopping.
+
+    It transmits a 4 byte integer every 500 ms, after every packet both the
+    sender and the receiver move to the next channel in the hop pattern.
+
+    Because the receiver only hops when it receives a packet, a lost packet
+    causes the peers to lose track of each other. The receiver returns to the
+    start of the pattern when it has not received anything for two seconds, the
+    sender does so every 16 packets.
+*/
+
+// channel order, shared by all nodes.
+const uint8_t hop_pattern[] = {0, 5, 2, 7, 4, 1, 6, 3};
+
+hopRFM69 rfm = hopRFM69(SLAVE_SELECT_PIN);
+
+
+void sender(){
+
+    uint32_t start_time = millis();
+
+    uint32_t counter = 0; // the counter which we are going to send.
+
+    while(true){
+        if (!rfm.canSend()){
+            continue; // sending is not possible, already sending.
+        }
+
+        if ((millis() - start_time) > 500){ // every 500 ms. 
+            start_time = millis();
+
+            // be a little bit verbose.
+            Serial.print("Send:");Serial.println(counter);
+
+            // send the number of bytes equal to that set with setPacketLength.
+            // read those bytes from memory where counter starts.
+            rfm.send(&counter);
+            
+            counter++; // increase the counter.
+
+            if ((counter % 16) == 0){
+                // resynchronise to the start of the pattern.
+                rfm.setHopIndex(0);
+            }
+        }
+       
+    }
+}
+
+void receiver(){
+    uint32_t counter = 0; // to count the messages.
+    uint32_t last_packet_time = millis();
+
+    while(true){
+        if ((millis() - last_packet_time) > 2000){
+            // lost track of the sender, wait on the start of the pattern.
+            rfm.setHopIndex(0);
+            last_packet_time = millis();
+        }
+
+        while(rfm.available()){ // for all available messages:
+            last_packet_time = millis();
+
+            uint32_t received_count = 0; // temporary for the new counter.
+            uint8_t len = rfm.read(&received_count); // read the packet into the new_counter.
+
+            // print verbose output.
+            Serial.print("Packet ("); Serial.print(len); Serial.print("): "); Serial.println(received_count);
+
+            if (counter+1 != received_count){
+                // if the increment is larger than one, we lost one or more packets.
+                Serial.println("Packetloss detected!");
+            }
+
+            // assign the received counter to our counter.
+            counter = received_count;
+        }
+    }
+}
+
+void interrupt_RFM(){
+    rfm.poll(); // in the interrupt, call the poll function.
+}
+
+void setup(){
+    Serial.begin(9600);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN); // sent the RFM69 a hard-reset.
+
+    rfm.setRecommended(); // set recommended paramters in RFM69.
+    rfm.setPacketType(false, false); // set the used packet type.
+
+    rfm.setBufferSize(2);   // set the internal buffer size.
+    rfm.setPacketLength(4); // set the packet length.
+    // 8 channels of 200 kHz, starting at 433.1 MHz, visited in hop_pattern order.
+    rfm.setHopChannels((uint32_t) 433100000, 200000, sizeof(hop_pattern), hop_pattern);
+    rfm.setHopMode(RFM69_HOP_PER_PACKET);
+
+    // baudrate is default, 4800 bps now.
+
+    rfm.receive();
+    // set it to receiving mode.
+
+    /*
+        setup up interrupts such that we don't have to call poll() in a loop.
+    */
+
+    // tell the RFM to represent whether we are in automode on DIO 2.
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+
+    // set pinmode to input.
+    pinMode(DIO2_PIN, INPUT);
+
+    // Tell the SPI library we're going to use the SPI bus from an interrupt.
+    SPI.usingInterrupt(DIO2_PIN);
+
+    // hook our interrupt function to any edge.
+    attachInterrupt(DIO2_PIN, interrupt_RFM, CHANGE);
+
+    // start receiving.
+    rfm.receive();
+
+
+    pinMode(SENDER_DETECT_PIN, INPUT_PULLUP);
+    delay(5);
+}
+
+void loop(){
+    if (digitalRead(SENDER_DETECT_PIN) == LOW){
+        Serial.println("Going Receiver!");
+        receiver(); 
+        // this function never returns and contains an infinite loop.
+    } else {
+        Serial.println("Going sender!");
+        sender();
+        // idem.
+    }
+}
+
+
@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <plainRFM69.h>
+#include <meshRFM69.h>
+
+// slave select pin.
+#define SLAVE_SELECT_PIN 10
+
+// connected to the reset pin of the RFM69.
+#define RESET_PIN 23
+
+// Pin DIO 2 on the RFM69 is attached to this digital pin.
+// Pin should have interrupt capability.
+#define DIO2_PIN 0
+
+// unique per node, node 1 is the collector.
+#define NODE_ADDRESS 1
+#define COLLECTOR_ADDRESS 1
+
+/*
+    Every node except the collector sends a 4 byte counter to the collector
+    every second, over as many hops as necessary; place the nodes in a line
+    such that each only reaches its neighbours. The collector prints the
+    counters with their origin and the number of hops to it.
+
+    A node that loses its route, for example because a relay was switched
+    off, forgets it after three seconds without acknowledgement from the
+    collector and discovers a new one.
+*/
+
+meshRFM69 rfm = meshRFM69(SLAVE_SELECT_PIN);
+
+void collector(){
+    while(true){
+        rfm.update(); // rebroadcasts route requests.
+
+        uint32_t counter;
+        uint8_t origin;
+        if (rfm.readMesh(&counter, &origin)){
+            Serial.print("Counter from "); Serial.print(origin);
+            Serial.print(" ("); Serial.print(rfm.getHops(origin)); Serial.print(" hops): ");
+            Serial.println(counter);
+
+            // acknowledge, such that the node knows its route works.
+            while (rfm.sendMesh(origin, &counter, sizeof(counter)) == RFM69_MESH_BUSY){
+            }
+        }
+    }
+}
+
+void node(){
+    uint32_t counter = 0;
+    uint32_t send_time = millis();
+    uint32_t ack_time = millis();
+
+    while(true){
+        rfm.update(); // rebroadcasts route requests.
+
+        uint32_t acknowledged;
+        if (rfm.readMesh(&acknowledged)){
+            ack_time = millis();
+        }
+
+        if ((millis() - ack_time) > 3000){
+            rfm.forgetRoute(COLLECTOR_ADDRESS);
+            ack_time = millis();
+        }
+
+        if ((millis() - send_time) > 1000){
+            uint8_t result = rfm.sendMesh(COLLECTOR_ADDRESS, &counter, sizeof(counter));
+            if (result == RFM69_MESH_BUSY){
+                continue; // relaying, try again.
+            }
+            send_time = millis();
+            if (result == RFM69_MESH_SENT){
+                Serial.print("Sent: "); Serial.println(counter);
+                counter++;
+            } else {
+                Serial.println("Discovering route.");
+            }
+            Serial.print("Relayed: "); Serial.print(rfm.getForwarded());
+            Serial.print(" duplicates: "); Serial.println(rfm.getDuplicates());
+        }
+    }
+}
+
+void interrupt_RFM(){
+    rfm.poll(); // in the interrupt, call the poll function.
+}
+
+void setup(){
+    Serial.begin(9600);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN); // sent the RFM69 a hard-reset.
+
+    rfm.setRecommended(); // set recommended paramters in RFM69.
+    rfm.setPacketType(true, true); // variable length with addressing.
+
+    rfm.setBufferSize(4);
+    rfm.setPacketLength(RFM69_MESH_HEADER_LENGTH + sizeof(uint32_t));
+    rfm.setMeshAddress(NODE_ADDRESS);
+
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+    pinMode(DIO2_PIN, INPUT);
+    SPI.usingInterrupt(DIO2_PIN);
+    attachInterrupt(DIO2_PIN, interrupt_RFM, CHANGE);
+
+    rfm.receive();
+}
+
+void loop(){
+    if (NODE_ADDRESS == COLLECTOR_ADDRESS){
+        Serial.println("Collector!");
+        collector();
+        // this function never returns and contains an infinite loop.
+    } else {
+        Serial.println("Node!");
+        node();
+        // idem.
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <plainRFM69.h>
+#include <multiRFM69.h>
+
+// slave select pins of both radios.
+#define SLAVE_SELECT_PIN_A 10
+#define SLAVE_SELECT_PIN_B 9
+
+// connected to the reset pins of the RFM69's.
+#define RESET_PIN_A 23
+#define RESET_PIN_B 22
+
+// Pin DIO 2 on each RFM69 is attached to these digital pins.
+// Pins should have interrupt capability.
+#define DIO2_PIN_A 0
+#define DIO2_PIN_B 1
+
+/*
+    This example receives on two frequencies at the same time, using two
+    radios attached to the same SPI bus.
+
+    The interrupts of the radios do not call poll() directly, they call
+    multiRFM69::interrupt(id) such that the SPI transactions of the radios are
+    never nested. Received packets are read from one queue, tagged with the id
+    of the radio that received them.
+
+    Use the MinimalInterrupt example on two other nodes as senders, one set
+    to each frequency.
+*/
+
+plainRFM69 rfm_a = plainRFM69(SLAVE_SELECT_PIN_A);
+plainRFM69 rfm_b = plainRFM69(SLAVE_SELECT_PIN_B);
+
+multiRFM69 multi;
+
+void interrupt_RFM_A(){
+    multi.interrupt(0);
+}
+
+void interrupt_RFM_B(){
+    multi.interrupt(1);
+}
+
+void setupRadio(plainRFM69& rfm, uint32_t frequency){
+    rfm.setRecommended(); // set recommended paramters in RFM69.
+    rfm.setPacketType(false, false); // set the used packet type.
+
+    rfm.setBufferSize(5);   // set the internal buffer size.
+    rfm.setPacketLength(4); // set the packet length.
+    rfm.setFrequency(frequency); // set the frequency.
+
+    // tell the RFM to represent whether we are in automode on DIO 2.
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+}
+
+void setup(){
+    Serial.begin(9600);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN_A); // sent the RFM69's a hard-reset.
+    bareRFM69::reset(RESET_PIN_B);
+
+    setupRadio(rfm_a, (uint32_t) 434*1000*1000);
+    setupRadio(rfm_b, (uint32_t) 435*1000*1000);
+
+    // the order of adding determines the id of the radio.
+    multi.addRadio(&rfm_a); // id 0
+    multi.addRadio(&rfm_b); // id 1
+
+    pinMode(DIO2_PIN_A, INPUT);
+    pinMode(DIO2_PIN_B, INPUT);
+
+    // Tell the SPI library we're going to use the SPI bus from interrupts.
+    SPI.usingInterrupt(DIO2_PIN_A);
+    SPI.usingInterrupt(DIO2_PIN_B);
+
+    attachInterrupt(DIO2_PIN_A, interrupt_RFM_A, CHANGE);
+    attachInterrupt(DIO2_PIN_B, interrupt_RFM_B, CHANGE);
+
+    // start receiving on both radios.
+    rfm_a.receive();
+    rfm_b.receive();
+}
+
+void loop(){
+    uint32_t counter = 0;
+    uint8_t radio_id;
+
+    while(multi.available()){ // for all available messages on any radio:
+        uint8_t len = multi.read(&counter, &radio_id);
+
+        Serial.print("Radio "); Serial.print(radio_id);
+        Serial.print(" packet ("); Serial.print(len); Serial.print("): ");
+        Serial.println(counter);
+    }
+}
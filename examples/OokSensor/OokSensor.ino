@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <bareRFM69.h>
+#include <continuousRFM69.h>
+#include <pulseRFM69.h>
+
+// slave select pin.
+#define SLAVE_SELECT_PIN 10
+
+// connected to the reset pin of the RFM69.
+#define RESET_PIN 23
+
+// Pin DIO 2 (DATA) on the RFM69 is attached to this digital pin.
+// Pin should have interrupt capability.
+#define DATA_PIN 0
+
+/*
+    Receives 433 MHz remote controls and sensors that use the EV1527, PT2262
+    or HX2262 chips, and prints their codes in hex.
+
+    Each code is printed for every repeat the transmitter sends.
+*/
+
+continuousRFM69 rfm = continuousRFM69(SLAVE_SELECT_PIN, DATA_PIN);
+
+pulseRFM69 pulses;
+
+void interrupt_edge(){
+    pulses.edge(micros(), digitalRead(DATA_PIN));
+}
+
+void setup(){
+    Serial.begin(115200);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN); // sent the RFM69 a hard-reset.
+
+    rfm.ookSensor(); // OOK, DATA pin follows the demodulator.
+    rfm.setFrf(bareRFM69::frequencyToFrf((uint32_t) 433920*1000));
+
+    pulseRFM69Protocol ev1527 = RFM69_PULSE_PROTOCOL_EV1527;
+    pulseRFM69Protocol hx2262 = RFM69_PULSE_PROTOCOL_HX2262;
+    pulses.addProtocol(ev1527);
+    pulses.addProtocol(hx2262);
+
+    rfm.receive();
+
+    attachInterrupt(DATA_PIN, interrupt_edge, CHANGE);
+}
+
+void loop(){
+    pulseRFM69Frame frame;
+    while (pulses.read(&frame)){
+        Serial.print("Protocol: "); Serial.print(frame.protocol);
+        Serial.print(" base: "); Serial.print(frame.base);
+        Serial.print(" us code: ");
+        for (uint8_t i=0; i < (frame.bits + 7) / 8; i++){
+            if (frame.data[i] < 0x10){
+                Serial.print("0");
+            }
+            Serial.print(frame.data[i], HEX);
+        }
+        Serial.println();
+    }
+    static uint16_t overruns = 0;
+    if (pulses.getOverruns() != overruns){
+        overruns = pulses.getOverruns();
+        Serial.print("Overruns: "); Serial.println(overruns);
+    }
+}
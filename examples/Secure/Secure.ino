@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <plainRFM69.h>
+#include <secureRFM69.h>
+
+// slave select pin.
+#define SLAVE_SELECT_PIN 10
+
+// connected to the reset pin of the RFM69.
+#define RESET_PIN 23
+
+// tie this pin down on the receiver.
+#define SENDER_DETECT_PIN 15
+
+// Pin DIO 2 on the RFM69 is attached to this digital pin.
+// Pin should have interrupt capability.
+#define DIO2_PIN 0
+
+/*
+    Sends authenticated packets with a counter as payload, the receiver
+    prints the valid packets and the number of rejected ones.
+
+    The radio's AES is used together with secureRFM69, such that the packets
+    are encrypted in hardware and authenticated and checked for replays in
+    software. Each node needs its own address, the sender uses 1.
+
+    In practice, the counter of the sender should be restored from EEPROM
+    after a reset, see secureRFM69.h.
+*/
+
+plainRFM69 rfm = plainRFM69(SLAVE_SELECT_PIN);
+
+// the same for all nodes, different from the AES key.
+const uint8_t secure_key[16] = {0x3a, 0x91, 0x5c, 0x07, 0xe2, 0x48, 0xb6, 0x1f,
+                                0x70, 0xd4, 0x29, 0x8b, 0xc3, 0x65, 0x0e, 0xfa};
+const uint8_t aes_key[16] = {146, 48, 0, 16, 31, 203, 208, 65, 31, 10, 94, 64, 8, 198, 226, 121};
+
+void sender(){
+    secureRFM69 secure(1);
+    secure.setKey(secure_key);
+
+    uint32_t start_time = millis();
+    uint32_t counter = 0;
+    uint8_t packet[sizeof(counter) + RFM69_SECURE_OVERHEAD];
+
+    while(true){
+        if (!rfm.canSend()){
+            continue; // sending is not possible, already sending.
+        }
+
+        if ((millis() - start_time) > 500){ // every 500 ms.
+            start_time = millis();
+
+            Serial.print("Send Packet: "); Serial.println(counter);
+
+            uint8_t len = secure.seal(&counter, sizeof(counter), packet);
+            rfm.sendVariable(packet, len);
+
+            counter++;
+        }
+    }
+}
+
+void receiver(){
+    secureRFM69 secure(2);
+    secure.setKey(secure_key);
+
+    uint8_t rx_buffer[64] = {0};
+    secureRFM69Message message;
+
+    while(true){ // do forever
+        while(rfm.available()){ // for all available messages:
+            uint8_t len = rfm.read(&rx_buffer);
+
+            if (secure.open(rx_buffer, len, &message)){
+                uint32_t counter;
+                memcpy(&counter, message.payload, sizeof(counter));
+                Serial.print("Packet from "); Serial.print(message.sender);
+                Serial.print(": "); Serial.println(counter);
+            } else {
+                Serial.print("Rejected, tag: "); Serial.print(secure.getRejectedTag());
+                Serial.print(" replay: "); Serial.println(secure.getRejectedReplay());
+            }
+        }
+    }
+}
+
+void interrupt_RFM(){
+    rfm.poll(); // in the interrupt, call the poll function.
+}
+
+void setup(){
+    Serial.begin(9600);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN); // sent the RFM69 a hard-reset.
+
+    rfm.setRecommended(); // set recommended paramters in RFM69.
+    rfm.setAES(true); // should come before setPacketType
+    rfm.setPacketType(true, false); // set the used packet type.
+    rfm.setAesKey((void*) aes_key, 16);
+
+    rfm.setBufferSize(5);   // set the internal buffer size.
+    rfm.setPacketLength(64); // set the packet length.
+    rfm.setFrequency((uint32_t) 434*1000*1000); // set the frequency.
+
+    rfm.baud9600();
+
+    pinMode(SENDER_DETECT_PIN, INPUT_PULLUP);
+    delay(5);
+
+    // tell the RFM to represent whether we are in automode on DIO 2.
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+
+    pinMode(DIO2_PIN, INPUT);
+    SPI.usingInterrupt(DIO2_PIN);
+    attachInterrupt(DIO2_PIN, interrupt_RFM, CHANGE);
+
+    rfm.receive();
+}
+
+void loop(){
+    if (digitalRead(SENDER_DETECT_PIN) == LOW){
+        Serial.println("Going Receiver!");
+        receiver();
+        // this function never returns and contains an infinite loop.
+    } else {
+        Serial.println("Going sender!");
+        sender();
+        // idem.
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <plainRFM69.h>
+#include <gatewayRFM69.h>
+#include <snifferRFM69.h>
+
+// slave select pin.
+#define SLAVE_SELECT_PIN 10     
+
+// connected to the reset pin of the RFM69.
+#define RESET_PIN 23
+
+// Pin DIO 2 on the RFM69 is attached to this digital pin.
+// Pin should have interrupt capability.
+#define DIO2_PIN 0
+
+/*
+    This example captures every frame on the channel, including those with a
+    failed CRC or for any address, and forwards them to the host with their
+    CRC status, RSSI and frequency error, see snifferRFM69.h.
+
+    On the host, use extras/host/gateway_dump to print the frames. The packet
+    type should match that of the network, variable length in this case.
+*/
+
+snifferRFM69 rfm = snifferRFM69(SLAVE_SELECT_PIN);
+
+void interrupt_RFM(){
+    rfm.poll(); // in the interrupt, call the poll function.
+}
+
+void setup(){
+    Serial.begin(115200);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN); // sent the RFM69 a hard-reset.
+
+    rfm.setRecommended();
+    rfm.setSniffer(true);       // instead of setPacketType().
+
+    rfm.setBufferSize(20);      // allow buffering of up to twenty frames.
+    rfm.setPacketLength(65);    // the longest frame that fits in the FIFO.
+
+    rfm.setFrequency((uint32_t) 434*1000*1000); // set frequency to 434 MHz.
+    rfm.baud300000(); // Set the baudRate to 300000 bps
+    rfm.setPreambleSize(15);
+
+    // tell the RFM to represent whether we are in automode on DIO 2.
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+
+    pinMode(DIO2_PIN, INPUT);
+    SPI.usingInterrupt(DIO2_PIN);
+    attachInterrupt(DIO2_PIN, interrupt_RFM, CHANGE);
+
+    rfm.receive();
+}
+
+void loop(){
+    // write all frames in the buffer to the host, in as few writes as possible.
+    rfm.bridge(&Serial);
+}
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include <SPI.h>
+#include <plainRFM69.h>
+#include <traceRFM69.h>
+
+// slave select pin.
+#define SLAVE_SELECT_PIN 10
+
+// connected to the reset pin of the RFM69.
+#define RESET_PIN 23
+
+// tie this pin down on the receiver.
+#define SENDER_DETECT_PIN 15
+
+// Pin DIO 2 on the RFM69 is attached to this digital pin.
+// Pin should have interrupt capability.
+#define DIO2_PIN 0
+
+/*
+    The MinimalInterrupt example, with a trace of what poll() does in the
+    interrupt, see traceRFM69.h.
+
+    The sender transmits a 4 byte integer every 100 ms. Both sides write the
+    trace to the serial port, as binary records instead of text; on the host,
+    extras/host/trace_dump prints the timeline and the histograms of the
+    latency and the time spent in poll():
+        ./trace_dump /dev/ttyACM0 1
+
+    The timestamps are micros(). For a cycle counter, define
+    RFM69_PLAIN_TRACE_CLOCK for the library as described at setTrace(), and
+    pass the ticks per microsecond to trace_dump, 96 for a Teensy 3.2 at
+    96 MHz.
+*/
+
+plainRFM69 rfm = plainRFM69(SLAVE_SELECT_PIN);
+
+traceRFM69 trace;
+
+// buffer for one record of the trace.
+uint8_t record[RFM69_TRACE_DUMP_ENCODED(RFM69_TRACE_DUMP)];
+
+bool is_sender = false;
+uint32_t counter = 0;
+uint32_t last_sent = 0;
+
+void interrupt_RFM(){
+    rfm.traceEdge(); // mark the edge, before anything else.
+    rfm.poll(); // in the interrupt, call the poll function.
+}
+
+void setup(){
+    Serial.begin(115200);
+    SPI.begin();
+
+    bareRFM69::reset(RESET_PIN); // sent the RFM69 a hard-reset.
+
+    rfm.setRecommended(); // set recommended paramters in RFM69.
+    rfm.setPacketType(false, false); // set the used packet type.
+
+    rfm.setBufferSize(2);   // set the internal buffer size.
+    rfm.setPacketLength(4); // set the packet length.
+    rfm.setFrequency((uint32_t) 434*1000*1000); // set the frequency.
+
+    // record from here on, the ring is read in loop().
+    rfm.setTrace(&trace);
+
+    // tell the RFM to represent whether we are in automode on DIO 2.
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+    pinMode(DIO2_PIN, INPUT);
+    SPI.usingInterrupt(DIO2_PIN);
+    attachInterrupt(DIO2_PIN, interrupt_RFM, CHANGE);
+
+    rfm.receive();
+
+    pinMode(SENDER_DETECT_PIN, INPUT_PULLUP);
+    delay(5);
+    is_sender = (digitalRead(SENDER_DETECT_PIN) != LOW);
+}
+
+void loop(){
+    if (is_sender && rfm.canSend() && ((millis() - last_sent) > 100)){ // every 100 ms.
+        last_sent = millis();
+        rfm.send(&counter);
+        counter++;
+    }
+
+    // empty the received packets, the trace shows them.
+    uint32_t received_count;
+    while (rfm.available()){
+        rfm.read(&received_count);
+    }
+
+    // write the entries of the trace, a record at a time.
+    uint16_t len;
+    while ((len = trace.dump(record)) != 0){
+        Serial.write(record, len);
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Checks aggregateRFM69 and computes the message rate with and without
+    aggregation, from the airtime of the frames.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -o aggregate_bench aggregate_bench.cpp ../../aggregateRFM69.cpp
+        ./aggregate_bench
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../aggregateRFM69.h"
+
+// preamble (setPreambleSize(3)), sync word (4), length byte and CRC.
+#define FRAME_OVERHEAD (3 + 4 + 1 + 2)
+
+static bool check(const char* name, bool value){
+    printf("%-40s %s\n", name, (value) ? "ok" : "FAIL");
+    return value;
+}
+
+static double airtime(uint16_t payload, uint32_t bitrate){
+    return (FRAME_OVERHEAD + payload) * 8.0 / bitrate;
+}
+
+int main(){
+    bool ok = true;
+
+    {
+        aggregateRFM69 aggregate(64, 100);
+        uint8_t messages[20][8];
+        uint8_t added = 0;
+        for (uint8_t i=0; i < 20; i++){
+            for (uint8_t j=0; j < 8; j++){
+                messages[i][j] = rand();
+            }
+            if (!aggregate.add(messages[i], 1 + (i % 8), 0)){
+                break;
+            }
+            added++;
+        }
+        bool fits = aggregate.getLength() <= 64;
+
+        uint8_t offset = 0;
+        const uint8_t* message;
+        uint8_t len;
+        uint8_t found = 0;
+        bool same = true;
+        while ((len = aggregateRFM69::unpack(aggregate.getFrame(), aggregate.getLength(), &offset, &message))){
+            same &= (len == 1 + (found % 8)) && (memcmp(message, messages[found], len) == 0);
+            found++;
+        }
+        ok &= check("round trip", fits && same && (found == added) && (added == aggregate.getCount()));
+    }
+
+    {
+        aggregateRFM69 aggregate(64, 100);
+        uint8_t message[4] = {0};
+        bool before = aggregate.due(50);
+        aggregate.add(message, 4, 50);
+        bool early = aggregate.due(149);
+        bool late = aggregate.due(150);
+        aggregate.clear();
+        ok &= check("deadline", !before && !early && late && !aggregate.due(1000));
+
+        while (aggregate.add(message, 4, 0)){
+        }
+        ok &= check("full frame is due", aggregate.due(0) && (aggregate.getLength() == 60));
+    }
+
+    {
+        // a length byte that points past the frame.
+        uint8_t frame[] = {2, 0xAA, 0xBB, 5, 0xCC};
+        uint8_t offset = 0;
+        const uint8_t* message;
+        bool first = aggregateRFM69::unpack(frame, sizeof(frame), &offset, &message) == 2;
+        bool second = aggregateRFM69::unpack(frame, sizeof(frame), &offset, &message) == 0;
+        uint8_t zero[] = {0, 1};
+        offset = 0;
+        bool third = aggregateRFM69::unpack(zero, sizeof(zero), &offset, &message) == 0;
+        ok &= check("malformed frames", first && second && third);
+    }
+
+    printf("\n%-10s %-8s %14s %14s %8s\n", "bitrate", "message", "single msg/s", "packed msg/s", "gain");
+    const uint32_t bitrates[] = {4800, 9600, 153600, 300000};
+    const uint8_t sizes[] = {4, 6, 8};
+    for (uint32_t bitrate : bitrates){
+        for (uint8_t size : sizes){
+            uint8_t per_frame = 64 / (size + 1);
+            double single = 1.0 / airtime(size, bitrate);
+            double packed = per_frame / airtime(per_frame * (size + 1), bitrate);
+            printf("%-10u %-8u %14.1f %14.1f %7.2fx\n", bitrate, size, single, packed, packed / single);
+        }
+    }
+    printf("\nThe time to switch between Rx and Tx, and any listen before talk, is\n"
+           "also spent per frame, so the gain in practice is larger.\n");
+
+    return (ok) ? 0 : 1;
+}
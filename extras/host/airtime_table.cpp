@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Prints the maximum packets per second of a single sender for every
+    profile, packet format and length, from airtimeRFM69.h. The airtime and
+    the time to start the transmitter are included, SPI transfers and
+    interrupt handling are not; plain_bench measures those.
+
+    It checks that plainRFM69::getAirtimeFormat() reads the format that was
+    configured, and that the airtime matches that of the simulated radio.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -I sim -I ../.. -o airtime_table airtime_table.cpp \
+            sim/simRFM69.cpp ../../bareRFM69.cpp ../../plainRFM69.cpp
+        ./airtime_table
+*/
+
+#include <stdio.h>
+#include "sim/simRFM69.h"
+#include "../../plainRFM69.h"
+
+// evaluated by the compiler: 64 bytes at 300 kbps, variable length with addressing.
+constexpr airtimeRFM69Format maximum_speed = airtimeRFM69Profile(RFM69_AIRTIME_BITRATE_300000, true, true, false);
+static_assert(airtimeRFM69Bits(maximum_speed, 64) == (3 + 4 + 1 + 1 + 64 + 2) * 8, "bits");
+static_assert(airtimeRFM69Microseconds(maximum_speed, 64) == 2007, "airtime");
+static_assert(airtimeRFM69Bytes(airtimeRFM69Profile(RFM69_AIRTIME_BITRATE_4800, false, false, true), 17) == 32 + 2, "AES padding");
+static_assert(airtimeRFM69Interval(airtimeRFM69Profile(RFM69_AIRTIME_BITRATE_4800, false, false, false), 8, 10) == 100 * airtimeRFM69Microseconds(airtimeRFM69Profile(RFM69_AIRTIME_BITRATE_4800, false, false, false), 8), "duty cycle");
+
+#define CS_PIN 10
+#define DIO2_PIN 20
+
+static bool check(const char* name, bool value){
+    fprintf(stderr, "%-50s %s\n", name, (value) ? "ok" : "FAIL");
+    return value;
+}
+
+struct tableProfile {
+    const char* name;
+    uint16_t bitrate;
+    void (plainRFM69::*apply)();
+};
+
+static const tableProfile profiles[] = {
+    {"baud4800", RFM69_AIRTIME_BITRATE_4800, &plainRFM69::baud4800},
+    {"baud9600", RFM69_AIRTIME_BITRATE_9600, &plainRFM69::baud9600},
+    {"baud153600", RFM69_AIRTIME_BITRATE_153600, &plainRFM69::baud153600},
+    {"baud300000", RFM69_AIRTIME_BITRATE_300000, &plainRFM69::baud300000},
+};
+
+struct tableFormat {
+    const char* name;
+    bool variable_length;
+    bool use_addressing;
+    bool use_AES;
+};
+
+static const tableFormat formats[] = {
+    {"fixed", false, false, false},
+    {"variable", true, false, false},
+    {"addressed", false, true, false},
+    {"addr+var", true, true, false},
+    {"aes", false, false, true},
+};
+
+static bool sameFormat(const airtimeRFM69Format& a, const airtimeRFM69Format& b){
+    return (a.bitrate == b.bitrate) && (a.preamble == b.preamble) && (a.sync == b.sync)
+        && (a.variable_length == b.variable_length) && (a.addressing == b.addressing)
+        && (a.aes == b.aes) && (a.crc == b.crc) && (a.manchester == b.manchester);
+}
+
+int main(int, char*[]){
+    bool ok = true;
+
+    // the registers against the model and the simulated radio.
+    bool reads = true;
+    bool matches = true;
+    for (const tableProfile& profile : profiles){
+        for (const tableFormat& format : formats){
+            simRFM69 radio(CS_PIN, DIO2_PIN);
+            plainRFM69 rfm(CS_PIN);
+            rfm.setRecommended();
+            rfm.setAES(format.use_AES);
+            rfm.setPacketType(format.variable_length, format.use_addressing);
+            rfm.setBufferSize(1);
+            rfm.setPacketLength(64);
+            (rfm.*(profile.apply))();
+
+            airtimeRFM69Format expected = airtimeRFM69Profile(profile.bitrate, format.variable_length, format.use_addressing, format.use_AES);
+            airtimeRFM69Format read = rfm.getAirtimeFormat();
+            reads &= sameFormat(read, expected);
+            for (uint8_t len=1; len <= 64; len++){
+                uint64_t simulated = radio.airtime(len + format.variable_length + format.use_addressing);
+                matches &= airtimeRFM69Microseconds(read, len) == (simulated + 999) / 1000;
+            }
+        }
+    }
+    ok &= check("getAirtimeFormat() reads the configured format", reads);
+    ok &= check("airtime matches the simulated radio", matches);
+
+    for (const tableProfile& profile : profiles){
+        airtimeRFM69Format any = airtimeRFM69Profile(profile.bitrate, false, false, false);
+        printf("%s, %u bps, maximum packets per second\n", profile.name, airtimeRFM69Bitrate(any));
+        printf("%6s", "length");
+        for (const tableFormat& format : formats){
+            printf(" %10s", format.name);
+        }
+        printf("\n");
+        for (uint8_t len=1; len <= 64; len++){
+            printf("%6u", len);
+            for (const tableFormat& format : formats){
+                airtimeRFM69Format f = airtimeRFM69Profile(profile.bitrate, format.variable_length, format.use_addressing, format.use_AES);
+                printf(" %10u", airtimeRFM69PacketsPerSecond(f, len));
+            }
+            printf("\n");
+        }
+        printf("\n");
+    }
+
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Runs request and response protocols written with asyncRFM69 on two
+    simulated radios, see sim/simRFM69.h, and checks:
+
+        ping        A coroutine pings the other radio with sendAndWaitAck(),
+                    like the PingPong example; prints the round trip.
+        retries     The responder ignores every third request, the pinger
+                    gets its response through a retry.
+        slow        The responder takes 2 ms to respond, as a sensor that
+                    measures first.
+        pipelined   As slow, with two coroutines on one radio that each have a
+                    request in flight; their receives match the response by
+                    its sequence number. The responder now measures while the
+                    next request is on the air, compare the responses per
+                    second with slow.
+        timeout     A receive without a sender returns zero after its timeout.
+        heap        The coroutine frames come from the pool of asyncRFM69 and
+                    the operations do not allocate; operator new is counted.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++20 -I sim -I ../.. -o async_pingpong async_pingpong.cpp \
+            sim/simRFM69.cpp ../../bareRFM69.cpp ../../plainRFM69.cpp ../../asyncRFM69.cpp
+        ./async_pingpong
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include "sim/simRFM69.h"
+#include "../../asyncRFM69.h"
+
+#define PINGER_CS 10
+#define PINGER_DIO2 20
+#define RESPONDER_CS 11
+#define RESPONDER_DIO2 21
+
+#define PINGER_ADDRESS 0x02
+#define RESPONDER_ADDRESS 0x01
+
+#define PINGS 50
+#define LENGTH 8
+
+static uint32_t allocations = 0;
+
+void* operator new(size_t size){
+    allocations++;
+    void* p = malloc(size);
+    if (p == 0){
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept{
+    free(p);
+}
+
+static bool check(const char* name, bool value){
+    fprintf(stderr, "%-50s %s\n", name, (value) ? "ok" : "FAIL");
+    return value;
+}
+
+static plainRFM69* pinger_rfm = 0;
+static plainRFM69* responder_rfm = 0;
+
+static void interruptPinger(){
+    pinger_rfm->poll();
+}
+
+static void interruptResponder(){
+    responder_rfm->poll();
+}
+
+static void setup(plainRFM69& rfm, uint8_t address, uint8_t dio2_pin, void (*isr)()){
+    rfm.setRecommended();
+    rfm.setPacketType(true, true);
+    rfm.setBufferSize(4);
+    rfm.setPacketLength(LENGTH);
+    rfm.baud300000();
+    rfm.setNodeAddress(address);
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+    attachInterrupt(dio2_pin, isr, CHANGE);
+    rfm.receive();
+}
+
+struct pingState {
+    uint32_t pongs;
+    uint32_t timeouts;
+    uint32_t wrong;
+    uint64_t rtt_ns;
+    bool done;
+};
+
+// the response carries the sequence number of the request in its first byte,
+// after the address byte.
+static bool matchSequence(void* context, const uint8_t* packet, uint8_t length){
+    return (length > 1) && (packet[1] == *((uint8_t*) context));
+}
+
+// echoes requests after delay_ms, but ignores every ignore-th one if ignore is
+// not zero.
+static asyncRFM69Task responder(asyncRFM69& async, uint8_t ignore, uint8_t delay_ms, bool* stop){
+    uint8_t request[LENGTH + 1];
+    uint32_t count = 0;
+    while (!*stop){
+        uint8_t len = co_await async.receive(request, 100);
+        if (len < 2){
+            continue;
+        }
+        count++;
+        if (ignore && ((count % ignore) == 0)){
+            continue;
+        }
+        if (delay_ms){
+            co_await async.delay(delay_ms);
+        }
+        co_await async.send(PINGER_ADDRESS, &(request[1]), len - 1);
+    }
+}
+
+static asyncRFM69Task pinger(asyncRFM69& async, uint8_t first, uint32_t pings, uint8_t retries, pingState* state){
+    uint8_t request[LENGTH];
+    uint8_t response[LENGTH + 1];
+    for (uint32_t i=0; i < pings; i++){
+        uint8_t sequence = first + i;
+        memset(request, sequence, sizeof(request));
+        uint64_t start = simRFM69Now();
+        uint8_t len = co_await async.sendAndWaitAck(RESPONDER_ADDRESS, request, sizeof(request), response, 20, retries, matchSequence, &sequence);
+        if (len == 0){
+            state->timeouts++;
+            continue;
+        }
+        state->rtt_ns += simRFM69Now() - start;
+        state->pongs++;
+        state->wrong += ((len == sizeof(request) + 1) && (memcmp(&(response[1]), request, sizeof(request)) == 0)) ? 0 : 1;
+    }
+    state->done = true;
+}
+
+static asyncRFM69Task timeout(asyncRFM69& async, uint32_t* elapsed_ms, uint8_t* result){
+    uint8_t buffer[LENGTH + 1];
+    uint32_t start = millis();
+    *result = co_await async.receive(buffer, 250);
+    *elapsed_ms = millis() - start;
+}
+
+struct asyncCase {
+    const char* name;
+    uint8_t tasks;      // pingers on the same radio.
+    uint8_t ignore;
+    uint8_t retries;
+    uint8_t delay_ms;   // of the responder.
+};
+
+static const asyncCase cases[] = {
+    {"ping", 1, 0, 0, 0},
+    {"retries", 1, 3, 2, 0},
+    {"slow", 1, 0, 0, 2},
+    {"pipelined", 2, 0, 0, 2},
+};
+
+static bool runCase(const asyncCase& c){
+    simRFM69 pinger_radio(PINGER_CS, PINGER_DIO2);
+    simRFM69 responder_radio(RESPONDER_CS, RESPONDER_DIO2);
+    plainRFM69 pinger_plain(PINGER_CS);
+    plainRFM69 responder_plain(RESPONDER_CS);
+    pinger_rfm = &pinger_plain;
+    responder_rfm = &responder_plain;
+    setup(pinger_plain, PINGER_ADDRESS, PINGER_DIO2, interruptPinger);
+    setup(responder_plain, RESPONDER_ADDRESS, RESPONDER_DIO2, interruptResponder);
+    delay(1);
+
+    asyncRFM69 pinger_async(&pinger_plain);
+    asyncRFM69 responder_async(&responder_plain);
+
+    uint32_t allocations_before = allocations;
+    bool stop = false;
+    pingState states[2];
+    memset(states, 0, sizeof(states));
+    bool started = (bool) responder(responder_async, c.ignore, c.delay_ms, &stop);
+    for (uint8_t t=0; t < c.tasks; t++){
+        started &= (bool) pinger(pinger_async, t * 128, PINGS, c.retries, &(states[t]));
+    }
+
+    uint64_t start = simRFM69Now();
+    uint64_t deadline = start + 10ULL*1000*1000*1000;
+    while (simRFM69Now() < deadline){
+        bool done = true;
+        for (uint8_t t=0; t < c.tasks; t++){
+            done &= states[t].done;
+        }
+        if (done){
+            break;
+        }
+        bool resumed = pinger_async.run();
+        resumed |= responder_async.run();
+        if (!resumed){
+            simRFM69Idle(100);
+        }
+    }
+
+    uint64_t elapsed = simRFM69Now() - start;
+
+    // let the responder see the stop flag.
+    stop = true;
+    while (!responder_async.idle()){
+        responder_async.run();
+        simRFM69Idle(1000);
+    }
+
+    char name[64];
+    bool ok = true;
+    uint32_t pongs = 0;
+    uint64_t rtt_ns = 0;
+    for (uint8_t t=0; t < c.tasks; t++){
+        snprintf(name, sizeof(name), "%s task %u all responses", c.name, t);
+        ok &= check(name, (states[t].pongs == PINGS) && (states[t].timeouts == 0) && (states[t].wrong == 0));
+        pongs += states[t].pongs;
+        rtt_ns += states[t].rtt_ns;
+    }
+    snprintf(name, sizeof(name), "%s no heap allocations", c.name);
+    ok &= check(name, started && (allocations == allocations_before));
+    snprintf(name, sizeof(name), "%s pinger idle", c.name);
+    ok &= check(name, pinger_async.idle() && (pinger_async.getUnclaimed() == 0));
+
+    printf("%-10s responses %3u, mean round trip %5.0f us, %4.0f responses per second\n", c.name, pongs, (pongs) ? rtt_ns / 1000.0 / pongs : 0.0, pongs * 1e9 / elapsed);
+    return ok;
+}
+
+static bool runTimeout(){
+    simRFM69 radio(PINGER_CS, PINGER_DIO2);
+    plainRFM69 rfm(PINGER_CS);
+    pinger_rfm = &rfm;
+    setup(rfm, PINGER_ADDRESS, PINGER_DIO2, interruptPinger);
+    asyncRFM69 async(&rfm);
+
+    uint32_t elapsed_ms = 0;
+    uint8_t result = 0xFF;
+    timeout(async, &elapsed_ms, &result);
+    while (!async.idle()){
+        async.run();
+        simRFM69Idle(1000);
+    }
+    return check("receive returns zero after its timeout", (result == 0) && (elapsed_ms >= 250) && (elapsed_ms <= 252));
+}
+
+static bool runPool(){
+    simRFM69 radio(PINGER_CS, PINGER_DIO2);
+    plainRFM69 rfm(PINGER_CS);
+    pinger_rfm = &rfm;
+    setup(rfm, PINGER_ADDRESS, PINGER_DIO2, interruptPinger);
+    asyncRFM69 async(&rfm);
+
+    // all frames taken, the next coroutine does not run.
+    uint32_t elapsed_ms[RFM69_ASYNC_FRAMES + 1];
+    uint8_t result[RFM69_ASYNC_FRAMES + 1];
+    bool started = true;
+    for (uint8_t i=0; i < RFM69_ASYNC_FRAMES; i++){
+        started &= (bool) timeout(async, &(elapsed_ms[i]), &(result[i]));
+    }
+    bool refused = !timeout(async, &(elapsed_ms[RFM69_ASYNC_FRAMES]), &(result[RFM69_ASYNC_FRAMES]));
+    while (!async.idle()){
+        async.run();
+        simRFM69Idle(1000);
+    }
+    // and the frames are returned.
+    bool again = (bool) timeout(async, &(elapsed_ms[0]), &(result[0]));
+    while (!async.idle()){
+        async.run();
+        simRFM69Idle(1000);
+    }
+    return check("frame pool refuses when full, and is returned", started && refused && again);
+}
+
+int main(int, char*[]){
+    bool ok = true;
+    for (const asyncCase& c : cases){
+        ok &= runCase(c);
+    }
+    ok &= runTimeout();
+    ok &= runPool();
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Checks codecRFM69 against captured packets and bitwise reference
+    implementations, and measures its throughput.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -o codec_bench codec_bench.cpp ../../codecRFM69.cpp
+        ./codec_bench
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../../codecRFM69.h"
+
+// Captured with CRC off and the payload length two bytes too long, from
+// extras/check_crypto_mode.py, the last two bytes are the CRC.
+static const char* captured[] = {
+    "A02AEBADF27DBBB36F3928BD53A3BC87AD7159E950A85F4ABF59F043828932B7226E",
+    "2B240611993CEB856A07FD353C940ACAAD7159E950A85F4ABF59F043828932B73A22",
+    "2475FEF5D93D2EE636B43584DEDCF622AD7159E950A85F4ABF59F043828932B7A639",
+    "27D3806ED8A8BB63BD700B9FAE8B64C9AD7159E950A85F4ABF59F043828932B782D4",
+    "652729B2F2A75C1279AF2833417DFCF5AD7159E950A85F4ABF59F043828932B76DA1",
+    "40C3D18D9DD0B5AA282163095BCAA2A3AD7159E950A85F4ABF59F043828932B71FCE",
+    "85096C2B74B868AB0028B8EB1C5F32DFAD7159E950A85F4ABF59F043828932B74531",
+};
+
+static uint16_t bitwiseCrc(const uint8_t* data, uint16_t len){
+    uint16_t crc = RFM69_CODEC_CRC_INIT;
+    for (uint16_t i=0; i < len; i++){
+        crc ^= data[i] << 8;
+        for (uint8_t b=0; b < 8; b++){
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    return crc ^ RFM69_CODEC_CRC_XOROUT;
+}
+
+static void bitwiseWhiten(uint8_t* data, uint16_t len){
+    uint16_t lfsr = RFM69_CODEC_WHITENING_INIT;
+    for (uint16_t i=0; i < len; i++){
+        uint8_t mask = 0;
+        for (uint8_t b=0; b < 8; b++){
+            mask |= (lfsr & 1) << b;
+            uint16_t bit = (lfsr ^ (lfsr >> 5)) & 1;
+            lfsr = (lfsr >> 1) | (bit << 8);
+        }
+        data[i] ^= mask;
+    }
+}
+
+static double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static bool check(const char* name, bool value){
+    printf("%-40s %s\n", name, (value) ? "ok" : "FAIL");
+    return value;
+}
+
+// keeps the compiler from removing the benchmarked calls.
+static volatile uint32_t sink;
+
+template <typename F>
+static void bench(const char* name, uint32_t bytes, F f){
+    double start = now();
+    uint32_t rounds = 0;
+    do {
+        for (uint16_t i=0; i < 1000; i++){
+            f();
+        }
+        rounds += 1000;
+    } while ((now() - start) < 0.5);
+    double seconds = now() - start;
+    printf("%-40s %8.1f MB/s\n", name, (rounds * (double) bytes) / seconds / 1e6);
+}
+
+int main(){
+    bool ok = true;
+
+    // CRC on the captured packets.
+    bool crc_ok = true;
+    for (const char* hex : captured){
+        uint8_t frame[64];
+        uint16_t len = 0;
+        for (; hex[len*2]; len++){
+            char byte[3] = {hex[len*2], hex[len*2 + 1], 0};
+            frame[len] = strtoul(byte, 0, 16);
+        }
+        crc_ok &= codecRFM69CheckCrc(frame, len);
+        frame[3] ^= 0x10;
+        crc_ok &= !codecRFM69CheckCrc(frame, len);
+    }
+    ok &= check("crc of captured packets", crc_ok);
+
+    uint8_t data[258];
+    uint8_t copy[258];
+    uint8_t air[(258 + 2) * 2];
+    for (uint16_t i=0; i < sizeof(data); i++){
+        data[i] = rand();
+    }
+
+    bool table_ok = true;
+    for (uint16_t len=0; len < sizeof(data); len++){
+        table_ok &= codecRFM69Crc(data, len) == bitwiseCrc(data, len);
+    }
+    ok &= check("crc table equals bitwise", table_ok);
+
+    memcpy(copy, data, sizeof(data));
+    codecRFM69Whiten(copy, sizeof(copy));
+    bitwiseWhiten(copy, sizeof(copy));
+    ok &= check("whitening equals bitwise lfsr", memcmp(copy, data, sizeof(data)) == 0);
+
+    uint8_t zeros[4] = {0};
+    codecRFM69Whiten(zeros, 4);
+    ok &= check("whitening sequence starts FF E1 1D 9A", (zeros[0] == 0xFF) && (zeros[1] == 0xE1) && (zeros[2] == 0x1D) && (zeros[3] == 0x9A));
+
+    codecRFM69Whiten(copy, sizeof(copy));
+    uint16_t state = codecRFM69Whiten(copy, 100);
+    codecRFM69Whiten(&(copy[100]), sizeof(copy) - 100, state);
+    ok &= check("whitening continued", memcmp(copy, data, sizeof(data)) == 0);
+
+    codecRFM69ManchesterEncode(data, sizeof(data), air);
+    ok &= check("manchester round trip", codecRFM69ManchesterDecode(air, sizeof(data) * 2, copy) && (memcmp(copy, data, sizeof(data)) == 0));
+    air[10] ^= 0x01; // a chip pair becomes 00 or 11.
+    ok &= check("manchester invalid chips", !codecRFM69ManchesterDecode(air, sizeof(data) * 2, copy));
+
+    const uint8_t modes[] = {RFM69_PACKET_CONFIG_DC_FREE_NONE, RFM69_PACKET_CONFIG_DC_FREE_MANCHESTER, RFM69_PACKET_CONFIG_DC_FREE_WHITENING};
+    bool air_ok = true;
+    for (uint8_t mode : modes){
+        uint16_t len = codecRFM69EncodeAir(data, 66, mode, true, air);
+        air_ok &= codecRFM69DecodeAir(air, len, mode, true, copy) && (memcmp(copy, data, 66) == 0);
+        air[len - 1] ^= 0x01;
+        air_ok &= !codecRFM69DecodeAir(air, len, mode, true, copy);
+    }
+    ok &= check("air round trip", air_ok);
+
+    printf("\n");
+    bench("crc bitwise (64 bytes)", 64, [&](){ sink += bitwiseCrc(data, 64); });
+    bench("crc table (64 bytes)", 64, [&](){ sink += codecRFM69Crc(data, 64); });
+    bench("whitening bitwise (64 bytes)", 64, [&](){ bitwiseWhiten(data, 64); sink += data[0]; });
+    bench("whitening (64 bytes)", 64, [&](){ codecRFM69Whiten(data, 64); sink += data[0]; });
+    bench("manchester encode (64 bytes)", 64, [&](){ codecRFM69ManchesterEncode(data, 64, air); sink += air[0]; });
+    bench("manchester decode (64 bytes)", 64, [&](){ sink += codecRFM69ManchesterDecode(air, 128, copy); });
+    bench("air encode, whitening and crc (64)", 64, [&](){ sink += codecRFM69EncodeAir(data, 64, RFM69_PACKET_CONFIG_DC_FREE_WHITENING, true, air); });
+
+    return (ok) ? 0 : 1;
+}
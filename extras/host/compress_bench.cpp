@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Checks compressRFM69 on synthetic telemetry and reports the compression
+    ratio and the time per frame.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -o compress_bench compress_bench.cpp ../../compressRFM69.cpp
+        ./compress_bench
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../../compressRFM69.h"
+
+static double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static bool check(const char* name, bool value){
+    printf("%-40s %s\n", name, (value) ? "ok" : "FAIL");
+    return value;
+}
+
+typedef struct {
+    uint8_t node;
+    uint8_t type;
+    uint32_t counter;
+    int16_t temperature[4];
+    uint16_t humidity;
+    uint16_t pressure;
+    uint16_t battery;
+    uint8_t status[6];
+} __attribute__((packed)) telemetry_t;
+
+// readings that change slowly, as a sensor node produces them.
+static uint8_t binaryTelemetry(uint32_t i, uint8_t* out){
+    telemetry_t t;
+    memset(&t, 0, sizeof(t));
+    t.node = 7;
+    t.type = 1;
+    t.counter = i;
+    for (uint8_t j=0; j < 4; j++){
+        t.temperature[j] = 2150 + j * 10 + (rand() % 3);
+    }
+    t.humidity = 450 + (i / 50) % 20;
+    t.pressure = 10132 + (rand() % 2);
+    t.battery = 3710 - i / 1000;
+    memcpy(out, &t, sizeof(t));
+    return sizeof(t);
+}
+
+static const char text_dictionary[] = "{\"node\":,\"temp\":,\"hum\":,\"bat\":,\"state\":\"ok\"}";
+
+static uint8_t textTelemetry(uint32_t i, uint8_t* out){
+    return snprintf((char*) out, RFM69_COMPRESS_MAX_FRAME, "{\"node\":7,\"temp\":%d.%d,\"hum\":%u,\"bat\":3.71,\"state\":\"ok\"}",
+                    21 + (int) (i / 200) % 3, (int) (rand() % 10), 45 + (unsigned) (i / 50) % 5);
+}
+
+typedef uint8_t (*generator_t)(uint32_t, uint8_t*);
+
+// the fraction of frames lost on the way is given by loss.
+static bool run(const char* name, generator_t generate, bool dictionary, double loss){
+    compressRFM69 tx;
+    compressRFM69 rx;
+    if (dictionary){
+        tx.setDictionary(text_dictionary, sizeof(text_dictionary) - 1);
+        rx.setDictionary(text_dictionary, sizeof(text_dictionary) - 1);
+    }
+
+    uint8_t payload[RFM69_COMPRESS_MAX_FRAME];
+    uint8_t packet[RFM69_COMPRESS_MAX_FRAME + RFM69_COMPRESS_OVERHEAD];
+    uint8_t decoded[RFM69_COMPRESS_MAX_FRAME];
+
+    const uint32_t frames = 20000;
+    uint32_t received = 0;
+    uint32_t recovered = 0;
+    bool correct = true;
+    double compress_time = 0;
+    double decompress_time = 0;
+    for (uint32_t i=0; i < frames; i++){
+        uint8_t len = generate(i, payload);
+
+        double t = now();
+        uint8_t size = tx.compress(3, payload, len, packet);
+        compress_time += now() - t;
+
+        if ((rand() / (double) RAND_MAX) < loss){
+            continue;
+        }
+        received++;
+
+        t = now();
+        uint8_t n = rx.decompress(3, packet, size, decoded);
+        decompress_time += now() - t;
+        if (n){
+            recovered++;
+            // a payload is either recovered exactly, or rejected.
+            correct &= (n == len) && (memcmp(decoded, payload, len) == 0);
+        }
+    }
+
+    printf("%-28s ratio %5.3f  compress %6.2f us  decompress %5.2f us  recovered %5.1f %%\n", name,
+           tx.getCompressedBytes() / (double) tx.getRawBytes(), compress_time / frames * 1e6,
+           decompress_time / received * 1e6, 100.0 * recovered / received);
+    return correct;
+}
+
+int main(){
+    bool ok = true;
+
+    {
+        compressRFM69 tx;
+        compressRFM69 rx;
+        uint8_t payload[RFM69_COMPRESS_MAX_FRAME];
+        uint8_t packet[RFM69_COMPRESS_MAX_FRAME + RFM69_COMPRESS_OVERHEAD];
+        uint8_t decoded[RFM69_COMPRESS_MAX_FRAME];
+        bool all = true;
+        for (uint16_t i=0; i < 2000; i++){
+            uint8_t len = rand() % (RFM69_COMPRESS_MAX_FRAME + 1);
+            for (uint8_t j=0; j < len; j++){
+                payload[j] = (i & 1) ? rand() : (rand() % 3);
+            }
+            uint8_t size = tx.compress(i % 6, payload, len, packet);
+            all &= size <= len + RFM69_COMPRESS_OVERHEAD;
+            uint8_t n = rx.decompress(i % 6, packet, size, decoded);
+            all &= (n == len) && (memcmp(decoded, payload, len) == 0);
+        }
+        ok &= check("round trip, random payloads and peers", all);
+
+        // random garbage never writes out of bounds, see -fsanitize=address.
+        for (uint16_t i=0; i < 20000; i++){
+            uint8_t len = rand() % sizeof(packet);
+            for (uint8_t j=0; j < len; j++){
+                packet[j] = rand();
+            }
+            rx.decompress(rand() % 6, packet, len, decoded);
+        }
+        ok &= check("random input is rejected safely", rx.getRejected() > 0);
+    }
+
+    printf("\n");
+    ok &= check("binary telemetry", run("binary, no loss", binaryTelemetry, false, 0.0));
+    ok &= check("binary telemetry with loss", run("binary, 10% loss", binaryTelemetry, false, 0.1));
+    ok &= check("text telemetry", run("text, no dictionary", textTelemetry, false, 0.0));
+    ok &= check("text telemetry with dictionary", run("text, dictionary", textTelemetry, true, 0.0));
+
+    return (ok) ? 0 : 1;
+}
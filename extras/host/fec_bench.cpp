@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Checks fecRFM69 and compares the goodput with FEC to that of the radio's
+    CRC with retransmission, on a channel with random bit errors.
+
+    Only the bytes after the sync word are subjected to errors, for both.
+    Goodput is the fraction of the airtime spent on payload that arrives,
+    retransmissions repeat the full frame.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -o fec_bench fec_bench.cpp ../../fecRFM69.cpp
+        ./fec_bench
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <random>
+#include "../../fecRFM69.h"
+
+// preamble (setPreambleSize(3)), sync word (4) and length byte.
+#define FRAME_OVERHEAD (3 + 4 + 1)
+#define CRC_LENGTH 2
+#define PAYLOAD 32
+
+static double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static bool check(const char* name, bool value){
+    printf("%-40s %s\n", name, (value) ? "ok" : "FAIL");
+    return value;
+}
+
+static std::mt19937 generator(1);
+
+// flips every bit with probability ber, returns the number flipped.
+static uint16_t channel(uint8_t* data, uint8_t len, double ber){
+    std::geometric_distribution<uint32_t> gap(ber);
+    uint16_t flipped = 0;
+    uint32_t bit = gap(generator);
+    while (bit < (uint32_t) len * 8){
+        data[bit / 8] ^= 0x80 >> (bit % 8);
+        flipped++;
+        bit += 1 + gap(generator);
+    }
+    return flipped;
+}
+
+// corrupts 'errors' distinct bytes in every codeword.
+static void byteErrors(uint8_t* frame, uint8_t payload, uint8_t parity, uint8_t depth, uint8_t errors){
+    for (uint8_t d=0; d < depth; d++){
+        uint8_t positions[80];
+        uint8_t n = 0;
+        for (uint8_t i=d; i < payload; i += depth){
+            positions[n++] = i;
+        }
+        for (uint8_t p=0; p < parity; p++){
+            positions[n++] = payload + p * depth + d;
+        }
+        for (uint8_t e=0; e < errors; e++){
+            uint8_t pick = e + generator() % (n - e);
+            uint8_t t = positions[e];
+            positions[e] = positions[pick];
+            positions[pick] = t;
+            frame[positions[e]] ^= 1 + generator() % 255;
+        }
+    }
+}
+
+int main(){
+    bool ok = true;
+    uint8_t payload[64];
+    uint8_t frame[RFM69_FEC_MAX_FRAME];
+
+    const uint8_t configs[][2] = {{8, 1}, {8, 2}, {16, 1}, {12, 2}};
+    for (auto config : configs){
+        fecRFM69 fec(config[0], config[1]);
+        uint8_t t = config[0] / 2;
+        bool corrects = true;
+        bool detects = true;
+        for (uint16_t trial=0; trial < 2000; trial++){
+            uint8_t len = 1 + generator() % (RFM69_FEC_MAX_FRAME - fec.getOverhead());
+            for (uint8_t i=0; i < len; i++){
+                payload[i] = generator();
+            }
+            uint8_t n = fec.encode(payload, len, frame);
+
+            byteErrors(frame, len, config[0], config[1], trial % (t + 1));
+            corrects &= (fec.decode(frame, n) == len) && (memcmp(frame, payload, len) == 0);
+
+            // one more than correctable, is detected or miscorrected, but
+            // never returned as the original.
+            fec.encode(payload, len, frame);
+            byteErrors(frame, len, config[0], config[1], t + 1);
+            if (fec.decode(frame, n) && (memcmp(frame, payload, len) == 0)){
+                detects = false;
+            }
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "parity %u depth %u corrects %u/codeword", config[0], config[1], t);
+        ok &= check(name, corrects && detects);
+    }
+
+    {
+        // a burst of depth * parity / 2 bytes.
+        fecRFM69 fec(8, 4);
+        for (uint8_t i=0; i < PAYLOAD; i++){
+            payload[i] = generator();
+        }
+        uint8_t n = fec.encode(payload, PAYLOAD, frame);
+        for (uint8_t i=10; i < 26; i++){
+            frame[i] ^= 0xFF;
+        }
+        ok &= check("burst of 16 bytes, parity 8 depth 4", (fec.decode(frame, n) == PAYLOAD) && (memcmp(frame, payload, PAYLOAD) == 0));
+    }
+
+    {
+        // parity below two or odd is raised to the next even value.
+        fecRFM69 none(0);
+        fecRFM69 odd(7, 2);
+        for (uint8_t i=0; i < PAYLOAD; i++){
+            payload[i] = generator();
+        }
+        uint8_t n = none.encode(payload, PAYLOAD, frame);
+        frame[3] ^= 0xFF;
+        bool corrected = (none.decode(frame, n) == PAYLOAD) && (memcmp(frame, payload, PAYLOAD) == 0);
+        ok &= check("parity 0 raised to 2", (none.getOverhead() == 2) && corrected);
+        n = odd.encode(payload, PAYLOAD, frame);
+        byteErrors(frame, PAYLOAD, 8, 2, 4);
+        corrected = (odd.decode(frame, n) == PAYLOAD) && (memcmp(frame, payload, PAYLOAD) == 0);
+        ok &= check("parity 7 rounded up to 8", (odd.getOverhead() == 16) && corrected);
+    }
+
+    printf("\n%u byte payload, goodput (fraction of airtime delivered as payload):\n", PAYLOAD);
+    printf("%-10s %10s", "ber", "crc");
+    for (auto config : configs){
+        char name[16];
+        snprintf(name, sizeof(name), "rs%u/%u", config[0], config[1]);
+        printf(" %10s", name);
+    }
+    printf(" %12s\n", "miscorrected");
+
+    const double bers[] = {1e-4, 1e-3, 3e-3, 1e-2, 2e-2};
+    const uint32_t trials = 20000;
+    for (double ber : bers){
+        printf("%-10.0e", ber);
+
+        uint32_t success = 0;
+        for (uint32_t i=0; i < trials; i++){
+            memset(frame, 0, PAYLOAD + CRC_LENGTH + 1);
+            success += channel(frame, PAYLOAD + CRC_LENGTH + 1, ber) == 0;
+        }
+        printf(" %10.3f", (success / (double) trials) * PAYLOAD / (FRAME_OVERHEAD + PAYLOAD + CRC_LENGTH));
+
+        uint32_t miscorrected = 0;
+        for (auto config : configs){
+            fecRFM69 fec(config[0], config[1]);
+            success = 0;
+            for (uint32_t i=0; i < trials; i++){
+                for (uint8_t j=0; j < PAYLOAD; j++){
+                    payload[j] = generator();
+                }
+                uint8_t n = fec.encode(payload, PAYLOAD, frame);
+                channel(frame, n, ber);
+                if (fec.decode(frame, n)){
+                    if (memcmp(frame, payload, PAYLOAD) == 0){
+                        success++;
+                    } else {
+                        miscorrected++;
+                    }
+                }
+            }
+            printf(" %10.3f", (success / (double) trials) * PAYLOAD / (FRAME_OVERHEAD + PAYLOAD + fec.getOverhead()));
+        }
+        printf(" %12u\n", miscorrected);
+    }
+
+    printf("\n");
+    const uint8_t error_counts[] = {0, 2, 4};
+    for (uint8_t errors : error_counts){
+        fecRFM69 fec(8, 1);
+        for (uint8_t i=0; i < PAYLOAD; i++){
+            payload[i] = generator();
+        }
+        uint8_t clean[RFM69_FEC_MAX_FRAME];
+        uint8_t n = fec.encode(payload, PAYLOAD, clean);
+        byteErrors(clean, PAYLOAD, 8, 1, errors);
+
+        uint32_t rounds = 0;
+        double start = now();
+        do {
+            for (uint16_t i=0; i < 1000; i++){
+                memcpy(frame, clean, n);
+                fec.decode(frame, n);
+            }
+            rounds += 1000;
+        } while ((now() - start) < 0.3);
+        printf("decode rs8/1, %u byte errors %15.2f us\n", errors, (now() - start) / rounds * 1e6);
+    }
+    {
+        fecRFM69 fec(8, 1);
+        uint32_t rounds = 0;
+        double start = now();
+        do {
+            for (uint16_t i=0; i < 1000; i++){
+                fec.encode(payload, PAYLOAD, frame);
+            }
+            rounds += 1000;
+        } while ((now() - start) < 0.3);
+        printf("encode rs8/1 %29.2f us\n", (now() - start) / rounds * 1e6);
+    }
+
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "../../frameRFM69.h"
+
+#ifndef GATEWAY_DECODER_H
+#define GATEWAY_DECODER_H
+
+/*
+    Host side decoder for the records written by gatewayRFM69::bridge().
+
+    The decoder owns the receive buffer, the data from the serial port is read
+    directly into it, using writePointer() and writeSpace(). The frames are
+    then decoded in place by commit(), and the handler is called with every
+    packet. The payload pointer of the packet points into the receive buffer,
+    so no data is copied between the read() call and the handler. The payload
+    is only valid during the call of the handler.
+
+    Only the incomplete frame at the end of the buffer is moved to the start
+    of the buffer after the complete frames are handled.
+
+    Usage:
+        gatewayDecoder<> decoder;
+        ssize_t n = read(fd, decoder.writePointer(), decoder.writeSpace());
+        decoder.commit(n, [](const frameRFM69Packet& packet){ ... });
+
+    Requires C++11 for the lambda handler, compile with frameRFM69.cpp.
+*/
+
+template <size_t BUFFER_SIZE = 4096>
+class gatewayDecoder{
+    protected:
+        uint8_t buffer[BUFFER_SIZE];
+
+        // bytes in the buffer.
+        size_t used;
+
+        // bytes at the start of the buffer known not to contain a delimiter.
+        size_t scanned;
+
+        // number of frames which could not be decoded.
+        size_t dropped;
+
+    public:
+        gatewayDecoder(){
+            this->used = 0;
+            this->scanned = 0;
+            this->dropped = 0;
+        };
+
+        uint8_t* writePointer(){return &(this->buffer[this->used]);};
+        // position to write new data to.
+
+        size_t writeSpace(){return BUFFER_SIZE - this->used;};
+        // number of bytes that can be written at writePointer().
+
+        size_t getDropped(){return this->dropped;};
+        // number of malformed or oversized frames.
+
+        template <typename Handler>
+        size_t commit(size_t length, Handler handler){
+            /*
+                Adds length bytes written at writePointer() and calls the
+                handler for every complete packet. Returns the number of
+                packets handled.
+            */
+            return this->commitRecords(length, [this, &handler](const uint8_t* record, uint16_t record_length){
+                frameRFM69Packet packet;
+                if (!frameRFM69ParsePacket(record, record_length, &packet)){
+                    return false;
+                }
+                handler(packet);
+                return true;
+            });
+        }
+
+        template <typename Handler>
+        size_t commitRecords(size_t length, Handler handler){
+            /*
+                Like commit(), but calls the handler with every decoded record,
+                of any type. The handler returns false if the record is not
+                valid, which counts it as dropped.
+            */
+            this->used += length;
+            size_t count = 0;
+            size_t start = 0;
+
+            while (true){
+                size_t search = (this->scanned > start) ? this->scanned : start;
+                uint8_t* delimiter = (uint8_t*) memchr(&(this->buffer[search]), RFM69_FRAME_DELIMITER, this->used - search);
+                if (delimiter == 0){
+                    break;
+                }
+                size_t end = delimiter - this->buffer;
+
+                // decode in place and hand out the record.
+                uint8_t* frame = &(this->buffer[start]);
+                uint16_t decoded = frameRFM69Decode(frame, end - start, frame);
+                if (decoded && handler(frame, decoded)){
+                    count++;
+                } else if (end != start){
+                    this->dropped++;
+                }
+                start = end + 1;
+            }
+
+            // keep the incomplete frame.
+            memmove(this->buffer, &(this->buffer[start]), this->used - start);
+            this->used -= start;
+            this->scanned = this->used;
+
+            if (this->used == BUFFER_SIZE){
+                // a frame larger than the buffer, this cannot be a valid one.
+                this->used = 0;
+                this->scanned = 0;
+                this->dropped++;
+            }
+            return count;
+        }
+};
+
+//GATEWAY_DECODER_H
+#endif
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Prints the packets forwarded by a gatewayRFM69 on the serial port, one
+    packet per line:
+        timestamp(us) rssi(dBm) address length payload(hex)
+
+    Or the frames captured by a snifferRFM69:
+        timestamp(us) rssi(dBm) crc_ok|crc_fail[,truncated] fei(Hz) length frame(hex)
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -o gateway_dump gateway_dump.cpp ../../frameRFM69.cpp
+        ./gateway_dump /dev/ttyACM0
+*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <termios.h>
+#include <unistd.h>
+#include "gatewayDecoder.h"
+
+int main(int argc, char* argv[]){
+    if (argc < 2){
+        fprintf(stderr, "Usage: %s /dev/ttyACM0\n", argv[0]);
+        return 1;
+    }
+
+    int fd = open(argv[1], O_RDONLY | O_NOCTTY);
+    if (fd < 0){
+        perror("open");
+        return 1;
+    }
+
+    // raw mode, no translation of the binary data. The baudrate is irrelevant
+    // for USB serial, but set it for real serial ports.
+    struct termios tty;
+    if (tcgetattr(fd, &tty) == 0){
+        cfmakeraw(&tty);
+        cfsetspeed(&tty, B115200);
+        tcsetattr(fd, TCSANOW, &tty);
+    }
+
+    gatewayDecoder<> decoder;
+    while (true){
+        ssize_t n = read(fd, decoder.writePointer(), decoder.writeSpace());
+        if (n <= 0){
+            break;
+        }
+        decoder.commitRecords(n, [](const uint8_t* record, uint16_t record_length){
+            frameRFM69Packet packet;
+            frameRFM69Raw raw;
+            if (frameRFM69ParsePacket(record, record_length, &packet)){
+                printf("%u -%u.%u %u %u ", packet.timestamp, packet.rssi / 2, (packet.rssi % 2) * 5, packet.address, packet.length);
+                for (uint8_t i=0; i < packet.length; i++){
+                    printf("%02X", packet.payload[i]);
+                }
+            } else if (frameRFM69ParseRaw(record, record_length, &raw)){
+                printf("%u -%u.%u %s%s %+dHz %u ", raw.timestamp, raw.rssi / 2, (raw.rssi % 2) * 5,
+                       (raw.flags & RFM69_FRAME_FLAG_CRC_OK) ? "crc_ok" : "crc_fail",
+                       (raw.flags & RFM69_FRAME_FLAG_TRUNCATED) ? ",truncated" : "", raw.fei * 61, raw.length);
+                for (uint8_t i=0; i < raw.length; i++){
+                    printf("%02X", raw.frame[i]);
+                }
+            } else {
+                return false;
+            }
+            printf("\n");
+            return true;
+        });
+        fflush(stdout);
+    }
+
+    close(fd);
+    return 0;
+}
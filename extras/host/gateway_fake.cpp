@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Pretends to be a gateway running the Gateway example, for testing rfm69d
+    and other host programs without hardware.
+
+    It writes a packet record with a counter as payload at the given rate, and
+    every transmit record it receives is echoed back as a packet record.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -o gateway_fake gateway_fake.cpp ../../frameRFM69.cpp
+        ./gateway_fake /dev/pts/N [packets per second]
+*/
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "gatewayDecoder.h"
+
+static uint32_t microseconds(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000UL + now.tv_nsec / 1000;
+}
+
+static void writePacket(int fd, const frameRFM69Packet& packet){
+    uint8_t encoded[RFM69_FRAME_MAX_ENCODED(RFM69_FRAME_PACKET_HEADER + 255)];
+    uint16_t length = frameRFM69EncodePacket(&packet, encoded);
+    if (write(fd, encoded, length) != length){
+        perror("write");
+    }
+}
+
+int main(int argc, char* argv[]){
+    if (argc < 2){
+        fprintf(stderr, "Usage: %s /dev/pts/N [packets per second]\n", argv[0]);
+        return 1;
+    }
+    uint32_t rate = (argc > 2) ? strtoul(argv[2], 0, 0) : 10;
+    int interval = (rate) ? (1000 / rate) : -1;
+
+    int fd = open(argv[1], O_RDWR | O_NOCTTY);
+    if (fd < 0){
+        perror("open");
+        return 1;
+    }
+    struct termios tty;
+    if (tcgetattr(fd, &tty) == 0){
+        cfmakeraw(&tty);
+        tcsetattr(fd, TCSANOW, &tty);
+    }
+
+    gatewayDecoder<> decoder;
+    uint32_t counter = 0;
+
+    while (true){
+        struct pollfd event = {fd, POLLIN, 0};
+        int ready = poll(&event, 1, interval);
+        if (ready < 0){
+            break;
+        }
+
+        if (ready == 0){
+            // the synthetic packet, address 1 and a counter as payload.
+            frameRFM69Packet packet;
+            packet.timestamp = microseconds();
+            packet.rssi = 100 + (counter % 60);
+            packet.address = 1;
+            packet.length = sizeof(counter);
+            packet.payload = (const uint8_t*) &counter;
+            writePacket(fd, packet);
+            counter++;
+            continue;
+        }
+
+        ssize_t n = read(fd, decoder.writePointer(), decoder.writeSpace());
+        if (n <= 0){
+            break;
+        }
+        decoder.commitRecords(n, [fd](const uint8_t* record, uint16_t record_length){
+            frameRFM69Transmit transmit;
+            if (!frameRFM69ParseTransmit(record, record_length, &transmit)){
+                return false;
+            }
+            frameRFM69Packet packet;
+            packet.timestamp = microseconds();
+            packet.rssi = 60;
+            packet.address = transmit.address;
+            packet.length = transmit.length;
+            packet.payload = transmit.payload;
+            writePacket(fd, packet);
+            return true;
+        });
+    }
+
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Checks hopRFM69 on two simulated radios, see sim/simRFM69.h, which only
+    hear each other on the same Frf. Both hop per packet; the receiver stays
+    in Rx, the sender returns to an idle mode after every packet:
+
+        received    Every packet arrives, the peers stay on the same channel.
+        hop index   The sender hops once per packet, also when it returns to
+                    the idle mode instead of Rx, and when its poll() is
+                    called through a plainRFM69 pointer.
+        idle mode   After a packet is sent, and after hop() between packets,
+                    the radio is in the idle mode; not in Rx.
+        time slot   update() from the loop hops once per dwell time, and the
+                    peers still exchange packets; setHopChannels() may be
+                    called again.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -I sim -I ../.. -o hop_check hop_check.cpp \
+            sim/simRFM69.cpp ../../bareRFM69.cpp ../../plainRFM69.cpp \
+            ../../hopRFM69.cpp
+        ./hop_check
+*/
+
+#include <stdio.h>
+#include "sim/simLink.h"
+#include "../../hopRFM69.h"
+
+#define CHANNELS 5
+#define PACKETS 12
+
+static const uint8_t pattern[CHANNELS] = {3, 0, 4, 1, 2};
+
+static void setup(hopRFM69& rfm){
+    rfm.setRecommended();
+    rfm.setPacketType(false, false);
+    rfm.setBufferSize(4);
+    rfm.setPacketLength(4);
+    rfm.baud300000();
+    rfm.setHopChannels((uint32_t) 433*1000*1000, 200*1000, CHANNELS, pattern);
+    rfm.setHopMode(RFM69_HOP_PER_PACKET);
+}
+
+static uint8_t opMode(hopRFM69& rfm){
+    return rfm.readRawRegister(RFM69_OPMODE) & (0b111 << 2);
+}
+
+static bool runCase(const char* case_name, uint8_t idle_mode){
+    simLink link;
+    hopRFM69 sender(SIM_LINK_SENDER_CS);
+    hopRFM69 receiver(SIM_LINK_RECEIVER_CS);
+
+    // poll() is called through plainRFM69, as multiRFM69 does.
+    setup(sender);
+    setup(receiver);
+    link.attach(&sender, &receiver);
+    sender.setIdleMode(idle_mode);
+    sender.idle();
+    receiver.receive();
+    delay(1);
+
+    uint32_t received = 0;
+    uint32_t wrong = 0;
+    uint32_t hops = 0;      // sent packets after which the index moved on.
+    uint32_t idle = 0;      // sent packets after which the radio was idle.
+    for (uint32_t n=0; n < PACKETS; n++){
+        // the receiver retunes after reading, give it time to enter Rx.
+        delay(1);
+        uint8_t index = sender.getHopIndex();
+        sender.send(&n);
+        link.wait([&](){return receiver.available();});
+        hops += (sender.getHopIndex() == (index + 1) % CHANNELS) ? 1 : 0;
+        idle += (opMode(sender) == idle_mode) ? 1 : 0;
+
+        uint32_t value;
+        while (receiver.available()){
+            receiver.read(&value);
+            wrong += (value == n) ? 0 : 1;
+            received++;
+        }
+    }
+
+    // an explicit hop between packets leaves the idle mode as it was.
+    sender.hop();
+    bool hop_idle = opMode(sender) == idle_mode;
+    receiver.hop();
+    delay(1);
+    uint32_t n = PACKETS;
+    sender.send(&n);
+    uint32_t value;
+    bool hop_received = link.wait([&](){return receiver.available();}) && receiver.read(&value) && (value == n);
+
+    char name[64];
+    bool ok = true;
+    snprintf(name, sizeof(name), "%s received", case_name);
+    ok &= check(name, (received == PACKETS) && (wrong == 0));
+    snprintf(name, sizeof(name), "%s hop index per packet", case_name);
+    ok &= check(name, hops == PACKETS);
+    snprintf(name, sizeof(name), "%s idle mode after sending", case_name);
+    ok &= check(name, idle == PACKETS);
+    snprintf(name, sizeof(name), "%s idle mode after hop()", case_name);
+    ok &= check(name, hop_idle);
+    snprintf(name, sizeof(name), "%s received after hop()", case_name);
+    ok &= check(name, hop_received);
+
+    printf("%-12s received %2u of %u, hops %2u, idle %2u\n", case_name, received, PACKETS, hops, idle);
+    return ok;
+}
+
+static bool checkTimeslot(){
+    simLink link;
+    hopRFM69 sender(SIM_LINK_SENDER_CS);
+    hopRFM69 receiver(SIM_LINK_RECEIVER_CS);
+    setup(sender);
+    setup(receiver);
+    link.attach(&sender, &receiver);
+    sender.receive();
+    receiver.receive();
+
+    // a second table replaces the first one.
+    sender.setHopChannels((uint32_t) 433*1000*1000, 200*1000, CHANNELS, pattern);
+    receiver.setHopChannels((uint32_t) 433*1000*1000, 200*1000, CHANNELS, pattern);
+    sender.setHopMode(RFM69_HOP_TIMESLOT, 10);
+    receiver.setHopMode(RFM69_HOP_TIMESLOT, 10);
+
+    // the loop only calls update(), the interrupts call poll().
+    uint8_t hops = 0;
+    uint8_t index = sender.getHopIndex();
+    link.wait([&](){
+        sender.update();
+        receiver.update();
+        hops += (sender.getHopIndex() != index) ? 1 : 0;
+        index = sender.getHopIndex();
+        return false;
+    }, 55);
+    bool ok = check("time slot hops per dwell time", hops == 5);
+    ok &= check("time slot peers on the same index", sender.getHopIndex() == receiver.getHopIndex());
+
+    uint32_t n = 1;
+    sender.send(&n);
+    uint32_t value;
+    ok &= check("time slot received", link.wait([&](){return receiver.available();}, 5) && receiver.read(&value) && (value == n));
+    printf("%-12s hops %2u in 55 ms of 10 ms slots\n", "time slot", hops);
+    return ok;
+}
+
+int main(int, char*[]){
+    bool ok = true;
+    ok &= runCase("standby", RFM69_MODE_STANDBY);
+    ok &= runCase("sleep", RFM69_MODE_SLEEP);
+    ok &= runCase("synthesizer", RFM69_MODE_FREQ_SYNTH);
+    ok &= checkTimeslot();
+    return (ok) ? 0 : 1;
+}
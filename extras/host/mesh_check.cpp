@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Checks meshRFM69 on four simulated radios, see sim/simRFM69.h, placed in
+    a line 1 - 2 - 3 - 4 with setReach(), such that each only hears its
+    neighbours. The hop limit is lowered to two for the build, such that four
+    nodes cover it:
+
+        discovery   A route request from 1 for 3 is rebroadcast by 2, the
+                    route reply of 3 is relayed back along the reverse path;
+                    1 and 3 learn each other at two hops.
+        relay       Data from 1 reaches 3, relayed by 2 from its Rx slot; 2
+                    keeps nothing in its buffer.
+        duplicate   With 1 also in reach of 3, 3 hears the route request of
+                    1 directly and again from 2, and drops the copy; 1 then
+                    uses the direct route.
+        hop limit   A route request from 1 for 4 is not rebroadcast by 3, it
+                    is at the limit; 4 never hears of 1.
+
+    The loop calls update() of every node, poll() only runs in the interrupt.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -DRFM69_MESH_MAX_HOPS=2 -I sim -I ../.. \
+            -o mesh_check mesh_check.cpp sim/simRFM69.cpp ../../bareRFM69.cpp \
+            ../../plainRFM69.cpp ../../meshRFM69.cpp
+        ./mesh_check
+*/
+
+#include <stdio.h>
+#include "sim/simLink.h"
+#include "../../meshRFM69.h"
+
+#if RFM69_MESH_MAX_HOPS != 2
+#error "build with -DRFM69_MESH_MAX_HOPS=2, see the top of this file."
+#endif
+
+#define NODES 4
+#define NODE_CS 10      // node i on cs NODE_CS + i,
+#define NODE_DIO2 20    // and dio2 NODE_DIO2 + i.
+
+static meshRFM69* nodes[NODES];
+static simRFM69* radios[NODES];
+
+static void interruptNode0(){nodes[0]->poll();}
+static void interruptNode1(){nodes[1]->poll();}
+static void interruptNode2(){nodes[2]->poll();}
+static void interruptNode3(){nodes[3]->poll();}
+
+static void (*interrupts_node[NODES])() = {interruptNode0, interruptNode1, interruptNode2, interruptNode3};
+
+static void setLine(bool shortcut){
+    // node i hears its neighbours, with shortcut 1 and 3 also hear each other.
+    for (uint8_t i=0; i < NODES; i++){
+        uint8_t mask = 0;
+        if (i > 0){
+            mask |= 1 << radios[i-1]->getIndex();
+        }
+        if (i < NODES - 1){
+            mask |= 1 << radios[i+1]->getIndex();
+        }
+        radios[i]->setReach(mask);
+    }
+    if (shortcut){
+        radios[0]->setReach((1 << radios[1]->getIndex()) | (1 << radios[2]->getIndex()));
+        radios[2]->setReach((1 << radios[0]->getIndex()) | (1 << radios[1]->getIndex()) | (1 << radios[3]->getIndex()));
+    }
+}
+
+template <typename Done>
+static bool wait(Done done, uint32_t timeout_ms=200){
+    uint64_t deadline = simRFM69Now() + timeout_ms * 1000ULL * 1000;
+    while (!done()){
+        if (simRFM69Now() >= deadline){
+            return false;
+        }
+        for (uint8_t i=0; i < NODES; i++){
+            nodes[i]->update();
+        }
+        simRFM69Idle(1000);
+    }
+    return true;
+}
+
+int main(int, char*[]){
+    for (uint8_t i=0; i < NODES; i++){
+        radios[i] = new simRFM69(NODE_CS + i, NODE_DIO2 + i);
+        nodes[i] = new meshRFM69(NODE_CS + i);
+    }
+    meshRFM69& one = *nodes[0];
+    meshRFM69& two = *nodes[1];
+    meshRFM69& three = *nodes[2];
+    meshRFM69& four = *nodes[3];
+
+    for (uint8_t i=0; i < NODES; i++){
+        nodes[i]->setRecommended();
+        nodes[i]->setPacketType(true, true);
+        nodes[i]->setBufferSize(4);
+        nodes[i]->setPacketLength(RFM69_MESH_HEADER_LENGTH + 1 + sizeof(uint32_t));
+        nodes[i]->setMeshAddress(i + 1);
+        nodes[i]->baud300000();
+        nodes[i]->setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+        attachInterrupt(NODE_DIO2 + i, interrupts_node[i], CHANGE);
+        nodes[i]->receive();
+    }
+    setLine(false);
+    delay(1);
+
+    bool ok = true;
+    uint32_t payload = 0x12345678;
+
+    // discovery, the reply comes back over 2.
+    bool requested = one.sendMesh(3, &payload, sizeof(payload)) == RFM69_MESH_NO_ROUTE;
+    bool found = wait([&](){return one.hasRoute(3);});
+    ok &= check("discovery request sent", requested);
+    ok &= check("discovery route found", found);
+    ok &= check("discovery hops at origin", one.getHops(3) == 2);
+    ok &= check("discovery hops at destination", three.getHops(1) == 2);
+    ok &= check("discovery reply relayed", two.getForwarded() == 1);
+
+    // data over the route, relayed by 2 without keeping it.
+    uint32_t value = 0;
+    uint8_t origin = 0;
+    bool sent = one.sendMesh(3, &payload, sizeof(payload)) == RFM69_MESH_SENT;
+    bool arrived = wait([&](){return three.readMesh(&value, &origin) != 0;});
+    ok &= check("relay sent", sent);
+    ok &= check("relay arrived", arrived && (value == payload) && (origin == 1));
+    ok &= check("relay forwarded", two.getForwarded() == 2);
+    ok &= check("relay not kept", !two.available() && (two.getUnroutable() == 0));
+
+    // 3 hears the request of 1 directly and through 2.
+    setLine(true);
+    one.forgetRoute(3);
+    uint16_t duplicates = three.getDuplicates();
+    requested = one.sendMesh(3, &payload, sizeof(payload)) == RFM69_MESH_NO_ROUTE;
+    wait([&](){return false;}, 50);
+    ok &= check("duplicate request sent", requested);
+    ok &= check("duplicate dropped", three.getDuplicates() == duplicates + 1);
+    ok &= check("duplicate direct route", one.getHops(3) == 1);
+    ok &= check("duplicate nothing delivered", !three.available());
+
+    // 4 is three hops away, beyond the limit.
+    setLine(false);
+    three.forgetRoute(1);
+    requested = one.sendMesh(4, &payload, sizeof(payload)) == RFM69_MESH_NO_ROUTE;
+    found = wait([&](){return one.hasRoute(4);}, 100);
+    ok &= check("hop limit request sent", requested);
+    ok &= check("hop limit no route", !found);
+    ok &= check("hop limit request reached 3", three.getHops(1) == 2);
+    ok &= check("hop limit not rebroadcast by 3", four.getHops(1) == 0);
+
+    printf("forwarded %u %u %u %u, duplicates %u %u %u %u, unroutable %u %u %u %u\n",
+           one.getForwarded(), two.getForwarded(), three.getForwarded(), four.getForwarded(),
+           one.getDuplicates(), two.getDuplicates(), three.getDuplicates(), four.getDuplicates(),
+           one.getUnroutable(), two.getUnroutable(), three.getUnroutable(), four.getUnroutable());
+
+    return (ok) ? 0 : 1;
+}
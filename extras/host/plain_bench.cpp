@@ -0,0 +1,315 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Benchmarks plainRFM69 on two simulated radios, see sim/simRFM69.h, for
+    every profile, packet format and a few lengths:
+
+        throughput  Packets sent back to back as fast as canSend() allows,
+                    like the Benchmark example.
+        ping        Round trip time of a packet echoed by the other radio,
+                    like the Benchmark example; mean and percentiles.
+        isr         Interrupts per packet and the time spent in them, in
+                    simulated time (SPI transfers) and host time.
+        spi         Bytes and transactions over SPI per packet, on the sending
+                    and the receiving side.
+        memory      Size of the object and of its buffers on the heap, for
+                    this host.
+
+    The results are written as JSON to stdout, the checks to stderr. Except
+    for the host times, which are left out with -n, the output only depends
+    on the library and the simulation; compare it between commits to find
+    regressions:
+        ./plain_bench -n > before.json
+        ./plain_bench -n | diff before.json -
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -I sim -I ../.. -o plain_bench plain_bench.cpp \
+            sim/simRFM69.cpp ../../bareRFM69.cpp ../../plainRFM69.cpp
+        ./plain_bench [-n] [packets]
+*/
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "sim/simRFM69.h"
+#include "../../plainRFM69.h"
+
+#define SENDER_CS 10
+#define SENDER_DIO2 20
+#define RECEIVER_CS 11
+#define RECEIVER_DIO2 21
+
+#define SENDER_ADDRESS 0x02
+#define RECEIVER_ADDRESS 0x01
+
+// on top of the airtime of the ping and the echo.
+#define PING_TIMEOUT_US (100*1000)
+
+static bool check(const char* name, bool value){
+    fprintf(stderr, "%-50s %s\n", name, (value) ? "ok" : "FAIL");
+    return value;
+}
+
+// exposes the sizes of the buffers.
+class benchRFM69 : public plainRFM69{
+    public:
+        benchRFM69(uint8_t cs_pin) : plainRFM69(cs_pin){};
+
+        uint32_t getHeapBytes(){
+            uint8_t slot = this->packet_length + this->use_variable_length;
+            return this->buffer_size * (sizeof(uint8_t*) + slot) + slot;
+        };
+};
+
+struct benchFormat {
+    const char* name;
+    bool variable_length;
+    bool use_addressing;
+    bool use_AES;
+};
+
+static const benchFormat formats[] = {
+    {"fixed", false, false, false},
+    {"variable", true, false, false},
+    {"addressed", false, true, false},
+    {"addressed_variable", true, true, false},
+    {"aes", false, false, true},
+};
+
+struct benchProfile {
+    const char* name;
+    void (plainRFM69::*apply)();
+};
+
+static const benchProfile profiles[] = {
+    {"baud4800", &plainRFM69::baud4800},
+    {"baud9600", &plainRFM69::baud9600},
+    {"baud153600", &plainRFM69::baud153600},
+    {"baud300000", &plainRFM69::baud300000},
+};
+
+static const uint8_t lengths[] = {8, 32, 60};
+
+static benchRFM69* sender_rfm = 0;
+static benchRFM69* receiver_rfm = 0;
+
+static void interruptSender(){
+    sender_rfm->poll();
+}
+
+static void interruptReceiver(){
+    receiver_rfm->poll();
+}
+
+static void setup(benchRFM69& rfm, const benchProfile& profile, const benchFormat& format, uint8_t len, uint8_t address, uint8_t dio2_pin, void (*isr)()){
+    uint8_t key[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    rfm.setRecommended();
+    rfm.setAES(format.use_AES);
+    rfm.setAesKey(key, sizeof(key));
+    rfm.setPacketType(format.variable_length, format.use_addressing);
+    rfm.setBufferSize(4);
+    rfm.setPacketLength(len);
+    rfm.setFrequency((uint32_t) 434*1000*1000);
+    (rfm.*(profile.apply))();
+    rfm.setNodeAddress(address);
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+    attachInterrupt(dio2_pin, isr, CHANGE);
+    rfm.receive();
+}
+
+static void sendFormat(benchRFM69& rfm, const benchFormat& format, uint8_t address, uint8_t* payload, uint8_t len){
+    if (format.variable_length && format.use_addressing){
+        rfm.sendAddressedVariable(address, payload, len);
+    } else if (format.variable_length){
+        rfm.sendVariable(payload, len);
+    } else if (format.use_addressing){
+        rfm.sendAddressed(address, payload);
+    } else {
+        rfm.send(payload);
+    }
+}
+
+static void fill(uint8_t* payload, uint8_t len, uint32_t counter){
+    for (uint8_t i=0; i < len; i++){
+        payload[i] = counter >> (8 * (i % 4));
+    }
+}
+
+// reads a packet, returns its counter or -1 if it is not the expected one.
+static int64_t take(benchRFM69& rfm, const benchFormat& format, uint8_t len){
+    uint8_t buffer[66];
+    uint8_t n = rfm.read(buffer);
+    uint8_t offset = format.use_addressing ? 1 : 0;
+    if (n != len + offset){
+        return -1;
+    }
+    uint32_t counter = 0;
+    for (uint8_t i=0; i < 4; i++){
+        counter |= (uint32_t) buffer[offset + i] << (8 * i);
+    }
+    uint8_t expected[64];
+    fill(expected, len, counter);
+    return (memcmp(&(buffer[offset]), expected, len) == 0) ? counter : -1;
+}
+
+static bool runOne(const benchProfile& profile, const benchFormat& format, uint8_t len, uint32_t packets, bool host_times, bool first){
+    simRFM69 sender_radio(SENDER_CS, SENDER_DIO2);
+    simRFM69 receiver_radio(RECEIVER_CS, RECEIVER_DIO2);
+    benchRFM69 sender(SENDER_CS);
+    benchRFM69 receiver(RECEIVER_CS);
+    sender_rfm = &sender;
+    receiver_rfm = &receiver;
+    setup(sender, profile, format, len, SENDER_ADDRESS, SENDER_DIO2, interruptSender);
+    setup(receiver, profile, format, len, RECEIVER_ADDRESS, RECEIVER_DIO2, interruptReceiver);
+    delay(1);
+
+    uint8_t payload[64];
+    bool ok = true;
+
+    // throughput, back to back.
+    sender_radio.clearStatistics();
+    receiver_radio.clearStatistics();
+    simRFM69ClearInterruptStatistics();
+    uint64_t start = simRFM69Now();
+    uint32_t sent = 0;
+    uint32_t received = 0;
+    uint32_t corrupt = 0;
+    while (true){
+        while (receiver.available()){
+            if (take(receiver, format, len) == received){
+                received++;
+            } else {
+                corrupt++;
+            }
+        }
+        if (sender.canSend()){
+            if (sent == packets){
+                break;
+            }
+            fill(payload, len, sent++);
+            sendFormat(sender, format, RECEIVER_ADDRESS, payload, len);
+            continue;
+        }
+        simRFM69Idle(1000);
+    }
+    // the last packet is in the FIFO of the receiver by now.
+    simRFM69Idle(0);
+    while (receiver.available()){
+        if (take(receiver, format, len) == received){
+            received++;
+        } else {
+            corrupt++;
+        }
+    }
+    double elapsed = (simRFM69Now() - start) * 1e-9;
+    uint64_t airtime = sender_radio.airtime(len + format.variable_length + format.use_addressing);
+
+    double tx_isr_calls = (double) simRFM69InterruptCount(SENDER_DIO2) / sent;
+    double rx_isr_calls = (double) simRFM69InterruptCount(RECEIVER_DIO2) / sent;
+    double tx_isr_us = simRFM69InterruptSimulated(SENDER_DIO2) * 1e-3 / sent;
+    double rx_isr_us = simRFM69InterruptSimulated(RECEIVER_DIO2) * 1e-3 / sent;
+    double tx_isr_host = (double) simRFM69InterruptNanoseconds(SENDER_DIO2) / sent;
+    double rx_isr_host = (double) simRFM69InterruptNanoseconds(RECEIVER_DIO2) / sent;
+    double tx_spi = (double) sender_radio.getSpiBytes() / sent;
+    double rx_spi = (double) receiver_radio.getSpiBytes() / sent;
+    double tx_transactions = (double) sender_radio.getSpiTransactions() / sent;
+    double rx_transactions = (double) receiver_radio.getSpiTransactions() / sent;
+    uint32_t missed = receiver_radio.getMissed();
+
+    // ping, the receiver echoes every packet.
+    uint32_t pings = (packets > 200) ? 200 : packets;
+    uint64_t timeout = PING_TIMEOUT_US * 1000ULL + 2 * airtime;
+    std::vector<double> rtt;
+    uint32_t timeouts = 0;
+    uint32_t incorrect = 0;
+    for (uint32_t i=0; i < pings; i++){
+        while (!sender.canSend()){
+            simRFM69Idle(1000);
+        }
+        fill(payload, len, i);
+        uint64_t sent_at = simRFM69Now();
+        sendFormat(sender, format, RECEIVER_ADDRESS, payload, len);
+        while (true){
+            if (receiver.available()){
+                int64_t counter = take(receiver, format, len);
+                fill(payload, len, counter);
+                while (!receiver.canSend()){
+                    simRFM69Idle(1000);
+                }
+                sendFormat(receiver, format, SENDER_ADDRESS, payload, len);
+            }
+            if (sender.available()){
+                if (take(sender, format, len) == i){
+                    rtt.push_back((simRFM69Now() - sent_at) * 1e-3);
+                } else {
+                    incorrect++;
+                }
+                break;
+            }
+            if ((simRFM69Now() - sent_at) > timeout){
+                timeouts++;
+                break;
+            }
+            simRFM69Idle(1000);
+        }
+    }
+    std::sort(rtt.begin(), rtt.end());
+    double mean = 0;
+    for (double t : rtt){
+        mean += t;
+    }
+    mean = (rtt.size()) ? (mean / rtt.size()) : 0;
+    #define PERCENTILE(p) ((rtt.size()) ? rtt[(rtt.size() - 1) * p / 100] : 0)
+
+    printf("%s\n    {\"profile\": \"%s\", \"format\": \"%s\", \"length\": %u,\n", (first) ? "" : ",", profile.name, format.name, len);
+    printf("     \"throughput\": {\"packets\": %u, \"received\": %u, \"corrupt\": %u, \"missed\": %u, \"packets_per_second\": %.1f, \"payload_bytes_per_second\": %.0f, \"airtime_us\": %.1f},\n",
+        sent, received, corrupt, missed, received / elapsed, received * len / elapsed, airtime * 1e-3);
+    printf("     \"ping\": {\"count\": %u, \"timeouts\": %u, \"incorrect\": %u, \"mean_us\": %.1f, \"p50_us\": %.1f, \"p90_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f},\n",
+        (unsigned) rtt.size(), timeouts, incorrect, mean, PERCENTILE(50), PERCENTILE(90), PERCENTILE(99), PERCENTILE(100));
+    printf("     \"isr\": {\"tx_calls_per_packet\": %.2f, \"rx_calls_per_packet\": %.2f, \"tx_us_per_packet\": %.2f, \"rx_us_per_packet\": %.2f",
+        tx_isr_calls, rx_isr_calls, tx_isr_us, rx_isr_us);
+    if (host_times){
+        printf(", \"tx_host_ns_per_packet\": %.0f, \"rx_host_ns_per_packet\": %.0f", tx_isr_host, rx_isr_host);
+    }
+    printf("},\n");
+    printf("     \"spi\": {\"tx_bytes_per_packet\": %.2f, \"rx_bytes_per_packet\": %.2f, \"tx_transactions_per_packet\": %.2f, \"rx_transactions_per_packet\": %.2f},\n",
+        tx_spi, rx_spi, tx_transactions, rx_transactions);
+    printf("     \"memory\": {\"object_bytes\": %u, \"heap_bytes\": %u}}",
+        (unsigned) sizeof(benchRFM69), sender.getHeapBytes());
+
+    char name[80];
+    snprintf(name, sizeof(name), "%s %s %u throughput", profile.name, format.name, len);
+    ok &= check(name, (received == packets) && (corrupt == 0));
+    snprintf(name, sizeof(name), "%s %s %u ping", profile.name, format.name, len);
+    ok &= check(name, (rtt.size() == pings) && (timeouts == 0) && (incorrect == 0));
+    return ok;
+}
+
+int main(int argc, char* argv[]){
+    bool host_times = true;
+    uint32_t packets = 500;
+    for (int i=1; i < argc; i++){
+        if (strcmp(argv[i], "-n") == 0){
+            host_times = false;
+        } else {
+            packets = strtoul(argv[i], 0, 0);
+        }
+    }
+
+    bool ok = true;
+    bool first = true;
+    printf("{\"benchmark\": \"plainRFM69\", \"simulated\": true, \"packets\": %u, \"results\": [", packets);
+    for (const benchProfile& profile : profiles){
+        for (const benchFormat& format : formats){
+            for (uint8_t len : lengths){
+                ok &= runOne(profile, format, len, packets, host_times, first);
+                first = false;
+            }
+        }
+    }
+    printf("\n]}\n");
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Checks the events of plainRFM69 on two simulated radios, see
+    sim/simRFM69.h, with the handlers called by dispatch() and by poll():
+
+        received    Every packet is passed once, in order and with its length.
+        sent        Once per packet sent.
+        crc error   Frames corrupted by the simulation are dropped and raised.
+                    With the CRC off, a handler for them sees none, and the
+                    frames are all received.
+        overflow    With a full Rx buffer new packets are dropped, the ones in
+                    the buffer are kept. Also for meshRFM69, which keeps the
+                    packets for the node in its own readPacket().
+        wake        The wake latency, measured by poll() on the AutoMode,
+                    is the start up time from the mode before sending and
+                    the FIFO write; from standby, sleep and the synthesizer.
+        batch       A batch in the sent handler leaves the interrupts as they
+                    were: disabled in poll(), enabled in dispatch(). So does
+                    receive() within noInterrupts().
+
+    The loop only wakes up when a handler has run, in dispatch() or in poll();
+    the number of wake ups is printed per case.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -I sim -I ../.. -o plain_events plain_events.cpp \
+            sim/simRFM69.cpp ../../bareRFM69.cpp ../../plainRFM69.cpp \
+            ../../meshRFM69.cpp
+        ./plain_events
+*/
+
+#include <stdio.h>
+#include "sim/simLink.h"
+#include "../../meshRFM69.h"
+
+#define PACKETS 20
+#define LENGTH 16
+
+struct eventCounts {
+    uint32_t received;
+    uint32_t wrong;     // packets out of order or with the wrong content.
+    uint32_t sent;
+    uint32_t crc_errors;
+    uint32_t overflows;
+    uint32_t enabled;   // sent handlers that returned with interrupts enabled.
+};
+
+static void onReceived(void* context, uint8_t* packet, uint8_t length){
+    eventCounts* counts = (eventCounts*) context;
+    // packet n has length n % LENGTH + 1, filled with n.
+    uint8_t n = packet[0];
+    bool right = (length == (n % LENGTH) + 1);
+    for (uint8_t i=0; i < length; i++){
+        right &= packet[i] == n;
+    }
+    counts->wrong += (right) ? 0 : 1;
+    counts->received++;
+}
+
+static void onSent(void* context){
+    eventCounts* counts = (eventCounts*) context;
+    counts->sent++;
+    // a batch, as a handler that sends the next packet would write.
+    sim_link_sender->receive();
+    counts->enabled += (simRFM69InterruptsEnabled()) ? 1 : 0;
+}
+
+static void onCrcError(void* context){
+    ((eventCounts*) context)->crc_errors++;
+}
+
+static void onOverflow(void* context){
+    ((eventCounts*) context)->overflows++;
+}
+
+static void setup(plainRFM69& rfm, uint8_t buffer_size, bool crc){
+    rfm.setRecommended();
+    rfm.setCRC(crc);
+    rfm.setPacketType(true, false);
+    rfm.setBufferSize(buffer_size);
+    rfm.setPacketLength(LENGTH);
+    rfm.baud300000();
+}
+
+struct eventCase {
+    const char* name;
+    bool in_isr;
+    uint8_t corrupt;        // frames corrupted by the receiving radio.
+    bool dispatch_receiver; // otherwise the receiver only dispatches at the end.
+    bool crc_off;           // with a handler for crc errors.
+};
+
+static const eventCase cases[] = {
+    {"deferred", false, 0, true, false},
+    {"in_isr", true, 0, true, false},
+    {"deferred crc", false, 5, true, false},
+    {"in_isr crc", true, 5, true, false},
+    {"deferred overflow", false, 0, false, false},
+    {"deferred crc off", false, 0, true, true},
+};
+
+static bool runCase(const eventCase& c){
+    simLink link;
+    plainRFM69 sender(SIM_LINK_SENDER_CS);
+    plainRFM69 receiver(SIM_LINK_RECEIVER_CS);
+
+    eventCounts tx = {0, 0, 0, 0, 0, 0};
+    eventCounts rx = {0, 0, 0, 0, 0, 0};
+    sender.onSent(onSent, &tx, c.in_isr);
+    receiver.onReceived(onReceived, &rx, c.in_isr);
+    // the overflows do not fit the queue with the received events.
+    receiver.onOverflow(onOverflow, &rx, true);
+    if (c.corrupt || c.crc_off){
+        // before setPacketType(), such that the radio keeps the frames.
+        receiver.onCrcError(onCrcError, &rx, c.in_isr);
+    }
+    setup(sender, 2, !c.crc_off);
+    setup(receiver, 4, !c.crc_off);
+    link.attach(&sender, &receiver);
+    sender.receive();
+    receiver.receive();
+    link.receiver_radio.corruptNext(c.corrupt);
+    delay(1);
+
+    // the sender waits for its sent event before sending the next packet.
+    uint8_t payload[LENGTH];
+    uint32_t wakeups = 0;
+    uint32_t seen = 0;
+    uint8_t n = 0;
+    uint64_t deadline = simRFM69Now() + 1000ULL*1000*1000;
+    while ((simRFM69Now() < deadline) && (tx.sent < PACKETS)){
+        if ((tx.sent == n) && (n < PACKETS)){
+            memset(payload, n, sizeof(payload));
+            sender.sendVariable(payload, (n % LENGTH) + 1);
+            n++;
+        }
+        bool woke = sender.dispatch();
+        if (c.dispatch_receiver){
+            woke |= receiver.dispatch();
+        }
+        // handlers in poll() have run before the loop wakes up.
+        woke |= (seen != tx.sent);
+        seen = tx.sent;
+        wakeups += (woke) ? 1 : 0;
+        if (!woke){
+            simRFM69Idle(1000);
+        }
+    }
+    simRFM69Idle(1000);
+    receiver.dispatch();
+
+    // each packet is sent, received, lost to a crc error or dropped.
+    char name[64];
+    bool ok = true;
+    uint32_t expected_received = PACKETS - c.corrupt;
+    if (!c.dispatch_receiver){
+        // the buffer of 4 slots holds 3 packets.
+        expected_received = 3;
+    }
+    snprintf(name, sizeof(name), "%s sent", c.name);
+    ok &= check(name, tx.sent == PACKETS);
+    snprintf(name, sizeof(name), "%s received", c.name);
+    ok &= check(name, (rx.received == expected_received) && (rx.wrong == 0));
+    snprintf(name, sizeof(name), "%s crc errors", c.name);
+    ok &= check(name, rx.crc_errors == c.corrupt);
+    snprintf(name, sizeof(name), "%s overflows", c.name);
+    ok &= check(name, (rx.overflows == PACKETS - c.corrupt - expected_received) && (receiver.getOverflows() == rx.overflows));
+    snprintf(name, sizeof(name), "%s queue empty", c.name);
+    ok &= check(name, !sender.pending() && !receiver.pending());
+    snprintf(name, sizeof(name), "%s wake latency", c.name);
+    uint16_t wake = sender.getWakeLatency();
+    ok &= check(name, (wake >= RFM69_PLAIN_TS_FS + RFM69_PLAIN_TS_TR) && (wake < RFM69_PLAIN_TS_FS + RFM69_PLAIN_TS_TR + 50));
+    snprintf(name, sizeof(name), "%s batch keeps the interrupt state", c.name);
+    ok &= check(name, tx.enabled == ((c.in_isr) ? 0 : tx.sent));
+
+    printf("%-20s received %2u, sent %2u, crc errors %u, overflows %2u, wake ups %u\n", c.name, rx.received, tx.sent, rx.crc_errors, rx.overflows, wakeups);
+    return ok;
+}
+
+static bool checkNoInterrupts(){
+    simRFM69 radio(SIM_LINK_SENDER_CS, SIM_LINK_SENDER_DIO2);
+    plainRFM69 rfm(SIM_LINK_SENDER_CS);
+    noInterrupts();
+    rfm.receive();
+    bool disabled = !simRFM69InterruptsEnabled();
+    interrupts();
+    return disabled && simRFM69InterruptsEnabled();
+}
+
+static bool checkWakeLatency(uint8_t idle_mode, uint16_t start){
+    // from the idle mode, the start up time and the FIFO write.
+    simLink link;
+    plainRFM69 rfm(SIM_LINK_SENDER_CS);
+    plainRFM69 receiver(SIM_LINK_RECEIVER_CS);
+    setup(rfm, 2, true);
+    setup(receiver, 2, true);
+    link.attach(&rfm, &receiver);
+    rfm.setIdleMode(idle_mode);
+    rfm.idle();
+    receiver.receive();
+    delay(1);
+    uint8_t payload[LENGTH] = {0};
+    rfm.sendVariable(payload, 1);
+    link.wait([&](){return rfm.canSend();});
+    uint16_t wake = rfm.getWakeLatency();
+    return (wake >= start) && (wake < start + 50);
+}
+
+static bool checkMeshOverflow(){
+    simLink link;
+    meshRFM69 sender(SIM_LINK_SENDER_CS);
+    meshRFM69 receiver(SIM_LINK_RECEIVER_CS);
+
+    eventCounts rx = {0, 0, 0, 0, 0, 0};
+    receiver.onOverflow(onOverflow, &rx, true);
+    meshRFM69* nodes[2] = {&sender, &receiver};
+    for (uint8_t i=0; i < 2; i++){
+        nodes[i]->setRecommended();
+        nodes[i]->setPacketType(true, true);
+        nodes[i]->setBufferSize(4);
+        nodes[i]->setPacketLength(RFM69_MESH_HEADER_LENGTH + 1 + 1);
+        nodes[i]->setMeshAddress(i + 1);
+        nodes[i]->baud300000();
+    }
+    link.attach(&sender, &receiver);
+    sender.receive();
+    receiver.receive();
+    delay(1);
+
+    // the first packet finds the route, then the receiver never reads.
+    uint8_t n = 0;
+    sender.sendMesh(2, &n, 1);
+    link.wait([&](){return sender.hasRoute(2);});
+    link.wait([&](){
+        if (sender.sendMesh(2, &n, 1) == RFM69_MESH_SENT){
+            n++;
+        }
+        return n == PACKETS;
+    }, 1000);
+    link.wait([&](){return sender.canSend();});
+    simRFM69Idle(1000);
+
+    // the buffer of 4 slots holds the first 3 packets.
+    uint8_t value;
+    uint8_t kept = 0;
+    bool right = true;
+    while (receiver.readMesh(&value)){
+        right &= (value == kept);
+        kept++;
+    }
+    return (n == PACKETS) && right && (kept == 3) && (rx.overflows == PACKETS - 3) && (receiver.getOverflows() == rx.overflows);
+}
+
+int main(int, char*[]){
+    bool ok = true;
+    for (const eventCase& c : cases){
+        ok &= runCase(c);
+    }
+    ok &= check("batch receive() within noInterrupts()", checkNoInterrupts());
+    ok &= check("wake latency from sleep", checkWakeLatency(RFM69_MODE_SLEEP, RFM69_PLAIN_TS_OSC + RFM69_PLAIN_TS_FS + RFM69_PLAIN_TS_TR));
+    ok &= check("wake latency from the synthesizer", checkWakeLatency(RFM69_MODE_FREQ_SYNTH, RFM69_PLAIN_TS_TR));
+    ok &= check("mesh overflows", checkMeshOverflow());
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Checks the profiles of profileRFM69.h, see sim/simRFM69.h for the radio:
+
+        compile     The profiles of the baud methods pass their checks, and
+                    broken ones fail the right check; in static_assert().
+        registers   For every profile and packet format, setProfile() leaves
+                    the same registers as the sequence of setRecommended(),
+                    setPacketType(), setFrf() and the baud method, except for
+                    RegFifoThresh, see profileRFM69.h. Compared with
+                    snapshotRFM69.
+        ook         After ook4800(), every baud method returns RegDataModul
+                    to the FSK of its profile.
+        link        Two radios set up by profile exchange a packet.
+
+    The SPI transactions and bytes of both ways are printed.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -I sim -I ../.. -o profile_check profile_check.cpp \
+            sim/simRFM69.cpp ../../bareRFM69.cpp ../../plainRFM69.cpp \
+            ../../snapshotRFM69.cpp
+        ./profile_check
+*/
+
+#include <stdio.h>
+#include "sim/simLink.h"
+#include "../../snapshotRFM69.h"
+
+#define FREQUENCY 434000000
+#define LENGTH 16
+
+constexpr bool sorted(const profileRFM69& profile, uint8_t i){
+    return (i + 1 >= RFM69_PROFILE_REGISTERS) || ((profile.registers[i].reg < profile.registers[i + 1].reg) && sorted(profile, i + 1));
+}
+
+constexpr profileRFM69Format any_format = profileRFM69Packet(true, true, false);
+constexpr profileRFM69 maximum_speed = profileRFM69Make(FREQUENCY, profileRFM69Baud300000(), any_format);
+static_assert(maximum_speed.error == RFM69_PROFILE_OK, "300000");
+static_assert(sorted(maximum_speed, 0), "sorted");
+static_assert(maximum_speed.registers[5].value == 0x6c, "Frf");
+static_assert(profileRFM69Make(868000000, profileRFM69Baud4800(), any_format).error == RFM69_PROFILE_OK, "4800");
+static_assert(profileRFM69Make(915000000, profileRFM69Baud9600(), any_format).error == RFM69_PROFILE_OK, "9600");
+static_assert(profileRFM69Make(433920000, profileRFM69Baud153600(), any_format).error == RFM69_PROFILE_OK, "153600");
+
+// what the comments of the baud methods compute, as the compiler does.
+static_assert(profileRFM69Occupied(profileRFM69Baud300000()) <= 500000, "FDEV + BR/2");
+static_assert(profileRFM69BandwidthHz(profileRFM69Bandwidth(0b010, 0b00, 0b101)) == 15625, "RxBw");
+static_assert(profileRFM69DccHz(profileRFM69Bandwidth(0b010, 0b00, 0)) == 19894, "DCC");
+
+// broken profiles fail the check they break.
+constexpr profileRFM69Modulation wide = {0x006b, 0x52*80, profileRFM69Bandwidth(0b010, 0b00, 0), 0x8B, 0, 0};
+constexpr profileRFM69Modulation narrow = {0x1a0b/2, 0x52*2, profileRFM69Bandwidth(0b010, 0b00, 0b110), 0x8B, 0, 0};
+constexpr profileRFM69Modulation low_index = {0x1a0b, 0x05, profileRFM69Bandwidth(0b010, 0b00, 0b101), 0x8B, 0, 0};
+constexpr profileRFM69Modulation small_offset = {0x006b, 0x52*64, profileRFM69Bandwidth(0b010, 0b00, 0), profileRFM69Bandwidth(0b000, 0b00, 0), 0, 20};
+constexpr profileRFM69Modulation slow = {0xFFFF, 0x52, profileRFM69Bandwidth(0b010, 0b00, 0b101), 0x8B, 0, 0};
+static_assert(profileRFM69Make(600000000, profileRFM69Baud4800(), any_format).error == RFM69_PROFILE_FREQUENCY, "band");
+static_assert(profileRFM69Make(FREQUENCY, slow, any_format).error == RFM69_PROFILE_BITRATE, "bitrate");
+static_assert(profileRFM69Make(FREQUENCY, wide, any_format).error == RFM69_PROFILE_FDEV_BITRATE, "wide");
+static_assert(profileRFM69Make(FREQUENCY, low_index, any_format).error == RFM69_PROFILE_BETA, "beta");
+static_assert(profileRFM69Make(FREQUENCY, narrow, any_format).error == RFM69_PROFILE_RX_BW, "narrow");
+static_assert(profileRFM69Make(FREQUENCY, small_offset, any_format).error == RFM69_PROFILE_LOW_BETA, "offset");
+
+struct checkProfile {
+    const char* name;
+    profileRFM69Modulation modulation;
+    void (plainRFM69::*apply)();
+};
+
+static const checkProfile profiles[] = {
+    {"baud4800", profileRFM69Baud4800(), &plainRFM69::baud4800},
+    {"baud9600", profileRFM69Baud9600(), &plainRFM69::baud9600},
+    {"baud153600", profileRFM69Baud153600(), &plainRFM69::baud153600},
+    {"baud300000", profileRFM69Baud300000(), &plainRFM69::baud300000},
+};
+
+static const profileRFM69Format formats[] = {
+    profileRFM69Packet(false, false, false),
+    profileRFM69Packet(true, false, false),
+    profileRFM69Packet(true, true, false),
+    profileRFM69Packet(true, true, true),
+    profileRFM69Packet(false, true, false, false),
+};
+
+static void legacy(plainRFM69& rfm, const checkProfile& profile, const profileRFM69Format& format){
+    rfm.setRecommended();
+    rfm.setAES(format.aes);
+    rfm.setCRC(format.crc);
+    rfm.setPacketType(format.variable_length, format.addressing);
+    rfm.setFrf(bareRFM69::frequencyToFrf(FREQUENCY));
+    (rfm.*(profile.apply))();
+}
+
+static bool sameRegisters(const snapshotRFM69& a, const snapshotRFM69& b){
+    bool same = true;
+    for (uint8_t reg=RFM69_SNAPSHOT_FIRST; reg <= RFM69_SNAPSHOT_LAST; reg++){
+        if (reg != RFM69_FIFO_THRESH){
+            same &= ((a.get(reg) ^ b.get(reg)) & snapshotRFM69::getWritableBits(reg)) == 0;
+        }
+    }
+    return same;
+}
+
+static bool checkLink(){
+    simLink link;
+    plainRFM69 sender(SIM_LINK_SENDER_CS);
+    plainRFM69 receiver(SIM_LINK_RECEIVER_CS);
+    plainRFM69* both[2] = {&sender, &receiver};
+    for (uint8_t i=0; i < 2; i++){
+        both[i]->setProfile(maximum_speed);
+        both[i]->setBufferSize(2);
+        both[i]->setPacketLength(LENGTH);
+        both[i]->setNodeAddress(i + 1);
+    }
+    link.attach(&sender, &receiver);
+    sender.receive();
+    receiver.receive();
+    delay(1);
+
+    uint8_t payload[LENGTH];
+    memset(payload, 0xA5, sizeof(payload));
+    sender.sendAddressedVariable(0x02, payload, sizeof(payload));
+    uint8_t packet[LENGTH + 1];
+    if (!link.wait([&](){return receiver.available();})){
+        return false;
+    }
+    uint8_t len = receiver.read(packet);
+    return (len == sizeof(payload) + 1) && (packet[0] == 0x02) && (memcmp(packet + 1, payload, sizeof(payload)) == 0);
+}
+
+int main(int, char*[]){
+    bool ok = true;
+    bool same = true;
+    printf("%-12s %-5s %23s %23s\n", "profile", "format", "legacy", "setProfile()");
+    for (const checkProfile& profile : profiles){
+        for (uint8_t f=0; f < sizeof(formats) / sizeof(formats[0]); f++){
+            const profileRFM69Format& format = formats[f];
+
+            simRFM69 radio(SIM_LINK_SENDER_CS, SIM_LINK_SENDER_DIO2);
+            plainRFM69 rfm(SIM_LINK_SENDER_CS);
+            radio.clearStatistics();
+            legacy(rfm, profile, format);
+            uint32_t legacy_transactions = radio.getSpiTransactions();
+            uint32_t legacy_bytes = radio.getSpiBytes();
+            snapshotRFM69 expected;
+            expected.read(&rfm);
+
+            radio.reset();
+            radio.clearStatistics();
+            bool applied = rfm.setProfile(profileRFM69Make(FREQUENCY, profile.modulation, format));
+            uint32_t transactions = radio.getSpiTransactions();
+            uint32_t bytes = radio.getSpiBytes();
+            snapshotRFM69 result;
+            result.read(&rfm);
+
+            bool right = applied && sameRegisters(expected, result);
+            if (!right){
+                uint8_t changed[16];
+                uint8_t count = result.diffFields(expected, changed, sizeof(changed));
+                snapshotRFM69Field field;
+                for (uint8_t i=0; (i < count) && (i < sizeof(changed)); i++){
+                    result.field(changed[i], &field);
+                    fprintf(stderr, "%s format %u differs in %s\n", profile.name, f, field.name);
+                }
+            }
+            same &= right;
+            printf("%-12s %-5u %3u transactions %4u B %3u transactions %4u B\n", profile.name, f, legacy_transactions, legacy_bytes, transactions, bytes);
+        }
+    }
+    ok &= check("registers setProfile() matches the legacy sequence", same);
+
+    // a profile that failed its check is not written.
+    simRFM69 radio(SIM_LINK_SENDER_CS, SIM_LINK_SENDER_DIO2);
+    plainRFM69 rfm(SIM_LINK_SENDER_CS);
+    radio.clearStatistics();
+    bool refused = !rfm.setProfile(profileRFM69Make(FREQUENCY, wide, any_format));
+    ok &= check("registers a failed profile writes nothing", refused && (radio.getSpiTransactions() == 0));
+
+    // the baud methods switch the modulation back to FSK.
+    bool fsk = true;
+    for (const checkProfile& profile : profiles){
+        legacy(rfm, profile, formats[0]);
+        uint8_t expected_modul = rfm.readRawRegister(RFM69_DATA_MODUL);
+        rfm.ook4800();
+        (rfm.*(profile.apply))();
+        fsk &= rfm.readRawRegister(RFM69_DATA_MODUL) == expected_modul;
+    }
+    ok &= check("ook baud methods switch back to FSK", fsk);
+
+    ok &= check("link radios set up by profile exchange a packet", checkLink());
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Checks pulseRFM69 on synthetic transmissions, with the clock error,
+    jitter and noise spikes of cheap transmitters, and measures the time it
+    takes per edge.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -o pulse_bench pulse_bench.cpp ../../pulseRFM69.cpp
+        ./pulse_bench
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../../pulseRFM69.h"
+
+static double now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static bool check(const char* name, bool value){
+    printf("%-40s %s\n", name, (value) ? "ok" : "FAIL");
+    return value;
+}
+
+// a transmission as the DATA pin sees it, as edges.
+class transmitter{
+    public:
+        uint32_t time;
+        bool level;
+        double clock; // relative clock error.
+        uint16_t jitter; // maximum jitter per pulse in microseconds.
+        uint16_t spikes; // one in this many pulses gets a noise spike.
+        pulseRFM69* receiver;
+
+        transmitter(pulseRFM69* receiver){
+            this->receiver = receiver;
+            this->time = 0;
+            this->level = false;
+            this->clock = 1.0;
+            this->jitter = 0;
+            this->spikes = 0;
+        };
+
+        void edgeAt(uint32_t when, bool to){
+            this->time = when;
+            this->level = to;
+            this->receiver->edge(when, to);
+        }
+
+        void pulse(bool level, uint32_t width){
+            width = width * this->clock;
+            if (this->jitter){
+                width += (rand() % (2 * this->jitter)) - this->jitter;
+            }
+            this->edgeAt(this->time, level);
+            if (this->spikes && ((rand() % this->spikes) == 0)){
+                // a spike of the opposite level inside the pulse.
+                uint32_t at = this->time + width / 2;
+                this->edgeAt(at, !level);
+                this->edgeAt(at + 20, level);
+                this->time = at + 20 - width / 2;
+            }
+            this->time += width;
+        };
+
+        void send(const pulseRFM69Protocol& p, uint32_t code){
+            for (uint8_t i=0; i < p.bits; i++){
+                bool bit = code & (1UL << (p.bits - 1 - i));
+                this->pulse(true, p.base * (bit ? p.one_high : p.zero_high));
+                this->pulse(false, p.base * (bit ? p.one_low : p.zero_low));
+            }
+            this->pulse(true, p.base * p.sync_high);
+            this->pulse(false, p.base * p.sync_low);
+        };
+};
+
+static uint32_t code(const pulseRFM69Frame& frame){
+    uint32_t r = 0;
+    for (uint8_t i=0; i < frame.bits; i++){
+        r = (r << 1) | ((frame.data[i >> 3] >> (7 - (i & 7))) & 1);
+    }
+    return r;
+}
+
+// sends repeats of code and counts the correct frames received.
+static uint32_t transmission(pulseRFM69* rx, transmitter* tx, const pulseRFM69Protocol& p, uint8_t index, uint32_t value, uint8_t repeats){
+    uint32_t correct = 0;
+    pulseRFM69Frame frame;
+    for (uint8_t r=0; r < repeats; r++){
+        tx->send(p, value);
+        while (rx->read(&frame)){
+            correct += (frame.protocol == index) && (code(frame) == value);
+        }
+    }
+    // silence until the next one.
+    tx->pulse(true, 100);
+    tx->pulse(false, 50000);
+    return correct;
+}
+
+// keeps the compiler from removing the benchmarked calls.
+static volatile uint32_t sink;
+
+int main(){
+    bool ok = true;
+    pulseRFM69Protocol ev1527 = RFM69_PULSE_PROTOCOL_EV1527;
+    pulseRFM69Protocol hx2262 = RFM69_PULSE_PROTOCOL_HX2262;
+
+    {
+        pulseRFM69 rx;
+        rx.addProtocol(ev1527);
+        transmitter tx(&rx);
+        // the first code precedes its sync and is lost.
+        ok &= check("ev1527 repeats", transmission(&rx, &tx, ev1527, 0, 0xA5C3F0, 5) == 4);
+    }
+
+    {
+        pulseRFM69 rx;
+        rx.addProtocol(ev1527);
+        rx.addProtocol(hx2262);
+        transmitter tx(&rx);
+        bool all = true;
+        for (uint16_t i=0; i < 100; i++){
+            uint32_t value = rand() & 0xFFFFFF;
+            tx.clock = 0.75 + (rand() % 50) / 100.0;
+            tx.jitter = 60;
+            if (i & 1){
+                all &= transmission(&rx, &tx, hx2262, 1, value, 4) == 3;
+            } else {
+                all &= transmission(&rx, &tx, ev1527, 0, value, 4) == 3;
+            }
+        }
+        ok &= check("two protocols, clock error and jitter", all);
+    }
+
+    {
+        pulseRFM69 rx;
+        rx.addProtocol(ev1527);
+        transmitter tx(&rx);
+        tx.spikes = 10;
+        tx.jitter = 40;
+        bool all = true;
+        for (uint16_t i=0; i < 100; i++){
+            all &= transmission(&rx, &tx, ev1527, 0, rand() & 0xFFFFFF, 4) == 3;
+        }
+        ok &= check("noise spikes are removed", all);
+    }
+
+    {
+        pulseRFM69 rx;
+        rx.addProtocol(ev1527);
+        transmitter tx(&rx);
+        pulseRFM69Frame frame;
+        for (uint16_t i=0; i < RFM69_PULSE_RING_SIZE * 2; i++){
+            tx.pulse(i & 1, 500);
+        }
+        while (rx.read(&frame)){
+        }
+        ok &= check("overruns counted", rx.getOverruns() > 0);
+    }
+
+    printf("\n");
+    {
+        // decoding time per edge, the edges are stored beforehand.
+        pulseRFM69 rx;
+        rx.addProtocol(ev1527);
+        rx.addProtocol(hx2262);
+        transmitter tx(&rx);
+        tx.jitter = 40;
+        pulseRFM69Frame frame;
+        uint32_t edges = 0;
+        uint32_t frames = 0;
+        double decoding = 0;
+        double start = now();
+        do {
+            // one code with its sync is 50 edges, half the ring.
+            tx.send(ev1527, rand() & 0xFFFFFF);
+            edges += 50;
+            double t = now();
+            while (rx.read(&frame)){
+                frames++;
+                sink += frame.data[0];
+            }
+            decoding += now() - t;
+        } while ((now() - start) < 0.5);
+        printf("%-40s %8.1f ns/edge\n", "read(), two protocols", decoding / edges * 1e9);
+        printf("%-40s %8.0f frames/s\n", "decoding capacity", frames / decoding);
+        ok &= check("all frames decoded", frames + 1 == edges / 50);
+    }
+
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,335 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Daemon which shares one serial attached gateway (the Gateway example, with
+    gatewayRFM69) with multiple local programs.
+
+    The serial port is read with epoll, the records are decoded in place by the
+    gatewayDecoder and copied once into a shared ring of packets. Every client
+    has its own position in this ring and a filter, the packets are sent from
+    the ring directly to the socket of the client. A client that does not keep
+    up only blocks itself, when the ring wraps around its position is moved
+    forward and the skipped packets are counted as dropped.
+
+    Transmit records from the clients are COBS encoded and written to the
+    gateway. See rfm69d.h for the protocol with the clients.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -o rfm69d rfm69d.cpp ../../frameRFM69.cpp
+        ./rfm69d /dev/ttyACM0 [/tmp/rfm69d.sock]
+
+    Using 'pty' as device creates a pseudo terminal instead of opening a serial
+    port, its name is printed. This allows testing without a gateway, for
+    example with gateway_fake:
+        ./rfm69d pty &
+        ./gateway_fake /dev/pts/N
+        ./rfm69d_client
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+#include "gatewayDecoder.h"
+#include "rfm69d.h"
+
+// number of packets in the ring, power of two.
+#define RFM69D_RING_SIZE 4096
+#define RFM69D_RECORD_MAX (RFM69_FRAME_PACKET_HEADER + 255)
+
+struct ringSlot {
+    uint16_t length;
+    uint8_t address;
+    uint8_t rssi;
+    uint8_t record[RFM69D_RECORD_MAX];
+};
+
+struct rfm69dClient {
+    int fd;
+    uint64_t position; // next packet in the ring for this client.
+    uint64_t dropped;
+    bool blocked; // waiting for EPOLLOUT.
+    uint8_t address;
+    uint8_t mask;
+    uint8_t max_rssi;
+};
+
+class rfm69d{
+    protected:
+        int epoll_fd;
+        int serial_fd;
+        int listen_fd;
+        int pty_slave_fd;
+
+        gatewayDecoder<> decoder;
+
+        std::vector<ringSlot> ring;
+        uint64_t head; // number of packets ever added to the ring.
+
+        std::unordered_map<int, rfm69dClient> clients;
+
+        // encoded transmit records not yet written to the gateway.
+        std::vector<uint8_t> serial_out;
+
+        void watch(int fd, uint32_t events, bool modify){
+            struct epoll_event event;
+            memset(&event, 0, sizeof(event));
+            event.events = events;
+            event.data.fd = fd;
+            epoll_ctl(this->epoll_fd, (modify) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event);
+        }
+
+        void addPacket(const frameRFM69Packet& packet){
+            // the payload points into the decoded record, copy the whole record.
+            ringSlot& slot = this->ring[this->head % RFM69D_RING_SIZE];
+            slot.length = RFM69_FRAME_PACKET_HEADER + packet.length;
+            slot.address = packet.address;
+            slot.rssi = packet.rssi;
+            memcpy(slot.record, packet.payload - RFM69_FRAME_PACKET_HEADER, slot.length);
+            this->head++;
+        }
+
+        bool deliver(rfm69dClient& client){
+            // returns false if the client should be disconnected.
+            if ((this->head - client.position) > RFM69D_RING_SIZE){
+                client.dropped += (this->head - client.position) - RFM69D_RING_SIZE;
+                client.position = this->head - RFM69D_RING_SIZE;
+            }
+            while (client.position != this->head){
+                const ringSlot& slot = this->ring[client.position % RFM69D_RING_SIZE];
+                bool match = ((slot.address & client.mask) == (client.address & client.mask)) &&
+                             (slot.rssi <= client.max_rssi);
+                if (match){
+                    ssize_t n = send(client.fd, slot.record, slot.length, MSG_DONTWAIT | MSG_NOSIGNAL);
+                    if (n < 0){
+                        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)){
+                            client.blocked = true;
+                            this->watch(client.fd, EPOLLIN | EPOLLOUT, true);
+                            return true;
+                        }
+                        return false;
+                    }
+                }
+                client.position++;
+            }
+            if (client.blocked){
+                client.blocked = false;
+                this->watch(client.fd, EPOLLIN, true);
+            }
+            return true;
+        }
+
+        void disconnect(int fd){
+            rfm69dClient& client = this->clients[fd];
+            fprintf(stderr, "client %d disconnected, dropped %llu packets\n", fd, (unsigned long long) client.dropped);
+            epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, fd, 0);
+            close(fd);
+            this->clients.erase(fd);
+        }
+
+        void readSerial(){
+            while (true){
+                ssize_t n = read(this->serial_fd, this->decoder.writePointer(), this->decoder.writeSpace());
+                if (n <= 0){
+                    break;
+                }
+                this->decoder.commit(n, [this](const frameRFM69Packet& packet){
+                    this->addPacket(packet);
+                });
+
+                // fan out after every read, before the ring wraps around.
+                std::vector<int> lost;
+                for (auto& entry : this->clients){
+                    if ((!entry.second.blocked) && (!this->deliver(entry.second))){
+                        lost.push_back(entry.first);
+                    }
+                }
+                for (int fd : lost){
+                    this->disconnect(fd);
+                }
+            }
+        }
+
+        void writeSerial(){
+            if (this->serial_out.empty()){
+                return;
+            }
+            ssize_t n = write(this->serial_fd, this->serial_out.data(), this->serial_out.size());
+            if (n > 0){
+                this->serial_out.erase(this->serial_out.begin(), this->serial_out.begin() + n);
+            }
+            this->watch(this->serial_fd, EPOLLIN | ((this->serial_out.empty()) ? 0u : (uint32_t) EPOLLOUT), true);
+        }
+
+        void acceptClients(){
+            while (true){
+                int fd = accept4(this->listen_fd, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0){
+                    return;
+                }
+                rfm69dClient client;
+                client.fd = fd;
+                client.position = this->head; // only new packets.
+                client.dropped = 0;
+                client.blocked = false;
+                client.address = 0;
+                client.mask = 0;
+                client.max_rssi = 0xFF;
+                this->clients[fd] = client;
+                this->watch(fd, EPOLLIN, false);
+                fprintf(stderr, "client %d connected\n", fd);
+            }
+        }
+
+        bool readClient(rfm69dClient& client){
+            uint8_t message[RFM69D_RECORD_MAX];
+            while (true){
+                ssize_t n = recv(client.fd, message, sizeof(message), MSG_DONTWAIT);
+                if (n == 0){
+                    return false;
+                }
+                if (n < 0){
+                    return (errno == EAGAIN) || (errno == EWOULDBLOCK);
+                }
+
+                frameRFM69Transmit transmit;
+                if ((message[0] == RFM69D_MESSAGE_FILTER) && (n == RFM69D_FILTER_LENGTH)){
+                    client.address = message[1];
+                    client.mask = message[2];
+                    client.max_rssi = message[3];
+                } else if (frameRFM69ParseTransmit(message, n, &transmit)){
+                    uint8_t encoded[RFM69_FRAME_MAX_ENCODED(RFM69D_RECORD_MAX)];
+                    uint16_t length = frameRFM69EncodeTransmit(&transmit, encoded);
+                    this->serial_out.insert(this->serial_out.end(), encoded, encoded + length);
+                    this->writeSerial();
+                }
+            }
+        }
+
+    public:
+        rfm69d(){
+            this->epoll_fd = -1;
+            this->serial_fd = -1;
+            this->listen_fd = -1;
+            this->pty_slave_fd = -1;
+            this->head = 0;
+            this->ring.resize(RFM69D_RING_SIZE);
+        };
+
+        bool openSerial(const char* device){
+            if (strcmp(device, "pty") == 0){
+                this->serial_fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+                if ((this->serial_fd < 0) || grantpt(this->serial_fd) || unlockpt(this->serial_fd)){
+                    perror("posix_openpt");
+                    return false;
+                }
+                // keep the slave side open, such that the master does not see
+                // a hangup while no other program has it open.
+                this->pty_slave_fd = open(ptsname(this->serial_fd), O_RDWR | O_NOCTTY);
+                printf("%s\n", ptsname(this->serial_fd));
+                fflush(stdout);
+            } else {
+                this->serial_fd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+                if (this->serial_fd < 0){
+                    perror("open");
+                    return false;
+                }
+            }
+
+            int fd = (this->pty_slave_fd >= 0) ? this->pty_slave_fd : this->serial_fd;
+            struct termios tty;
+            if (tcgetattr(fd, &tty) == 0){
+                cfmakeraw(&tty);
+                cfsetspeed(&tty, B115200);
+                tcsetattr(fd, TCSANOW, &tty);
+            }
+            return true;
+        }
+
+        bool openSocket(const char* path){
+            this->listen_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            struct sockaddr_un address;
+            memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+            unlink(path);
+            if ((bind(this->listen_fd, (struct sockaddr*) &address, sizeof(address)) < 0) || (listen(this->listen_fd, 16) < 0)){
+                perror("bind");
+                return false;
+            }
+            return true;
+        }
+
+        int run(){
+            this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+            this->watch(this->serial_fd, EPOLLIN, false);
+            this->watch(this->listen_fd, EPOLLIN, false);
+
+            struct epoll_event events[64];
+            while (true){
+                int count = epoll_wait(this->epoll_fd, events, 64, -1);
+                if ((count < 0) && (errno != EINTR)){
+                    perror("epoll_wait");
+                    return 1;
+                }
+                for (int i=0; i < count; i++){
+                    int fd = events[i].data.fd;
+                    if (fd == this->serial_fd){
+                        if (events[i].events & (EPOLLHUP | EPOLLERR)){
+                            fprintf(stderr, "serial port closed\n");
+                            return 1;
+                        }
+                        if (events[i].events & EPOLLOUT){
+                            this->writeSerial();
+                        }
+                        if (events[i].events & EPOLLIN){
+                            this->readSerial();
+                        }
+                    } else if (fd == this->listen_fd){
+                        this->acceptClients();
+                    } else if (this->clients.count(fd)){
+                        rfm69dClient& client = this->clients[fd];
+                        bool alive = !(events[i].events & (EPOLLHUP | EPOLLERR));
+                        if (alive && (events[i].events & EPOLLIN)){
+                            alive = this->readClient(client);
+                        }
+                        if (alive && (events[i].events & EPOLLOUT)){
+                            alive = this->deliver(client);
+                        }
+                        if (!alive){
+                            this->disconnect(fd);
+                        }
+                    }
+                }
+            }
+        }
+};
+
+int main(int argc, char* argv[]){
+    if (argc < 2){
+        fprintf(stderr, "Usage: %s /dev/ttyACM0|pty [%s]\n", argv[0], RFM69D_DEFAULT_SOCKET);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    rfm69d daemon;
+    if (!daemon.openSerial(argv[1])){
+        return 1;
+    }
+    if (!daemon.openSocket((argc > 2) ? argv[2] : RFM69D_DEFAULT_SOCKET)){
+        return 1;
+    }
+    return daemon.run();
+}
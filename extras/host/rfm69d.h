@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include "../../frameRFM69.h"
+
+#ifndef RFM69D_H
+#define RFM69D_H
+
+/*
+    Protocol between the rfm69d daemon and its clients.
+
+    The clients connect to the Unix socket of the daemon, which is a
+    SOCK_SEQPACKET socket, so every message is delivered as a whole.
+
+    Daemon to client:
+        Every message is one packet record as described in frameRFM69.h, not
+        COBS encoded. It can be parsed with frameRFM69ParsePacket().
+
+    Client to daemon:
+        A transmit record as described in frameRFM69.h, not COBS encoded. The
+        daemon forwards it to the gateway, which sends it.
+
+        A filter message, which determines which packets the client receives:
+            0       RFM69D_MESSAGE_FILTER
+            1       address
+            2       address mask
+            3       maximum RssiValue
+        A packet is delivered if (packet address & mask) == (address & mask)
+        and the RssiValue of the packet is at most the maximum, so the packet
+        is at least as strong as -maximum/2 dBm. The default filter, with the
+        mask and maximum set to 0 and 0xFF, delivers all packets.
+*/
+
+#define RFM69D_MESSAGE_FILTER 0x10
+#define RFM69D_FILTER_LENGTH 4
+
+#define RFM69D_DEFAULT_SOCKET "/tmp/rfm69d.sock"
+
+//RFM69D_H
+#endif
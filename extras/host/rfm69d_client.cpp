@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Client for the rfm69d daemon. It prints the received packets, or sends a
+    single packet.
+
+    Build (Linux):
+        g++ -O2 -std=c++11 -o rfm69d_client rfm69d_client.cpp ../../frameRFM69.cpp
+
+    Print all packets, or only those for address 0x02 stronger than -80 dBm:
+        ./rfm69d_client
+        ./rfm69d_client -a 2 -m 255 -r 160
+
+    Send a packet with payload 01 02 03 to address 0x02:
+        ./rfm69d_client -a 2 -t 010203
+
+    Use -s to specify another socket than /tmp/rfm69d.sock.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "rfm69d.h"
+
+int main(int argc, char* argv[]){
+    const char* path = RFM69D_DEFAULT_SOCKET;
+    const char* transmit_hex = 0;
+    uint8_t filter[RFM69D_FILTER_LENGTH] = {RFM69D_MESSAGE_FILTER, 0, 0, 0xFF};
+
+    int option;
+    while ((option = getopt(argc, argv, "s:a:m:r:t:")) != -1){
+        switch (option){
+            case 's': path = optarg; break;
+            case 'a': filter[1] = strtoul(optarg, 0, 0); break;
+            case 'm': filter[2] = strtoul(optarg, 0, 0); break;
+            case 'r': filter[3] = strtoul(optarg, 0, 0); break;
+            case 't': transmit_hex = optarg; break;
+            default:
+                fprintf(stderr, "Usage: %s [-s socket] [-a address] [-m mask] [-r max_rssi] [-t hexpayload]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    if (connect(fd, (struct sockaddr*) &address, sizeof(address)) < 0){
+        perror("connect");
+        return 1;
+    }
+
+    if (transmit_hex){
+        uint8_t record[RFM69_FRAME_TRANSMIT_HEADER + 255];
+        uint8_t length = 0;
+        for (size_t i=0; ((i + 1) < strlen(transmit_hex)) && (length < 255); i += 2){
+            char byte[3] = {transmit_hex[i], transmit_hex[i + 1], 0};
+            record[RFM69_FRAME_TRANSMIT_HEADER + length++] = strtoul(byte, 0, 16);
+        }
+        record[0] = RFM69_FRAME_TYPE_TRANSMIT;
+        record[1] = filter[1];
+        record[2] = length;
+        send(fd, record, RFM69_FRAME_TRANSMIT_HEADER + length, 0);
+        close(fd);
+        return 0;
+    }
+
+    send(fd, filter, sizeof(filter), 0);
+
+    uint8_t record[RFM69_FRAME_PACKET_HEADER + 255];
+    while (true){
+        ssize_t n = recv(fd, record, sizeof(record), 0);
+        if (n <= 0){
+            break;
+        }
+        frameRFM69Packet packet;
+        if (!frameRFM69ParsePacket(record, n, &packet)){
+            continue;
+        }
+        printf("%u -%u.%u %u %u ", packet.timestamp, packet.rssi / 2, (packet.rssi % 2) * 5, packet.address, packet.length);
+        for (uint8_t i=0; i < packet.length; i++){
+            printf("%02X", packet.payload[i]);
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Prints the packets of secureRFM69 for the vectors of secure_reference.py,
+    the output of both should be identical. It also exercises the replay
+    window and the tag check, the results go to stderr.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -o secure_vectors secure_vectors.cpp ../../secureRFM69.cpp
+        diff <(python3 ../secure_reference.py) <(./secure_vectors)
+*/
+
+#include <stdio.h>
+#include "../../secureRFM69.h"
+
+static bool check(const char* name, bool value){
+    fprintf(stderr, "%-40s %s\n", name, (value) ? "ok" : "FAIL");
+    return value;
+}
+
+int main(){
+    const uint8_t key[16] = {146, 48, 0, 16, 31, 203, 208, 65, 31, 10, 94, 64, 8, 198, 226, 121};
+    const uint8_t lengths[] = {0, 1, 11, 12, 27, 28, 60};
+    const uint32_t counters[] = {0, 0xFFFFFFFE};
+
+    secureRFM69 sender(0x2A);
+    sender.setKey(key);
+
+    uint8_t payload[64];
+    uint8_t packet[64 + RFM69_SECURE_OVERHEAD];
+    for (uint8_t keystream=0; keystream < 2; keystream++){
+        sender.setKeystream(keystream);
+        for (uint8_t length : lengths){
+            for (uint32_t counter : counters){
+                for (uint8_t i=0; i < length; i++){
+                    payload[i] = i * 7 + length;
+                }
+                sender.setCounter(counter);
+                uint8_t packet_len = sender.seal(payload, length, packet);
+                for (uint8_t i=0; i < packet_len; i++){
+                    printf("%02X", packet[i]);
+                }
+                printf("\n");
+            }
+        }
+    }
+
+    // replay window.
+    bool ok = true;
+    secureRFM69 receiver(0x01);
+    receiver.setKey(key);
+    receiver.setKeystream(true);
+    sender.setKeystream(true);
+    secureRFM69Message message;
+    uint8_t stored[8][16 + RFM69_SECURE_OVERHEAD];
+    uint8_t stored_len[8];
+
+    sender.setCounter(100);
+    for (uint8_t i=0; i < 8; i++){
+        for (uint8_t j=0; j < 16; j++){
+            payload[j] = i;
+        }
+        stored_len[i] = sender.seal(payload, 16, stored[i]);
+    }
+
+    memcpy(packet, stored[0], stored_len[0]);
+    ok &= check("first packet accepted", receiver.open(packet, stored_len[0], &message));
+    ok &= check("payload decrypted", (message.length == 16) && (message.payload[15] == 0) && (message.counter == 100));
+    memcpy(packet, stored[0], stored_len[0]);
+    ok &= check("replay rejected", !receiver.open(packet, stored_len[0], &message));
+    memcpy(packet, stored[5], stored_len[5]);
+    ok &= check("skip ahead accepted", receiver.open(packet, stored_len[5], &message));
+    memcpy(packet, stored[3], stored_len[3]);
+    ok &= check("reordered accepted", receiver.open(packet, stored_len[3], &message) && (message.payload[0] == 3));
+    memcpy(packet, stored[3], stored_len[3]);
+    ok &= check("reordered replay rejected", !receiver.open(packet, stored_len[3], &message));
+
+    memcpy(packet, stored[6], stored_len[6]);
+    packet[7] ^= 0x01;
+    ok &= check("modified payload rejected", !receiver.open(packet, stored_len[6], &message));
+    memcpy(packet, stored[6], stored_len[6]);
+    packet[1] ^= 0x01;
+    ok &= check("modified counter rejected", !receiver.open(packet, stored_len[6], &message));
+    memcpy(packet, stored[6], stored_len[6]);
+    ok &= check("unmodified accepted", receiver.open(packet, stored_len[6], &message));
+
+    sender.setCounter(100 + 7 + RFM69_SECURE_WINDOW);
+    uint8_t far_len = sender.seal(payload, 16, packet);
+    ok &= check("window jump accepted", receiver.open(packet, far_len, &message));
+    memcpy(packet, stored[7], stored_len[7]);
+    ok &= check("behind window rejected", !receiver.open(packet, stored_len[7], &message));
+    ok &= check("counters", (receiver.getRejectedTag() == 2) && (receiver.getRejectedReplay() == 3));
+
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+/*
+    The part of the Arduino API used by the library, for compiling it on the
+    host against the simulated radio of simRFM69.h. Time is the simulated
+    time, pins are those of the simulated radios.
+*/
+
+#define HIGH 1
+#define LOW 0
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define HEX 16
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+uint32_t micros();
+uint32_t millis();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+long random(long max);
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void noInterrupts();
+void interrupts();
+
+// the interrupt state of bareRFM69Batch, as on the AVR: disabled in an
+// interrupt, and left so by a batch.
+bool simRFM69InterruptsEnabled();
+#define RFM69_INTERRUPTS_SAVE() simRFM69InterruptsEnabled()
+#define RFM69_INTERRUPTS_RESTORE(state) do {if (state){interrupts();}} while (0)
+
+class simSerial{
+    public:
+        void begin(uint32_t){};
+        template <typename T> void print(T){};
+        template <typename T> void print(T, int){};
+        template <typename T> void println(T){};
+        void println(){};
+};
+
+extern simSerial Serial;
+
+//SIM_ARDUINO_H
+#endif
@@ -0,0 +1,39 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+
+#ifndef SIM_SPI_H
+#define SIM_SPI_H
+
+/*
+    SPI library with transactions, every byte goes to the simulated radio
+    whose chip select is low.
+*/
+
+#define SPI_HAS_TRANSACTION 1
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+class SPISettings{
+    public:
+        SPISettings(uint32_t, uint8_t, uint8_t){};
+};
+
+class SPIClass{
+    public:
+        void begin(){};
+        void beginTransaction(SPISettings){};
+        uint8_t transfer(uint8_t data);
+        void endTransaction();
+        void usingInterrupt(uint8_t){};
+};
+
+extern SPIClass SPI;
+
+//SIM_SPI_H
+#endif
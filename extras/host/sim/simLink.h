@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdio.h>
+#include "simRFM69.h"
+#include "../../../plainRFM69.h"
+
+#ifndef SIM_LINK_H
+#define SIM_LINK_H
+
+/*
+    The two simulated radios most host tools run plainRFM69 on, a sender and
+    a receiver, with poll() attached to DIO2 of both:
+        simLink link;
+        hopRFM69 sender(SIM_LINK_SENDER_CS);
+        hopRFM69 receiver(SIM_LINK_RECEIVER_CS);
+        // configure both, then:
+        link.attach(&sender, &receiver);
+        sender.sendVariable(payload, len);
+        bool arrived = link.wait([&](){return receiver.available();});
+
+    poll() is called through a plainRFM69 pointer, as multiRFM69 does. Only
+    one link exists at a time; its radios are removed from the air when it is
+    destroyed.
+
+    Also holds check(), which prints the result of every check of a tool.
+*/
+
+#define SIM_LINK_SENDER_CS 10
+#define SIM_LINK_SENDER_DIO2 20
+#define SIM_LINK_RECEIVER_CS 11
+#define SIM_LINK_RECEIVER_DIO2 21
+
+static bool check(const char* name, bool value){
+    fprintf(stderr, "%-50s %s\n", name, (value) ? "ok" : "FAIL");
+    return value;
+}
+
+// the objects of the current link, for the interrupts.
+static plainRFM69* sim_link_sender = 0;
+static plainRFM69* sim_link_receiver = 0;
+
+static void simLinkPollSender(){
+    sim_link_sender->poll();
+}
+
+static void simLinkPollReceiver(){
+    sim_link_receiver->poll();
+}
+
+class simLink{
+    public:
+        simRFM69 sender_radio;
+        simRFM69 receiver_radio;
+
+        simLink() : sender_radio(SIM_LINK_SENDER_CS, SIM_LINK_SENDER_DIO2),
+                    receiver_radio(SIM_LINK_RECEIVER_CS, SIM_LINK_RECEIVER_DIO2){
+        };
+
+        void attach(plainRFM69* sender, plainRFM69* receiver,
+                    void (*sender_isr)()=simLinkPollSender, void (*receiver_isr)()=simLinkPollReceiver){
+            sim_link_sender = sender;
+            sim_link_receiver = receiver;
+            sender->setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+            receiver->setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+            attachInterrupt(SIM_LINK_SENDER_DIO2, sender_isr, CHANGE);
+            attachInterrupt(SIM_LINK_RECEIVER_DIO2, receiver_isr, CHANGE);
+        };
+        /*
+            Maps DIO2 of both to the AutoMode and attaches the interrupts,
+            which call poll() unless other functions are given; these can
+            reach the objects through sim_link_sender and sim_link_receiver.
+            Call receive() or idle() afterwards.
+        */
+
+        template <typename Done>
+        bool wait(Done done, uint32_t timeout_ms=100, uint32_t step_us=1000){
+            uint64_t deadline = simRFM69Now() + timeout_ms * 1000ULL * 1000;
+            while (!done()){
+                if (simRFM69Now() >= deadline){
+                    return false;
+                }
+                simRFM69Idle(step_us);
+            }
+            return true;
+        };
+        /*
+            Advances the simulated time, at most step_us at a time, until
+            done() returns true. Returns false if that took longer than
+            timeout_ms.
+        */
+
+        bool exchange(const void* payload, uint8_t len, uint32_t timeout_ms=100){
+            uint8_t packet[256];
+            sim_link_sender->sendVariable((void*) payload, len);
+            if (!this->wait([&](){return sim_link_receiver->available();}, timeout_ms)){
+                return false;
+            }
+            return (sim_link_receiver->read(packet) == len) && (memcmp(packet, payload, len) == 0);
+        };
+        /*
+            Sends payload with variable length and reads it on the receiver,
+            returns whether it arrived unchanged within timeout_ms.
+        */
+};
+
+//SIM_LINK_H
+#endif
@@ -0,0 +1,605 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <time.h>
+#include <string.h>
+#ifndef SIM_RFM69_NO_ARDUINO
+#include "Arduino.h"
+#include "SPI.h"
+#endif
+#include "simRFM69.h"
+
+// levels of the automode conditions.
+#define SIM_SIGNAL_FIFONOTEMPTY (1<<0)
+#define SIM_SIGNAL_FIFOLEVEL (1<<1)
+#define SIM_SIGNAL_CRCOK (1<<2)
+#define SIM_SIGNAL_PAYLOADREADY (1<<3)
+#define SIM_SIGNAL_PACKETSENT (1<<4)
+
+#ifndef SIM_RFM69_NO_ARDUINO
+simSerial Serial;
+SPIClass SPI;
+#endif
+
+static uint64_t sim_now = 0;
+static simRFM69* radios[SIM_RFM69_MAX_RADIOS] = {0};
+
+static void (*isr_functions[256])() = {0};
+static bool isr_pending[256] = {0};
+static uint64_t isr_host[256] = {0};
+static uint64_t isr_simulated[256] = {0};
+static uint32_t isr_count[256] = {0};
+static bool in_isr = false;
+static bool interrupts_enabled = true;
+
+static uint64_t hostNanoseconds(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+static void dispatchInterrupts(){
+    if (in_isr || !interrupts_enabled){
+        return;
+    }
+    // an interrupt may cause another edge, which runs after it returns.
+    bool again = true;
+    while (again){
+        again = false;
+        for (uint8_t i=0; i < SIM_RFM69_MAX_RADIOS; i++){
+            if (radios[i] == 0){
+                continue;
+            }
+            uint8_t pin = radios[i]->getDio2Pin();
+            if (!isr_pending[pin]){
+                continue;
+            }
+            isr_pending[pin] = false;
+            if (isr_functions[pin] == 0){
+                continue;
+            }
+            in_isr = true;
+            interrupts_enabled = false;
+            uint64_t start = hostNanoseconds();
+            uint64_t start_simulated = sim_now;
+            isr_functions[pin]();
+            isr_host[pin] += hostNanoseconds() - start;
+            isr_simulated[pin] += sim_now - start_simulated;
+            isr_count[pin]++;
+            interrupts_enabled = true; // by the return from the interrupt.
+            in_isr = false;
+            again = true;
+        }
+    }
+}
+
+static uint8_t modeLevel(uint8_t mode){
+    // sleep, standby, synthesizer, then transmitter and receiver.
+    switch (mode){
+        case (RFM69_MODE_SLEEP): return 0;
+        case (RFM69_MODE_STANDBY): return 1;
+        case (RFM69_MODE_FREQ_SYNTH): return 2;
+        default: return 3;
+    }
+}
+
+
+
+#ifndef SIM_RFM69_NO_ARDUINO
+/*
+        Arduino and SPI
+*/
+
+void pinMode(uint8_t, uint8_t){
+}
+
+void digitalWrite(uint8_t pin, uint8_t value){
+    for (uint8_t i=0; i < SIM_RFM69_MAX_RADIOS; i++){
+        if (radios[i] && (radios[i]->getCsPin() == pin)){
+            radios[i]->select(value == LOW);
+        }
+    }
+}
+
+int digitalRead(uint8_t pin){
+    for (uint8_t i=0; i < SIM_RFM69_MAX_RADIOS; i++){
+        if (radios[i] && (radios[i]->getDio2Pin() == pin)){
+            return radios[i]->getDio2() ? HIGH : LOW;
+        }
+    }
+    return HIGH;
+}
+
+uint32_t micros(){
+    return sim_now / 1000;
+}
+
+uint32_t millis(){
+    return sim_now / 1000000;
+}
+
+void delayMicroseconds(uint32_t us){
+    uint64_t until = sim_now + us * 1000ULL;
+    while (sim_now < until){
+        simRFM69Idle((until - sim_now + 999) / 1000);
+    }
+}
+
+void delay(uint32_t ms){
+    delayMicroseconds(ms * 1000);
+}
+
+long random(long max){
+    return (max > 0) ? (rand() % max) : 0;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int){
+    isr_functions[pin] = isr;
+}
+
+void noInterrupts(){
+    interrupts_enabled = false;
+}
+
+void interrupts(){
+    interrupts_enabled = true;
+    dispatchInterrupts();
+}
+
+bool simRFM69InterruptsEnabled(){
+    return interrupts_enabled;
+}
+
+uint8_t SPIClass::transfer(uint8_t data){
+    for (uint8_t i=0; i < SIM_RFM69_MAX_RADIOS; i++){
+        if (radios[i] && radios[i]->isSelected()){
+            return radios[i]->transfer(data);
+        }
+    }
+    return 0xFF; // nothing drives MISO.
+}
+
+void SPIClass::endTransaction(){
+    dispatchInterrupts();
+}
+
+// SIM_RFM69_NO_ARDUINO
+#endif
+
+
+
+/*
+        Simulation
+*/
+
+uint64_t simRFM69Now(){
+    return sim_now;
+}
+
+void simRFM69Idle(uint32_t max_us){
+    dispatchInterrupts();
+    uint64_t limit = sim_now + max_us * 1000ULL;
+    uint64_t next = SIM_RFM69_NEVER;
+    for (uint8_t i=0; i < SIM_RFM69_MAX_RADIOS; i++){
+        if (radios[i] && (radios[i]->nextEvent() < next)){
+            next = radios[i]->nextEvent();
+        }
+    }
+    if (next > limit){
+        sim_now = limit;
+    } else if (next > sim_now){
+        sim_now = next;
+    }
+    for (uint8_t i=0; i < SIM_RFM69_MAX_RADIOS; i++){
+        if (radios[i]){
+            radios[i]->process(sim_now);
+        }
+    }
+    dispatchInterrupts();
+}
+
+uint64_t simRFM69InterruptNanoseconds(uint8_t pin){
+    return isr_host[pin];
+}
+
+uint64_t simRFM69InterruptSimulated(uint8_t pin){
+    return isr_simulated[pin];
+}
+
+uint32_t simRFM69InterruptCount(uint8_t pin){
+    return isr_count[pin];
+}
+
+void simRFM69ClearInterruptStatistics(){
+    memset(isr_host, 0, sizeof(isr_host));
+    memset(isr_simulated, 0, sizeof(isr_simulated));
+    memset(isr_count, 0, sizeof(isr_count));
+}
+
+
+
+/*
+        Public Methods
+*/
+
+simRFM69::simRFM69(uint8_t cs_pin, uint8_t dio2_pin){
+    this->cs_pin = cs_pin;
+    this->dio2_pin = dio2_pin;
+    this->reach = 0xFF;
+    this->index = SIM_RFM69_MAX_RADIOS; // not on the air.
+    this->reset();
+    this->clearStatistics();
+    for (uint8_t i=0; i < SIM_RFM69_MAX_RADIOS; i++){
+        if (radios[i] == 0){
+            radios[i] = this;
+            this->index = i;
+            break;
+        }
+    }
+}
+
+simRFM69::~simRFM69(){
+    for (uint8_t i=0; i < SIM_RFM69_MAX_RADIOS; i++){
+        if (radios[i] == this){
+            radios[i] = 0;
+        }
+    }
+    isr_pending[this->dio2_pin] = false;
+    isr_functions[this->dio2_pin] = 0;
+}
+
+void simRFM69::reset(){
+    memset(this->regs, 0, sizeof(this->regs));
+    this->regs[RFM69_OPMODE] = RFM69_MODE_STANDBY;
+    this->regs[RFM69_BITRATE_MSB] = 0x1A;
+    this->regs[RFM69_BITRATE_LSB] = 0x0B;
+    this->regs[RFM69_PREAMBLE_LSB] = 0x03;
+    this->regs[RFM69_SYNC_CONFIG] = 0x98;
+    this->regs[RFM69_PACKET_CONFIG1] = 0x10;
+    this->regs[RFM69_PAYLOAD_LENGTH] = 0x40;
+    this->regs[RFM69_FIFO_THRESH] = 0x8F;
+    this->regs[RFM69_PACKET_CONFIG2] = 0x02;
+    this->regs[RFM69_VERSION] = 0x24;
+
+    this->fifo_read = 0;
+    this->fifo_count = 0;
+    this->selected = false;
+    this->first_byte = false;
+    this->address = 0;
+    this->writing = false;
+    this->mode = RFM69_MODE_STANDBY;
+    this->ready_at = 0;
+    this->automode = false;
+    this->signals = 0;
+    this->packet_sent = false;
+    this->payload_ready = false;
+    this->crc_error = false;
+    this->corrupt = 0;
+    this->tx_start = SIM_RFM69_NEVER;
+    this->tx_end = SIM_RFM69_NEVER;
+    this->tx_length = 0;
+    this->dio2 = false;
+}
+
+void simRFM69::clearStatistics(){
+    this->spi_bytes = 0;
+    this->spi_transactions = 0;
+    this->sent = 0;
+    this->received = 0;
+    this->missed = 0;
+}
+
+uint64_t simRFM69::airtime(uint8_t len){
+    uint8_t config = this->regs[RFM69_PACKET_CONFIG1];
+    uint8_t header = (config & RFM69_PACKET_CONFIG_LENGTH_VARIABLE) ? 1 : 0;
+    uint8_t address = (config & (0b11<<1)) ? 1 : 0;
+    uint32_t message = (len > (header + address)) ? (len - header - address) : 0;
+    if (this->regs[RFM69_PACKET_CONFIG2] & 1){
+        // AES works on blocks of 16 bytes.
+        message = (message + 15) / 16 * 16;
+    }
+    uint32_t payload = (header + address + message + ((config & RFM69_PACKET_CONFIG_CRC_ON) ? 2 : 0)) * 8;
+    if ((config & (0b11<<5)) == RFM69_PACKET_CONFIG_DC_FREE_MANCHESTER){
+        payload *= 2;
+    }
+    uint32_t preamble = (this->regs[RFM69_PREAMBLE_MSB] << 8) | this->regs[RFM69_PREAMBLE_LSB];
+    uint8_t sync = this->regs[RFM69_SYNC_CONFIG];
+    uint32_t sync_bytes = (sync & (1<<7)) ? (((sync >> 3) & 0b111) + 1) : 0;
+    uint64_t bits = (preamble + sync_bytes) * 8 + payload;
+
+    // a bit takes BitRate / 32 MHz seconds.
+    uint32_t divider = (this->regs[RFM69_BITRATE_MSB] << 8) | this->regs[RFM69_BITRATE_LSB];
+    return bits * divider * 125 / 4;
+}
+
+uint64_t simRFM69::nextEvent(){
+    if (this->mode != RFM69_MODE_TRANSMITTER){
+        return SIM_RFM69_NEVER;
+    }
+    return (this->tx_end == SIM_RFM69_NEVER) ? this->tx_start : this->tx_end;
+}
+
+void simRFM69::process(uint64_t now){
+    while (this->nextEvent() <= now){
+        if (this->tx_end == SIM_RFM69_NEVER){
+            this->startTx();
+        } else {
+            this->finishTx();
+        }
+    }
+}
+
+void simRFM69::select(bool enable){
+    if (enable && !this->selected){
+        this->first_byte = true;
+        this->spi_transactions++;
+        sim_now += SIM_RFM69_SPI_SELECT;
+    }
+    this->selected = enable;
+}
+
+uint8_t simRFM69::transfer(uint8_t data){
+    this->spi_bytes++;
+    sim_now += SIM_RFM69_SPI_BYTE;
+
+    if (this->first_byte){
+        this->first_byte = false;
+        this->writing = (data & RFM69_WRITE_REG_MASK) != 0;
+        this->address = data & RFM69_READ_REG_MASK;
+        return 0;
+    }
+
+    if (this->address == RFM69_FIFO){
+        if (this->writing){
+            if ((this->fifo_read + this->fifo_count) < SIM_RFM69_FIFO){
+                this->fifo[this->fifo_read + this->fifo_count++] = data;
+            }
+            this->update();
+            return 0;
+        }
+        uint8_t value = 0;
+        if (this->fifo_count){
+            value = this->fifo[this->fifo_read++];
+            this->fifo_count--;
+        }
+        if (this->fifo_count == 0){
+            this->fifo_read = 0;
+            this->payload_ready = false;
+        }
+        this->update();
+        return value;
+    }
+
+    uint8_t reg = this->address;
+    this->address = (this->address + 1) & RFM69_READ_REG_MASK;
+    if (this->writing){
+        this->writeRegister(reg, data);
+        return 0;
+    }
+    return this->readRegister(reg);
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+uint8_t simRFM69::readRegister(uint8_t reg){
+    bool ready = this->ready_at <= sim_now;
+    uint8_t flags = 0;
+    switch (reg){
+        case (RFM69_IRQ_FLAGS1):
+            flags |= ready ? RFM69_IRQ1_MODEREADY : 0;
+            flags |= (ready && (this->mode == RFM69_MODE_RECEIVER)) ? RFM69_IRQ1_RXREADY : 0;
+            flags |= (ready && (this->mode == RFM69_MODE_TRANSMITTER)) ? RFM69_IRQ1_TXREADY : 0;
+            flags |= (ready && (modeLevel(this->mode) >= 2)) ? RFM69_IRQ1_PLLLOCK : 0;
+            flags |= this->automode ? RFM69_IRQ1_AUTOMODE : 0;
+            return flags;
+        case (RFM69_IRQ_FLAGS2):
+            flags |= (this->fifo_count >= SIM_RFM69_FIFO) ? RFM69_IRQ2_FIFOFULL : 0;
+            flags |= (this->signals & SIM_SIGNAL_FIFONOTEMPTY) ? RFM69_IRQ2_FIFONOTEMPTY : 0;
+            flags |= (this->signals & SIM_SIGNAL_FIFOLEVEL) ? RFM69_IRQ2_FIFOLEVEL : 0;
+            flags |= this->packet_sent ? RFM69_IRQ2_PACKETSENT : 0;
+            flags |= this->payload_ready ? RFM69_IRQ2_PAYLOADREADY : 0;
+            flags |= (this->signals & SIM_SIGNAL_CRCOK) ? RFM69_IRQ2_CRCOK : 0;
+            return flags;
+        default:
+            return this->regs[reg];
+    }
+}
+
+void simRFM69::writeRegister(uint8_t reg, uint8_t value){
+    if ((reg == RFM69_IRQ_FLAGS1) || (reg == RFM69_IRQ_FLAGS2) || (reg == RFM69_VERSION)){
+        return;
+    }
+    this->regs[reg] = value;
+    this->update();
+}
+
+uint8_t simRFM69::requestedMode(){
+    if (this->automode){
+        switch (this->regs[RFM69_AUTO_MODES] & 0b11){
+            case (RFM69_AUTOMODE_INTERMEDIATEMODE_SLEEP): return RFM69_MODE_SLEEP;
+            case (RFM69_AUTOMODE_INTERMEDIATEMODE_STANDBY): return RFM69_MODE_STANDBY;
+            case (RFM69_AUTOMODE_INTERMEDIATEMODE_RECEIVER): return RFM69_MODE_RECEIVER;
+            default: return RFM69_MODE_TRANSMITTER;
+        }
+    }
+    uint8_t mode = this->regs[RFM69_OPMODE] & 0b11100;
+    return (mode > RFM69_MODE_RECEIVER) ? RFM69_MODE_STANDBY : mode;
+}
+
+void simRFM69::enterMode(uint8_t new_mode){
+    if (this->mode == RFM69_MODE_TRANSMITTER){
+        // leaving Tx aborts the frame on the air.
+        this->tx_start = SIM_RFM69_NEVER;
+        this->tx_end = SIM_RFM69_NEVER;
+    }
+
+    // continues from the previous transition if that was not done yet.
+    uint64_t base = (this->ready_at > sim_now) ? this->ready_at : sim_now;
+    uint8_t from = modeLevel(this->mode);
+    uint8_t to = modeLevel(new_mode);
+    uint64_t duration = 0;
+    if ((to >= 1) && (from < 1)){
+        duration += SIM_RFM69_OSCILLATOR;
+    }
+    if ((to >= 2) && (from < 2)){
+        duration += SIM_RFM69_SYNTHESIZER;
+    }
+    if (new_mode == RFM69_MODE_TRANSMITTER){
+        duration += SIM_RFM69_TX_RAMP;
+    }
+    if (new_mode == RFM69_MODE_RECEIVER){
+        duration += SIM_RFM69_RX_START;
+    }
+    this->ready_at = base + duration;
+    this->mode = new_mode;
+
+    if (new_mode == RFM69_MODE_TRANSMITTER){
+        this->tx_start = this->ready_at;
+    }
+}
+
+void simRFM69::update(){
+    uint8_t config = this->regs[RFM69_PACKET_CONFIG1];
+    uint8_t now = 0;
+    now |= (this->fifo_count > 0) ? SIM_SIGNAL_FIFONOTEMPTY : 0;
+    now |= (this->fifo_count > (this->regs[RFM69_FIFO_THRESH] & RFM69_READ_REG_MASK)) ? SIM_SIGNAL_FIFOLEVEL : 0;
+    now |= (this->payload_ready && (config & RFM69_PACKET_CONFIG_CRC_ON) && !this->crc_error) ? SIM_SIGNAL_CRCOK : 0;
+    now |= this->payload_ready ? SIM_SIGNAL_PAYLOADREADY : 0;
+    now |= this->packet_sent ? SIM_SIGNAL_PACKETSENT : 0;
+    uint8_t rising = now & ~this->signals;
+    uint8_t falling = this->signals & ~now;
+    this->signals = now;
+
+    uint8_t enter = this->regs[RFM69_AUTO_MODES] & (0b111<<5);
+    uint8_t exit = this->regs[RFM69_AUTO_MODES] & (0b111<<2);
+    if ((enter == RFM69_AUTOMODE_ENTER_NONE_AUTOMODES_OFF) || (exit == RFM69_AUTOMODE_EXIT_NONE_AUTOMODES_OFF)){
+        this->automode = false;
+    } else if (!this->automode){
+        switch (enter){
+            case (RFM69_AUTOMODE_ENTER_RISING_FIFONOTEMPTY): this->automode = rising & SIM_SIGNAL_FIFONOTEMPTY; break;
+            case (RFM69_AUTOMODE_ENTER_RISING_FIFOLEVEL): this->automode = rising & SIM_SIGNAL_FIFOLEVEL; break;
+            case (RFM69_AUTOMODE_ENTER_RISING_CRCOK): this->automode = rising & SIM_SIGNAL_CRCOK; break;
+            case (RFM69_AUTOMODE_ENTER_RISING_PAYLOADREADY): this->automode = rising & SIM_SIGNAL_PAYLOADREADY; break;
+            case (RFM69_AUTOMODE_ENTER_RISING_PACKETSENT): this->automode = rising & SIM_SIGNAL_PACKETSENT; break;
+            case (RFM69_AUTOMODE_ENTER_FALLING_FIFONOTEMPTY): this->automode = falling & SIM_SIGNAL_FIFONOTEMPTY; break;
+            default: break; // sync address is not simulated.
+        }
+    } else {
+        switch (exit){
+            case (RFM69_AUTOMODE_EXIT_FALLING_FIFONOTEMPTY): this->automode = !(falling & SIM_SIGNAL_FIFONOTEMPTY); break;
+            case (RFM69_AUTOMODE_EXIT_RISING_FIFOLEVEL_OR_TIMEOUT): this->automode = !(rising & SIM_SIGNAL_FIFOLEVEL); break;
+            case (RFM69_AUTOMODE_EXIT_RISING_CRCOK_OR_TIMEOUT): this->automode = !(rising & SIM_SIGNAL_CRCOK); break;
+            case (RFM69_AUTOMODE_EXIT_RISING_PAYLOADREADY_OR_TIMEOUT): this->automode = !(rising & SIM_SIGNAL_PAYLOADREADY); break;
+            case (RFM69_AUTOMODE_EXIT_RISING_PACKETSENT): this->automode = !(rising & SIM_SIGNAL_PACKETSENT); break;
+            default: break; // timeouts are not simulated.
+        }
+    }
+
+    uint8_t requested = this->requestedMode();
+    if (requested != this->mode){
+        this->enterMode(requested);
+    }
+
+    // PacketSent is cleared when Tx is left.
+    if (this->packet_sent && (this->mode != RFM69_MODE_TRANSMITTER)){
+        this->packet_sent = false;
+        this->signals &= ~SIM_SIGNAL_PACKETSENT;
+    }
+
+    bool level = false;
+    uint8_t mapping = this->regs[RFM69_DIO_MAPPING1] & (0b11 << RFM69_DIO_2_MAP_SHIFT);
+    if (mapping == RFM69_PACKET_DIO_2_AUTOMODE){
+        level = this->automode;
+    } else if (mapping == RFM69_PACKET_DIO_2_FIFO_NOT_EMPTY){
+        level = this->fifo_count > 0;
+    }
+    if (level != this->dio2){
+        this->dio2 = level;
+        isr_pending[this->dio2_pin] = true;
+    }
+}
+
+uint8_t simRFM69::frameLength(){
+    uint8_t len = 0;
+    if (this->regs[RFM69_PACKET_CONFIG1] & RFM69_PACKET_CONFIG_LENGTH_VARIABLE){
+        len = (this->fifo_count) ? (this->fifo[this->fifo_read] + 1) : 0;
+    } else {
+        len = this->regs[RFM69_PAYLOAD_LENGTH];
+    }
+    return (len > SIM_RFM69_FIFO) ? SIM_RFM69_FIFO : len;
+}
+
+void simRFM69::startTx(){
+    if (this->fifo_count == 0){
+        // only a preamble, until Tx is left.
+        this->tx_start = SIM_RFM69_NEVER;
+        return;
+    }
+    this->tx_length = this->frameLength();
+    this->tx_end = this->tx_start + this->airtime(this->tx_length);
+}
+
+void simRFM69::finishTx(){
+    uint8_t frame[SIM_RFM69_FIFO];
+    uint8_t len = (this->tx_length < this->fifo_count) ? this->tx_length : this->fifo_count;
+    memcpy(frame, &(this->fifo[this->fifo_read]), len);
+    uint64_t start = this->tx_start;
+
+    this->fifo_read = 0;
+    this->fifo_count = 0;
+    this->tx_start = SIM_RFM69_NEVER;
+    this->tx_end = SIM_RFM69_NEVER;
+    this->sent++;
+
+    for (uint8_t i=0; i < SIM_RFM69_MAX_RADIOS; i++){
+        if (radios[i] && (radios[i] != this) && (this->reach & (1<<i))){
+            radios[i]->deliver(&(this->regs[RFM69_FRF_MSB]), frame, len, start);
+        }
+    }
+
+    this->packet_sent = true;
+    this->update();
+}
+
+void simRFM69::deliver(const uint8_t* frf, const uint8_t* frame, uint8_t len, uint64_t start){
+    if (memcmp(frf, &(this->regs[RFM69_FRF_MSB]), 3) != 0){
+        return; // on another channel, not heard at all.
+    }
+    if ((this->mode != RFM69_MODE_RECEIVER) || (this->ready_at > start) || this->payload_ready || this->fifo_count){
+        this->missed++;
+        return;
+    }
+
+    uint8_t config = this->regs[RFM69_PACKET_CONFIG1];
+    uint8_t filter = config & (0b11<<1);
+    if (filter != RFM69_PACKET_CONFIG_ADDRESS_FILTER_NONE){
+        uint8_t address = frame[(config & RFM69_PACKET_CONFIG_LENGTH_VARIABLE) ? 1 : 0];
+        bool broadcast = (filter == RFM69_PACKET_CONFIG_ADDRESS_FILTER_NODE_BROADCAST) && (address == this->regs[RFM69_BROADCAST_ADRESS]);
+        if ((address != this->regs[RFM69_NODE_ADRESS]) && !broadcast){
+            return;
+        }
+    }
+
+    this->crc_error = false;
+    if (this->corrupt && (config & RFM69_PACKET_CONFIG_CRC_ON)){
+        this->corrupt--;
+        if ((config & RFM69_PACKET_CONFIG_CRC_FAIL_KEEP) == 0){
+            return; // cleared by the packet engine.
+        }
+        this->crc_error = true;
+    }
+
+    memcpy(this->fifo, frame, len);
+    this->fifo_read = 0;
+    this->fifo_count = len;
+    this->payload_ready = true;
+    this->received++;
+    this->update();
+}
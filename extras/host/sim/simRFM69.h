@@ -0,0 +1,190 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include "../../../bareRFM69_const.h"
+
+#ifndef SIM_RFM69_H
+#define SIM_RFM69_H
+
+/*
+    A simulated RFM69 for running the library on the host, behind the Arduino
+    and SPI shims in this folder. It models what plainRFM69 depends on:
+
+        - the registers, read and written over SPI, with the FIFO at 0x00.
+        - the modes, the sequencer with the times to switch between them, and
+          the automodes with their enter and exit conditions.
+        - the packet engine: fixed and variable length, address filtering, AES
+          padding and CRC as far as they change the time on the air. Data is
+          not whitened or encrypted; both ends of a link are simulated alike.
+        - the IRQ flags, and DIO2 mapped to the automode, which calls the
+          function attached with attachInterrupt().
+
+    All radios share the air; a packet is received by every radio with the
+    same Frf that was listening when it started and has room in its FIFO. There is no noise,
+    packets are only lost if the receiver was not ready, or corrupted on
+    request with corruptNext(). setReach() limits which radios hear another,
+    for topologies such as a line.
+
+    Time is simulated in nanoseconds. SPI transfers advance it by the time
+    they take at 10 MHz, the processor itself takes no time; interrupts run
+    at the first SPI transaction end or idle call after their edge, as they
+    would once the SPI bus is released. simRFM69Idle() advances the time to
+    the next event of any radio.
+
+    Compiled with SIM_RFM69_NO_ARDUINO the shims are left out and the radios
+    are driven through select() and transfer() directly, as the simulated
+    device of extras/linux does.
+*/
+
+// times in ns; typical values from the datasheet, with the default PaRamp.
+#define SIM_RFM69_SPI_BYTE 800
+#define SIM_RFM69_SPI_SELECT 200
+#define SIM_RFM69_OSCILLATOR (RFM69_TS_OSC * 1000ULL)
+#define SIM_RFM69_SYNTHESIZER (RFM69_TS_FS * 1000ULL)
+#define SIM_RFM69_TX_RAMP (RFM69_TS_TR * 1000ULL)
+#define SIM_RFM69_RX_START 60000
+
+#define SIM_RFM69_MAX_RADIOS 4
+#define SIM_RFM69_FIFO 66
+#define SIM_RFM69_NEVER 0xFFFFFFFFFFFFFFFFULL
+
+class simRFM69{
+    protected:
+        uint8_t cs_pin;
+        uint8_t dio2_pin;
+        uint8_t index;      // in the radios on the air.
+        uint8_t reach;      // bit per index of the radios that hear this one.
+
+        uint8_t regs[0x72];
+
+        uint8_t fifo[SIM_RFM69_FIFO];
+        uint8_t fifo_read;
+        uint8_t fifo_count;
+
+        // SPI transaction state.
+        bool selected;
+        bool first_byte;
+        uint8_t address;
+        bool writing;
+
+        uint8_t mode;       // mode being entered or in, RFM69_MODE_*.
+        uint64_t ready_at;  // time at which mode is ready.
+        bool automode;
+
+        uint8_t signals;    // levels of the automode conditions.
+        bool packet_sent;
+        bool payload_ready;
+        bool crc_error;     // of the frame in the FIFO.
+        uint8_t corrupt;    // frames still to be received with a wrong CRC.
+
+        uint64_t tx_start;
+        uint64_t tx_end;
+        uint8_t tx_length;  // bytes taken from the FIFO.
+        bool dio2;
+
+        uint32_t spi_bytes;
+        uint32_t spi_transactions;
+        uint32_t sent;
+        uint32_t received;
+        uint32_t missed;
+
+        void update();
+        /*
+            Evaluates the automode conditions and the mode, call after every
+            change of the FIFO, flags or registers.
+        */
+
+        void enterMode(uint8_t new_mode);
+        uint8_t requestedMode();
+
+        uint8_t readRegister(uint8_t reg);
+        void writeRegister(uint8_t reg, uint8_t value);
+
+        void startTx();
+        void finishTx();
+        void deliver(const uint8_t* frf, const uint8_t* frame, uint8_t len, uint64_t start);
+
+        uint8_t frameLength();
+        /*
+            Length of the frame as the packet engine takes it from the FIFO,
+            including the length byte.
+        */
+
+    public:
+        simRFM69(uint8_t cs_pin, uint8_t dio2_pin);
+        ~simRFM69();
+
+        void reset();
+        /*
+            Sets the registers to their defaults and clears the FIFO.
+        */
+
+        uint64_t airtime(uint8_t len);
+        /*
+            Time on the air of a frame of len bytes from the FIFO, in ns.
+        */
+
+        uint64_t nextEvent();
+        void process(uint64_t now);
+
+        void select(bool enable);
+        bool isSelected(){return this->selected;};
+        uint8_t transfer(uint8_t data);
+        bool getDio2(){return this->dio2;};
+        uint8_t getDio2Pin(){return this->dio2_pin;};
+        uint8_t getCsPin(){return this->cs_pin;};
+
+        uint32_t getSpiBytes(){return this->spi_bytes;};
+        uint32_t getSpiTransactions(){return this->spi_transactions;};
+        uint32_t getSent(){return this->sent;};
+        uint32_t getReceived(){return this->received;};
+        uint32_t getMissed(){return this->missed;};
+        /*
+            Bytes and transactions over SPI including the address byte,
+            frames sent, frames placed in the FIFO and frames that arrived
+            while this radio was not ready to receive them.
+        */
+
+        void clearStatistics();
+
+        uint8_t getIndex(){return this->index;};
+        void setReach(uint8_t mask){this->reach = mask;};
+        /*
+            The radios that hear the frames of this one, bit i being the radio
+            of getIndex() i; all of them by default, also after reset().
+        */
+
+        void corruptNext(uint8_t count){this->corrupt = count;};
+        /*
+            The next count frames for this radio arrive with a wrong CRC. With
+            CrcOn they are dropped, unless CrcAutoClearOff is set; then they
+            are received without CrcOk.
+        */
+};
+
+uint64_t simRFM69Now();
+/*
+    The simulated time in ns.
+*/
+
+void simRFM69Idle(uint32_t max_us);
+/*
+    Advances the time to the next event of a radio, but at most max_us, and
+    runs the interrupts it causes.
+*/
+
+uint64_t simRFM69InterruptNanoseconds(uint8_t pin);
+uint64_t simRFM69InterruptSimulated(uint8_t pin);
+uint32_t simRFM69InterruptCount(uint8_t pin);
+void simRFM69ClearInterruptStatistics();
+/*
+    Time spent in the interrupt attached to pin, measured on the host and in
+    simulated time (the SPI transfers), and the number of calls.
+*/
+
+//SIM_RFM69_H
+#endif
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Prints the fields of the register map that plainRFM69 configures, as a
+    diff of snapshotRFM69 against the radio after a reset, then checks the
+    warm restore on the simulated radios, see sim/simRFM69.h:
+
+        read        A snapshot is a single SPI transaction.
+        restore     After a reset of the radio, restore() brings back every
+                    writable bit, writing fewer transactions and bytes than
+                    configuring it again; the receiver then receives.
+        diff        A second restore writes nothing, the fields of a changed
+                    register are found by diffFields().
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -I sim -I ../.. -o snapshot_dump snapshot_dump.cpp \
+            sim/simRFM69.cpp ../../bareRFM69.cpp ../../plainRFM69.cpp \
+            ../../snapshotRFM69.cpp
+        ./snapshot_dump
+*/
+
+#include <stdio.h>
+#include "sim/simLink.h"
+#include "../../snapshotRFM69.h"
+
+#define LENGTH 16
+
+static void setup(plainRFM69& rfm){
+    rfm.setRecommended();
+    rfm.setPacketType(true, false);
+    rfm.setBufferSize(2);
+    rfm.setPacketLength(LENGTH);
+    rfm.baud300000();
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+    rfm.receive();
+}
+
+static void printFields(const snapshotRFM69& before, const snapshotRFM69& after){
+    uint8_t changed[255];
+    uint8_t count = after.diffFields(before, changed, sizeof(changed));
+    snapshotRFM69Field a;
+    snapshotRFM69Field b;
+    printf("%-4s %-20s %10s %10s\n", "reg", "field", "reset", "configured");
+    for (uint8_t i=0; i < count; i++){
+        before.field(changed[i], &b);
+        after.field(changed[i], &a);
+        printf("0x%02X %-20s %10u %10u\n", a.reg, a.name, b.value, a.value);
+    }
+    printf("\n");
+}
+
+static bool sameWritable(const snapshotRFM69& a, const snapshotRFM69& b){
+    bool same = true;
+    for (uint8_t reg=RFM69_SNAPSHOT_FIRST; reg <= RFM69_SNAPSHOT_LAST; reg++){
+        same &= ((a.get(reg) ^ b.get(reg)) & snapshotRFM69::getWritableBits(reg)) == 0;
+    }
+    return same;
+}
+
+int main(int, char*[]){
+    bool ok = true;
+    simLink link;
+    simRFM69& receiver_radio = link.receiver_radio;
+    plainRFM69 sender(SIM_LINK_SENDER_CS);
+    plainRFM69 receiver(SIM_LINK_RECEIVER_CS);
+
+    snapshotRFM69 reset;
+    reset.read(&receiver);
+
+    // the cost of configuring the radio from its reset values.
+    receiver_radio.clearStatistics();
+    setup(receiver);
+    uint32_t setup_transactions = receiver_radio.getSpiTransactions();
+    uint32_t setup_bytes = receiver_radio.getSpiBytes();
+    setup(sender);
+    link.attach(&sender, &receiver);
+    delay(1);
+
+    snapshotRFM69 configured;
+    receiver_radio.clearStatistics();
+    configured.read(&receiver);
+    ok &= check("read is one transaction", (receiver_radio.getSpiTransactions() == 1) && (receiver_radio.getSpiBytes() == RFM69_SNAPSHOT_SIZE + 1));
+    printFields(reset, configured);
+
+    // the radio loses its settings, the library does not.
+    receiver_radio.reset();
+    snapshotRFM69 now;
+    now.read(&receiver);
+    receiver_radio.clearStatistics();
+    uint8_t bursts = configured.restore(&receiver, &now);
+    uint32_t restore_transactions = receiver_radio.getSpiTransactions();
+    uint32_t restore_bytes = receiver_radio.getSpiBytes();
+    receiver.receive();
+    delay(1);
+
+    snapshotRFM69 restored;
+    restored.read(&receiver);
+    ok &= check("restore brings back the writable registers", sameWritable(configured, restored));
+    ok &= check("restore is cheaper than configuring again", (restore_transactions < setup_transactions) && (restore_bytes < setup_bytes));
+    uint8_t payload[LENGTH - 1];
+    memset(payload, 0x5A, sizeof(payload));
+    ok &= check("restore the receiver receives again", link.exchange(payload, sizeof(payload)));
+
+    printf("configure: %3u transactions, %4u bytes\n", setup_transactions, setup_bytes);
+    printf("restore:   %3u transactions, %4u bytes, %u bursts\n", restore_transactions, restore_bytes, bursts);
+
+    // the full restore writes the same, without knowing the radio.
+    receiver_radio.reset();
+    receiver_radio.clearStatistics();
+    bursts = configured.restore(&receiver);
+    printf("full:      %3u transactions, %4u bytes, %u bursts\n", receiver_radio.getSpiTransactions(), receiver_radio.getSpiBytes(), bursts);
+    printf("read:        1 transaction,  %4u bytes\n", RFM69_SNAPSHOT_SIZE + 1);
+    restored.read(&receiver);
+    ok &= check("restore without current writes everything", sameWritable(configured, restored));
+
+    // nothing is written when nothing changed, a change is found by field.
+    ok &= check("diff restore onto itself writes nothing", configured.restore(&receiver, &restored) == 0);
+    snapshotRFM69 changed = configured;
+    changed.set(RFM69_RX_BW, (configured.get(RFM69_RX_BW) & 0x1F) | (0x07 << 5));
+    uint8_t registers[4];
+    uint8_t fields[4];
+    snapshotRFM69Field field;
+    bool found = (changed.diff(configured, registers, sizeof(registers)) == 1) && (registers[0] == RFM69_RX_BW);
+    found &= changed.diffFields(configured, fields, sizeof(fields)) == 1;
+    found &= changed.field(fields[0], &field) && (strcmp(field.name, "DccFreq") == 0) && (field.value == 7);
+    ok &= check("diff finds the changed field", found);
+
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Prints the modulations profileRFM69Solve() computes for a range of
+    bitrates, with the rates they give and their errors, after checking it:
+
+        solve       Every bitrate from 1.2 to 300 kbps solves to a modulation
+                    that passes profileRFM69CheckModulation(), within 0.5% of
+                    the bitrate, also with an offset of 17 kHz.
+        link        Two simulated radios, see sim/simRFM69.h, exchange packets
+                    at 38400 and 250000 bps.
+
+    The first argument is the offset between the radios in Hz, the second the
+    modulation index times 100; by default 0 and 200.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -I sim -I ../.. -o solver_table solver_table.cpp \
+            sim/simRFM69.cpp ../../bareRFM69.cpp ../../plainRFM69.cpp
+        ./solver_table 17000 200
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim/simLink.h"
+
+#define FREQUENCY 868000000
+#define LENGTH 16
+
+// evaluated by the compiler.
+constexpr profileRFM69Modulation m38400 = profileRFM69Solve(38400);
+static_assert(profileRFM69CheckModulation(m38400) == RFM69_PROFILE_OK, "38400");
+static_assert(profileRFM69Solve(4800).bitrate == RFM69_AIRTIME_BITRATE_4800, "4800");
+static_assert(profileRFM69Solve(300000).bitrate == RFM69_AIRTIME_BITRATE_300000, "300000");
+static_assert(profileRFM69Describe(profileRFM69Solve(300000), 300000).error == RFM69_PROFILE_OK, "300000 check");
+static_assert(profileRFM69Solve(9600, 100).low_beta_offset != 0, "low beta");
+static_assert(profileRFM69CheckModulation(profileRFM69Solve(800)) == RFM69_PROFILE_BITRATE, "below 1.2 kbps");
+
+static const uint32_t rates[] = {1200, 2400, 4800, 9600, 19200, 38400, 57600, 76800, 100000, 115200, 153600, 200000, 250000, 300000};
+
+static bool solvesAll(uint32_t offset_hz){
+    bool ok = true;
+    for (uint32_t bps=1200; bps <= 300000; bps += 37){
+        profileRFM69Solution s = profileRFM69Describe(profileRFM69Solve(bps, 200, RFM69_PROFILE_SHAPING_AUTO, offset_hz), bps);
+        ok &= (s.error == RFM69_PROFILE_OK) && (labs(s.bitrate_ppm) <= 5000);
+    }
+    return ok;
+}
+
+static bool checkLink(uint32_t bps){
+    simLink link;
+    plainRFM69 sender(SIM_LINK_SENDER_CS);
+    plainRFM69 receiver(SIM_LINK_RECEIVER_CS);
+    profileRFM69 profile = profileRFM69Make(FREQUENCY, profileRFM69Solve(bps), profileRFM69Packet(true, false, false));
+    plainRFM69* both[2] = {&sender, &receiver};
+    bool ok = true;
+    for (uint8_t i=0; i < 2; i++){
+        ok &= both[i]->setProfile(profile);
+        both[i]->setBufferSize(2);
+        both[i]->setPacketLength(LENGTH);
+    }
+    link.attach(&sender, &receiver);
+    sender.receive();
+    receiver.receive();
+    delay(1);
+
+    uint8_t payload[LENGTH];
+    uint8_t received = 0;
+    for (uint8_t n=0; n < 4; n++){
+        memset(payload, n, sizeof(payload));
+        received += link.exchange(payload, sizeof(payload), 200);
+    }
+    return ok && (received == 4);
+}
+
+static const char* shapingName(uint8_t shaping){
+    switch (shaping){
+        case (RFM69_DATAMODUL_SHAPING_GFSK_BT_1_0): return "BT 1.0";
+        case (RFM69_DATAMODUL_SHAPING_GFSK_BT_0_5): return "BT 0.5";
+        case (RFM69_DATAMODUL_SHAPING_GFSK_BT_0_3): return "BT 0.3";
+    }
+    return "none";
+}
+
+int main(int argc, char* argv[]){
+    uint32_t offset_hz = (argc > 1) ? strtoul(argv[1], 0, 10) : 0;
+    uint16_t beta_percent = (argc > 2) ? strtoul(argv[2], 0, 10) : 200;
+
+    bool ok = true;
+    ok &= check("solve 1.2 to 300 kbps pass the checks", solvesAll(0));
+    ok &= check("solve with an offset of 17 kHz", solvesAll(17000));
+    ok &= check("link 38400 bps", checkLink(38400));
+    ok &= check("link 250000 bps", checkLink(250000));
+
+    printf("offset %u Hz, beta %u.%02u\n", offset_hz, beta_percent / 100, beta_percent % 100);
+    printf("%7s %7s %6s %7s %5s %7s %6s %7s %6s %6s %s\n", "target", "bps", "ppm", "fdev", "beta", "rxbw", "dcc", "afcbw", "beta-o", "shape", "check");
+    for (uint32_t bps : rates){
+        profileRFM69Modulation m = profileRFM69Solve(bps, beta_percent, RFM69_PROFILE_SHAPING_AUTO, offset_hz);
+        profileRFM69Solution s = profileRFM69Describe(m, bps);
+        printf("%7u %7u %6d %7u %2u.%02u %7u %6u %7u %6u %6s %u\n", bps, s.bitrate_hz, s.bitrate_ppm, s.fdev_hz,
+            s.beta_percent / 100, s.beta_percent % 100, s.rx_bw_hz, s.dcc_hz, s.afc_bw_hz, s.low_beta_offset_hz,
+            shapingName(m.shaping), s.error);
+    }
+    return (ok) ? 0 : 1;
+}
@@ -0,0 +1,532 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Prints the trace of plainRFM69, see traceRFM69.h, as a timeline with one
+    entry per line:
+        time(us) delta(us) type state details
+
+    Followed by histograms of the latency from the edge of the DIO pin until
+    poll() starts, and of the time spent in poll().
+
+    With a serial port, it reads the records written by trace.dump() on the
+    microcontroller, see the Trace example; the second argument is the number
+    of clock ticks per microsecond, 1 for micros(). The histograms are printed
+    every 256 polls, and when the stream ends.
+
+    Without arguments, it traces two simulated radios, see sim/simRFM69.h,
+    exchanging packets; with poll() in the interrupt and with poll() called
+    from the loop after traceEdge(). It checks:
+
+        isr         Every poll() has its start and end in the trace, the
+                    sender enters sending and returns to receiving for every
+                    packet, the receiver reads every packet from the FIFO.
+        loop        Every poll() follows an edge, the latency is at most the
+                    longest time between two checks of the loop.
+        drain       Draining from the loop drops no entries.
+        full        A ring that is not drained keeps its oldest entries and
+                    counts the dropped ones.
+        dump        The records of dump() decode to the entries that were in
+                    the ring.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -I sim -I ../.. -o trace_dump trace_dump.cpp \
+            sim/simRFM69.cpp ../../bareRFM69.cpp ../../plainRFM69.cpp \
+            ../../traceRFM69.cpp ../../frameRFM69.cpp
+        ./trace_dump
+        ./trace_dump /dev/ttyACM0 1
+*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+#include "sim/simLink.h"
+#include "gatewayDecoder.h"
+#include "../../plainRFM69.h"
+#include "../../traceRFM69.h"
+
+#define LENGTH 16
+#define PACKETS 32
+#define LOOP_US 100
+
+// histogram bins of a power of two microseconds each, the last collects the rest.
+#define BINS 12
+#define HISTOGRAM_EVERY 256
+
+//###########################################################################
+// Rendering
+//###########################################################################
+
+static const char* typeName(uint8_t type){
+    switch (type){
+        case (RFM69_TRACE_EDGE): return "edge";
+        case (RFM69_TRACE_POLL): return "poll";
+        case (RFM69_TRACE_DONE): return "done";
+        case (RFM69_TRACE_RX_FIFO): return "rx_fifo";
+        case (RFM69_TRACE_DISCARD): return "discard";
+        case (RFM69_TRACE_TX_FIFO): return "tx_fifo";
+        case (RFM69_TRACE_STATE): return "state";
+    }
+    return "?";
+}
+
+static const char* stateName(uint8_t state){
+    switch (state){
+        case (RFM69_PLAIN_STATE_RECEIVING): return "receiving";
+        case (RFM69_PLAIN_STATE_SENDING): return "sending";
+        case (RFM69_PLAIN_STATE_IDLE): return "idle";
+    }
+    return "?";
+}
+
+struct traceHistogram {
+    const char* name;
+    uint32_t bins[BINS];
+    uint32_t count;
+    uint32_t maximum;
+
+    void add(uint32_t us){
+        uint8_t bin = 0;
+        while ((bin < BINS - 1) && (us >= (1UL << bin))){
+            bin++;
+        }
+        this->bins[bin]++;
+        this->count++;
+        this->maximum = (us > this->maximum) ? us : this->maximum;
+    }
+
+    void print() const {
+        printf("%s, %u samples, at most %u us\n", this->name, this->count, this->maximum);
+        uint32_t largest = 1;
+        for (uint8_t i=0; i < BINS; i++){
+            largest = (this->bins[i] > largest) ? this->bins[i] : largest;
+        }
+        for (uint8_t i=0; i < BINS; i++){
+            uint32_t low = (i == 0) ? 0 : (1UL << (i - 1));
+            if (i == BINS - 1){
+                printf("  >= %4u us %7u ", low, this->bins[i]);
+            } else {
+                printf("  < %5lu us %7u ", 1UL << i, this->bins[i]);
+            }
+            for (uint32_t j=0; j < (this->bins[i] * 50 + largest - 1) / largest; j++){
+                printf("#");
+            }
+            printf("\n");
+        }
+    }
+};
+
+class traceView{
+    public:
+        uint32_t ticks_per_us;
+        bool timeline;
+
+        traceHistogram latency;
+        traceHistogram duration;
+
+        // the entries seen, and what is left unmatched.
+        uint32_t entries;
+        uint32_t polls;
+        uint32_t unmatched;
+
+        traceView(uint32_t ticks_per_us, bool timeline){
+            this->ticks_per_us = ticks_per_us;
+            this->timeline = timeline;
+            this->latency = {"latency from the edge to poll()", {0}, 0, 0};
+            this->duration = {"time spent in poll()", {0}, 0, 0};
+            this->entries = 0;
+            this->polls = 0;
+            this->unmatched = 0;
+            this->in_poll = false;
+            this->after_edge = false;
+        };
+
+        void add(const traceRFM69Entry& entry){
+            uint32_t time = entry.time;
+            if (this->timeline){
+                printf("%10u %+8d %-8s %-9s ", time / this->ticks_per_us, (this->entries == 0) ? 0 : this->since(this->last, time),
+                       typeName(entry.type), stateName(entry.state));
+            }
+            switch (entry.type){
+                case (RFM69_TRACE_EDGE):
+                    this->after_edge = true;
+                    this->edge = time;
+                    break;
+                case (RFM69_TRACE_POLL):
+                    this->unmatched += this->in_poll;
+                    this->in_poll = true;
+                    this->start = time;
+                    if (this->after_edge){
+                        this->latency.add(this->since(this->edge, time));
+                        this->detail("latency %u us", this->since(this->edge, time));
+                    }
+                    this->after_edge = false;
+                    break;
+                case (RFM69_TRACE_DONE):
+                    this->unmatched += !this->in_poll;
+                    if (this->in_poll){
+                        this->duration.add(this->since(this->start, time));
+                        this->detail("IrqFlags1 0x%02X, %u us in poll()", entry.flags, this->since(this->start, time));
+                    }
+                    this->in_poll = false;
+                    this->polls++;
+                    break;
+                case (RFM69_TRACE_STATE):
+                    this->detail("-> %s", stateName(entry.value));
+                    break;
+                default:
+                    this->detail("%u bytes", entry.value);
+            }
+            if (this->timeline){
+                printf("\n");
+            }
+            this->last = time;
+            this->entries++;
+        };
+
+        void print(){
+            this->latency.print();
+            this->duration.print();
+        };
+
+    protected:
+        bool in_poll;
+        bool after_edge;
+        uint32_t edge;
+        uint32_t start;
+        uint32_t last;
+
+        int32_t since(uint32_t from, uint32_t to){
+            // the ticks wrap around at 2^32, their difference does not.
+            return ((int32_t) (to - from)) / (int32_t) this->ticks_per_us;
+        };
+
+        template <typename... Args>
+        void detail(const char* format, Args... args){
+            if (this->timeline){
+                printf(format, args...);
+            }
+        };
+};
+
+//###########################################################################
+// Serial port
+//###########################################################################
+
+static int dumpSerial(const char* device, uint32_t ticks_per_us){
+    int fd = open(device, O_RDONLY | O_NOCTTY);
+    if (fd < 0){
+        perror("open");
+        return 1;
+    }
+
+    struct termios tty;
+    if (tcgetattr(fd, &tty) == 0){
+        cfmakeraw(&tty);
+        cfsetspeed(&tty, B115200);
+        tcsetattr(fd, TCSANOW, &tty);
+    }
+
+    traceView view(ticks_per_us, true);
+    gatewayDecoder<> decoder;
+    uint16_t dropped = 0;
+    uint32_t printed = 0;
+    while (true){
+        ssize_t n = read(fd, decoder.writePointer(), decoder.writeSpace());
+        if (n <= 0){
+            break;
+        }
+        decoder.commitRecords(n, [&](const uint8_t* record, uint16_t record_length){
+            frameRFM69Trace trace;
+            if (!frameRFM69ParseTrace(record, record_length, &trace)){
+                return false;
+            }
+            if (trace.dropped != dropped){
+                printf("%u entries dropped by the ring\n", (uint16_t) (trace.dropped - dropped));
+                dropped = trace.dropped;
+            }
+            traceRFM69Entry entry;
+            for (uint8_t i=0; i < trace.count; i++){
+                traceRFM69::unpack(&(trace.entries[i * RFM69_FRAME_TRACE_ENTRY]), &entry);
+                view.add(entry);
+            }
+            return true;
+        });
+        if (view.polls >= printed + HISTOGRAM_EVERY){
+            printed = view.polls;
+            view.print();
+        }
+        fflush(stdout);
+    }
+    view.print();
+
+    close(fd);
+    return 0;
+}
+
+//###########################################################################
+// Simulation
+//###########################################################################
+
+static bool poll_in_isr = true;
+static volatile bool sender_pending = false;
+static volatile bool receiver_pending = false;
+
+static void interruptSender(){
+    sim_link_sender->traceEdge();
+    if (poll_in_isr){
+        sim_link_sender->poll();
+    } else {
+        sender_pending = true;
+    }
+}
+
+static void interruptReceiver(){
+    sim_link_receiver->traceEdge();
+    if (poll_in_isr){
+        sim_link_receiver->poll();
+    } else {
+        receiver_pending = true;
+    }
+}
+
+struct simTrace {
+    std::vector<traceRFM69Entry> sender;
+    std::vector<traceRFM69Entry> receiver;
+    uint16_t dropped;
+    uint8_t received;
+
+    // the longest time between two checks for an edge in the loop.
+    uint32_t longest_us;
+};
+
+static void drainInto(traceRFM69& trace, std::vector<traceRFM69Entry>& entries){
+    traceRFM69Entry drained[RFM69_TRACE_SIZE];
+    uint8_t count = trace.drain(drained, RFM69_TRACE_SIZE);
+    entries.insert(entries.end(), drained, drained + count);
+}
+
+static simTrace runLink(bool in_isr){
+    simLink link;
+    plainRFM69 sender(SIM_LINK_SENDER_CS);
+    plainRFM69 receiver(SIM_LINK_RECEIVER_CS);
+    traceRFM69 sender_trace;
+    traceRFM69 receiver_trace;
+    poll_in_isr = in_isr;
+    sender_pending = false;
+    receiver_pending = false;
+
+    plainRFM69* both[2] = {&sender, &receiver};
+    for (uint8_t i=0; i < 2; i++){
+        both[i]->setRecommended();
+        both[i]->setPacketType(true, false);
+        both[i]->setBufferSize(2);
+        both[i]->setPacketLength(LENGTH);
+        both[i]->baud153600();
+    }
+    link.attach(&sender, &receiver, interruptSender, interruptReceiver);
+    sender.receive();
+    receiver.receive();
+    delay(1);
+    sender.setTrace(&sender_trace);
+    receiver.setTrace(&receiver_trace);
+
+    simTrace result;
+    result.received = 0;
+    uint64_t longest = 0;
+    uint64_t checked = simRFM69Now();
+    uint8_t payload[LENGTH];
+    uint8_t packet[LENGTH];
+    for (uint8_t n=0; n < PACKETS; n++){
+        memset(payload, n, sizeof(payload));
+        sender.sendVariable(payload, sizeof(payload));
+        bool sent = false;
+        bool received = false;
+        link.wait([&](){
+            // the loop, polls the radios that had an edge.
+            longest = (simRFM69Now() - checked > longest) ? (simRFM69Now() - checked) : longest;
+            checked = simRFM69Now();
+            if (sender_pending){
+                sender_pending = false;
+                sender.poll();
+            }
+            if (receiver_pending){
+                receiver_pending = false;
+                receiver.poll();
+            }
+            drainInto(sender_trace, result.sender);
+            drainInto(receiver_trace, result.receiver);
+            sent = sender.canSend();
+            if (receiver.available()){
+                uint8_t len = receiver.read(packet);
+                result.received += (len == sizeof(payload)) && (memcmp(packet, payload, len) == 0);
+                received = true;
+            }
+            return sent && received;
+        }, 100, LOOP_US);
+    }
+    delay(1);
+    drainInto(sender_trace, result.sender);
+    drainInto(receiver_trace, result.receiver);
+    result.dropped = sender_trace.getDropped() + receiver_trace.getDropped();
+    result.longest_us = (longest + 999) / 1000;
+    sender.setTrace(0);
+    receiver.setTrace(0);
+    return result;
+}
+
+static uint32_t countType(const std::vector<traceRFM69Entry>& entries, uint8_t type, uint8_t value){
+    uint32_t count = 0;
+    for (const traceRFM69Entry& entry : entries){
+        count += (entry.type == type) && (entry.value == value);
+    }
+    return count;
+}
+
+static bool pollsMatched(const std::vector<traceRFM69Entry>& entries, uint32_t* polls){
+    traceView view(1, false);
+    for (const traceRFM69Entry& entry : entries){
+        view.add(entry);
+    }
+    *polls = view.polls;
+    return (view.unmatched == 0) && (view.duration.count == view.polls);
+}
+
+static bool latencyBounded(const std::vector<traceRFM69Entry>& entries, uint32_t longest_us, bool* every_poll_after_edge){
+    traceView view(1, false);
+    for (const traceRFM69Entry& entry : entries){
+        view.add(entry);
+    }
+    *every_poll_after_edge = (view.latency.count == view.polls);
+    // the edge is marked between two checks of the loop, poll() follows the
+    // second; plus one for micros() rounding down.
+    return view.latency.maximum <= longest_us + 1;
+}
+
+static bool checkFull(){
+    traceRFM69 trace;
+    for (uint32_t i=0; i < RFM69_TRACE_SIZE + 10; i++){
+        trace.record(i, RFM69_TRACE_POLL, RFM69_PLAIN_STATE_RECEIVING, 0, 0);
+    }
+    traceRFM69Entry entry;
+    bool ok = (trace.available() == RFM69_TRACE_SIZE - 1) && (trace.getDropped() == 11);
+    ok &= trace.read(&entry) && (entry.time == 0);
+    trace.record(1000, RFM69_TRACE_DONE, RFM69_PLAIN_STATE_IDLE, 0xD8, 0);
+    traceRFM69Entry entries[RFM69_TRACE_SIZE];
+    uint8_t count = trace.drain(entries, RFM69_TRACE_SIZE);
+    ok &= (count == RFM69_TRACE_SIZE - 1) && (entries[count - 1].time == 1000) && (entries[count - 1].flags == 0xD8);
+    return ok && (trace.available() == 0) && !trace.read(&entry);
+}
+
+static bool checkDump(){
+    traceRFM69 trace;
+    std::vector<traceRFM69Entry> expected;
+    for (uint32_t i=0; i < 20; i++){
+        traceRFM69Entry entry = {0xFF000000 | (i * 7919), (uint8_t) (1 + i % 7), (uint8_t) (i % 3), (uint8_t) (i * 3), (uint8_t) (i == 4 ? 0 : i)};
+        trace.record(entry.time, entry.type, entry.state, entry.flags, entry.value);
+        expected.push_back(entry);
+    }
+
+    // as a stream over the serial port.
+    uint8_t out[RFM69_TRACE_DUMP_ENCODED(RFM69_TRACE_DUMP)];
+    std::vector<uint8_t> stream;
+    uint16_t len;
+    while ((len = trace.dump(out)) != 0){
+        stream.insert(stream.end(), out, out + len);
+    }
+
+    gatewayDecoder<> decoder;
+    memcpy(decoder.writePointer(), stream.data(), stream.size());
+    std::vector<traceRFM69Entry> decoded;
+    uint32_t records = 0;
+    decoder.commitRecords(stream.size(), [&](const uint8_t* record, uint16_t record_length){
+        frameRFM69Trace parsed;
+        if (!frameRFM69ParseTrace(record, record_length, &parsed)){
+            return false;
+        }
+        records++;
+        traceRFM69Entry entry;
+        for (uint8_t i=0; i < parsed.count; i++){
+            traceRFM69::unpack(&(parsed.entries[i * RFM69_FRAME_TRACE_ENTRY]), &entry);
+            decoded.push_back(entry);
+        }
+        return true;
+    });
+
+    bool same = (decoded.size() == expected.size()) && (records == (expected.size() + RFM69_TRACE_DUMP - 1) / RFM69_TRACE_DUMP);
+    for (uint32_t i=0; same && (i < expected.size()); i++){
+        same &= (memcmp(&(decoded[i]), &(expected[i]), sizeof(traceRFM69Entry)) == 0);
+    }
+    return same;
+}
+
+static int runChecks(){
+    bool ok = true;
+
+    simTrace isr = runLink(true);
+    uint32_t sender_polls;
+    uint32_t receiver_polls;
+    ok &= check("isr every packet received", isr.received == PACKETS);
+    ok &= check("isr every poll() starts and ends", pollsMatched(isr.sender, &sender_polls) && pollsMatched(isr.receiver, &receiver_polls));
+    ok &= check("isr sender enters sending for every packet", countType(isr.sender, RFM69_TRACE_STATE, RFM69_PLAIN_STATE_SENDING) == PACKETS);
+    ok &= check("isr sender returns to receiving for every packet", countType(isr.sender, RFM69_TRACE_STATE, RFM69_PLAIN_STATE_RECEIVING) == PACKETS);
+    ok &= check("isr sender writes every packet to the FIFO", countType(isr.sender, RFM69_TRACE_TX_FIFO, LENGTH + 1) == PACKETS);
+    ok &= check("isr receiver reads every packet from the FIFO", countType(isr.receiver, RFM69_TRACE_RX_FIFO, LENGTH + 1) == PACKETS);
+
+    simTrace loop = runLink(false);
+    bool after_edge = false;
+    ok &= check("loop every packet received", loop.received == PACKETS);
+    bool bounded = latencyBounded(loop.sender, loop.longest_us, &after_edge);
+    bool followed = after_edge;
+    bounded &= latencyBounded(loop.receiver, loop.longest_us, &after_edge);
+    followed &= after_edge;
+    ok &= check("loop every poll() follows an edge", followed);
+    ok &= check("loop latency at most the period of the loop", bounded);
+
+    ok &= check("drain no entries dropped", (isr.dropped == 0) && (loop.dropped == 0));
+    ok &= check("full keeps the oldest and counts the dropped", checkFull());
+    ok &= check("dump records decode to the same entries", checkDump());
+
+    // the timeline of the first packet, and the histograms of both ways.
+    printf("sender, poll() in the interrupt, the first packet:\n");
+    traceView timeline(1, true);
+    for (uint32_t i=0; (i < isr.sender.size()) && (timeline.polls < 3); i++){
+        timeline.add(isr.sender[i]);
+    }
+    printf("\nreceiver, poll() in the interrupt, the first packet:\n");
+    traceView receiver_timeline(1, true);
+    for (uint32_t i=0; (i < isr.receiver.size()) && (receiver_timeline.polls < 2); i++){
+        receiver_timeline.add(isr.receiver[i]);
+    }
+
+    simTrace* traces[2] = {&isr, &loop};
+    for (uint8_t i=0; i < 2; i++){
+        if (i == 0){
+            printf("\npoll() in the interrupt, %u packets:\n", PACKETS);
+        } else {
+            printf("\npoll() from the loop, at most %u us apart, %u packets:\n", loop.longest_us, PACKETS);
+        }
+        traceView view(1, false);
+        for (const traceRFM69Entry& entry : traces[i]->sender){
+            view.add(entry);
+        }
+        for (const traceRFM69Entry& entry : traces[i]->receiver){
+            view.add(entry);
+        }
+        view.print();
+    }
+    return (ok) ? 0 : 1;
+}
+
+int main(int argc, char* argv[]){
+    if (argc > 1){
+        uint32_t ticks_per_us = (argc > 2) ? strtoul(argv[2], 0, 10) : 1;
+        return dumpSerial(argv[1], (ticks_per_us == 0) ? 1 : ticks_per_us);
+    }
+    return runChecks();
+}
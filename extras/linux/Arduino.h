@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#ifndef LINUX_ARDUINO_H
+#define LINUX_ARDUINO_H
+
+/*
+    The part of the Arduino API used by the library, for running it on Linux
+    with linuxRFM69.h. Time is the monotonic clock of the host, the chip
+    select pins are those of the radios registered with linuxRFM69; other
+    pins are not driven.
+
+    noInterrupts() and interrupts() take and release the lock of the radios,
+    which the thread of linuxRFM69 holds while it calls poll().
+*/
+
+#define HIGH 1
+#define LOW 0
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define HEX 16
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+uint32_t micros();
+uint32_t millis();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+long random(long max);
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void noInterrupts();
+void interrupts();
+
+class linuxSerial{
+    public:
+        void begin(uint32_t){};
+        void print(const char* s){printf("%s", s);};
+        void print(long v, int base=10){printf((base == HEX) ? "%lx" : "%ld", v);};
+        void print(int v, int base=10){this->print((long) v, base);};
+        void print(unsigned long v, int base=10){printf((base == HEX) ? "%lx" : "%lu", v);};
+        void print(unsigned int v, int base=10){this->print((unsigned long) v, base);};
+        template <typename T> void println(T v){this->print(v); this->println();};
+        void println(){printf("\n");};
+};
+
+extern linuxSerial Serial;
+
+//LINUX_ARDUINO_H
+#endif
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef LINUX_SPI_H
+#define LINUX_SPI_H
+
+/*
+    SPI library with transactions on top of spidev. bareRFM69 passes every
+    transaction as one block to transfer(), and a batch of them to
+    transferFrames(), which hand them to the bus of the radio whose chip
+    select is low, see linuxRFM69Bus in linuxRFM69.h.
+*/
+
+#define SPI_HAS_TRANSACTION 1
+
+// bareRFM69 transfers the address and the data of a transaction in one block,
+// of at most all registers after the address.
+#define RFM69_SPI_BLOCK
+#define RFM69_SPI_BLOCK_MAX 127
+
+// and a bareRFM69Batch in one call of transferFrames().
+#define RFM69_SPI_BATCH
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+class SPISettings{
+    public:
+        SPISettings(uint32_t, uint8_t, uint8_t){};
+};
+
+class SPIClass{
+    public:
+        void begin(){};
+        void beginTransaction(SPISettings);
+        void transfer(void* buffer, size_t count);
+        void transferFrames(uint8_t* frames, const uint8_t* sizes, uint8_t count);
+        /*
+            count blocks back to back in frames, of sizes[i] bytes, with the
+            chip select released between them.
+        */
+        void endTransaction();
+        void usingInterrupt(uint8_t){};
+};
+
+extern SPIClass SPI;
+
+//LINUX_SPI_H
+#endif
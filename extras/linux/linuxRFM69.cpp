@@ -0,0 +1,482 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include <chrono>
+#include "linuxRFM69.h"
+
+linuxSerial Serial;
+SPIClass SPI;
+
+static std::recursive_mutex radio_lock;
+static linuxRFM69Bus* buses[LINUX_RFM69_MAX_RADIOS] = {0};
+static linuxRFM69Bus* selected = 0;
+
+static uint64_t hostNanoseconds(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+static const uint64_t start_ns = hostNanoseconds();
+
+std::recursive_mutex& linuxRFM69Mutex(){
+    return radio_lock;
+}
+
+
+
+/*
+        Arduino and SPI
+*/
+
+void pinMode(uint8_t, uint8_t){
+}
+
+void digitalWrite(uint8_t pin, uint8_t value){
+    for (uint8_t i=0; i < LINUX_RFM69_MAX_RADIOS; i++){
+        if (buses[i] && (buses[i]->getCsPin() == pin)){
+            selected = (value == LOW) ? buses[i] : 0;
+        }
+    }
+}
+
+int digitalRead(uint8_t){
+    return LOW;
+}
+
+uint32_t micros(){
+    return (hostNanoseconds() - start_ns) / 1000;
+}
+
+uint32_t millis(){
+    return (hostNanoseconds() - start_ns) / 1000000;
+}
+
+void delayMicroseconds(uint32_t us){
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void delay(uint32_t ms){
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+long random(long max){
+    return (max > 0) ? (rand() % max) : 0;
+}
+
+void attachInterrupt(uint8_t, void (*)(), int){
+    // the thread of linuxRFM69 calls poll() on the edges.
+}
+
+void noInterrupts(){
+    radio_lock.lock();
+}
+
+void interrupts(){
+    radio_lock.unlock();
+}
+
+void SPIClass::beginTransaction(SPISettings){
+    radio_lock.lock();
+}
+
+void SPIClass::transfer(void* buffer, size_t count){
+    if (selected){
+        selected->transfer(reinterpret_cast<uint8_t*>(buffer), count);
+    }
+}
+
+void SPIClass::transferFrames(uint8_t* frames, const uint8_t* sizes, uint8_t count){
+    if (selected){
+        selected->transferFrames(frames, sizes, count);
+    }
+}
+
+void SPIClass::endTransaction(){
+    radio_lock.unlock();
+}
+
+
+
+/*
+        linuxSpidevRFM69
+*/
+
+linuxSpidevRFM69::linuxSpidevRFM69(){
+    this->spi_fd = -1;
+    this->line_fd = -1;
+    this->speed_hz = 0;
+}
+
+linuxSpidevRFM69::~linuxSpidevRFM69(){
+    if (this->spi_fd >= 0){
+        close(this->spi_fd);
+    }
+    if (this->line_fd >= 0){
+        close(this->line_fd);
+    }
+}
+
+bool linuxSpidevRFM69::open(const char* spidev, const char* gpiochip, uint32_t dio2_line, uint32_t speed_hz){
+    this->speed_hz = speed_hz;
+    this->spi_fd = ::open(spidev, O_RDWR);
+    if (this->spi_fd < 0){
+        return false;
+    }
+    uint8_t mode = SPI_MODE_0;
+    uint8_t bits = 8;
+    if ((ioctl(this->spi_fd, SPI_IOC_WR_MODE, &mode) < 0) ||
+        (ioctl(this->spi_fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0) ||
+        (ioctl(this->spi_fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed_hz) < 0)){
+        return false;
+    }
+
+    int chip_fd = ::open(gpiochip, O_RDWR);
+    if (chip_fd < 0){
+        return false;
+    }
+    struct gpio_v2_line_request request;
+    memset(&request, 0, sizeof(request));
+    request.offsets[0] = dio2_line;
+    request.num_lines = 1;
+    strncpy(request.consumer, "plainRFM69", sizeof(request.consumer) - 1);
+    request.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING;
+    int result = ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &request);
+    int saved = errno;
+    close(chip_fd);
+    errno = saved;
+    if (result < 0){
+        return false;
+    }
+    this->line_fd = request.fd;
+    return true;
+}
+
+bool linuxSpidevRFM69::transfer(struct spi_ioc_transfer* transfers, uint8_t count){
+    for (uint8_t i=0; i < count; i++){
+        transfers[i].speed_hz = this->speed_hz;
+        transfers[i].bits_per_word = 8;
+    }
+    return ioctl(this->spi_fd, SPI_IOC_MESSAGE(count), transfers) >= 0;
+}
+
+int8_t linuxSpidevRFM69::waitEdge(uint32_t timeout_ms){
+    struct pollfd fd = {this->line_fd, POLLIN, 0};
+    int result = poll(&fd, 1, timeout_ms);
+    if (result < 0){
+        return (errno == EINTR) ? 0 : -1;
+    }
+    if (result == 0){
+        return 0;
+    }
+    // the edges that queued up are handled by one poll().
+    struct gpio_v2_line_event events[16];
+    if (read(this->line_fd, events, sizeof(events)) < 0){
+        return -1;
+    }
+    return 1;
+}
+
+
+
+/*
+        linuxRFM69Bus
+*/
+
+linuxRFM69Bus::linuxRFM69Bus(uint8_t cs_pin, linuxRFM69Device* device){
+    this->device = device;
+    this->cs_pin = cs_pin;
+    this->count = 0;
+    this->depth = 0;
+    this->clearStatistics();
+    std::lock_guard<std::recursive_mutex> lock(radio_lock);
+    for (uint8_t i=0; i < LINUX_RFM69_MAX_RADIOS; i++){
+        if (buses[i] == 0){
+            buses[i] = this;
+            break;
+        }
+    }
+}
+
+linuxRFM69Bus::~linuxRFM69Bus(){
+    std::lock_guard<std::recursive_mutex> lock(radio_lock);
+    this->flush();
+    for (uint8_t i=0; i < LINUX_RFM69_MAX_RADIOS; i++){
+        if (buses[i] == this){
+            buses[i] = 0;
+        }
+    }
+    if (selected == this){
+        selected = 0;
+    }
+}
+
+void linuxRFM69Bus::transfer(uint8_t* buffer, size_t len){
+    if (this->count == LINUX_RFM69_BATCH){
+        this->flush();
+    }
+    bool write = (buffer[0] & RFM69_WRITE_REG_MASK) != 0;
+    struct spi_ioc_transfer* t = &(this->transfers[this->count]);
+    memset(t, 0, sizeof(*t));
+    if (write && this->depth){
+        // the caller's buffer is gone by the time the batch is sent.
+        memcpy(this->frames[this->count], buffer, len);
+        t->tx_buf = (uintptr_t) this->frames[this->count];
+    } else {
+        t->tx_buf = (uintptr_t) buffer;
+        t->rx_buf = (uintptr_t) buffer;
+    }
+    t->len = len;
+    this->count++;
+    if (!write || !this->depth){
+        this->flush();
+    }
+}
+
+void linuxRFM69Bus::transferFrames(uint8_t* frames, const uint8_t* sizes, uint8_t count){
+    for (uint8_t i=0; i < count; i++){
+        if (this->count == LINUX_RFM69_BATCH){
+            this->flush();
+        }
+        struct spi_ioc_transfer* t = &(this->transfers[this->count]);
+        memset(t, 0, sizeof(*t));
+        t->tx_buf = (uintptr_t) frames;
+        t->rx_buf = (uintptr_t) frames;
+        t->len = sizes[i];
+        this->count++;
+        frames += sizes[i];
+    }
+    // the reads are needed when this returns.
+    this->flush();
+}
+
+void linuxRFM69Bus::begin(){
+    std::lock_guard<std::recursive_mutex> lock(radio_lock);
+    this->depth++;
+}
+
+void linuxRFM69Bus::commit(){
+    std::lock_guard<std::recursive_mutex> lock(radio_lock);
+    if (this->depth){
+        this->depth--;
+    }
+    if (!this->depth){
+        this->flush();
+    }
+}
+
+void linuxRFM69Bus::clearStatistics(){
+    this->messages = 0;
+    this->transactions = 0;
+    this->errors = 0;
+}
+
+void linuxRFM69Bus::flush(){
+    if (this->count == 0){
+        return;
+    }
+    // release the chip select between the transactions.
+    for (uint8_t i=0; i < this->count; i++){
+        this->transfers[i].cs_change = (i + 1 < this->count) ? 1 : 0;
+    }
+    if (!this->device->transfer(this->transfers, this->count)){
+        this->errors++;
+    }
+    this->messages++;
+    this->transactions += this->count;
+    this->count = 0;
+}
+
+
+
+/*
+        linuxRFM69Queue
+*/
+
+linuxRFM69Queue::linuxRFM69Queue(){
+    for (uint32_t i=0; i < LINUX_RFM69_QUEUE; i++){
+        this->slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    this->write_index.store(0, std::memory_order_relaxed);
+    this->read_index.store(0, std::memory_order_relaxed);
+}
+
+bool linuxRFM69Queue::push(const linuxRFM69Packet& packet){
+    uint32_t position = this->write_index.load(std::memory_order_relaxed);
+    slot* s;
+    while (true){
+        s = &(this->slots[position % LINUX_RFM69_QUEUE]);
+        int32_t lap = (int32_t) (s->sequence.load(std::memory_order_acquire) - position);
+        if (lap == 0){
+            // free in this lap, claim it.
+            if (this->write_index.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                break;
+            }
+        } else if (lap < 0){
+            return false; // not read yet in the previous lap.
+        } else {
+            position = this->write_index.load(std::memory_order_relaxed);
+        }
+    }
+    s->packet = packet;
+    s->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool linuxRFM69Queue::pop(linuxRFM69Packet* packet){
+    uint32_t position = this->read_index.load(std::memory_order_relaxed);
+    slot* s;
+    while (true){
+        s = &(this->slots[position % LINUX_RFM69_QUEUE]);
+        int32_t lap = (int32_t) (s->sequence.load(std::memory_order_acquire) - (position + 1));
+        if (lap == 0){
+            if (this->read_index.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                break;
+            }
+        } else if (lap < 0){
+            return false; // not written yet.
+        } else {
+            position = this->read_index.load(std::memory_order_relaxed);
+        }
+    }
+    *packet = s->packet;
+    s->sequence.store(position + LINUX_RFM69_QUEUE, std::memory_order_release);
+    return true;
+}
+
+
+
+/*
+        Public Methods
+*/
+
+linuxRFM69::linuxRFM69(plainRFM69* rfm, uint8_t cs_pin, linuxRFM69Device* device) : bus(cs_pin, device){
+    this->rfm = rfm;
+    this->device = device;
+    this->running = false;
+    this->edges = 0;
+    this->safety_polls = 0;
+    this->dropped = 0;
+    this->failed = false;
+}
+
+linuxRFM69::~linuxRFM69(){
+    this->stop();
+}
+
+void linuxRFM69::start(){
+    if (this->running){
+        return;
+    }
+    this->running = true;
+    this->failed = false;
+    this->thread = std::thread(&linuxRFM69::run, this);
+}
+
+void linuxRFM69::stop(){
+    this->running = false;
+    if (this->thread.joinable()){
+        this->thread.join();
+    }
+}
+
+uint8_t linuxRFM69::receive(void* packet, uint32_t timeout_ms, uint32_t* time_us){
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    linuxRFM69Packet p;
+    bool got = this->queue.pop(&p);
+    while (!got){
+        // the thread takes this lock after a push, before it notifies.
+        std::unique_lock<std::mutex> lock(this->received_lock);
+        got = this->queue.pop(&p);
+        if (got){
+            break;
+        }
+        if (this->received.wait_until(lock, deadline) == std::cv_status::timeout){
+            got = this->queue.pop(&p);
+            if (!got){
+                return 0;
+            }
+        }
+    }
+    memcpy(packet, p.data, p.length);
+    if (time_us){
+        *time_us = p.time_us;
+    }
+    return p.length;
+}
+
+bool linuxRFM69::send(uint8_t address, void* buffer, uint8_t len, uint32_t timeout_ms){
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    std::unique_lock<std::recursive_mutex> lock(radio_lock);
+    while (!this->rfm->canSend()){
+        if (this->polled.wait_until(lock, deadline) == std::cv_status::timeout){
+            if (!this->rfm->canSend()){
+                return false;
+            }
+        }
+    }
+    this->bus.begin();
+    this->rfm->sendAny(address, buffer, len);
+    this->bus.commit();
+    return true;
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+void linuxRFM69::run(){
+    while (this->running){
+        int8_t edge = this->device->waitEdge(LINUX_RFM69_SAFETY_POLL);
+        if (edge < 0){
+            this->failed = true;
+            this->running = false;
+            break;
+        }
+        if (edge){
+            this->edges++;
+        } else {
+            this->safety_polls++;
+        }
+        this->service();
+    }
+}
+
+void linuxRFM69::service(){
+    bool pushed = false;
+    {
+        std::lock_guard<std::recursive_mutex> lock(radio_lock);
+        this->bus.begin();
+        this->rfm->poll();
+        linuxRFM69Packet packet;
+        while (this->rfm->available()){
+            packet.length = this->rfm->read(packet.data);
+            packet.time_us = micros();
+            if (this->queue.push(packet)){
+                pushed = true;
+            } else {
+                this->dropped++;
+            }
+        }
+        this->bus.commit();
+        this->polled.notify_all();
+    }
+    if (pushed){
+        {
+            std::lock_guard<std::mutex> lock(this->received_lock);
+        }
+        this->received.notify_all();
+    }
+}
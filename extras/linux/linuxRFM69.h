@@ -0,0 +1,282 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <linux/spi/spidev.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Arduino.h"
+#include "SPI.h"
+#include "../../plainRFM69.h"
+
+#ifndef LINUX_RFM69_H
+#define LINUX_RFM69_H
+
+/*
+    Runs plainRFM69 on Linux, with the RFM69 on a spidev device and DIO2 on a
+    line of a GPIO chip, for example on a Raspberry Pi:
+
+        linuxSpidevRFM69 device;
+        device.open("/dev/spidev0.0", "/dev/gpiochip0", 25);
+        plainRFM69 rfm(0);              // the chip select is that of spidev.
+        linuxRFM69 radio(&rfm, 0, &device);
+
+        rfm.setRecommended();           // set up as on the Arduino.
+        ...
+        rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+        rfm.receive();
+        radio.start();
+
+        uint8_t packet[LINUX_RFM69_MAX_PACKET];
+        uint8_t len = radio.receive(packet, 1000);
+        radio.send(0x01, packet, len, 100);
+
+    start() spawns a thread which waits for edges on DIO2 and calls poll(),
+    the interrupt handler of the Arduino examples. The packets it reads are
+    passed to receive() through a lock-free queue; any number of threads can
+    receive and send.
+
+    bareRFM69 transfers every SPI transaction as one block on Linux, see
+    RFM69_SPI_BLOCK in SPI.h. Between begin() and commit() of the bus the
+    writes are held back, and sent in one SPI_IOC_MESSAGE ioctl with the next
+    read, or at the commit; the thread does so around poll(), send() around
+    the send. A bareRFM69Batch, as sendPacket() records, is one ioctl as
+    well. The chip select is released between the transactions of an ioctl,
+    the radio sees the same transactions as from an Arduino.
+
+    The radios share one recursive lock, which stands in for the disabled
+    interrupts of the Arduino: the thread holds it while it polls, as does
+    noInterrupts(). After start(), other calls on the plainRFM69 have to
+    hold it too, with linuxRFM69Mutex().
+
+    The device is an interface, linuxSimRFM69Device in linuxSimRFM69.h runs
+    the backend against the simulated radio of extras/host/sim instead of the
+    hardware.
+*/
+
+// transactions in one ioctl, the writes are sent when the batch is full.
+#ifndef LINUX_RFM69_BATCH
+#define LINUX_RFM69_BATCH 16
+#endif
+
+// packets the queue holds, a power of two.
+#ifndef LINUX_RFM69_QUEUE
+#define LINUX_RFM69_QUEUE 32
+#endif
+
+// ms without an edge after which the thread polls anyway.
+#ifndef LINUX_RFM69_SAFETY_POLL
+#define LINUX_RFM69_SAFETY_POLL 100
+#endif
+
+#define LINUX_RFM69_MAX_RADIOS 4
+
+// the largest packet read() writes, variable length with addressing.
+#define LINUX_RFM69_MAX_PACKET 66
+
+class linuxRFM69Device{
+    public:
+        virtual ~linuxRFM69Device(){};
+
+        virtual bool transfer(struct spi_ioc_transfer* transfers, uint8_t count) = 0;
+        /*
+            Performs the transfers as one message, the chip select is released
+            after a transfer if its cs_change is set. Returns false on error.
+        */
+
+        virtual int8_t waitEdge(uint32_t timeout_ms) = 0;
+        /*
+            Waits for an edge on DIO2; returns 1 for an edge, 0 after the
+            timeout and -1 on error.
+        */
+};
+
+class linuxSpidevRFM69 : public linuxRFM69Device{
+    protected:
+        int spi_fd;
+        int line_fd;
+        uint32_t speed_hz;
+
+    public:
+        linuxSpidevRFM69();
+        ~linuxSpidevRFM69();
+
+        bool open(const char* spidev, const char* gpiochip, uint32_t dio2_line, uint32_t speed_hz=10000000);
+        /*
+            Opens spidev in SPI mode 0 with 8 bit words, and requests the line
+            as an input with events on both edges. Returns false if either
+            failed, errno tells why.
+        */
+
+        bool transfer(struct spi_ioc_transfer* transfers, uint8_t count);
+        int8_t waitEdge(uint32_t timeout_ms);
+};
+
+class linuxRFM69Bus{
+    protected:
+        linuxRFM69Device* device;
+        uint8_t cs_pin;
+
+        // the batch; a read goes out with the writes before it.
+        struct spi_ioc_transfer transfers[LINUX_RFM69_BATCH];
+        uint8_t frames[LINUX_RFM69_BATCH][RFM69_SPI_BLOCK_MAX + 1];
+        uint8_t count;
+        uint8_t depth;
+
+        uint32_t messages;
+        uint32_t transactions;
+        uint32_t errors;
+
+        void flush();
+
+    public:
+        linuxRFM69Bus(uint8_t cs_pin, linuxRFM69Device* device);
+        ~linuxRFM69Bus();
+        /*
+            Registers the bus for the chip select pin, SPI.transfer() uses it
+            while the pin is low.
+        */
+
+        uint8_t getCsPin(){return this->cs_pin;};
+
+        void transfer(uint8_t* buffer, size_t len);
+        /*
+            One transaction, with the address in the first byte. Outside a
+            batch, or if it is a read, the batch is sent before it returns.
+        */
+
+        void transferFrames(uint8_t* frames, const uint8_t* sizes, uint8_t count);
+        /*
+            The transactions of a bareRFM69Batch, sent in one ioctl with the
+            writes held back before them.
+        */
+
+        void begin();
+        void commit();
+        /*
+            Holds back the writes until the matching commit(), these nest.
+        */
+
+        uint32_t getMessages(){return this->messages;};
+        uint32_t getTransactions(){return this->transactions;};
+        uint32_t getErrors(){return this->errors;};
+        void clearStatistics();
+        /*
+            ioctls, transactions in them and ioctls that failed.
+        */
+};
+
+struct linuxRFM69Packet{
+    uint8_t length;
+    uint8_t data[LINUX_RFM69_MAX_PACKET];
+    uint32_t time_us;   // micros() when it was read from the radio.
+};
+
+class linuxRFM69Queue{
+    protected:
+        // a bounded queue with a sequence number per slot, the index of the
+        // lap in which it may be written or read next; after D. Vyukov.
+        struct slot{
+            std::atomic<uint32_t> sequence;
+            linuxRFM69Packet packet;
+        };
+        slot slots[LINUX_RFM69_QUEUE];
+        std::atomic<uint32_t> write_index;
+        std::atomic<uint32_t> read_index;
+
+    public:
+        linuxRFM69Queue();
+
+        bool push(const linuxRFM69Packet& packet);
+        bool pop(linuxRFM69Packet* packet);
+        /*
+            Lock-free for any number of threads on either side. push()
+            returns false if the queue is full, pop() if it is empty.
+        */
+};
+
+class linuxRFM69{
+    protected:
+        plainRFM69* rfm;
+        linuxRFM69Device* device;
+        linuxRFM69Bus bus;
+        linuxRFM69Queue queue;
+
+        std::thread thread;
+        std::atomic<bool> running;
+
+        // receive() sleeps on this while the queue is empty.
+        std::mutex received_lock;
+        std::condition_variable received;
+
+        // send() sleeps on this with the radio lock, until canSend().
+        std::condition_variable_any polled;
+
+        std::atomic<uint32_t> edges;
+        std::atomic<uint32_t> safety_polls;
+        std::atomic<uint32_t> dropped;
+        std::atomic<bool> failed;
+
+        void run();
+        void service();
+        /*
+            The thread, and one poll() with the packets moved to the queue.
+        */
+
+    public:
+        linuxRFM69(plainRFM69* rfm, uint8_t cs_pin, linuxRFM69Device* device);
+        ~linuxRFM69();
+        /*
+            cs_pin is the pin passed to plainRFM69, the transactions on it go
+            to device. The destructor stops the thread.
+        */
+
+        void start();
+        void stop();
+        /*
+            Starts and stops the thread; stop() returns within the safety
+            poll interval.
+        */
+
+        uint8_t receive(void* packet, uint32_t timeout_ms, uint32_t* time_us=0);
+        /*
+            Takes the next packet from the queue, as read() writes it, waiting
+            up to timeout_ms. Returns its length, zero if none arrived. The
+            queue is lock-free; only an empty queue takes a lock, to sleep.
+        */
+
+        bool send(uint8_t address, void* buffer, uint8_t len, uint32_t timeout_ms);
+        /*
+            Waits up to timeout_ms until the radio can send, then sends the
+            packet with plainRFM69::sendAny(). Returns false if it could not
+            be sent in time. Must not be called with the radio lock held.
+        */
+
+        bool hasFailed(){return this->failed;};
+        /*
+            Waiting for an edge failed, the thread has stopped.
+        */
+
+        linuxRFM69Bus* getBus(){return &(this->bus);};
+        uint32_t getEdges(){return this->edges;};
+        uint32_t getSafetyPolls(){return this->safety_polls;};
+        uint32_t getDropped(){return this->dropped;};
+        /*
+            Polls after an edge and after the timeout, and packets dropped
+            because the queue was full.
+        */
+};
+
+std::recursive_mutex& linuxRFM69Mutex();
+/*
+    The lock of the radios, held by the threads while they poll and by
+    noInterrupts() until interrupts().
+*/
+
+//LINUX_RFM69_H
+#endif
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <time.h>
+#include <chrono>
+#include "linuxSimRFM69.h"
+
+// how often waitEdge() looks at the simulation.
+#define LINUX_SIM_RFM69_STEP_US 50
+
+static std::mutex sim_lock;
+
+// host time minus simulated time, set on the first advance.
+static bool synchronized = false;
+static uint64_t offset = 0;
+
+static uint64_t hostNanoseconds(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+
+
+/*
+        Public Methods
+*/
+
+linuxSimRFM69Device::linuxSimRFM69Device(uint8_t cs_pin, uint8_t dio2_pin) : radio(cs_pin, dio2_pin){
+    this->dio2 = this->radio.getDio2();
+}
+
+bool linuxSimRFM69Device::transfer(struct spi_ioc_transfer* transfers, uint8_t count){
+    std::lock_guard<std::mutex> lock(sim_lock);
+    for (uint8_t i=0; i < count; i++){
+        const uint8_t* tx = reinterpret_cast<const uint8_t*>(transfers[i].tx_buf);
+        uint8_t* rx = reinterpret_cast<uint8_t*>(transfers[i].rx_buf);
+        // the chip select is released after every transfer, also the last.
+        this->radio.select(true);
+        for (uint32_t j=0; j < transfers[i].len; j++){
+            uint8_t value = this->radio.transfer((tx) ? tx[j] : 0);
+            if (rx){
+                rx[j] = value;
+            }
+        }
+        this->radio.select(false);
+    }
+    return true;
+}
+
+int8_t linuxSimRFM69Device::waitEdge(uint32_t timeout_ms){
+    uint64_t deadline = hostNanoseconds() + timeout_ms * 1000000ULL;
+    while (true){
+        {
+            std::lock_guard<std::mutex> lock(sim_lock);
+            if (this->advance()){
+                return 1;
+            }
+        }
+        if (hostNanoseconds() >= deadline){
+            return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(LINUX_SIM_RFM69_STEP_US));
+    }
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+bool linuxSimRFM69Device::advance(){
+    uint64_t now = hostNanoseconds();
+    if (!synchronized){
+        offset = now - simRFM69Now();
+        synchronized = true;
+    }
+    // stop at every event, such that no edge of this radio is missed.
+    while (this->radio.getDio2() == this->dio2){
+        uint64_t sim_now = simRFM69Now();
+        if (sim_now + offset + 1000 > now){
+            break;
+        }
+        simRFM69Idle((now - offset - sim_now) / 1000);
+    }
+    if (this->radio.getDio2() != this->dio2){
+        this->dio2 = this->radio.getDio2();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "linuxRFM69.h"
+#include "../host/sim/simRFM69.h"
+
+#ifndef LINUX_SIM_RFM69_H
+#define LINUX_SIM_RFM69_H
+
+/*
+    A linuxRFM69Device on the simulated radio of extras/host/sim, for running
+    the Linux backend and the programs that use it without hardware. The
+    simulation is compiled with SIM_RFM69_NO_ARDUINO, the Arduino shims are
+    those of this folder.
+
+    The simulated time follows the monotonic clock of the host: waitEdge()
+    advances it, up to the current time, until DIO2 of its radio changes. All
+    devices share one lock around the simulation, so the threads of several
+    backends can run radios on the same air.
+*/
+
+class linuxSimRFM69Device : public linuxRFM69Device{
+    protected:
+        simRFM69 radio;
+        bool dio2;  // level at the last edge returned.
+
+        bool advance();
+        /*
+            Advances the simulation to the host time, returns whether DIO2
+            of this radio changed on the way. Call with the lock held.
+        */
+
+    public:
+        linuxSimRFM69Device(uint8_t cs_pin, uint8_t dio2_pin);
+
+        bool transfer(struct spi_ioc_transfer* transfers, uint8_t count);
+        int8_t waitEdge(uint32_t timeout_ms);
+
+        simRFM69* getRadio(){return &(this->radio);};
+        /*
+            For the statistics, read them once the backends have stopped.
+        */
+};
+
+//LINUX_SIM_RFM69_H
+#endif
@@ -0,0 +1,244 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+/*
+    Checks the Linux backend without hardware, on two simulated radios, see
+    linuxSimRFM69.h:
+
+        queue       The packet queue refuses pushes when full, and passes
+                    every packet exactly once between four producer and four
+                    consumer threads.
+        link        Two threads send through one backend, two threads receive
+                    from the other; every packet the radio received arrives
+                    once and unchanged.
+        batching    The writes go out with the reads in the same ioctl, a
+                    send is a single ioctl, as is a bareRFM69Batch with
+                    reads; the transactions per ioctl are printed.
+        stop        The threads stop, and their devices did not fail.
+
+    Build and run (Linux):
+        g++ -O2 -std=c++11 -pthread -DSIM_RFM69_NO_ARDUINO -I . -I ../.. \
+            -o linux_check linux_check.cpp linuxRFM69.cpp linuxSimRFM69.cpp \
+            ../host/sim/simRFM69.cpp ../../bareRFM69.cpp ../../plainRFM69.cpp
+        ./linux_check
+*/
+
+#include <stdio.h>
+#include <vector>
+#include "linuxSimRFM69.h"
+
+#define SENDER_CS 10
+#define SENDER_DIO2 20
+#define RECEIVER_CS 11
+#define RECEIVER_DIO2 21
+
+#define SENDER_ADDRESS 0x02
+#define RECEIVER_ADDRESS 0x01
+
+#define THREADS 2
+#define PACKETS 40
+#define LENGTH 16
+
+#define QUEUE_THREADS 4
+#define QUEUE_ITEMS 100000
+
+static bool check(const char* name, bool value){
+    fprintf(stderr, "%-50s %s\n", name, (value) ? "ok" : "FAIL");
+    return value;
+}
+
+static bool checkQueueFull(){
+    linuxRFM69Queue queue;
+    linuxRFM69Packet packet;
+    memset(&packet, 0, sizeof(packet));
+    bool ok = true;
+    for (uint32_t i=0; i < LINUX_RFM69_QUEUE; i++){
+        packet.time_us = i;
+        ok &= queue.push(packet);
+    }
+    ok &= !queue.push(packet);
+    for (uint32_t i=0; i < LINUX_RFM69_QUEUE; i++){
+        ok &= queue.pop(&packet) && (packet.time_us == i);
+    }
+    ok &= !queue.pop(&packet);
+    return check("queue refuses when full, keeps the order", ok);
+}
+
+static bool checkQueueThreads(){
+    linuxRFM69Queue queue;
+    std::vector<std::atomic<uint8_t> > seen(QUEUE_THREADS * QUEUE_ITEMS);
+    for (size_t i=0; i < seen.size(); i++){
+        seen[i] = 0;
+    }
+    std::atomic<uint32_t> popped(0);
+    std::vector<std::thread> threads;
+    for (uint32_t t=0; t < QUEUE_THREADS; t++){
+        threads.push_back(std::thread([&queue, t](){
+            linuxRFM69Packet packet;
+            memset(&packet, 0, sizeof(packet));
+            for (uint32_t i=0; i < QUEUE_ITEMS; i++){
+                packet.time_us = t * QUEUE_ITEMS + i;
+                packet.length = packet.time_us & 0xFF;
+                while (!queue.push(packet)){
+                    std::this_thread::yield();
+                }
+            }
+        }));
+        threads.push_back(std::thread([&queue, &seen, &popped](){
+            linuxRFM69Packet packet;
+            while (popped < QUEUE_THREADS * QUEUE_ITEMS){
+                if (!queue.pop(&packet)){
+                    std::this_thread::yield();
+                    continue;
+                }
+                if ((packet.time_us < seen.size()) && (packet.length == (packet.time_us & 0xFF))){
+                    seen[packet.time_us]++;
+                }
+                popped++;
+            }
+        }));
+    }
+    for (size_t i=0; i < threads.size(); i++){
+        threads[i].join();
+    }
+    bool once = true;
+    for (size_t i=0; i < seen.size(); i++){
+        once &= seen[i] == 1;
+    }
+    return check("queue passes every packet once between threads", once);
+}
+
+static void setup(plainRFM69& rfm, uint8_t address){
+    rfm.setRecommended();
+    rfm.setPacketType(true, true);
+    rfm.setBufferSize(4);
+    rfm.setPacketLength(LENGTH);
+    rfm.baud300000();
+    rfm.setNodeAddress(address);
+    rfm.setDioMapping1(RFM69_PACKET_DIO_2_AUTOMODE);
+    rfm.receive();
+}
+
+static bool checkLink(){
+    linuxSimRFM69Device sender_device(SENDER_CS, SENDER_DIO2);
+    linuxSimRFM69Device receiver_device(RECEIVER_CS, RECEIVER_DIO2);
+    plainRFM69 sender_rfm(SENDER_CS);
+    plainRFM69 receiver_rfm(RECEIVER_CS);
+    linuxRFM69 sender(&sender_rfm, SENDER_CS, &sender_device);
+    linuxRFM69 receiver(&receiver_rfm, RECEIVER_CS, &receiver_device);
+    setup(sender_rfm, SENDER_ADDRESS);
+    setup(receiver_rfm, RECEIVER_ADDRESS);
+    sender.getBus()->clearStatistics();
+    receiver.getBus()->clearStatistics();
+    sender.start();
+    receiver.start();
+
+    // packet n of thread t is filled with t * PACKETS + n.
+    std::atomic<uint32_t> not_sent(0);
+    std::atomic<uint32_t> wrong(0);
+    std::atomic<uint32_t> received(0);
+    std::atomic<uint8_t> seen[THREADS * PACKETS];
+    for (uint32_t i=0; i < THREADS * PACKETS; i++){
+        seen[i] = 0;
+    }
+
+    std::mutex pace;
+    std::vector<std::thread> threads;
+    for (uint32_t t=0; t < THREADS; t++){
+        threads.push_back(std::thread([&sender, &not_sent, &pace, t](){
+            uint8_t payload[LENGTH - 1];
+            for (uint32_t n=0; n < PACKETS; n++){
+                memset(payload, t * PACKETS + n, sizeof(payload));
+                // leave the receiver the time to empty its FIFO, also when
+                // the other thread sends next.
+                std::lock_guard<std::mutex> lock(pace);
+                if (!sender.send(RECEIVER_ADDRESS, payload, (n % sizeof(payload)) + 1, 100)){
+                    not_sent++;
+                }
+                delay(2);
+            }
+        }));
+        threads.push_back(std::thread([&receiver, &wrong, &received, &seen](){
+            uint8_t packet[LINUX_RFM69_MAX_PACKET];
+            while (received < THREADS * PACKETS){
+                uint8_t len = receiver.receive(packet, 500);
+                if (len == 0){
+                    break;
+                }
+                uint8_t n = packet[1];
+                bool right = (packet[0] == RECEIVER_ADDRESS) && (n < THREADS * PACKETS) && (len == (n % PACKETS) % (LENGTH - 1) + 2);
+                for (uint8_t i=1; i < len; i++){
+                    right &= packet[i] == n;
+                }
+                if (right){
+                    seen[n]++;
+                } else {
+                    wrong++;
+                }
+                received++;
+            }
+        }));
+    }
+    for (size_t i=0; i < threads.size(); i++){
+        threads[i].join();
+    }
+    sender.stop();
+    receiver.stop();
+
+    // a packet the receiving radio missed, because its thread was not
+    // scheduled in time to empty the FIFO, is not lost by the backend.
+    uint32_t missed = receiver_device.getRadio()->getMissed();
+    bool once = true;
+    uint32_t arrived = 0;
+    for (uint32_t i=0; i < THREADS * PACKETS; i++){
+        once &= seen[i] <= 1;
+        arrived += seen[i];
+    }
+    bool ok = true;
+    ok &= check("link every packet sent", (not_sent == 0) && (sender_device.getRadio()->getSent() == THREADS * PACKETS));
+    ok &= check("link every packet received once, unchanged", once && (wrong == 0) && (arrived + missed == THREADS * PACKETS));
+    ok &= check("link no packets dropped by the queue", receiver.getDropped() == 0);
+
+    // the receiver only reads in this setup, the sender writes the packets.
+    linuxRFM69Bus* bus = sender.getBus();
+    ok &= check("batching writes go out with the reads", bus->getTransactions() > bus->getMessages());
+    ok &= check("batching no failed ioctls", (bus->getErrors() == 0) && (receiver.getBus()->getErrors() == 0));
+    ok &= check("stop threads stopped without failure", !sender.hasFailed() && !receiver.hasFailed());
+
+    printf("received %u of %u, missed by the radio %u\n", (uint32_t) received, THREADS * PACKETS, missed);
+    printf("sender:   %u polls after an edge, %u safety polls, %.2f transactions per ioctl\n", sender.getEdges(), sender.getSafetyPolls(), bus->getTransactions() / (double) bus->getMessages());
+    bus = receiver.getBus();
+    printf("receiver: %u polls after an edge, %u safety polls, %.2f transactions per ioctl\n", receiver.getEdges(), receiver.getSafetyPolls(), bus->getTransactions() / (double) bus->getMessages());
+
+    // a send by itself, with the backend stopped.
+    uint8_t payload[LENGTH - 1];
+    memset(payload, 0, sizeof(payload));
+    bus = sender.getBus();
+    bus->clearStatistics();
+    sender.send(RECEIVER_ADDRESS, payload, sizeof(payload), 100);
+    ok &= check("batching a send is one ioctl", (bus->getMessages() == 1) && (bus->getTransactions() > 1));
+    printf("send: %u transactions in %u ioctl\n", bus->getTransactions(), bus->getMessages());
+
+    // a recorded read returns what was written before it, in the same ioctl.
+    bareRFM69Batch batch;
+    uint8_t length = 0;
+    uint8_t sync[2] = {0, 0};
+    bus->clearStatistics();
+    sender_rfm.beginBatch(&batch);
+    sender_rfm.setPayloadLength(0x2A);
+    sender_rfm.queueRead(RFM69_PAYLOAD_LENGTH, &length);
+    sender_rfm.queueReadRawRegisters(RFM69_SYNC_VALUE1, sync, sizeof(sync));
+    sender_rfm.submitBatch();
+    ok &= check("batching queued reads see the writes before them", (length == 0x2A) && (sync[0] != 0) && (bus->getMessages() == 1));
+    return ok;
+}
+
+int main(int, char*[]){
+    bool ok = true;
+    ok &= checkQueueFull();
+    ok &= checkQueueThreads();
+    ok &= checkLink();
+    return (ok) ? 0 : 1;
+}
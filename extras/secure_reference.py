@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""
+ *  This file is part of plainRFM69.
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+"""
+
+import struct
+
+"""
+    Reference implementation of the packets of secureRFM69, independent of
+    the C++ code. It prints a number of packets, one per line in hex, which
+    should be identical to the output of extras/host/secure_vectors.cpp:
+
+        diff <(python3 secure_reference.py) <(./host/secure_vectors)
+"""
+
+M = 0xFFFFFFFF
+TAG_LENGTH = 4
+
+
+def rotl(x, b):
+    return ((x << b) | (x >> (32 - b))) & M
+
+
+def permute(v):
+    v = list(v)
+    for i in range(0, 12):
+        v[0] = (v[0] + v[1]) & M; v[1] = rotl(v[1], 5) ^ v[0]; v[0] = rotl(v[0], 16)
+        v[2] = (v[2] + v[3]) & M; v[3] = rotl(v[3], 8) ^ v[2]
+        v[0] = (v[0] + v[3]) & M; v[3] = rotl(v[3], 13) ^ v[0]
+        v[2] = (v[2] + v[1]) & M; v[1] = rotl(v[1], 7) ^ v[2]; v[2] = rotl(v[2], 16)
+    return v
+
+
+def words(b):
+    return list(struct.unpack("<4I", b))
+
+
+def times2(k):
+    n = int.from_bytes(struct.pack("<4I", *k), "little") << 1
+    if (n >> 128):
+        n ^= (1 << 128) | 0x87
+    return words(n.to_bytes(16, "little"))
+
+
+def chaskey(key, data):
+    k1 = times2(key)
+    k2 = times2(k1)
+    v = list(key)
+    while len(data) > 16:
+        v = permute([a ^ b for a, b in zip(v, words(data[0:16]))])
+        data = data[16:]
+    subkey = k1
+    if (len(data) < 16):
+        data = data + bytes([1]) + bytes(15 - len(data))
+        subkey = k2
+    v = permute([a ^ b ^ c for a, b, c in zip(v, words(data), subkey)])
+    return struct.pack("<4I", *[a ^ b for a, b in zip(v, subkey)])
+
+
+def stream_key(key):
+    v = permute(key[0:3] + [key[3] ^ M])
+    return [a ^ b for a, b in zip(v, key)]
+
+
+def keystream(key, sender, counter, length):
+    sk = stream_key(key)
+    out = b""
+    block = 0
+    while len(out) < length:
+        v = permute([sender ^ sk[0], counter ^ sk[1], block ^ sk[2], sk[3]])
+        out += struct.pack("<4I", *[a ^ b for a, b in zip(v, sk)])
+        block += 1
+    return out[0:length]
+
+
+def seal(key, sender, counter, payload, use_keystream):
+    key = words(key)
+    if (use_keystream):
+        payload = bytes([a ^ b for a, b in zip(payload, keystream(key, sender, counter, len(payload)))])
+    packet = bytes([sender]) + struct.pack("<I", counter) + payload
+    return packet + chaskey(key, packet)[0:TAG_LENGTH]
+
+
+# Identical to the vectors in extras/host/secure_vectors.cpp.
+key = bytes([146, 48, 0, 16, 31, 203, 208, 65, 31, 10, 94, 64, 8, 198, 226, 121])
+for use_keystream in [False, True]:
+    for length in [0, 1, 11, 12, 27, 28, 60]:
+        for counter in [0, 0xFFFFFFFE]:
+            payload = bytes([(i * 7 + length) & 0xFF for i in range(0, length)])
+            print(seal(key, 0x2A, counter, payload, use_keystream).hex().upper())
@@ -0,0 +1,290 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "fecRFM69.h"
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#define RFM69_FEC_TABLE PROGMEM
+#define RFM69_FEC_READ(table, index) pgm_read_byte(&(table[index]))
+#else
+#define RFM69_FEC_TABLE
+#define RFM69_FEC_READ(table, index) (table[index])
+#endif
+
+// alpha^i, twice such that the sum of two logarithms needs no modulo.
+static const uint8_t fecRFM69Exp[512] RFM69_FEC_TABLE = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26,
+    0x4C, 0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0,
+    0x9D, 0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23,
+    0x46, 0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1,
+    0x5F, 0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0,
+    0xFD, 0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2,
+    0xD9, 0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE,
+    0x81, 0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC,
+    0x85, 0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54,
+    0xA8, 0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73,
+    0xE6, 0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF,
+    0xE3, 0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41,
+    0x82, 0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6,
+    0x51, 0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09,
+    0x12, 0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16,
+    0x2C, 0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01,
+    0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26, 0x4C,
+    0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x9D,
+    0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23, 0x46,
+    0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1, 0x5F,
+    0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0xFD,
+    0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2, 0xD9,
+    0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE, 0x81,
+    0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC, 0x85,
+    0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54, 0xA8,
+    0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73, 0xE6,
+    0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF, 0xE3,
+    0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41, 0x82,
+    0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6, 0x51,
+    0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09, 0x12,
+    0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16, 0x2C,
+    0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01, 0x02
+};
+
+// logarithm of i, the entry for zero is unused.
+static const uint8_t fecRFM69Log[256] RFM69_FEC_TABLE = {
+    0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1A, 0xC6, 0x03, 0xDF, 0x33, 0xEE, 0x1B, 0x68, 0xC7, 0x4B,
+    0x04, 0x64, 0xE0, 0x0E, 0x34, 0x8D, 0xEF, 0x81, 0x1C, 0xC1, 0x69, 0xF8, 0xC8, 0x08, 0x4C, 0x71,
+    0x05, 0x8A, 0x65, 0x2F, 0xE1, 0x24, 0x0F, 0x21, 0x35, 0x93, 0x8E, 0xDA, 0xF0, 0x12, 0x82, 0x45,
+    0x1D, 0xB5, 0xC2, 0x7D, 0x6A, 0x27, 0xF9, 0xB9, 0xC9, 0x9A, 0x09, 0x78, 0x4D, 0xE4, 0x72, 0xA6,
+    0x06, 0xBF, 0x8B, 0x62, 0x66, 0xDD, 0x30, 0xFD, 0xE2, 0x98, 0x25, 0xB3, 0x10, 0x91, 0x22, 0x88,
+    0x36, 0xD0, 0x94, 0xCE, 0x8F, 0x96, 0xDB, 0xBD, 0xF1, 0xD2, 0x13, 0x5C, 0x83, 0x38, 0x46, 0x40,
+    0x1E, 0x42, 0xB6, 0xA3, 0xC3, 0x48, 0x7E, 0x6E, 0x6B, 0x3A, 0x28, 0x54, 0xFA, 0x85, 0xBA, 0x3D,
+    0xCA, 0x5E, 0x9B, 0x9F, 0x0A, 0x15, 0x79, 0x2B, 0x4E, 0xD4, 0xE5, 0xAC, 0x73, 0xF3, 0xA7, 0x57,
+    0x07, 0x70, 0xC0, 0xF7, 0x8C, 0x80, 0x63, 0x0D, 0x67, 0x4A, 0xDE, 0xED, 0x31, 0xC5, 0xFE, 0x18,
+    0xE3, 0xA5, 0x99, 0x77, 0x26, 0xB8, 0xB4, 0x7C, 0x11, 0x44, 0x92, 0xD9, 0x23, 0x20, 0x89, 0x2E,
+    0x37, 0x3F, 0xD1, 0x5B, 0x95, 0xBC, 0xCF, 0xCD, 0x90, 0x87, 0x97, 0xB2, 0xDC, 0xFC, 0xBE, 0x61,
+    0xF2, 0x56, 0xD3, 0xAB, 0x14, 0x2A, 0x5D, 0x9E, 0x84, 0x3C, 0x39, 0x53, 0x47, 0x6D, 0x41, 0xA2,
+    0x1F, 0x2D, 0x43, 0xD8, 0xB7, 0x7B, 0xA4, 0x76, 0xC4, 0x17, 0x49, 0xEC, 0x7F, 0x0C, 0x6F, 0xF6,
+    0x6C, 0xA1, 0x3B, 0x52, 0x29, 0x9D, 0x55, 0xAA, 0xFB, 0x60, 0x86, 0xB1, 0xBB, 0xCC, 0x3E, 0x5A,
+    0xCB, 0x59, 0x5F, 0xB0, 0x9C, 0xA9, 0xA0, 0x51, 0x0B, 0xF5, 0x16, 0xEB, 0x7A, 0x75, 0x2C, 0xD7,
+    0x4F, 0xAE, 0xD5, 0xE9, 0xE6, 0xE7, 0xAD, 0xE8, 0x74, 0xD6, 0xF4, 0xEA, 0xA8, 0x50, 0x58, 0xAF
+};
+
+
+
+/*
+        Public Methods
+*/
+
+fecRFM69::fecRFM69(uint8_t parity, uint8_t depth){
+    // each wrong byte takes two parity bytes to correct, so at least two and even.
+    parity = (parity > RFM69_FEC_MAX_PARITY) ? RFM69_FEC_MAX_PARITY : parity;
+    this->parity = (parity < 2) ? 2 : ((parity + 1) & ~1);
+    this->depth = (depth == 0) ? 1 : depth;
+    this->corrected = 0;
+    this->failed = 0;
+
+    // product of (x - alpha^i) for i = 0 ... parity - 1.
+    memset(this->generator, 0, sizeof(this->generator));
+    this->generator[0] = 1;
+    for (uint8_t i=0; i < this->parity; i++){
+        for (uint8_t j=i+1; j > 0; j--){
+            this->generator[j] ^= fecRFM69::multiply(this->generator[j - 1], fecRFM69::power(i));
+        }
+    }
+}
+
+uint8_t fecRFM69::encode(const void* payload, uint8_t len, uint8_t* out){
+    uint8_t overhead = this->getOverhead();
+    if ((len + overhead) > RFM69_FEC_MAX_FRAME){
+        return 0;
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(payload);
+    memmove(out, data, len);
+
+    for (uint8_t d=0; d < this->depth; d++){
+        // remainder of the division by the generator, in the parity bytes.
+        uint8_t remainder[RFM69_FEC_MAX_PARITY] = {0};
+        for (uint8_t i=d; i < len; i += this->depth){
+            uint8_t feedback = data[i] ^ remainder[0];
+            memmove(remainder, &(remainder[1]), this->parity - 1);
+            remainder[this->parity - 1] = 0;
+            if (feedback){
+                for (uint8_t j=0; j < this->parity; j++){
+                    remainder[j] ^= fecRFM69::multiply(feedback, this->generator[j + 1]);
+                }
+            }
+        }
+        for (uint8_t p=0; p < this->parity; p++){
+            out[len + p * this->depth + d] = remainder[p];
+        }
+    }
+    return len + overhead;
+}
+
+uint8_t fecRFM69::decode(uint8_t* frame, uint8_t len){
+    uint8_t overhead = this->getOverhead();
+    if ((len <= overhead) || (len > RFM69_FEC_MAX_FRAME)){
+        this->failed++;
+        return 0;
+    }
+    uint8_t payload_length = len - overhead;
+
+    uint8_t total = 0;
+    for (uint8_t d=0; d < this->depth; d++){
+        // gather the codeword, correct it and put it back.
+        uint8_t n = 0;
+        for (uint8_t i=d; i < payload_length; i += this->depth){
+            this->codeword[n++] = frame[i];
+        }
+        for (uint8_t p=0; p < this->parity; p++){
+            this->codeword[n++] = frame[payload_length + p * this->depth + d];
+        }
+
+        int8_t errors = this->correct(this->codeword, n);
+        if (errors < 0){
+            this->failed++;
+            return 0;
+        }
+        if (errors){
+            n = 0;
+            for (uint8_t i=d; i < payload_length; i += this->depth){
+                frame[i] = this->codeword[n++];
+            }
+            total += errors;
+        }
+    }
+    this->corrected += total;
+    return payload_length;
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+uint8_t fecRFM69::multiply(uint8_t a, uint8_t b){
+    if ((a == 0) || (b == 0)){
+        return 0;
+    }
+    return RFM69_FEC_READ(fecRFM69Exp, RFM69_FEC_READ(fecRFM69Log, a) + RFM69_FEC_READ(fecRFM69Log, b));
+}
+
+uint8_t fecRFM69::divide(uint8_t a, uint8_t b){
+    if (a == 0){
+        return 0;
+    }
+    return RFM69_FEC_READ(fecRFM69Exp, RFM69_FEC_READ(fecRFM69Log, a) + 255 - RFM69_FEC_READ(fecRFM69Log, b));
+}
+
+uint8_t fecRFM69::power(uint8_t exponent){
+    return RFM69_FEC_READ(fecRFM69Exp, exponent);
+}
+
+int8_t fecRFM69::correct(uint8_t* word, uint8_t n){
+    uint8_t parity = this->parity;
+
+    // syndromes, the received word evaluated at the roots of the generator.
+    uint8_t syndromes[RFM69_FEC_MAX_PARITY];
+    bool clean = true;
+    for (uint8_t i=0; i < parity; i++){
+        uint8_t s = 0;
+        uint8_t root = fecRFM69::power(i);
+        for (uint8_t j=0; j < n; j++){
+            s = fecRFM69::multiply(s, root) ^ word[j];
+        }
+        syndromes[i] = s;
+        clean &= (s == 0);
+    }
+    if (clean){
+        return 0;
+    }
+
+    // Berlekamp-Massey, error locator polynomial, lowest power first.
+    uint8_t locator[RFM69_FEC_MAX_PARITY + 1] = {1};
+    uint8_t previous[RFM69_FEC_MAX_PARITY + 1] = {1};
+    uint8_t errors = 0;
+    uint8_t shift = 1;
+    uint8_t previous_discrepancy = 1;
+    for (uint8_t k=0; k < parity; k++){
+        uint8_t discrepancy = syndromes[k];
+        for (uint8_t i=1; i <= errors; i++){
+            discrepancy ^= fecRFM69::multiply(locator[i], syndromes[k - i]);
+        }
+        if (discrepancy == 0){
+            shift++;
+            continue;
+        }
+        uint8_t scale = fecRFM69::divide(discrepancy, previous_discrepancy);
+        uint8_t backup[RFM69_FEC_MAX_PARITY + 1];
+        bool grow = (2 * errors) <= k;
+        if (grow){
+            memcpy(backup, locator, sizeof(backup));
+        }
+        for (uint8_t i=0; (i + shift) <= parity; i++){
+            locator[i + shift] ^= fecRFM69::multiply(scale, previous[i]);
+        }
+        if (grow){
+            errors = k + 1 - errors;
+            memcpy(previous, backup, sizeof(previous));
+            previous_discrepancy = discrepancy;
+            shift = 1;
+        } else {
+            shift++;
+        }
+    }
+    if ((2 * errors) > parity){
+        return -1;
+    }
+
+    // evaluator polynomial, syndromes times locator modulo x^parity.
+    uint8_t evaluator[RFM69_FEC_MAX_PARITY];
+    for (uint8_t i=0; i < parity; i++){
+        uint8_t e = 0;
+        for (uint8_t j=0; (j <= i) && (j <= errors); j++){
+            e ^= fecRFM69::multiply(syndromes[i - j], locator[j]);
+        }
+        evaluator[i] = e;
+    }
+
+    // Chien search over the positions of the shortened code, with Forney's
+    // algorithm for the value at every root.
+    uint8_t found = 0;
+    for (uint8_t j=0; j < n; j++){
+        // position j has locator alpha^e, the root is alpha^-e.
+        uint8_t e = n - 1 - j;
+        uint8_t inverse = (255 - e) % 255;
+
+        uint8_t value = 0;
+        uint8_t derivative = 0;
+        for (uint8_t i=0; i <= errors; i++){
+            uint8_t term = fecRFM69::multiply(locator[i], fecRFM69::power(((uint16_t) inverse * i) % 255));
+            value ^= term;
+            if (i & 1){
+                // formal derivative, the odd terms divided by x once.
+                derivative ^= fecRFM69::multiply(locator[i], fecRFM69::power(((uint16_t) inverse * (i - 1)) % 255));
+            }
+        }
+        if (value != 0){
+            continue;
+        }
+        if (derivative == 0){
+            return -1;
+        }
+
+        uint8_t numerator = 0;
+        for (uint8_t i=0; i < parity; i++){
+            numerator ^= fecRFM69::multiply(evaluator[i], fecRFM69::power(((uint16_t) inverse * i) % 255));
+        }
+        word[j] ^= fecRFM69::multiply(fecRFM69::power(e), fecRFM69::divide(numerator, derivative));
+        found++;
+    }
+
+    // roots outside the shortened code mean too many errors.
+    if (found != errors){
+        return -1;
+    }
+    return errors;
+}
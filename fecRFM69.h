@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef FEC_RFM69_H
+#define FEC_RFM69_H
+
+/*
+    Forward error correction with a Reed-Solomon code, to recover frames with
+    bit errors instead of retransmitting them.
+
+    The radio discards a frame with a single wrong bit if its CRC is on, so
+    disable it with plainRFM69::setCRC(false) before setPacketType(). The
+    Reed-Solomon code then both corrects and detects the errors: with
+    'parity' bytes per codeword, up to parity / 2 wrong bytes per codeword
+    are corrected, more are detected with high probability.
+
+    The payload is split over 'depth' codewords, byte i belongs to codeword
+    i % depth; a burst of errors is spread over the codewords, so up to
+    depth * parity / 2 consecutive wrong bytes are corrected. The encoded
+    frame is the payload itself followed by the parity bytes, interleaved
+    in the same way:
+        [payload (len), parity (depth * parity)]
+
+    Use fixed length packets, the length byte of variable length packets is
+    not protected.
+
+    The code is RS(255, 255 - parity) over GF(256) with polynomial 0x11D,
+    shortened to the length of the frame. Multiplication uses a table of
+    logarithms and exponents (768 bytes, in flash on AVR); decoding uses
+    Berlekamp-Massey, a Chien search and Forney's algorithm, and only costs
+    more than computing the syndromes if there are errors.
+*/
+
+#ifndef RFM69_FEC_MAX_PARITY
+#define RFM69_FEC_MAX_PARITY 16
+#endif
+
+// largest encoded frame, the FIFO holds 66 bytes.
+#ifndef RFM69_FEC_MAX_FRAME
+#define RFM69_FEC_MAX_FRAME 66
+#endif
+
+class fecRFM69{
+    protected:
+        uint8_t parity;
+        uint8_t depth;
+
+        // generator polynomial, highest power first, parity + 1 coefficients.
+        uint8_t generator[RFM69_FEC_MAX_PARITY + 1];
+
+        // codeword being decoded.
+        uint8_t codeword[RFM69_FEC_MAX_FRAME];
+
+        uint16_t corrected;
+        uint16_t failed;
+
+        static uint8_t multiply(uint8_t a, uint8_t b);
+        static uint8_t divide(uint8_t a, uint8_t b);
+        static uint8_t power(uint8_t exponent); // alpha^exponent, 0 ... 254.
+
+        int8_t correct(uint8_t* word, uint8_t n);
+        /*
+            Corrects a codeword of n bytes, parity bytes last, in place.
+            Returns the number of corrected bytes, or -1 if uncorrectable.
+        */
+
+    public:
+        fecRFM69(uint8_t parity, uint8_t depth=1);
+        /*
+            parity is the number of parity bytes per codeword, even and up to
+            RFM69_FEC_MAX_PARITY; depth the number of interleaved codewords.
+            Both sides should use the same parameters. A parity below two is
+            raised to two, an odd one rounded up, see getOverhead().
+        */
+
+        uint8_t getOverhead(){return this->parity * this->depth;};
+        /*
+            Number of bytes added to the payload.
+        */
+
+        uint8_t encode(const void* payload, uint8_t len, uint8_t* out);
+        /*
+            Writes the payload and the parity bytes to out, which should hold
+            len + getOverhead() bytes, at most RFM69_FEC_MAX_FRAME. Returns
+            the length of the frame, zero if it is too long.
+        */
+
+        uint8_t decode(uint8_t* frame, uint8_t len);
+        /*
+            Corrects the frame in place, returns the length of the payload at
+            the start of frame, or zero if it could not be corrected.
+        */
+
+        uint16_t getCorrected(){return this->corrected;};
+        uint16_t getFailed(){return this->failed;};
+        /*
+            Total number of bytes corrected, and number of frames that could
+            not be corrected.
+        */
+};
+
+//FEC_RFM69_H
+#endif
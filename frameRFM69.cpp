@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "frameRFM69.h"
+
+
+static uint16_t frameRFM69EncodeParts(const uint8_t* first, uint16_t first_len, const uint8_t* second, uint16_t second_len, uint8_t* out){
+    // COBS encode the concatenation of first and second, such that a record
+    // does not have to be assembled in a temporary buffer first.
+    uint16_t code_index = 0;
+    uint16_t out_index = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i=0; i < (first_len + second_len); i++){
+        uint8_t c = (i < first_len) ? first[i] : second[i - first_len];
+        if (c == 0){
+            // end of a block, the zero is implied by the code.
+            out[code_index] = code;
+            code_index = out_index++;
+            code = 1;
+        } else {
+            out[out_index++] = c;
+            code++;
+            if (code == 0xFF){
+                // maximum block length, without an implied zero.
+                out[code_index] = code;
+                code_index = out_index++;
+                code = 1;
+            }
+        }
+    }
+    out[code_index] = code;
+    out[out_index++] = RFM69_FRAME_DELIMITER;
+    return out_index;
+}
+
+uint16_t frameRFM69Encode(const uint8_t* in, uint16_t len, uint8_t* out){
+    return frameRFM69EncodeParts(in, len, 0, 0, out);
+}
+
+uint16_t frameRFM69Decode(const uint8_t* in, uint16_t len, uint8_t* out){
+    uint16_t in_index = 0;
+    uint16_t out_index = 0;
+
+    while (in_index < len){
+        uint8_t code = in[in_index++];
+        if ((code == 0) || ((in_index + code - 1) > len)){
+            return 0; // delimiter in the frame or block beyond the frame.
+        }
+        for (uint8_t i=1; i < code; i++){
+            out[out_index++] = in[in_index++];
+        }
+        if ((code != 0xFF) && (in_index < len)){
+            out[out_index++] = 0;
+        }
+    }
+    return out_index;
+}
+
+uint16_t frameRFM69EncodePacket(const frameRFM69Packet* packet, uint8_t* out){
+    uint8_t header[RFM69_FRAME_PACKET_HEADER];
+    header[0] = RFM69_FRAME_TYPE_PACKET;
+    header[1] = packet->timestamp;
+    header[2] = packet->timestamp >> 8;
+    header[3] = packet->timestamp >> 16;
+    header[4] = packet->timestamp >> 24;
+    header[5] = packet->rssi;
+    header[6] = packet->address;
+    header[7] = packet->length;
+    return frameRFM69EncodeParts(header, sizeof(header), packet->payload, packet->length, out);
+}
+
+bool frameRFM69ParsePacket(const uint8_t* record, uint16_t len, frameRFM69Packet* packet){
+    if ((len < RFM69_FRAME_PACKET_HEADER) || (record[0] != RFM69_FRAME_TYPE_PACKET)){
+        return false;
+    }
+    if (record[7] != (len - RFM69_FRAME_PACKET_HEADER)){
+        return false;
+    }
+    packet->timestamp = (uint32_t) record[1] | ((uint32_t) record[2] << 8) |
+                        ((uint32_t) record[3] << 16) | ((uint32_t) record[4] << 24);
+    packet->rssi = record[5];
+    packet->address = record[6];
+    packet->length = record[7];
+    packet->payload = &(record[RFM69_FRAME_PACKET_HEADER]);
+    return true;
+}
+
+uint16_t frameRFM69EncodeTransmit(const frameRFM69Transmit* transmit, uint8_t* out){
+    uint8_t header[RFM69_FRAME_TRANSMIT_HEADER];
+    header[0] = RFM69_FRAME_TYPE_TRANSMIT;
+    header[1] = transmit->address;
+    header[2] = transmit->length;
+    return frameRFM69EncodeParts(header, sizeof(header), transmit->payload, transmit->length, out);
+}
+
+bool frameRFM69ParseTransmit(const uint8_t* record, uint16_t len, frameRFM69Transmit* transmit){
+    if ((len < RFM69_FRAME_TRANSMIT_HEADER) || (record[0] != RFM69_FRAME_TYPE_TRANSMIT)){
+        return false;
+    }
+    if (record[2] != (len - RFM69_FRAME_TRANSMIT_HEADER)){
+        return false;
+    }
+    transmit->address = record[1];
+    transmit->length = record[2];
+    transmit->payload = &(record[RFM69_FRAME_TRANSMIT_HEADER]);
+    return true;
+}
+
+uint16_t frameRFM69EncodeRaw(const frameRFM69Raw* raw, uint8_t* out){
+    uint8_t header[RFM69_FRAME_RAW_HEADER];
+    header[0] = RFM69_FRAME_TYPE_RAW;
+    header[1] = raw->timestamp;
+    header[2] = raw->timestamp >> 8;
+    header[3] = raw->timestamp >> 16;
+    header[4] = raw->timestamp >> 24;
+    header[5] = raw->rssi;
+    header[6] = raw->flags;
+    header[7] = raw->fei;
+    header[8] = ((uint16_t) raw->fei) >> 8;
+    header[9] = raw->length;
+    return frameRFM69EncodeParts(header, sizeof(header), raw->frame, raw->length, out);
+}
+
+bool frameRFM69ParseRaw(const uint8_t* record, uint16_t len, frameRFM69Raw* raw){
+    if ((len < RFM69_FRAME_RAW_HEADER) || (record[0] != RFM69_FRAME_TYPE_RAW)){
+        return false;
+    }
+    if (record[9] != (len - RFM69_FRAME_RAW_HEADER)){
+        return false;
+    }
+    raw->timestamp = (uint32_t) record[1] | ((uint32_t) record[2] << 8) |
+                     ((uint32_t) record[3] << 16) | ((uint32_t) record[4] << 24);
+    raw->rssi = record[5];
+    raw->flags = record[6];
+    raw->fei = (int16_t) (record[7] | (record[8] << 8));
+    raw->length = record[9];
+    raw->frame = &(record[RFM69_FRAME_RAW_HEADER]);
+    return true;
+}
+
+uint16_t frameRFM69EncodeTrace(const frameRFM69Trace* trace, uint8_t* out){
+    uint8_t header[RFM69_FRAME_TRACE_HEADER];
+    header[0] = RFM69_FRAME_TYPE_TRACE;
+    header[1] = trace->dropped;
+    header[2] = trace->dropped >> 8;
+    header[3] = trace->count;
+    return frameRFM69EncodeParts(header, sizeof(header), trace->entries, trace->count * RFM69_FRAME_TRACE_ENTRY, out);
+}
+
+bool frameRFM69ParseTrace(const uint8_t* record, uint16_t len, frameRFM69Trace* trace){
+    if ((len < RFM69_FRAME_TRACE_HEADER) || (record[0] != RFM69_FRAME_TYPE_TRACE)){
+        return false;
+    }
+    if ((record[3] * RFM69_FRAME_TRACE_ENTRY) != (len - RFM69_FRAME_TRACE_HEADER)){
+        return false;
+    }
+    trace->dropped = record[1] | (record[2] << 8);
+    trace->count = record[3];
+    trace->entries = &(record[RFM69_FRAME_TRACE_HEADER]);
+    return true;
+}
@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef FRAME_RFM69_H
+#define FRAME_RFM69_H
+
+/*
+    Binary framing of packet records, shared by the gateway on the
+    microcontroller (gatewayRFM69) and the decoder on the host. It does not
+    depend on Arduino, such that the host can compile this file as is.
+
+    Each record is encoded with Consistent Overhead Byte Stuffing (COBS), this
+    removes all zero bytes from the record at a cost of one byte per 254 bytes.
+    A zero byte is then used as delimiter between the records. A receiver that
+    starts halfway a stream, or that loses bytes, resynchronises on the next
+    zero byte.
+
+    Record layout, before encoding, multi byte values are little endian:
+        0       type, RFM69_FRAME_TYPE_*
+        1-4     timestamp, micros() when the packet was read from the radio.
+        5       RssiValue, RSSI = -RssiValue/2 dBm.
+        6       address byte, zero if addressing is not used.
+        7       payload length.
+        8...    payload.
+
+    The transmit record, sent from the host to the gateway:
+        0       type, RFM69_FRAME_TYPE_TRANSMIT
+        1       address byte, used if addressing is enabled.
+        2       payload length.
+        3...    payload.
+
+    The raw record, written by the sniffer (snifferRFM69):
+        0       type, RFM69_FRAME_TYPE_RAW
+        1-4     timestamp, micros() when the frame was read from the radio.
+        5       RssiValue, RSSI = -RssiValue/2 dBm.
+        6       flags, RFM69_FRAME_FLAG_*
+        7-8     FEI, signed, in steps of 61 Hz.
+        9       frame length.
+        10...   frame, as read from the FIFO; length byte (if variable length),
+                address byte and payload.
+
+    The trace record, written by traceRFM69::dump():
+        0       type, RFM69_FRAME_TYPE_TRACE
+        1-2     entries dropped by the trace, since it was constructed.
+        3       number of entries.
+        4...    entries, RFM69_FRAME_TRACE_ENTRY bytes each:
+                0-3 time, 4 type, 5 state, 6 flags, 7 value; see traceRFM69.h.
+*/
+
+#define RFM69_FRAME_TYPE_PACKET 0x01
+#define RFM69_FRAME_TYPE_TRANSMIT 0x02
+#define RFM69_FRAME_TYPE_RAW 0x03
+#define RFM69_FRAME_TYPE_TRACE 0x04
+
+#define RFM69_FRAME_PACKET_HEADER 8
+#define RFM69_FRAME_TRANSMIT_HEADER 3
+#define RFM69_FRAME_RAW_HEADER 10
+#define RFM69_FRAME_TRACE_HEADER 4
+#define RFM69_FRAME_TRACE_ENTRY 8
+
+// flags of the raw record.
+#define RFM69_FRAME_FLAG_CRC_OK (1<<0)
+#define RFM69_FRAME_FLAG_TRUNCATED (1<<1)
+
+#define RFM69_FRAME_DELIMITER 0x00
+
+// maximum encoded size of a record of n bytes, including the delimiter.
+#define RFM69_FRAME_MAX_ENCODED(n) ((n) + ((n) / 254) + 2)
+
+struct frameRFM69Packet {
+    uint32_t timestamp;
+    uint8_t rssi;
+    uint8_t address;
+    uint8_t length;
+    const uint8_t* payload;
+};
+
+struct frameRFM69Transmit {
+    uint8_t address;
+    uint8_t length;
+    const uint8_t* payload;
+};
+
+struct frameRFM69Raw {
+    uint32_t timestamp;
+    uint8_t rssi;
+    uint8_t flags;
+    int16_t fei;
+    uint8_t length;
+    const uint8_t* frame;
+};
+
+struct frameRFM69Trace {
+    uint16_t dropped;
+    uint8_t count;
+    const uint8_t* entries;
+};
+
+uint16_t frameRFM69Encode(const uint8_t* in, uint16_t len, uint8_t* out);
+/*
+    COBS encodes len bytes from in to out and appends the delimiter. Returns
+    the number of bytes written to out, at most RFM69_FRAME_MAX_ENCODED(len).
+*/
+
+uint16_t frameRFM69Decode(const uint8_t* in, uint16_t len, uint8_t* out);
+/*
+    Decodes len bytes of a COBS encoded frame, without its delimiter, from in
+    to out. Decoding in place, with out equal to in, is possible.
+
+    Returns the number of decoded bytes, zero for a malformed frame.
+*/
+
+uint16_t frameRFM69EncodePacket(const frameRFM69Packet* packet, uint8_t* out);
+/*
+    Builds a packet record and encodes it into out, including the delimiter.
+    Returns the number of bytes written, which is at most:
+        RFM69_FRAME_MAX_ENCODED(RFM69_FRAME_PACKET_HEADER + packet->length)
+*/
+
+bool frameRFM69ParsePacket(const uint8_t* record, uint16_t len, frameRFM69Packet* packet);
+/*
+    Parses a decoded record, the payload pointer refers to the record itself,
+    so the record should outlive the packet. Returns false if the record is not
+    a valid packet record.
+*/
+
+uint16_t frameRFM69EncodeTransmit(const frameRFM69Transmit* transmit, uint8_t* out);
+/*
+    Builds a transmit record and encodes it into out, like
+    frameRFM69EncodePacket().
+*/
+
+bool frameRFM69ParseTransmit(const uint8_t* record, uint16_t len, frameRFM69Transmit* transmit);
+/*
+    Parses a decoded transmit record, like frameRFM69ParsePacket().
+*/
+
+uint16_t frameRFM69EncodeRaw(const frameRFM69Raw* raw, uint8_t* out);
+/*
+    Builds a raw record and encodes it into out, like
+    frameRFM69EncodePacket().
+*/
+
+bool frameRFM69ParseRaw(const uint8_t* record, uint16_t len, frameRFM69Raw* raw);
+/*
+    Parses a decoded raw record, like frameRFM69ParsePacket().
+*/
+
+uint16_t frameRFM69EncodeTrace(const frameRFM69Trace* trace, uint8_t* out);
+/*
+    Builds a trace record from count packed entries and encodes it into out,
+    like frameRFM69EncodePacket().
+*/
+
+bool frameRFM69ParseTrace(const uint8_t* record, uint16_t len, frameRFM69Trace* trace);
+/*
+    Parses a decoded trace record, like frameRFM69ParsePacket(). The entries
+    are unpacked with traceRFM69::unpack().
+*/
+
+//FRAME_RFM69_H
+#endif
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "gatewayRFM69.h"
+
+
+
+/*
+        Public Methods
+*/
+
+uint8_t gatewayRFM69::bridge(Print* out){
+    uint8_t count = 0;
+
+    while (this->buffer_read_index != this->buffer_write_index){
+        uint8_t index = this->buffer_read_index;
+        uint16_t length = this->encodeSlot(index, &(this->batch[this->batch_length]), RFM69_GATEWAY_BATCH_SIZE - this->batch_length);
+        if (length == 0){
+            // does not fit behind the batch, try again in an empty batch.
+            this->flush(out);
+            length = this->encodeSlot(index, this->batch, RFM69_GATEWAY_BATCH_SIZE);
+        }
+        this->batch_length += length;
+
+        // the slot is encoded, it can be reused.
+        this->buffer_read_index = (index + 1) % this->buffer_size;
+        count++;
+    }
+
+    this->flush(out);
+    return count;
+}
+
+
+uint8_t gatewayRFM69::receiveHost(Stream* in){
+    uint8_t count = 0;
+
+    while (true){
+        if (this->host_record_length){
+            // a record is waiting for the radio.
+            if (!this->canSend()){
+                return count;
+            }
+            this->transmitHost();
+            count++;
+        }
+
+        if (!in->available()){
+            return count;
+        }
+
+        int c = in->read();
+        if (c == RFM69_FRAME_DELIMITER){
+            if (!this->host_overflow){
+                this->host_record_length = frameRFM69Decode(this->host_buffer, this->host_length, this->host_buffer);
+            }
+            this->host_length = 0;
+            this->host_overflow = false;
+        } else if (this->host_length < RFM69_GATEWAY_HOST_BUFFER){
+            this->host_buffer[this->host_length++] = c;
+        } else {
+            // too long for any packet, discard up to the next delimiter.
+            this->host_overflow = true;
+        }
+    }
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+void gatewayRFM69::transmitHost(){
+    frameRFM69Transmit transmit;
+    uint8_t record_length = this->host_record_length;
+    this->host_record_length = 0;
+
+    if (!frameRFM69ParseTransmit(this->host_buffer, record_length, &transmit)){
+        return;
+    }
+    void* payload = (void*) transmit.payload;
+
+    if (this->use_variable_length){
+        // the length should fit the Tx buffer, address included.
+        if ((transmit.length == 0) || ((transmit.length + this->use_addressing) > this->packet_length)){
+            return;
+        }
+        if (this->use_addressing){
+            this->sendAddressedVariable(transmit.address, payload, transmit.length);
+        } else {
+            this->sendVariable(payload, transmit.length);
+        }
+    } else {
+        // fixed length packets should match the length exactly.
+        if (transmit.length != (this->packet_length - this->use_addressing)){
+            return;
+        }
+        if (this->use_addressing){
+            this->sendAddressed(transmit.address, payload);
+        } else {
+            this->send(payload);
+        }
+    }
+}
+
+uint16_t gatewayRFM69::encodeSlot(uint8_t index, uint8_t* out, uint16_t space){
+    uint8_t* slot = this->packet_buffer[index];
+
+    frameRFM69Packet packet;
+    packet.timestamp = this->packet_time[index];
+    packet.rssi = this->packet_rssi[index];
+    packet.address = 0;
+
+    // determine the payload in the slot, identical to plainRFM69::read().
+    uint8_t length = this->packet_length;
+    if (this->use_variable_length){
+        length = (slot[0] > this->packet_length) ? this->packet_length : slot[0];
+        slot++;
+    }
+    if (this->use_addressing && (length > 0)){
+        packet.address = slot[0];
+        slot++;
+        length--;
+    }
+    packet.length = length;
+    packet.payload = slot;
+
+    if (RFM69_FRAME_MAX_ENCODED(RFM69_FRAME_PACKET_HEADER + length) > space){
+        return 0;
+    }
+    return frameRFM69EncodePacket(&packet, out);
+}
+
+void gatewayRFM69::flush(Print* out){
+    if (this->batch_length){
+        out->write(this->batch, this->batch_length);
+        this->batch_length = 0;
+    }
+}
+
+void gatewayRFM69::setRawPacketLength(){
+    plainRFM69::setRawPacketLength();
+    this->packet_rssi = (uint8_t*) malloc(this->buffer_size);
+    this->packet_time = (uint32_t*) malloc(this->buffer_size * sizeof(uint32_t));
+}
+
+void gatewayRFM69::readPacket(){
+    // The RSSI has to be read before the FIFO is emptied, emptying it restarts
+    // the receiver.
+    this->packet_rssi[this->buffer_write_index] = this->getRssiValue();
+    this->packet_time[this->buffer_write_index] = micros();
+
+    plainRFM69::readPacket();
+}
@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <Arduino.h>
+#include <plainRFM69.h>
+#include <frameRFM69.h>
+
+#ifndef GATEWAY_RFM69_H
+#define GATEWAY_RFM69_H
+
+/*
+    The gatewayRFM69 object extends plainRFM69 to forward all received packets
+    to a host, for example over the USB serial port.
+
+    Instead of printing the packets as text, the packets are written as binary
+    records with the COBS framing from frameRFM69.h. For every packet the
+    RSSI and the time it was read from the radio are recorded as well, this is
+    done in readPacket(), so it is exact even if bridge() is called late.
+
+    The bridge() method encodes the packets directly from the Rx buffer into a
+    batch buffer, which is written to the host with a single write() call when
+    it is full. This keeps the per packet overhead minimal, such that a gateway
+    can forward packets at the full rate of the radio.
+
+    The host can request packets to be sent by writing transmit records, these
+    are handled by receiveHost().
+
+    The extras/host/ folder contains the decoder for the host side and the
+    rfm69d daemon, which shares a gateway with multiple local programs.
+*/
+
+// records that do not fit an empty batch are dropped by bridge().
+#ifndef RFM69_GATEWAY_BATCH_SIZE
+#define RFM69_GATEWAY_BATCH_SIZE 128
+#endif
+
+#ifndef RFM69_GATEWAY_HOST_BUFFER
+#define RFM69_GATEWAY_HOST_BUFFER 80
+#endif
+
+class gatewayRFM69 : public plainRFM69{
+    protected:
+
+        // RssiValue and micros() per Rx buffer slot.
+        uint8_t* packet_rssi;
+        uint32_t* packet_time;
+
+        // encoded records waiting to be written.
+        uint8_t batch[RFM69_GATEWAY_BATCH_SIZE];
+        uint16_t batch_length;
+
+        // frame from the host, being received or waiting to be sent.
+        uint8_t host_buffer[RFM69_GATEWAY_HOST_BUFFER];
+        uint8_t host_length;
+        uint8_t host_record_length;
+        bool host_overflow;
+
+        void flush(Print* out);
+        /*
+            Writes the batch to out and empties it.
+        */
+
+        virtual uint16_t encodeSlot(uint8_t index, uint8_t* out, uint16_t space);
+        /*
+            Encodes the record for Rx buffer slot index into out. Returns the
+            number of bytes written, or zero if the record might not fit in
+            space bytes.
+        */
+
+        void transmitHost();
+        /*
+            Sends the decoded transmit record with the send method that matches
+            the packet type, records that do not fit the packet type are
+            dropped.
+        */
+
+        virtual void readPacket();
+        /*
+            Records the RSSI and timestamp, then reads the packet.
+        */
+
+        virtual void setRawPacketLength();
+        /*
+            Also allocates the RSSI and timestamp for every buffer slot.
+        */
+
+    public:
+
+        gatewayRFM69(uint8_t cs_pin) : plainRFM69(cs_pin){
+            this->packet_rssi = 0;
+            this->packet_time = 0;
+            this->batch_length = 0;
+            this->host_length = 0;
+            this->host_record_length = 0;
+            this->host_overflow = false;
+        };
+
+        uint8_t bridge(Print* out);
+        /*
+            Encodes all packets available in the Rx buffer and writes them to
+            out, for example bridge(&Serial). Returns the number of packets
+            written.
+
+            The packets are removed from the buffer, so read() and available()
+            should not be used in combination with this.
+        */
+
+        uint8_t receiveHost(Stream* in);
+        /*
+            Reads the transmit records written by the host from in, for example
+            receiveHost(&Serial), and sends them. Returns the number of records
+            handled.
+
+            If the radio is still sending, the record is kept and no more
+            bytes are read from in, it is sent on one of the next calls.
+        */
+};
+
+//GATEWAY_RFM69_H
+#endif
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "hopRFM69.h"
+
+
+
+/*
+        Public Methods
+*/
+
+void hopRFM69::setHopChannels(uint32_t base_freq, uint32_t spacing, uint8_t count, const uint8_t* pattern){
+    if (count > RFM69_HOP_MAX_CHANNELS){
+        count = RFM69_HOP_MAX_CHANNELS;
+    }
+    this->hop_count = count;
+    this->hop_index = 0;
+
+    // precompute the exact Frf values, such that hopping is just a burst write.
+    for (uint8_t i=0; i < count; i++){
+        uint8_t channel = (pattern) ? pattern[i] : i;
+        this->hop_table[i] = bareRFM69::frequencyToFrf(base_freq + channel * spacing);
+    }
+
+    // not receiving yet, so just set the first channel.
+    this->setFrf(this->hop_table[0]);
+}
+
+void hopRFM69::setHopMode(uint8_t mode, uint16_t dwell_time_ms){
+    this->hop_mode = mode;
+    this->dwell_time = dwell_time_ms;
+    this->hop_time = millis();
+}
+
+void hopRFM69::hop(){
+    this->setHopIndex((this->hop_index + 1) % this->hop_count);
+}
+
+void hopRFM69::setHopIndex(uint8_t index){
+    this->hop_index = index;
+    if (this->state == RFM69_PLAIN_STATE_SENDING){
+        // do not disturb the transmission, poll() retunes when it is sent.
+        this->hop_pending = true;
+        return;
+    }
+    this->retune();
+}
+
+void hopRFM69::poll(){
+    uint8_t previous_state = this->state;
+
+    plainRFM69::poll();
+
+    if ((previous_state == RFM69_PLAIN_STATE_SENDING) && (this->state != RFM69_PLAIN_STATE_SENDING)){
+        // the packet has been sent, the radio is back in receiving or idle mode.
+        if (this->hop_pending){
+            // an explicit hop was requested during the transmission.
+            this->hop_pending = false;
+            this->retune();
+        } else if (this->hop_mode == RFM69_HOP_PER_PACKET){
+            this->hop_index = (this->hop_index + 1) % this->hop_count;
+            this->retune();
+        }
+    }
+
+    this->hopTimeslot();
+}
+
+void hopRFM69::update(){
+    // poll() in the interrupt also hops and retunes.
+    noInterrupts();
+    this->hopTimeslot();
+    interrupts();
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+void hopRFM69::retune(){
+    uint32_t Frf = this->hop_table[this->hop_index];
+    if (this->state == RFM69_PLAIN_STATE_RECEIVING){
+        this->hopFrf(Frf, RFM69_MODE_SEQUENCER_ON | RFM69_MODE_RECEIVER);
+        this->shadow_mode = RFM69_MODE_SEQUENCER_ON | RFM69_MODE_RECEIVER;
+    } else if (this->idle_mode == RFM69_MODE_FREQ_SYNTH){
+        // relock the synthesizer, it stays in the idle mode.
+        this->hopFrf(Frf, RFM69_MODE_SEQUENCER_ON | RFM69_MODE_FREQ_SYNTH);
+        this->shadow_mode = RFM69_MODE_SEQUENCER_ON | RFM69_MODE_FREQ_SYNTH;
+    } else {
+        // standby or sleep, the PLL locks on the new Frf when it starts.
+        this->setFrf(Frf);
+    }
+}
+
+void hopRFM69::hopTimeslot(){
+    if ((this->hop_mode == RFM69_HOP_TIMESLOT) && ((millis() - this->hop_time) >= this->dwell_time)){
+        // keep to the slot grid, unless we are lagging more than a slot.
+        this->hop_time += this->dwell_time;
+        if ((millis() - this->hop_time) >= this->dwell_time){
+            this->hop_time = millis();
+        }
+        this->hop();
+    }
+}
+
+void hopRFM69::readPacket(){
+    plainRFM69::readPacket();
+
+    // The FIFO is empty now, so the AutoMode has returned the radio to Rx.
+    if (this->hop_mode == RFM69_HOP_PER_PACKET){
+        this->hop_index = (this->hop_index + 1) % this->hop_count;
+        this->retune();
+    } else if (this->hop_mode == RFM69_HOP_TIMESLOT){
+        // follow the slot timing of the sender.
+        this->hop_time = millis();
+    }
+}
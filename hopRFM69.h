@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <Arduino.h>
+#include <plainRFM69.h>
+
+#ifndef HOP_RFM69_H
+#define HOP_RFM69_H
+
+/*
+    The hopRFM69 object extends plainRFM69 with frequency hopping.
+
+    The hop table contains the exact Frf register values of the channels, in
+    the order in which they are visited. It is computed once by
+    setHopChannels(), such that a hop only consists of the fast retune
+    sequence from bareRFM69::hopFrf(); a single burst write of the Frf
+    registers and a pass through the frequency synthesizer mode.
+
+    Two ways of synchronising the peers are provided:
+
+    RFM69_HOP_PER_PACKET:
+        Both sides move to the next channel after every packet, the sender when
+        the packet is sent, the receiver when it is read from the radio. As long
+        as no packets are lost, the peers stay on the same channel. A lost
+        packet can be recovered from with setHopIndex(), for example by falling
+        back to a known index after a timeout.
+
+    RFM69_HOP_TIMESLOT:
+        Both sides move to the next channel after the dwell time has passed.
+        When a packet is received, the start of the current time slot is
+        aligned to the moment the packet was read, so a receiver follows the
+        clock of the sender. The dwell time also bounds the time spent on one
+        channel for regulatory compliance. In this mode update() should be
+        called periodically from the loop, as the interrupt does not trigger
+        on the end of the time slot.
+
+    A hop is never performed during a transmission, it is deferred until the
+    packet is sent.
+*/
+
+#define RFM69_HOP_MANUAL 0
+#define RFM69_HOP_PER_PACKET 1
+#define RFM69_HOP_TIMESLOT 2
+
+#ifndef RFM69_HOP_MAX_CHANNELS
+#define RFM69_HOP_MAX_CHANNELS 16
+#endif
+
+class hopRFM69 : public plainRFM69{
+    protected:
+
+        // Frf value per hop, in visiting order.
+        uint32_t hop_table[RFM69_HOP_MAX_CHANNELS];
+        uint8_t hop_count;
+        volatile uint8_t hop_index;
+
+        uint8_t hop_mode;
+
+        // start of the current time slot and its length, in milliseconds.
+        volatile uint32_t hop_time;
+        uint16_t dwell_time;
+
+        // set when a hop was requested while sending.
+        volatile bool hop_pending;
+
+        void retune();
+        /*
+            Applies the Frf of the current hop index to the radio. While
+            receiving, the radio is returned to Rx, otherwise it stays in the
+            idle mode, see plainRFM69::setIdleMode().
+        */
+
+        void hopTimeslot();
+        /*
+            Hops if the time slot has ended in the time slot mode. Called by
+            poll() and update().
+        */
+
+        virtual void readPacket();
+        /*
+            Reads the packet and hops to the next channel in the per packet
+            mode, or aligns the time slot in the time slot mode.
+        */
+
+    public:
+
+        hopRFM69(uint8_t cs_pin) : plainRFM69(cs_pin){
+            this->hop_count = 0;
+            this->hop_index = 0;
+            this->hop_mode = RFM69_HOP_MANUAL;
+            this->hop_time = 0;
+            this->dwell_time = 0;
+            this->hop_pending = false;
+        };
+
+        void setHopChannels(uint32_t base_freq, uint32_t spacing, uint8_t count, const uint8_t* pattern=0);
+        /*
+            Computes the hop table, of at most RFM69_HOP_MAX_CHANNELS; further
+            channels are left out. The channels are at base_freq + channel *
+            spacing Hz.
+
+            If pattern is zero, the channels are visited in order 0 ... count-1.
+            Otherwise pattern should contain 'count' channel numbers, which
+            determine the order in which the channels are visited. The same
+            pattern should be used by all peers.
+
+            Should be called before receive(), it tunes the radio to the first
+            channel in the table.
+        */
+
+        void setHopMode(uint8_t mode, uint16_t dwell_time_ms=0);
+        /*
+            Sets the synchronisation mode, one of:
+                RFM69_HOP_MANUAL
+                    Only hop when hop() is called.
+                RFM69_HOP_PER_PACKET
+                    Hop after every packet sent or received.
+                RFM69_HOP_TIMESLOT
+                    Hop every dwell_time_ms milliseconds.
+        */
+
+        void hop();
+        /*
+            Moves to the next channel in the hop table. If the radio is
+            sending, the retune happens after the packet is sent, this replaces
+            the hop of the per packet mode for that packet.
+        */
+
+        void setHopIndex(uint8_t index);
+        /*
+            Moves to a specific position in the hop table, for synchronisation
+            with a peer.
+        */
+
+        uint8_t getHopIndex(){return this->hop_index;};
+        // returns the current position in the hop table.
+
+        virtual void poll();
+        /*
+            Identical to plainRFM69::poll(), but it also hops after a packet
+            is sent in the per packet mode, whether the radio returns to Rx
+            or to the idle mode, and at the end of a time slot in the
+            time slot mode.
+        */
+
+        void update();
+        /*
+            Only hops at the end of a time slot in the time slot mode, with
+            interrupts disabled. Call it periodically from the loop, instead
+            of poll(), which must not run there while it is attached to the
+            interrupt.
+        */
+};
+
+//HOP_RFM69_H
+#endif
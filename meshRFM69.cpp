@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "meshRFM69.h"
+
+
+
+/*
+        Public Methods
+*/
+
+void meshRFM69::setMeshAddress(uint8_t address){
+    this->mesh_address = address;
+    this->setNodeAddress(address);
+    this->setBroadcastAddress(RFM69_MESH_BROADCAST);
+}
+
+uint8_t meshRFM69::sendMesh(uint8_t destination, const void* buffer, uint8_t len){
+    // the tx buffer holds packet_length bytes after the length byte.
+    if ((len + RFM69_MESH_HEADER_LENGTH + 1) > this->packet_length){
+        return RFM69_MESH_TOO_LONG;
+    }
+
+    // poll() may start a relay or route reply, and changes the routes and
+    // the sequence number; keep it out until the packet is in the FIFO.
+    noInterrupts();
+    if (!this->canSend()){
+        interrupts();
+        return RFM69_MESH_BUSY;
+    }
+
+    uint8_t result = RFM69_MESH_SENT;
+    route_t* route = this->findRoute(destination);
+    if (route == 0){
+        this->composeHeader(this->tx_buffer, RFM69_MESH_HEADER_LENGTH + 1, RFM69_MESH_BROADCAST, destination, RFM69_MESH_TYPE_ROUTE_REQUEST);
+        this->sendPacket(this->tx_buffer, RFM69_MESH_PAYLOAD);
+        result = RFM69_MESH_NO_ROUTE;
+    } else {
+        this->composeHeader(this->tx_buffer, RFM69_MESH_HEADER_LENGTH + 1 + len, route->next_hop, destination, RFM69_MESH_TYPE_DATA);
+        memcpy(&(this->tx_buffer[RFM69_MESH_PAYLOAD]), buffer, len);
+        this->sendPacket(this->tx_buffer, RFM69_MESH_PAYLOAD + len);
+    }
+    interrupts();
+    return result;
+}
+
+uint8_t meshRFM69::readMesh(void* buffer, uint8_t* origin){
+    if (this->buffer_read_index == this->buffer_write_index){
+        return 0;
+    }
+
+    // readPacket() only keeps complete packets for this node.
+    uint8_t* slot = this->packet_buffer[this->buffer_read_index];
+    uint8_t length = slot[0] - RFM69_MESH_HEADER_LENGTH - 1;
+    memcpy(buffer, &(slot[RFM69_MESH_PAYLOAD]), length);
+    if (origin){
+        *origin = slot[RFM69_MESH_ORIGIN];
+    }
+
+    this->buffer_read_index = (this->buffer_read_index+1) % this->buffer_size;
+    return length;
+}
+
+uint8_t meshRFM69::getHops(uint8_t destination){
+    route_t* route = this->findRoute(destination);
+    return (route) ? route->hops : 0;
+}
+
+void meshRFM69::forgetRoute(uint8_t destination){
+    route_t* route = this->findRoute(destination);
+    if (route){
+        route->hops = 0;
+    }
+}
+
+void meshRFM69::update(){
+    // readPacket() fills flood and the state changes in poll().
+    noInterrupts();
+    if (this->flood_pending && (this->state == RFM69_PLAIN_STATE_RECEIVING) && ((int32_t) (millis() - this->flood_time) >= 0)){
+        this->flood_pending = false;
+        this->sendPacket(this->flood, RFM69_MESH_PAYLOAD);
+    }
+    interrupts();
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+meshRFM69::route_t* meshRFM69::findRoute(uint8_t destination){
+    for (uint8_t i=0; i < RFM69_MESH_MAX_ROUTES; i++){
+        if ((this->routes[i].hops != 0) && (this->routes[i].destination == destination)){
+            return &(this->routes[i]);
+        }
+    }
+    return 0;
+}
+
+void meshRFM69::learnRoute(uint8_t destination, uint8_t next_hop, uint8_t hops){
+    if (destination == this->mesh_address){
+        return;
+    }
+
+    route_t* route = this->findRoute(destination);
+    if (route){
+        // keep the shortest route, but follow changes of the current one.
+        if ((hops <= route->hops) || (next_hop == route->next_hop)){
+            route->next_hop = next_hop;
+            route->hops = hops;
+        }
+        return;
+    }
+
+    // use an empty entry, or replace them in turn if the table is full.
+    route = &(this->routes[this->route_victim]);
+    for (uint8_t i=0; i < RFM69_MESH_MAX_ROUTES; i++){
+        if (this->routes[i].hops == 0){
+            route = &(this->routes[i]);
+            break;
+        }
+    }
+    if (route == &(this->routes[this->route_victim])){
+        this->route_victim = (this->route_victim + 1) % RFM69_MESH_MAX_ROUTES;
+    }
+    route->destination = destination;
+    route->next_hop = next_hop;
+    route->hops = hops;
+}
+
+bool meshRFM69::isDuplicate(uint8_t origin, uint8_t sequence){
+    uint16_t id = (origin << 8) | sequence;
+    for (uint8_t i=0; i < RFM69_MESH_SEEN; i++){
+        if (this->seen[i] == id){
+            return true;
+        }
+    }
+    this->seen[this->seen_index] = id;
+    this->seen_index = (this->seen_index + 1) % RFM69_MESH_SEEN;
+    return false;
+}
+
+void meshRFM69::composeHeader(uint8_t* packet, uint8_t length, uint8_t address, uint8_t destination, uint8_t type){
+    packet[0] = length;
+    packet[RFM69_MESH_ADDRESS] = address;
+    packet[RFM69_MESH_FROM] = this->mesh_address;
+    packet[RFM69_MESH_ORIGIN] = this->mesh_address;
+    packet[RFM69_MESH_DESTINATION] = destination;
+    packet[RFM69_MESH_SEQUENCE] = this->sequence++;
+    packet[RFM69_MESH_TYPE] = type;
+}
+
+void meshRFM69::readPacket(){
+    uint8_t* slot = this->packet_buffer[this->buffer_write_index];
+    this->readVariableFIFO(slot, this->packet_length + 1);
+
+    uint8_t length = slot[0];
+    if ((length < (RFM69_MESH_HEADER_LENGTH + 1)) || (length > this->packet_length)){
+        return; // not a mesh packet, or truncated.
+    }
+
+    uint8_t from = slot[RFM69_MESH_FROM];
+    uint8_t origin = slot[RFM69_MESH_ORIGIN];
+    uint8_t destination = slot[RFM69_MESH_DESTINATION];
+    uint8_t type = slot[RFM69_MESH_TYPE] & RFM69_MESH_TYPE_MASK;
+    uint8_t hops = (slot[RFM69_MESH_TYPE] & RFM69_MESH_HOPS_MASK) + 1;
+
+    if ((origin == this->mesh_address) || this->isDuplicate(origin, slot[RFM69_MESH_SEQUENCE])){
+        // our own flood, or a copy through another path.
+        this->duplicates++;
+        return;
+    }
+
+    // the transmitter is a neighbour, and the way back to the origin.
+    this->learnRoute(from, from, 1);
+    this->learnRoute(origin, from, hops);
+
+    if (type == RFM69_MESH_TYPE_ROUTE_REQUEST){
+        if (destination == this->mesh_address){
+            this->composeHeader(this->reply, RFM69_MESH_HEADER_LENGTH + 1, from, origin, RFM69_MESH_TYPE_ROUTE_REPLY);
+            this->sendPacket(this->reply, RFM69_MESH_PAYLOAD);
+        } else if ((hops < RFM69_MESH_MAX_HOPS) && !this->flood_pending){
+            // rebroadcast from update(), after a random delay.
+            memcpy(this->flood, slot, RFM69_MESH_PAYLOAD);
+            this->flood[0] = RFM69_MESH_HEADER_LENGTH + 1;
+            this->flood[RFM69_MESH_FROM] = this->mesh_address;
+            this->flood[RFM69_MESH_TYPE] = RFM69_MESH_TYPE_ROUTE_REQUEST | hops;
+            this->flood_time = millis() + random(RFM69_MESH_FLOOD_JITTER);
+            this->flood_pending = true;
+        }
+        return;
+    }
+
+    if (destination == this->mesh_address){
+        if (type == RFM69_MESH_TYPE_DATA){
+            this->commitSlot();
+        }
+        // a route reply has done its work by now.
+        return;
+    }
+
+    // relay, straight from the slot.
+    route_t* route = this->findRoute(destination);
+    if ((route == 0) || (hops >= RFM69_MESH_MAX_HOPS) || (type != RFM69_MESH_TYPE_DATA && type != RFM69_MESH_TYPE_ROUTE_REPLY)){
+        this->unroutable++;
+        return;
+    }
+    slot[RFM69_MESH_ADDRESS] = route->next_hop;
+    slot[RFM69_MESH_FROM] = this->mesh_address;
+    slot[RFM69_MESH_TYPE] = type | hops;
+    this->sendPacket(slot, length + 1);
+    this->forwarded++;
+}
@@ -0,0 +1,223 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <Arduino.h>
+#include <plainRFM69.h>
+
+#ifndef MESH_RFM69_H
+#define MESH_RFM69_H
+
+/*
+    The meshRFM69 object relays packets over multiple hops, it extends
+    plainRFM69 with variable length and addressing.
+
+    The address byte holds the next hop, so the address filter of the radio
+    still discards the packets for other nodes. It is followed by a header:
+        [from, origin, destination, sequence, type | hops, payload...]
+    from being the node that transmitted this hop, origin the node that
+    created the packet.
+
+    Routes are learned from every packet received; the node it came from is
+    the next hop towards its origin. If no route to the destination is known,
+    sendMesh() floods a route request and returns RFM69_MESH_NO_ROUTE, the
+    destination answers with a route reply along the learned path. The table
+    holds the next hop and hop count for RFM69_MESH_MAX_ROUTES destinations.
+
+    Packets are relayed from readPacket(), so from poll() in the interrupt:
+    the header is rewritten in the Rx buffer slot and the slot is written to
+    the FIFO directly, without copying it. The delay per hop is the airtime
+    and the SPI transfers. poll() must only be called from the interrupt.
+    Route requests are rebroadcast after a random delay to avoid collisions,
+    by update(), which should be called periodically from the loop.
+
+    Packets that were seen before, identified by origin and sequence number,
+    are dropped; a packet is relayed at most RFM69_MESH_MAX_HOPS times.
+
+    Order of calling the methods:
+        rfm.setRecommended();
+        rfm.setPacketType(true, true);
+        rfm.setBufferSize(4);
+        rfm.setPacketLength(RFM69_MESH_HEADER_LENGTH + payload length);
+        rfm.setMeshAddress(address);
+*/
+
+#define RFM69_MESH_BROADCAST 0xFF
+
+// results of sendMesh().
+#define RFM69_MESH_SENT 0
+#define RFM69_MESH_NO_ROUTE 1
+#define RFM69_MESH_BUSY 2
+#define RFM69_MESH_TOO_LONG 3
+
+#define RFM69_MESH_HEADER_LENGTH 5
+
+// position of the header fields in the packet, after the length byte.
+#define RFM69_MESH_ADDRESS 1
+#define RFM69_MESH_FROM 2
+#define RFM69_MESH_ORIGIN 3
+#define RFM69_MESH_DESTINATION 4
+#define RFM69_MESH_SEQUENCE 5
+#define RFM69_MESH_TYPE 6
+#define RFM69_MESH_PAYLOAD 7
+
+#define RFM69_MESH_TYPE_DATA (0b00<<6)
+#define RFM69_MESH_TYPE_ROUTE_REQUEST (0b01<<6)
+#define RFM69_MESH_TYPE_ROUTE_REPLY (0b10<<6)
+#define RFM69_MESH_TYPE_MASK (0b11<<6)
+#define RFM69_MESH_HOPS_MASK 0b111111
+
+#ifndef RFM69_MESH_MAX_ROUTES
+#define RFM69_MESH_MAX_ROUTES 16
+#endif
+
+// number of (origin, sequence) pairs remembered for duplicate suppression.
+#ifndef RFM69_MESH_SEEN
+#define RFM69_MESH_SEEN 16
+#endif
+
+#ifndef RFM69_MESH_MAX_HOPS
+#define RFM69_MESH_MAX_HOPS 8
+#endif
+
+// maximum delay in milliseconds before a route request is rebroadcast.
+#ifndef RFM69_MESH_FLOOD_JITTER
+#define RFM69_MESH_FLOOD_JITTER 20
+#endif
+
+class meshRFM69 : public plainRFM69{
+    protected:
+        typedef struct {
+            uint8_t destination;
+            uint8_t next_hop;
+            uint8_t hops; // zero if the entry is unused.
+        } route_t;
+
+        uint8_t mesh_address;
+        uint8_t sequence;
+
+        route_t routes[RFM69_MESH_MAX_ROUTES];
+        uint8_t route_victim; // replaced when the table is full.
+
+        uint16_t seen[RFM69_MESH_SEEN]; // origin << 8 | sequence
+        uint8_t seen_index;
+
+        // route replies are sent from the interrupt, not using tx_buffer.
+        uint8_t reply[RFM69_MESH_PAYLOAD];
+
+        // route request to rebroadcast from update().
+        uint8_t flood[RFM69_MESH_PAYLOAD];
+        volatile bool flood_pending;
+        uint32_t flood_time;
+
+        volatile uint16_t forwarded;
+        volatile uint16_t duplicates;
+        volatile uint16_t unroutable;
+
+        route_t* findRoute(uint8_t destination);
+        /*
+            Returns the route to destination, or 0.
+        */
+
+        void learnRoute(uint8_t destination, uint8_t next_hop, uint8_t hops);
+        /*
+            Stores the route, unless a shorter route through another node is
+            known.
+        */
+
+        bool isDuplicate(uint8_t origin, uint8_t sequence);
+        /*
+            Returns true if this packet was seen, otherwise remembers it.
+        */
+
+        void composeHeader(uint8_t* packet, uint8_t length, uint8_t address, uint8_t destination, uint8_t type);
+        /*
+            Writes the length byte and header of a new packet from this node.
+        */
+
+        virtual void readPacket();
+        /*
+            Reads the packet and learns the routes from it. It is kept if
+            this node is the destination, relayed or rebroadcast otherwise.
+        */
+
+    public:
+
+        meshRFM69(uint8_t cs_pin) : plainRFM69(cs_pin){
+            this->mesh_address = 0;
+            this->sequence = 0;
+            this->route_victim = 0;
+            for (uint8_t i=0; i < RFM69_MESH_MAX_ROUTES; i++){
+                this->routes[i].hops = 0;
+            }
+            for (uint8_t i=0; i < RFM69_MESH_SEEN; i++){
+                this->seen[i] = 0xFFFF;
+            }
+            this->seen_index = 0;
+            this->flood_pending = false;
+            this->flood_time = 0;
+            this->forwarded = 0;
+            this->duplicates = 0;
+            this->unroutable = 0;
+        };
+
+        void setMeshAddress(uint8_t address);
+        /*
+            Sets the address of this node, unique in the mesh and not
+            RFM69_MESH_BROADCAST. Also sets the node and broadcast address.
+        */
+
+        uint8_t sendMesh(uint8_t destination, const void* buffer, uint8_t len);
+        /*
+            Sends len bytes to destination, returns RFM69_MESH_SENT if it did.
+            Returns RFM69_MESH_NO_ROUTE if no route is known, a route request
+            is sent instead; try again once hasRoute() is true.
+
+            Relays and route replies are sent from the interrupt, so canSend()
+            can change right after it returned true. The state is checked with
+            interrupts disabled, if the radio is sending RFM69_MESH_BUSY is
+            returned and nothing is sent; try again later.
+        */
+
+        uint8_t readMesh(void* buffer, uint8_t* origin=0);
+        /*
+            Reads the payload of a packet for this node into buffer, and its
+            origin. Returns the length of the payload, zero if no packet is
+            available.
+        */
+
+        bool hasRoute(uint8_t destination){return this->findRoute(destination) != 0;};
+
+        uint8_t getHops(uint8_t destination);
+        /*
+            Returns the number of hops to destination, zero if not known.
+        */
+
+        void forgetRoute(uint8_t destination);
+        /*
+            Removes the route, for example when no answer was received over it,
+            such that the next sendMesh() discovers a new route.
+        */
+
+        void update();
+        /*
+            Rebroadcasts the pending route request once its delay has passed
+            and the radio is receiving. Call it periodically from the loop,
+            not from the interrupt; it does not read the radio unless it
+            sends, and does that with interrupts disabled.
+        */
+
+        uint16_t getForwarded(){return this->forwarded;};
+        uint16_t getDuplicates(){return this->duplicates;};
+        uint16_t getUnroutable(){return this->unroutable;};
+        /*
+            Packets relayed, packets dropped because they were seen before
+            and packets dropped because no route was known or the hop limit
+            was reached.
+        */
+};
+
+//MESH_RFM69_H
+#endif
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "multiRFM69.h"
+
+
+
+/*
+        Public Methods
+*/
+
+uint8_t multiRFM69::addRadio(plainRFM69* radio){
+    if (this->radio_count >= RFM69_MULTI_MAX_RADIOS){
+        return RFM69_MULTI_NO_RADIO;
+    }
+    this->radios[this->radio_count] = radio;
+    return this->radio_count++;
+}
+
+void multiRFM69::interrupt(uint8_t id){
+    // mark this radio as pending, it is serviced by whoever services now.
+    noInterrupts();
+    this->pending |= (1<<id);
+    interrupts();
+
+    this->service();
+}
+
+void multiRFM69::poll(){
+    noInterrupts();
+    this->pending = (1<<this->radio_count) - 1;
+    interrupts();
+
+    this->service();
+}
+
+bool multiRFM69::available(){
+    for (uint8_t i=0; i < this->radio_count; i++){
+        if (this->radios[i]->available()){
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t multiRFM69::read(void* buffer, uint8_t* radio_id){
+    for (uint8_t i=0; i < this->radio_count; i++){
+        uint8_t id = (this->read_radio + i) % this->radio_count;
+        if (this->radios[id]->available()){
+            // next read starts at the radio after this one.
+            this->read_radio = (id + 1) % this->radio_count;
+            *radio_id = id;
+            return this->radios[id]->read(buffer);
+        }
+    }
+    *radio_id = RFM69_MULTI_NO_RADIO;
+    return 0;
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+void multiRFM69::service(){
+    noInterrupts();
+    if (this->servicing){
+        // another interrupt is servicing the radios, it will pick up our
+        // pending mark before it returns.
+        interrupts();
+        return;
+    }
+    this->servicing = true;
+
+    while (this->pending){
+        uint8_t to_service = this->pending;
+        this->pending = 0;
+
+        // allow the other radios to mark themselves pending while we poll.
+        interrupts();
+        for (uint8_t i=0; i < this->radio_count; i++){
+            if (to_service & (1<<i)){
+                this->radios[i]->poll();
+            }
+        }
+        noInterrupts();
+    }
+
+    // pending is checked and cleared with interrupts disabled, so no mark
+    // can be lost between the last check and clearing the servicing flag.
+    this->servicing = false;
+    interrupts();
+}
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <Arduino.h>
+#include <plainRFM69.h>
+
+#ifndef MULTI_RFM69_H
+#define MULTI_RFM69_H
+
+/*
+    The multiRFM69 object manages several plainRFM69 radios which are attached
+    to the same microcontroller, each with its own chip select pin.
+
+    Every radio performs its SPI transactions from its poll() method. When the
+    interrupts of multiple radios are attached directly to poll(), the
+    interrupts of one radio can interrupt the SPI transaction of another, or
+    the poll() of one radio is delayed until the other is done.
+
+    Instead, the interrupt of each radio calls interrupt(id). This only marks
+    the radio as pending. If no other radio is being serviced at that moment,
+    the pending radios are serviced directly, one after the other. If another
+    radio is being serviced, that loop picks up the new work before it returns.
+    So the poll() calls are never nested and every radio is serviced exactly
+    once per pending mark.
+
+    Each radio keeps its own Rx buffer, the read() method of this object reads
+    from these buffers in a round robin fashion and tags every packet with the
+    id of the radio it was received on. This results in one receive queue for
+    all radios, without copying the packets an additional time.
+
+    Usage:
+        plainRFM69 rfm_a = plainRFM69(10);
+        plainRFM69 rfm_b = plainRFM69(9);
+        multiRFM69 multi;
+
+        void interrupt_a(){multi.interrupt(0);}
+        void interrupt_b(){multi.interrupt(1);}
+
+        // configure both radios as usual, then:
+        multi.addRadio(&rfm_a); // id 0.
+        multi.addRadio(&rfm_b); // id 1.
+        attachInterrupt(DIO2_PIN_A, interrupt_a, CHANGE);
+        attachInterrupt(DIO2_PIN_B, interrupt_b, CHANGE);
+*/
+
+#ifndef RFM69_MULTI_MAX_RADIOS
+#define RFM69_MULTI_MAX_RADIOS 4
+#endif
+
+#define RFM69_MULTI_NO_RADIO 0xFF
+
+class multiRFM69 {
+    protected:
+        plainRFM69* radios[RFM69_MULTI_MAX_RADIOS];
+        uint8_t radio_count;
+
+        // bitmask of radios which have to be serviced.
+        volatile uint8_t pending;
+
+        // true while the pending radios are being serviced.
+        volatile bool servicing;
+
+        // the radio from which the next read() starts searching.
+        uint8_t read_radio;
+
+        void service();
+        /*
+            Services the pending radios until no radios are pending, returns
+            directly if the radios are already being serviced.
+        */
+
+    public:
+        multiRFM69(){
+            this->radio_count = 0;
+            this->pending = 0;
+            this->servicing = false;
+            this->read_radio = 0;
+        };
+
+        uint8_t addRadio(plainRFM69* radio);
+        /*
+            Adds a radio to the manager, returns the id of the radio, this id
+            is used for interrupt(id) and is returned by read().
+
+            Returns RFM69_MULTI_NO_RADIO if RFM69_MULTI_MAX_RADIOS radios are
+            already managed.
+        */
+
+        plainRFM69* radio(uint8_t id){return this->radios[id];};
+        // returns the radio with this id, for sending or configuration.
+
+        uint8_t count(){return this->radio_count;};
+        // returns the number of radios managed.
+
+        void interrupt(uint8_t id);
+        /*
+            Should be called from the interrupt attached to the radio with
+            this id. Marks the radio as pending and services all pending
+            radios if this is not already done by another interrupt.
+        */
+
+        void poll();
+        /*
+            Marks all radios pending and services them. Can be used instead of
+            the interrupts, by calling it from the loop.
+        */
+
+        bool available();
+        /*
+            Returns true if any of the radios has a packet available.
+        */
+
+        uint8_t read(void* buffer, uint8_t* radio_id);
+        /*
+            Reads the next packet from the radios into the buffer, this uses
+            plainRFM69::read(void* buffer) on the radio, so the buffer should
+            be large enough for the packets of all radios.
+
+            The radios are checked in a round robin fashion, such that one busy
+            radio does not starve the others. The id of the radio the packet was
+            read from is written to radio_id.
+
+            Returns the number of bytes in the packet, zero if no packet was
+            available. In that case radio_id is set to RFM69_MULTI_NO_RADIO.
+        */
+};
+
+//MULTI_RFM69_H
+#endif
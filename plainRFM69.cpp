@@ -53,7 +53,10 @@ void plainRFM69::setPacketType(bool variable_length, bool use_addressing){
     this->use_variable_length = variable_length;
     this->use_addressing = use_addressing;
 
-    uint8_t flags = RFM69_PACKET_CONFIG_DC_FREE_WHITENING | RFM69_PACKET_CONFIG_CRC_ON;
+    uint8_t flags = RFM69_PACKET_CONFIG_DC_FREE_WHITENING | (this->use_CRC ? RFM69_PACKET_CONFIG_CRC_ON : RFM69_PACKET_CONFIG_CRC_OFF);
+    // keep packets with a wrong CRC, such that poll() can raise the event.
+    this->crc_kept = this->use_CRC && this->on_crc_error;
+    flags |= (this->crc_kept) ? RFM69_PACKET_CONFIG_CRC_FAIL_KEEP : RFM69_PACKET_CONFIG_CRC_FAIL_DISCARD;
     // uint8_t flags = RFM69_PACKET_CONFIG_DC_FREE_MANCHESTER | RFM69_PACKET_CONFIG_CRC_ON;
     // uint8_t flags = RFM69_PACKET_CONFIG_DC_FREE_NONE | RFM69_PACKET_CONFIG_CRC_ON; // This is actually recommended, surprisingly.
 
@@ -76,6 +79,39 @@ void plainRFM69::setPacketType(bool variable_length, bool use_addressing){
 
 }
 
+bool plainRFM69::setProfile(const profileRFM69& profile){
+    if (profile.error != RFM69_PROFILE_OK){
+        return false;
+    }
+    this->use_variable_length = profile.format.variable_length;
+    this->use_addressing = profile.format.addressing;
+    this->use_AES = profile.format.aes;
+    this->use_CRC = profile.format.crc;
+    this->crc_kept = this->use_CRC && this->on_crc_error;
+
+    // the registers are sorted, consecutive ones are written in one burst.
+    uint8_t values[RFM69_PROFILE_REGISTERS];
+    bareRFM69Batch batch;
+    this->beginBatch(&batch);
+    uint8_t i = 0;
+    while (i < RFM69_PROFILE_REGISTERS){
+        uint8_t len = 0;
+        do {
+            const profileRFM69Register& r = profile.registers[i + len];
+            values[len] = r.value;
+            if ((r.reg == RFM69_PACKET_CONFIG1) && this->crc_kept){
+                // as setPacketType(), such that poll() can raise the event.
+                values[len] |= RFM69_PACKET_CONFIG_CRC_FAIL_KEEP;
+            }
+            len++;
+        } while ((i + len < RFM69_PROFILE_REGISTERS) && (profile.registers[i + len].reg == profile.registers[i].reg + len));
+        this->writeRawRegisters(profile.registers[i].reg, values, len);
+        i += len;
+    }
+    this->submitBatch();
+    return true;
+}
+
 void plainRFM69::setBufferSize(uint8_t size){
     this->buffer_size = size;
 }
@@ -105,6 +141,10 @@ void plainRFM69::setAES(bool use_AES){
     this->use_AES = use_AES;
 }
 
+void plainRFM69::setCRC(bool use_CRC){
+    this->use_CRC = use_CRC;
+}
+
 
 void plainRFM69::setTxPower(int8_t power_level_dBm, bool enable_boost)
 {
@@ -190,8 +230,30 @@ void plainRFM69::setTxPower(int8_t power_level_dBm, bool enable_boost)
 }
 
 
+airtimeRFM69Format plainRFM69::getAirtimeFormat(){
+    uint8_t bitrate[2];
+    uint8_t preamble[2];
+    this->readRawRegisters(RFM69_BITRATE_MSB, bitrate, 2);
+    this->readRawRegisters(RFM69_PREAMBLE_MSB, preamble, 2);
+    uint8_t sync = this->readRawRegister(RFM69_SYNC_CONFIG);
+    uint8_t config1 = this->readRawRegister(RFM69_PACKET_CONFIG1);
+    uint8_t config2 = this->readRawRegister(RFM69_PACKET_CONFIG2);
+
+    airtimeRFM69Format format;
+    format.bitrate = (bitrate[0] << 8) | bitrate[1];
+    format.preamble = (preamble[0] << 8) | preamble[1];
+    // p71, SyncOn and SyncSize + 1 bytes.
+    format.sync = (sync & (1<<7)) ? (((sync >> 3) & 0b111) + 1) : 0;
+    format.variable_length = (config1 & RFM69_PACKET_CONFIG_LENGTH_VARIABLE) != 0;
+    format.addressing = (config1 & (0b11<<1)) != RFM69_PACKET_CONFIG_ADDRESS_FILTER_NONE;
+    format.aes = (config2 & 1) != 0;
+    format.crc = (config1 & RFM69_PACKET_CONFIG_CRC_ON) != 0;
+    format.manchester = (config1 & (0b11<<5)) == RFM69_PACKET_CONFIG_DC_FREE_MANCHESTER;
+    return format;
+}
+
 bool plainRFM69::canSend(){
-    return (this->state == RFM69_PLAIN_STATE_RECEIVING);
+    return (this->state == RFM69_PLAIN_STATE_RECEIVING) || (this->state == RFM69_PLAIN_STATE_IDLE);
     // if we're receiving, we can send.
     // This is perhaps slightly naive, as a packet might be being received.
     
@@ -225,39 +287,54 @@ void plainRFM69::sendVariable(void* buffer, uint8_t len){
 
 void plainRFM69::sendAddressed(uint8_t address, void* buffer){
     this->tx_buffer[0] = address;
-    memcpy(&(this->tx_buffer[1]), buffer, this->packet_length);
-    this->sendPacket(this->tx_buffer, this->packet_length+1);
+    // the packet length includes the address byte.
+    memcpy(&(this->tx_buffer[1]), buffer, this->packet_length - 1);
+    this->sendPacket(this->tx_buffer, this->packet_length);
 }
 
 void plainRFM69::send(void* buffer){
     this->sendPacket(buffer, this->packet_length);
 }
 
+void plainRFM69::sendAny(uint8_t address, void* buffer, uint8_t len){
+    if (this->use_variable_length && this->use_addressing){
+        this->sendAddressedVariable(address, buffer, len);
+    } else if (this->use_variable_length){
+        this->sendVariable(buffer, len);
+    } else if (this->use_addressing){
+        this->sendAddressed(address, buffer);
+    } else {
+        this->send(buffer);
+    }
+}
 
 
-void plainRFM69::receive(){
-    /*
-        Setup the automode such that we go into standby mode when a packet is
-        available in the FIFO. Automatically go back into receiving mode when it
-        is read.
 
-        See the datasheet, p42 for information.
-    */
+void plainRFM69::receive(){
+    // the mode may have been changed outside this object, always write it.
+    this->shadow_mode = RFM69_PLAIN_SHADOW_UNKNOWN;
+    this->shadow_automode = RFM69_PLAIN_SHADOW_UNKNOWN;
+
+    // in a batch, with the interrupts disabled, as poll() also changes the
+    // state and writes the trace.
+    bareRFM69Batch batch;
+    this->beginBatch(&batch);
+    this->enterReceiver();
+    this->submitBatch();
+}
 
-    this->setAutoMode(RFM69_AUTOMODE_ENTER_RISING_PAYLOADREADY, RFM69_AUTOMODE_EXIT_FALLING_FIFONOTEMPTY, RFM69_AUTOMODE_INTERMEDIATEMODE_STANDBY);
-    // one disadvantage of this is that the PayloadReady Interrupt is not asserted.
-    // however, the intermediate mode can be detected easily.
+void plainRFM69::setIdleMode(uint8_t mode){
+    this->idle_mode = mode;
+}
 
-    // p22 - Turn off the high power boost registers in receiving mode.
-    if (this->tx_power_boosted)
-    {
-        this->setPa13dBm1(false);
-        this->setPa13dBm2(false);
-    }
+void plainRFM69::idle(){
+    this->shadow_mode = RFM69_PLAIN_SHADOW_UNKNOWN;
+    this->shadow_automode = RFM69_PLAIN_SHADOW_UNKNOWN;
 
-    // set the mode to receiver.
-    this->setMode(RFM69_MODE_SEQUENCER_ON+RFM69_MODE_RECEIVER);
-    this->state = RFM69_PLAIN_STATE_RECEIVING;
+    bareRFM69Batch batch;
+    this->beginBatch(&batch);
+    this->enterIdle();
+    this->submitBatch();
 }
 
 
@@ -267,8 +344,30 @@ void plainRFM69::poll(){
     uint8_t flags1;
     // uint8_t flags2;
 
+    if ((this->tracer != 0) && this->edge_pending){
+        // the edge of traceEdge(), at the time it was marked.
+        this->tracer->record(this->edge_time, RFM69_TRACE_EDGE, this->state, 0, 0);
+        this->edge_pending = false;
+    }
+    this->trace(RFM69_TRACE_POLL, 0, 0);
     flags1 = this->getIRQ1Flags();
     // flags2 = this->getIRQ2Flags();
+
+    if (this->wake_pending && (flags1 & RFM69_IRQ1_TXREADY)){
+        this->wake_latency = micros() - this->wake_time;
+        this->wake_pending = false;
+    } else if (this->wake_pending && (flags1 & RFM69_IRQ1_AUTOMODE)){
+        // the AutoMode entered Tx, the transmitter still has to start.
+        uint32_t latency = micros() - this->wake_time;
+        if ((this->wake_mode == (RFM69_MODE_SEQUENCER_ON | RFM69_MODE_SLEEP)) && (latency < RFM69_PLAIN_TS_OSC)){
+            latency = RFM69_PLAIN_TS_OSC; // Tx waits for the oscillator.
+        }
+        if (this->wake_mode != (RFM69_MODE_SEQUENCER_ON | RFM69_MODE_FREQ_SYNTH)){
+            latency += RFM69_PLAIN_TS_FS;
+        }
+        this->wake_latency = latency + RFM69_PLAIN_TS_TR;
+        this->wake_pending = false;
+    }
     
 
     // debug_rfm("Flags1: "); debug_rfmln(flags1);
@@ -279,7 +378,23 @@ void plainRFM69::poll(){
                 debug_rfm("Flags1: "); debug_rfmln(flags1);
                 debug_rfm("Flags2: "); debug_rfmln(this->getIRQ2Flags());
 
+                // only kept by the radio if CrcAutoClearOff was written; with
+                // the CRC off, CrcOk is never set.
+                if (this->crc_kept && ((this->getIRQ2Flags() & RFM69_IRQ2_CRCOK) == 0)){
+                    this->discardPacket();
+                    this->raiseEvent(RFM69_PLAIN_EVENT_CRC_ERROR);
+                    break;
+                }
+
+                uint8_t write_index = this->buffer_write_index;
+                uint16_t overflows = this->overflows;
                 this->readPacket();
+                if (write_index != this->buffer_write_index){
+                    this->raiseEvent(RFM69_PLAIN_EVENT_RECEIVED);
+                }
+                if (overflows != this->overflows){
+                    this->raiseEvent(RFM69_PLAIN_EVENT_OVERFLOW);
+                }
             }
             break;
 
@@ -288,13 +403,16 @@ void plainRFM69::poll(){
                 debug_rfm("Flags1: "); debug_rfmln(flags1);
                 debug_rfm("Flags2: "); debug_rfmln(this->getIRQ2Flags());
 
-                this->receive(); // we're done sending, set the receiving mode.
+                this->wake_pending = false;
+                this->enterIdle(); // we're done sending, set the idle mode.
+                this->raiseEvent(RFM69_PLAIN_EVENT_SENT);
             }
             break;
         default:
             // this should not happen... 
             debug_rfm("In undefined state!");
     };
+    this->trace(RFM69_TRACE_DONE, flags1, 0);
 }
 
 
@@ -310,28 +428,14 @@ uint8_t plainRFM69::read(void* buffer){
     debug_rfm("Read");
 
     // no data to return.
-    if (buffer_read_index == buffer_write_index){
+    uint8_t length;
+    uint8_t* packet = this->nextPacket(&length);
+    if (packet == 0){
         return 0;
     }
 
-    // read packet length.
-    uint8_t length = this->packet_length;
-    uint8_t payload_start = 0;
-    if (this->use_variable_length){
-
-        // if variable length is used, read length from the first byte.
-        length = this->packet_buffer[buffer_read_index][0];
-        // debug_rfm("Length from packet: ");debug_rfm(length);
-        // prevent buffer overflow, take shortest length of Rx length and packet length.
-        length = (length > this->packet_length) ? this->packet_length : length;
-        // debug_rfm("maxed length: ");debug_rfm(length);
-
-        // payload starts one byte later.
-        payload_start++;
-    }
-
     // copy the message into the buffer.
-    memcpy(buffer, &(this->packet_buffer[buffer_read_index][payload_start]), length);
+    memcpy(buffer, packet, length);
     
     // increase the read index.
     this->buffer_read_index = (this->buffer_read_index+1) % this->buffer_size;
@@ -341,6 +445,38 @@ uint8_t plainRFM69::read(void* buffer){
 }
 
 
+void plainRFM69::onReceived(plainRFM69ReceivedHandler handler, void* context, bool in_isr){
+    this->on_received = handler;
+    this->setHandler(RFM69_PLAIN_EVENT_RECEIVED, context, in_isr, handler != 0);
+}
+
+void plainRFM69::onSent(plainRFM69SentHandler handler, void* context, bool in_isr){
+    this->on_sent = handler;
+    this->setHandler(RFM69_PLAIN_EVENT_SENT, context, in_isr, handler != 0);
+}
+
+void plainRFM69::onCrcError(plainRFM69CrcErrorHandler handler, void* context, bool in_isr){
+    this->on_crc_error = handler;
+    this->setHandler(RFM69_PLAIN_EVENT_CRC_ERROR, context, in_isr, handler != 0);
+}
+
+void plainRFM69::onOverflow(plainRFM69OverflowHandler handler, void* context, bool in_isr){
+    this->on_overflow = handler;
+    this->setHandler(RFM69_PLAIN_EVENT_OVERFLOW, context, in_isr, handler != 0);
+}
+
+bool plainRFM69::dispatch(){
+    bool any = false;
+    while (this->event_read_index != this->event_write_index){
+        uint8_t event = this->event_queue[this->event_read_index];
+        this->event_read_index = (this->event_read_index + 1) % RFM69_PLAIN_EVENT_QUEUE;
+        this->runEvent(event);
+        any = true;
+    }
+    return any;
+}
+
+
 
 // Baud rate configurations below.
 
@@ -356,6 +492,9 @@ void plainRFM69::baud4800(){
     // RxBwMant=16, RxBwExp=5; 15.62 Khz in FSK
     // RxBwMant=0b00; RxBwExp=0b101; FXO_SC/((RxBwMant*4+16)*2**(RxBwExp+2))= 15625 Hz
     this->setRxBw(0b010, 0b00, 0b101); 
+
+    // FSK without shaping, also after ook4800() or ook9600().
+    this->setDataModul(RFM69_DATAMODUL_PROCESSING_PACKET, RFM69_DATAMODUL_FSK, RFM69_DATAMODUL_SHAPING_GFSK_NONE);
 }
 
 void plainRFM69::baud9600(){
@@ -366,6 +505,8 @@ void plainRFM69::baud9600(){
     // RxBwMant=16, RxBwExp=5; 15.62 Khz in FSK
     // RxBwMant=0b10; RxBwExp=0b101; FXO_SC/((RxBwMant*4+16)*2**(RxBwExp+2))= 15625 Hz
     this->setRxBw(0b010, 0b00, 0b101); // RxBwMant=24, RxBwExp=4;
+
+    this->setDataModul(RFM69_DATAMODUL_PROCESSING_PACKET, RFM69_DATAMODUL_FSK, RFM69_DATAMODUL_SHAPING_GFSK_NONE);
 }
 
 void plainRFM69::baud153600(){
@@ -421,9 +562,36 @@ void plainRFM69::baud300000(){
     this->setLowBetaAfcOffset(45);
 }
 
+void plainRFM69::ook4800(){
+    // FXO_SC / 0x1a0b = 4799.76 ~= 4800 bps
+    this->setBitRate(0x1a0b);
+
+    // In OOK the filter is single sided, half the bandwidth of FSK:
+    // RxBwMant=0b00; RxBwExp=0b100; FXO_SC/((RxBwMant*4+16)*2**(RxBwExp+3))= 15625 Hz
+    this->setRxBw(0b010, 0b00, 0b100);
+
+    // filter the envelope at the bit rate to suppress the spikes of noise.
+    this->setDataModul(RFM69_DATAMODUL_PROCESSING_PACKET, RFM69_DATAMODUL_OOK, RFM69_DATAMODUL_SHAPING_OOK_FCUTOFF_BR);
+
+    // p31, the peak threshold with its defaults is recommended; the floor is
+    // raised from 6 dB, such that noise is not demodulated between packets.
+    this->setOokPeak(RFM69_OOK_THRESH_TYPE_PEAK, RFM69_OOK_PEAK_STEP_0_5_DB, RFM69_OOK_PEAK_DEC_1_PER_CHIP);
+    this->setOokFixedThreshold(10);
+}
+
+void plainRFM69::ook9600(){
+    this->setBitRate(0x1a0b/2);  // FXO_SC / 0x1a0b = 9599.52 ~= 9600 bps
+
+    // RxBwMant=0b00; RxBwExp=0b011; FXO_SC/((RxBwMant*4+16)*2**(RxBwExp+3))= 31250 Hz
+    this->setRxBw(0b010, 0b00, 0b011);
+
+    this->setDataModul(RFM69_DATAMODUL_PROCESSING_PACKET, RFM69_DATAMODUL_OOK, RFM69_DATAMODUL_SHAPING_OOK_FCUTOFF_BR);
+    this->setOokPeak(RFM69_OOK_THRESH_TYPE_PEAK, RFM69_OOK_PEAK_STEP_0_5_DB, RFM69_OOK_PEAK_DEC_1_PER_CHIP);
+    this->setOokFixedThreshold(10);
+}
 
 void plainRFM69::emitPreamble(){
-    this->setMode(RFM69_MODE_SEQUENCER_OFF | RFM69_MODE_TRANSMITTER);
+    this->changeMode(RFM69_MODE_SEQUENCER_OFF | RFM69_MODE_TRANSMITTER);
 }
 
 
@@ -442,10 +610,22 @@ void plainRFM69::sendPacket(void* buffer, uint8_t len){
 
         This results in a minimal Tx time and packetSent can be detected when
         automode is left again.
+
+        The automode returns to the mode set here: frequency synthesizer if
+        that is the idle mode, such that the PLL stays locked, otherwise
+        standby. Sleep is only entered again after the packet is sent.
+
+        The writes are recorded in a batch and performed together, on the
+        Linux backend in one ioctl.
         
     */
-    this->setMode(RFM69_MODE_SEQUENCER_ON | RFM69_MODE_STANDBY);
-    this->setAutoMode(RFM69_AUTOMODE_ENTER_RISING_FIFOLEVEL, RFM69_AUTOMODE_EXIT_RISING_PACKETSENT, RFM69_AUTOMODE_INTERMEDIATEMODE_TRANSMITTER);
+    bareRFM69Batch batch;
+    this->beginBatch(&batch);
+    this->wake_time = micros();
+    this->wake_pending = true;
+    this->wake_mode = this->shadow_mode;
+    this->changeMode(RFM69_MODE_SEQUENCER_ON | ((this->idle_mode == RFM69_MODE_FREQ_SYNTH) ? RFM69_MODE_FREQ_SYNTH : RFM69_MODE_STANDBY));
+    this->changeAutoMode(RFM69_AUTOMODE_ENTER_RISING_FIFOLEVEL, RFM69_AUTOMODE_EXIT_RISING_PACKETSENT, RFM69_AUTOMODE_INTERMEDIATEMODE_TRANSMITTER);
     // perhaps RFM69_AUTOMODE_ENTER_RISING_FIFONOTEMPTY is faster?
     
     // set it into automode for transmitting
@@ -458,11 +638,74 @@ void plainRFM69::sendPacket(void* buffer, uint8_t len){
     }
 
     // write the fifo.
-    this->state = RFM69_PLAIN_STATE_SENDING; // set the state to sending.
+    this->changeState(RFM69_PLAIN_STATE_SENDING); // set the state to sending.
     this->writeFIFO(buffer, len);
+    this->trace(RFM69_TRACE_TX_FIFO, 0, len);
+    this->submitBatch();
+}
+
+
+
+void plainRFM69::enterReceiver(){
+    /*
+        Setup the automode such that we go into standby mode when a packet is
+        available in the FIFO. Automatically go back into receiving mode when it
+        is read.
+
+        See the datasheet, p42 for information.
+    */
+
+    this->changeAutoMode(RFM69_AUTOMODE_ENTER_RISING_PAYLOADREADY, RFM69_AUTOMODE_EXIT_FALLING_FIFONOTEMPTY, RFM69_AUTOMODE_INTERMEDIATEMODE_STANDBY);
+    // one disadvantage of this is that the PayloadReady Interrupt is not asserted.
+    // however, the intermediate mode can be detected easily.
+
+    // p22 - Turn off the high power boost registers in receiving mode.
+    if (this->tx_power_boosted)
+    {
+        this->setPa13dBm1(false);
+        this->setPa13dBm2(false);
+    }
+
+    // set the mode to receiver.
+    this->changeMode(RFM69_MODE_SEQUENCER_ON+RFM69_MODE_RECEIVER);
+    this->changeState(RFM69_PLAIN_STATE_RECEIVING);
+}
+
+void plainRFM69::enterIdle(){
+    if (this->idle_mode == RFM69_MODE_RECEIVER){
+        this->enterReceiver();
+        return;
+    }
+    /*
+        The Tx automode is left in place; it only starts on a FIFO level that
+        is not reached outside of sendPacket(), so the next packet is sent
+        without writing RegAutoModes.
+    */
+    this->changeMode(RFM69_MODE_SEQUENCER_ON | this->idle_mode);
+    this->changeState(RFM69_PLAIN_STATE_IDLE);
 }
 
+void plainRFM69::changeMode(uint8_t mode){
+    if (mode != this->shadow_mode){
+        this->setMode(mode);
+        this->shadow_mode = mode;
+    }
+}
 
+void plainRFM69::changeAutoMode(uint8_t enter, uint8_t exit, uint8_t intermediate_mode){
+    uint8_t automode = enter + exit + intermediate_mode;
+    if (automode != this->shadow_automode){
+        this->setAutoMode(enter, exit, intermediate_mode);
+        this->shadow_automode = automode;
+    }
+}
+
+void plainRFM69::changeState(uint8_t state){
+    if (state != this->state){
+        this->trace(RFM69_TRACE_STATE, 0, state);
+        this->state = state;
+    }
+}
 
 void plainRFM69::setRawPacketLength(){
     // allocate the Tx Buffer
@@ -478,13 +721,104 @@ void plainRFM69::setRawPacketLength(){
 
 
 void plainRFM69::readPacket(){
-    // read it into the buffer.
+    // read it into the free slot, and add it to the buffer if it fits.
+    uint8_t bytes = this->readSlot();
+    this->trace((this->commitSlot()) ? RFM69_TRACE_RX_FIFO : RFM69_TRACE_DISCARD, 0, bytes);
+}
+
+void plainRFM69::discardPacket(){
+    // the slot at the write index is never read, and the FIFO has to be
+    // emptied to return to Rx.
+    uint8_t bytes = this->readSlot();
+    this->trace(RFM69_TRACE_DISCARD, 0, bytes);
+}
+
+uint8_t plainRFM69::readSlot(){
     if (this->use_variable_length) {
-        this->readVariableFIFO(this->packet_buffer[this->buffer_write_index], this->packet_length + this->use_variable_length);
-    } else{
-        this->readFIFO(this->packet_buffer[this->buffer_write_index], this->packet_length);
+        // the length byte and the bytes following it.
+        return this->readVariableFIFO(this->packet_buffer[this->buffer_write_index], this->packet_length + this->use_variable_length) + 1;
+    }
+    this->readFIFO(this->packet_buffer[this->buffer_write_index], this->packet_length);
+    return this->packet_length;
+}
+
+bool plainRFM69::commitSlot(){
+    uint8_t next = (this->buffer_write_index + 1) % this->buffer_size;
+    if (next == this->buffer_read_index){
+        // full, adding it would make the buffer appear empty.
+        this->overflows = this->overflows + 1;
+        return false;
+    }
+    this->buffer_write_index = next;
+    return true;
+}
+
+uint8_t* plainRFM69::nextPacket(uint8_t* length){
+    if (this->buffer_read_index == this->buffer_write_index){
+        return 0;
+    }
+
+    // read packet length.
+    uint8_t* slot = this->packet_buffer[this->buffer_read_index];
+    *length = this->packet_length;
+    if (this->use_variable_length){
+        // if variable length is used, read length from the first byte.
+        // prevent buffer overflow, take shortest length of Rx length and packet length.
+        *length = (slot[0] > this->packet_length) ? this->packet_length : slot[0];
+
+        // payload starts one byte later.
+        return &(slot[1]);
     }
+    return slot;
+}
+
+void plainRFM69::setHandler(uint8_t event, void* context, bool in_isr, bool set){
+    this->event_context[event] = context;
+    this->event_handlers = (set) ? (this->event_handlers | (1 << event)) : (this->event_handlers & ~(1 << event));
+    this->event_in_isr = (in_isr) ? (this->event_in_isr | (1 << event)) : (this->event_in_isr & ~(1 << event));
+}
+
+void plainRFM69::raiseEvent(uint8_t event){
+    if ((this->event_handlers & (1 << event)) == 0){
+        return;
+    }
+    if (this->event_in_isr & (1 << event)){
+        this->runEvent(event);
+        return;
+    }
+    uint8_t next = (this->event_write_index + 1) % RFM69_PLAIN_EVENT_QUEUE;
+    if (next == this->event_read_index){
+        return; // queue is full, dropped.
+    }
+    this->event_queue[this->event_write_index] = event;
+    this->event_write_index = next;
+}
 
-    // increase the write index.
-    this->buffer_write_index = (this->buffer_write_index+1) % this->buffer_size;
+void plainRFM69::runEvent(uint8_t event){
+    void* context = this->event_context[event];
+    switch (event){
+        case (RFM69_PLAIN_EVENT_RECEIVED):
+            uint8_t length;
+            uint8_t* packet;
+            while ((this->on_received != 0) && ((packet = this->nextPacket(&length)) != 0)){
+                this->on_received(context, packet, length);
+                this->buffer_read_index = (this->buffer_read_index+1) % this->buffer_size;
+            }
+            break;
+        case (RFM69_PLAIN_EVENT_SENT):
+            if (this->on_sent != 0){
+                this->on_sent(context);
+            }
+            break;
+        case (RFM69_PLAIN_EVENT_CRC_ERROR):
+            if (this->on_crc_error != 0){
+                this->on_crc_error(context);
+            }
+            break;
+        case (RFM69_PLAIN_EVENT_OVERFLOW):
+            if (this->on_overflow != 0){
+                this->on_overflow(context);
+            }
+            break;
+    }
 }
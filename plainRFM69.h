@@ -7,6 +7,9 @@
 #include <Arduino.h>
 #include <bareRFM69.h>
 #include <bareRFM69_const.h>
+#include <airtimeRFM69.h>
+#include <profileRFM69.h>
+#include <traceRFM69.h>
 
 #ifndef PLAIN_RFM69_H
 #define PLAIN_RFM69_H
@@ -53,6 +56,36 @@
 
 #define RFM69_PLAIN_STATE_RECEIVING 0
 #define RFM69_PLAIN_STATE_SENDING 1
+#define RFM69_PLAIN_STATE_IDLE 2
+
+// the register value is not known, the next write always happens.
+#define RFM69_PLAIN_SHADOW_UNKNOWN 0xFF
+
+// start up times in us that getWakeLatency() adds, see RFM69_TS_OSC.
+#define RFM69_PLAIN_TS_OSC RFM69_TS_OSC
+#define RFM69_PLAIN_TS_FS RFM69_TS_FS
+#define RFM69_PLAIN_TS_TR RFM69_TS_TR
+
+// events raised by poll(), see onReceived().
+#define RFM69_PLAIN_EVENT_RECEIVED 0
+#define RFM69_PLAIN_EVENT_SENT 1
+#define RFM69_PLAIN_EVENT_CRC_ERROR 2
+#define RFM69_PLAIN_EVENT_OVERFLOW 3
+
+// events waiting for dispatch(), one less than this fits.
+#ifndef RFM69_PLAIN_EVENT_QUEUE
+#define RFM69_PLAIN_EVENT_QUEUE 8
+#endif
+
+// timestamps of the trace, see setTrace().
+#ifndef RFM69_PLAIN_TRACE_CLOCK
+#define RFM69_PLAIN_TRACE_CLOCK() micros()
+#endif
+
+typedef void (*plainRFM69ReceivedHandler)(void* context, uint8_t* packet, uint8_t length);
+typedef void (*plainRFM69SentHandler)(void* context);
+typedef void (*plainRFM69CrcErrorHandler)(void* context);
+typedef void (*plainRFM69OverflowHandler)(void* context);
 
 class plainRFM69 : public bareRFM69{
     protected:
@@ -60,6 +93,7 @@ class plainRFM69 : public bareRFM69{
         bool use_variable_length;
         bool use_addressing;
         bool use_AES;
+        bool use_CRC;
         bool use_HP_module = false;
         bool tx_power_boosted = false;
 
@@ -78,6 +112,75 @@ class plainRFM69 : public bareRFM69{
         // Temporary buffer to compose the message in before writing to FIFO
         uint8_t* tx_buffer;
 
+        // mode between packets, RFM69_MODE_RECEIVER unless set otherwise.
+        uint8_t idle_mode;
+
+        // last values written to RegOpMode and RegAutoModes.
+        uint8_t shadow_mode;
+        uint8_t shadow_automode;
+
+        // start of the last transmission and the time until TxReady, in us,
+        // and the mode the radio was in when it was started.
+        uint32_t wake_time;
+        volatile uint16_t wake_latency;
+        volatile bool wake_pending;
+        uint8_t wake_mode;
+
+        // event handlers with their context, a bit per event for those that
+        // are set and those that run in poll().
+        plainRFM69ReceivedHandler on_received;
+        plainRFM69SentHandler on_sent;
+        plainRFM69CrcErrorHandler on_crc_error;
+        plainRFM69OverflowHandler on_overflow;
+        void* event_context[RFM69_PLAIN_EVENT_OVERFLOW + 1];
+        uint8_t event_handlers;
+        uint8_t event_in_isr;
+
+        // CrcAutoClearOff was written, the radio keeps frames with a wrong CRC.
+        bool crc_kept;
+
+        // events from poll() waiting for dispatch().
+        volatile uint8_t event_queue[RFM69_PLAIN_EVENT_QUEUE];
+        volatile uint8_t event_read_index;
+        volatile uint8_t event_write_index;
+
+        // packets dropped because the Rx buffer was full.
+        volatile uint16_t overflows;
+
+        // ring the trace entries are written to, or 0, and the time of the
+        // first edge passed to traceEdge() since poll() recorded the last.
+        traceRFM69* tracer;
+        uint32_t edge_time;
+        volatile bool edge_pending;
+
+        void trace(uint8_t type, uint8_t flags, uint8_t value){
+            if (this->tracer != 0){
+                this->tracer->record(RFM69_PLAIN_TRACE_CLOCK(), type, this->state, flags, value);
+            }
+        };
+        /*
+            Adds an entry to the trace, if one is set.
+        */
+
+        void enterReceiver();
+        void enterIdle();
+        /*
+            As receive() and idle(), but these only write the registers that
+            changed; used by poll() after a packet was sent.
+        */
+
+        void changeMode(uint8_t mode);
+        void changeAutoMode(uint8_t enter, uint8_t exit, uint8_t intermediate_mode);
+        /*
+            As setMode() and setAutoMode(), but the register is only written
+            if the value differs from the last one written by these methods.
+        */
+
+        void changeState(uint8_t state);
+        /*
+            Sets the state, a change is added to the trace.
+        */
+
         void sendPacket(void* buffer, uint8_t len);
         /*
             Set the radio to Tx automode and write buffer up to len to the fifo.
@@ -86,7 +189,43 @@ class plainRFM69 : public bareRFM69{
 
         virtual void readPacket();
         /*
-            Read a packet from the hardware to the internal buffer.
+            Read a packet from the hardware to the internal buffer. If the
+            buffer is full, the packet is dropped and counted in overflows.
+        */
+
+        void discardPacket();
+        /*
+            Empties the FIFO into the free slot of the Rx buffer, without
+            adding it to the buffer.
+        */
+
+        uint8_t readSlot();
+        /*
+            Reads the FIFO into the free slot of the Rx buffer, returns the
+            number of bytes read; used by the two above.
+        */
+
+        bool commitSlot();
+        /*
+            Adds the packet in the free slot to the Rx buffer. If the buffer
+            is full, the packet is dropped and counted in overflows, and
+            poll() raises RFM69_PLAIN_EVENT_OVERFLOW; returns false. Every
+            readPacket() that keeps packets adds them with this.
+        */
+
+        uint8_t* nextPacket(uint8_t* length);
+        /*
+            Returns the payload of the next packet in the Rx buffer and sets
+            length, as read() would copy it. Returns zero if there is none.
+        */
+
+        void setHandler(uint8_t event, void* context, bool in_isr, bool set);
+        void raiseEvent(uint8_t event);
+        void runEvent(uint8_t event);
+        /*
+            raiseEvent() runs the handler directly if it runs in poll(),
+            otherwise it adds the event to the queue. Events without a
+            handler are ignored, and so are events that do not fit the queue.
         */
 
         virtual void setRawPacketLength();
@@ -103,6 +242,27 @@ class plainRFM69 : public bareRFM69{
             this->buffer_write_index = 0;
             this->state = RFM69_PLAIN_STATE_RECEIVING;
             this->use_AES = false;
+            this->use_CRC = true;
+            this->idle_mode = RFM69_MODE_RECEIVER;
+            this->shadow_mode = RFM69_PLAIN_SHADOW_UNKNOWN;
+            this->shadow_automode = RFM69_PLAIN_SHADOW_UNKNOWN;
+            this->wake_time = 0;
+            this->wake_latency = 0;
+            this->wake_pending = false;
+            this->wake_mode = RFM69_PLAIN_SHADOW_UNKNOWN;
+            this->on_received = 0;
+            this->on_sent = 0;
+            this->on_crc_error = 0;
+            this->crc_kept = false;
+            this->on_overflow = 0;
+            this->event_handlers = 0;
+            this->event_in_isr = 0;
+            this->event_read_index = 0;
+            this->event_write_index = 0;
+            this->overflows = 0;
+            this->tracer = 0;
+            this->edge_time = 0;
+            this->edge_pending = false;
         };
         /*
 
@@ -156,6 +316,18 @@ class plainRFM69 : public bareRFM69{
             packets, which is the recommended value. If a slow SPI bus is used,
             it might be necessary to manually use setFifoThreshold(). 
         */
+        bool setProfile(const profileRFM69& profile);
+        /*
+            Writes the registers of setRecommended(), setPacketType(),
+            setFrequency() and the baud method from a table computed by the
+            compiler, see profileRFM69.h, in as few bursts as possible. Also
+            takes the AES and CRC settings from the profile.
+
+            Returns false and writes nothing if the profile failed a check.
+            Should come before setBufferSize() and setPacketLength(); it can
+            be called again to retune.
+        */
+
         void setBufferSize(uint8_t length);
         /*
             Sets the number of buffers slots to buffer messages into.
@@ -193,7 +365,8 @@ class plainRFM69 : public bareRFM69{
         /*
             Sets the frequency to approximately Freq.
             Uses 61 as Fstep instead of 61.03515625 which it actually is.
-            For more precise control, use void setFrf from bareRFM69.
+            For more precise control, use void setFrf from bareRFM69, with
+            bareRFM69::frequencyToFrf(freq) to obtain the exact value.
 
             Example:
                 setFrequency((uint32_t) 450*1000*1000); sets to ~450 MHz (actually 450.259)
@@ -213,6 +386,15 @@ class plainRFM69 : public bareRFM69{
             It does provide some sort of whitening filter.
         */
 
+        void setCRC(bool use_CRC);
+        /*
+            enable (default) or disable the CRC, should come before
+            setPacketType.
+
+            Without CRC, frames with bit errors are received as well, for
+            example to correct them with fecRFM69.
+        */
+
         void setHighPowerModule(){this->use_HP_module = true;};
         /*
             Informs the library that a high-power module variant (RFM69HW or RFM69HCW) is present.
@@ -251,13 +433,76 @@ class plainRFM69 : public bareRFM69{
         virtual void send(void* buffer);
         // send without addressing and fixed length. Use with setPacketType(false, false).
 
+        void sendAny(uint8_t address, void* buffer, uint8_t len);
+        // send with the method above that matches setPacketType(). The address is
+        // ignored without addressing, len with fixed length.
+
         void receive();
         // sets the radio into receiver mode.
         // should be called after setup.
 
+        void setIdleMode(uint8_t mode);
+        /*
+            Sets the mode of the radio between packets, for nodes that only
+            listen at times. One of:
+                RFM69_MODE_RECEIVER (default)
+                    Receive, as described at the top of this file.
+                RFM69_MODE_FREQ_SYNTH
+                    Keep the synthesizer locked, a transmission starts
+                    within tens of microseconds.
+                RFM69_MODE_STANDBY
+                    Keep the crystal oscillator running (1.25 mA).
+                RFM69_MODE_SLEEP
+                    Lowest current (0.1 uA), the oscillator starts in about
+                    a millisecond on every transmission.
+            Other than with RFM69_MODE_RECEIVER, the radio returns to this
+            mode after a packet is sent, and receive() has to be called to
+            receive packets; idle() returns to this mode after receiving.
+
+            Sending never waits on ModeReady; the FIFO is written directly
+            and the sequencer of the radio moves through the modes to Tx on
+            its own. Registers are only written if their value changes.
+        */
 
+        void idle();
+        /*
+            Puts the radio in the idle mode, or in receiver mode with the
+            default idle mode.
+        */
 
-        void poll();
+        airtimeRFM69Format getAirtimeFormat();
+        /*
+            Reads the bitrate, preamble, sync word and packet configuration
+            from the radio, for the functions in airtimeRFM69.h.
+        */
+
+        uint32_t getAirtime(uint8_t len){return airtimeRFM69Microseconds(this->getAirtimeFormat(), len);};
+        /*
+            Time on the air in microseconds of a packet with len bytes of
+            payload, with the current configuration. This reads the registers,
+            keep the format from getAirtimeFormat() to compute it repeatedly.
+        */
+
+        uint16_t getWakeLatency(){return this->wake_latency;};
+        /*
+            Time in microseconds from the last send until the transmitter was
+            ready and started the preamble. Zero until measured.
+
+            With poll() attached to DIO2 mapped to the AutoMode, as at the
+            top of this file, poll() sees the AutoMode enter Tx and adds the
+            start up time of the mode the radio was in: TS_TR from the
+            synthesizer, TS_FS + TS_TR from standby or Rx, and from sleep no
+            less than TS_OSC before that. These are the typical values of the
+            datasheet, see RFM69_PLAIN_TS_TR.
+
+            It is measured exactly if poll() sees the TxReady flag; map DIO0
+            with RFM69_PACKET_DIO_0_TX_TX_READY (PayloadReady in Rx) and
+            attach poll() to its rising edge instead.
+        */
+
+
+
+        virtual void poll();
         /*
             Polls the radio to check for packets in the fifo. If a packet is
             received, it is written to the buffer, from which it can be
@@ -271,6 +516,10 @@ class plainRFM69 : public bareRFM69{
 
             It is recommended to to call this method from an interrupt attached
             to the AutoMode indicator.
+
+            Virtual, such that the poll() of hopRFM69 and meshRFM69 also runs
+            when it is called through a plainRFM69 pointer, as by multiRFM69
+            and linuxRFM69.
         */
 
 
@@ -280,7 +529,8 @@ class plainRFM69 : public bareRFM69{
             pointer, this means packets are available, returns false in case
             they align and no new packets are available.
 
-            There is no method to detect overflows of the buffer.
+            When the buffer is full, new packets are dropped; these are
+            counted by getOverflows().
         */
 
         uint8_t read(void* buffer);
@@ -303,11 +553,104 @@ class plainRFM69 : public bareRFM69{
         */
 
 
+        void onReceived(plainRFM69ReceivedHandler handler, void* context=0, bool in_isr=false);
+        void onSent(plainRFM69SentHandler handler, void* context=0, bool in_isr=false);
+        void onCrcError(plainRFM69CrcErrorHandler handler, void* context=0, bool in_isr=false);
+        void onOverflow(plainRFM69OverflowHandler handler, void* context=0, bool in_isr=false);
+        /*
+            Sets the handler of an event raised by poll(), instead of checking
+            available() and canSend() in a loop. A handler of zero removes it.
+            The context is passed to the handler.
+
+            With in_isr, the handler is called by poll() itself, which is
+            usually in the interrupt; keep it short. Otherwise the event is
+            queued and the handler is called by dispatch(), from loop().
+
+            onReceived
+                A packet was added to the Rx buffer. The handler gets the
+                payload as read() would write it, in the buffer; the slot is
+                freed after the handler returns, so available() and read()
+                should not be used alongside. All packets in the buffer are
+                passed, also those of events that did not fit the queue.
+            onSent
+                The packet was sent and the radio is in the idle mode again.
+            onCrcError
+                A packet with a wrong CRC was received and dropped. The radio
+                only keeps these with CrcAutoClearOff, which setPacketType()
+                sets if this handler is set, so it should come before it.
+                Without the CRC, see setCRC(), it is never called.
+            onOverflow
+                A packet was dropped because the Rx buffer was full.
+        */
+
+        bool dispatch();
+        /*
+            Calls the handlers of the queued events, returns whether there
+            were any. To sleep until something happens:
+                while (!rfm.dispatch()){
+                    // sleep until the next interrupt.
+                }
+        */
+
+        bool pending(){return this->event_read_index != this->event_write_index;};
+        /*
+            Returns whether events are waiting for dispatch().
+        */
+
+        uint16_t getOverflows(){return this->overflows;};
+        /*
+            Number of packets dropped because the Rx buffer was full.
+        */
+
+        void setTrace(traceRFM69* trace){this->tracer = trace;};
+        /*
+            Records what poll() does into the trace, see traceRFM69.h: when
+            it runs and for how long, the IRQ flags, the bytes moved through
+            the FIFO and the state changes. Read the entries from loop() with
+            trace.drain(), or send them to extras/host/trace_dump.cpp with
+            trace.dump(). A trace of zero stops it.
+
+            The entries are timestamped with RFM69_PLAIN_TRACE_CLOCK(), which
+            is micros() unless defined otherwise; a cycle counter resolves
+            short times better, on a Teensy 3:
+                #define RFM69_PLAIN_TRACE_CLOCK() ARM_DWT_CYCCNT
+            with the counter enabled in setup():
+                ARM_DEMCR |= ARM_DEMCR_TRCENA;
+                ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+            The AVR has no cycle counter, its micros() has steps of 4 us.
+        */
+
+        void traceEdge(){
+            if (!this->edge_pending){
+                this->edge_time = RFM69_PLAIN_TRACE_CLOCK();
+                this->edge_pending = true;
+            }
+        };
+        /*
+            Marks the edge of the DIO pin, call it first in the interrupt. The
+            next poll() adds it to the trace, so the ring keeps one writer;
+            the time until poll() starts is its latency, which is what matters
+            if poll() is called later, from loop():
+                void interrupt_RFM(){
+                    rfm.traceEdge();
+                    poll_pending = true;
+                }
+            Further edges before that poll() are not recorded.
+        */
+
         void baud4800();
         void baud9600();
         void baud153600();
         void baud300000();
 
+        void ook4800();
+        void ook9600();
+        /*
+            OOK instead of FSK, for example to reach receivers that only do
+            OOK. These switch the modulation, the baud methods above switch
+            it back to FSK.
+        */
+
         void emitPreamble(); // continuously emit a preamble
 };
 
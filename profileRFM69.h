@@ -0,0 +1,341 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <bareRFM69_const.h>
+
+#ifndef PROFILE_RFM69_H
+#define PROFILE_RFM69_H
+
+/*
+    The configuration of setRecommended(), setPacketType(), setFrequency() and
+    one of the baud methods as a table of register values, computed by the
+    compiler from the frequency, the modulation and the packet format:
+
+        constexpr profileRFM69 profile = profileRFM69Make(434000000,
+            profileRFM69Baud300000(), profileRFM69Packet(true, true, false));
+        static_assert(profile.error == RFM69_PROFILE_OK, "profile");
+
+        rfm.setProfile(profile);    // instead of the four calls above.
+        rfm.setBufferSize(4);
+        rfm.setPacketLength(32);
+
+    The constraints that the comments of the baud methods work out by hand are
+    checked: the frequency band, the bitrate, FDEV + BR/2 <= 500 kHz, the
+    modulation index beta = 2 * FDEV / BR between 0.5 and 10, a receiver
+    bandwidth that holds FDEV + BR/2, and for the low beta AFC an offset above
+    the cut-off of the DC canceller. error holds the first one that failed;
+    with static_assert() a wrong profile does not compile, setProfile()
+    refuses it at runtime.
+
+    The registers are in ascending order, plainRFM69::setProfile() writes the
+    consecutive ones in one burst each, all of them in one bareRFM69Batch.
+    Unlike setPacketType(), the FIFO threshold is set to start transmitting
+    once the FIFO is not empty; setFifoThreshold() takes the condition as a
+    bool, which turns RFM69_THRESHOLD_CONDITION_NOT_EMPTY into a threshold of
+    one byte.
+
+    profileRFM69Solve() computes the modulation for any bitrate from 1.2 to
+    300 kbps, instead of the four fixed ones; profileRFM69Describe() reports
+    the rates and bandwidths it results in.
+
+    The profile does not hold the payload length, the buffers and the length
+    are still set with setBufferSize() and setPacketLength(), after it.
+*/
+
+#define RFM69_PROFILE_FXOSC 32000000UL
+
+#define RFM69_PROFILE_OK 0
+#define RFM69_PROFILE_FREQUENCY 1       // outside 290-340, 424-510 and 862-1020 MHz.
+#define RFM69_PROFILE_BITRATE 2         // outside 1.2 to 300 kbps.
+#define RFM69_PROFILE_FDEV 3            // more than 14 bits.
+#define RFM69_PROFILE_FDEV_BITRATE 4    // FDEV + BR/2 above 500 kHz.
+#define RFM69_PROFILE_BETA 5            // 2 * FDEV / BR outside 0.5 to 10.
+#define RFM69_PROFILE_RX_BW 6           // below FDEV + BR/2, or RxBwMant of 0b11.
+#define RFM69_PROFILE_AFC_BW 7          // RxBwMantAfc of 0b11.
+#define RFM69_PROFILE_LOW_BETA 8        // offset not above the cut-off of DccFreqAfc.
+
+#define RFM69_PROFILE_REGISTERS 25
+
+struct profileRFM69Modulation {
+    uint16_t bitrate;           // RegBitrate.
+    uint16_t fdev;              // RegFdev.
+    uint8_t rx_bw;              // RegRxBw, see profileRFM69Bandwidth().
+    uint8_t afc_bw;             // RegAfcBw.
+    uint8_t shaping;            // RFM69_DATAMODUL_SHAPING_GFSK_*.
+    uint8_t low_beta_offset;    // RegTestAfc, zero for AfcLowBetaOn=0.
+};
+
+struct profileRFM69Format {
+    bool variable_length;
+    bool addressing;
+    bool aes;
+    bool crc;
+};
+
+struct profileRFM69Register {
+    uint8_t reg;
+    uint8_t value;
+};
+
+struct profileRFM69 {
+    uint8_t error;              // RFM69_PROFILE_OK, or the check that failed.
+    profileRFM69Format format;
+    profileRFM69Register registers[RFM69_PROFILE_REGISTERS];
+};
+
+constexpr uint8_t profileRFM69Bandwidth(uint8_t dcc_freq, uint8_t mant, uint8_t exp){
+    return ((dcc_freq & 0b111) << 5) | ((mant & 0b11) << 3) | (exp & 0b111);
+}
+/*
+    RegRxBw and RegAfcBw, as setRxBw() writes them; mant is 0b00, 0b01 or 0b10
+    for 16, 20 and 24.
+*/
+
+constexpr uint32_t profileRFM69BitrateHz(uint16_t bitrate){
+    return RFM69_PROFILE_FXOSC / bitrate;
+}
+
+constexpr uint32_t profileRFM69FdevHz(uint16_t fdev){
+    return (uint32_t) fdev * 31250 / 512;
+}
+/*
+    FSTEP = FXOSC / 2^19 = 31250 / 512 Hz.
+*/
+
+constexpr uint32_t profileRFM69BandwidthHz(uint8_t bandwidth){
+    return RFM69_PROFILE_FXOSC / ((16 + 4 * ((bandwidth >> 3) & 0b11)) << ((bandwidth & 0b111) + 2));
+}
+/*
+    Single sided bandwidth of the channel filter in FSK.
+*/
+
+constexpr uint32_t profileRFM69DccHz(uint8_t bandwidth){
+    return (uint64_t) 4 * profileRFM69BandwidthHz(bandwidth) * 113 / ((uint64_t) 2 * 355 << ((bandwidth >> 5) + 2));
+}
+/*
+    Cut-off of the DC canceller, 4 * RxBw / (2 * pi * 2^(DccFreq + 2)), with
+    pi as 355 / 113.
+*/
+
+constexpr uint32_t profileRFM69Frf(uint32_t frequency){
+    return ((frequency / 31250) << 9) + (((frequency % 31250) << 9) + 15625) / 31250;
+}
+/*
+    As bareRFM69::frequencyToFrf().
+*/
+
+// The modulations of the baud methods of plainRFM69.
+constexpr profileRFM69Modulation profileRFM69Baud4800(){
+    return profileRFM69Modulation{0x1a0b, 0x52, profileRFM69Bandwidth(0b010, 0b00, 0b101), profileRFM69Bandwidth(0b100, 0b01, 0b011), RFM69_DATAMODUL_SHAPING_GFSK_NONE, 0};
+}
+
+constexpr profileRFM69Modulation profileRFM69Baud9600(){
+    return profileRFM69Modulation{0x1a0b/2, 0x52*2, profileRFM69Bandwidth(0b010, 0b00, 0b101), profileRFM69Bandwidth(0b100, 0b01, 0b011), RFM69_DATAMODUL_SHAPING_GFSK_NONE, 0};
+}
+
+constexpr profileRFM69Modulation profileRFM69Baud153600(){
+    return profileRFM69Modulation{0x1a0b/32, 0x52*32, profileRFM69Bandwidth(0b010, 0b00, 0), profileRFM69Bandwidth(0b100, 0b01, 0b011), RFM69_DATAMODUL_SHAPING_GFSK_BT_0_5, 0};
+}
+
+constexpr profileRFM69Modulation profileRFM69Baud300000(){
+    return profileRFM69Modulation{0x006b, 0x52*64, profileRFM69Bandwidth(0b010, 0b00, 0), profileRFM69Bandwidth(0b100, 0b01, 0b011), RFM69_DATAMODUL_SHAPING_GFSK_BT_1_0, 45};
+}
+
+constexpr profileRFM69Format profileRFM69Packet(bool variable_length, bool addressing, bool aes, bool crc=true){
+    return profileRFM69Format{variable_length, addressing, aes, crc};
+}
+/*
+    As setPacketType(), setAES() and setCRC().
+*/
+
+constexpr bool profileRFM69InBand(uint32_t frequency){
+    return ((frequency >= 290000000UL) && (frequency <= 340000000UL)) ||
+           ((frequency >= 424000000UL) && (frequency <= 510000000UL)) ||
+           ((frequency >= 862000000UL) && (frequency <= 1020000000UL));
+}
+
+constexpr uint32_t profileRFM69Occupied(const profileRFM69Modulation& m){
+    return profileRFM69FdevHz(m.fdev) + profileRFM69BitrateHz(m.bitrate) / 2;
+}
+/*
+    FDEV + BR/2, the single sided bandwidth of the signal.
+*/
+
+constexpr uint8_t profileRFM69CheckModulation(const profileRFM69Modulation& m){
+    return ((m.bitrate < RFM69_PROFILE_FXOSC / 300000 + 1) || (m.bitrate > (RFM69_PROFILE_FXOSC + 600) / 1200)) ? RFM69_PROFILE_BITRATE :
+           (m.fdev > 0x3FFF) ? RFM69_PROFILE_FDEV :
+           (profileRFM69Occupied(m) > 500000UL) ? RFM69_PROFILE_FDEV_BITRATE :
+           ((4 * profileRFM69FdevHz(m.fdev) < profileRFM69BitrateHz(m.bitrate)) ||
+            (2 * profileRFM69FdevHz(m.fdev) > 10 * profileRFM69BitrateHz(m.bitrate))) ? RFM69_PROFILE_BETA :
+           ((((m.rx_bw >> 3) & 0b11) == 0b11) || (profileRFM69BandwidthHz(m.rx_bw) < profileRFM69Occupied(m))) ? RFM69_PROFILE_RX_BW :
+           (((m.afc_bw >> 3) & 0b11) == 0b11) ? RFM69_PROFILE_AFC_BW :
+           ((m.low_beta_offset != 0) && ((uint32_t) m.low_beta_offset * 488 <= profileRFM69DccHz(m.afc_bw))) ? RFM69_PROFILE_LOW_BETA :
+           RFM69_PROFILE_OK;
+}
+/*
+    The first constraint the modulation violates; the bitrate register of
+    300 kbps is 107, 299065 bps.
+*/
+
+constexpr uint8_t profileRFM69Check(uint32_t frequency, const profileRFM69Modulation& m){
+    return (!profileRFM69InBand(frequency)) ? RFM69_PROFILE_FREQUENCY : profileRFM69CheckModulation(m);
+}
+
+constexpr profileRFM69 profileRFM69Make(uint32_t frequency, const profileRFM69Modulation& m, const profileRFM69Format& f){
+    return profileRFM69{profileRFM69Check(frequency, m), f, {
+        // setDataModul(), packet mode and FSK.
+        {RFM69_DATA_MODUL, (uint8_t) (m.shaping & 0b11)},
+        {RFM69_BITRATE_MSB, (uint8_t) (m.bitrate >> 8)},
+        {RFM69_BITRATE_LSB, (uint8_t) (m.bitrate & 0xFF)},
+        {RFM69_FDEV_MSB, (uint8_t) (m.fdev >> 8)},
+        {RFM69_FDEV_LSB, (uint8_t) (m.fdev & 0xFF)},
+        {RFM69_FRF_MSB, (uint8_t) (profileRFM69Frf(frequency) >> 16)},
+        {RFM69_FRF_MID, (uint8_t) ((profileRFM69Frf(frequency) >> 8) & 0xFF)},
+        {RFM69_FRF_LSB, (uint8_t) (profileRFM69Frf(frequency) & 0xFF)},
+        {RFM69_AFC_CTRL, (uint8_t) ((m.low_beta_offset != 0) ? (RFM69_AFC_CTRL_IMPROVED << 5) : 0)},
+        // setRecommended(), 200 ohm and the AGC loop.
+        {RFM69_LNA, RFM69_LNA_IMP_200OHM | RFM69_LNA_GAIN_AGC_LOOP},
+        {RFM69_RX_BW, m.rx_bw},
+        {RFM69_AFC_BW, m.afc_bw},
+        {RFM69_RSSI_THRESH, 0xe4},
+        // 3 bytes of preamble, 4 bytes of sync word 0x01.
+        {RFM69_PREAMBLE_MSB, 0},
+        {RFM69_PREAMBLE_LSB, 3},
+        {RFM69_SYNC_CONFIG, (1 << 7) | ((4 - 1) << 3)},
+        {RFM69_SYNC_VALUE1, 1},
+        {RFM69_SYNC_VALUE2, 1},
+        {RFM69_SYNC_VALUE3, 1},
+        {RFM69_SYNC_VALUE4, 1},
+        {RFM69_PACKET_CONFIG1, (uint8_t) (RFM69_PACKET_CONFIG_DC_FREE_WHITENING |
+            ((f.crc) ? RFM69_PACKET_CONFIG_CRC_ON : RFM69_PACKET_CONFIG_CRC_OFF) |
+            ((f.variable_length) ? RFM69_PACKET_CONFIG_LENGTH_VARIABLE : RFM69_PACKET_CONFIG_LENGTH_FIXED) |
+            ((f.addressing) ? RFM69_PACKET_CONFIG_ADDRESS_FILTER_NODE_BROADCAST : RFM69_PACKET_CONFIG_ADDRESS_FILTER_NONE))},
+        {RFM69_FIFO_THRESH, RFM69_THRESHOLD_CONDITION_NOT_EMPTY},
+        {RFM69_PACKET_CONFIG2, (uint8_t) f.aes},
+        {RFM69_TEST_DAGC, (uint8_t) ((m.low_beta_offset != 0) ? RFM69_CONTINUOUS_DAGC_IMPROVED_AFCLOWBETAON : RFM69_CONTINUOUS_DAGC_IMPROVED_AFCLOWBETAOFF)},
+        {RFM69_TEST_AFC, m.low_beta_offset},
+    }};
+}
+/*
+    The profile for a frequency in Hz, the modulation and the packet format.
+*/
+
+// shaping chosen by profileRFM69Solve() from the bitrate.
+#define RFM69_PROFILE_SHAPING_AUTO 0xFF
+
+struct profileRFM69Solution {
+    uint32_t bitrate_hz;
+    int32_t bitrate_ppm;        // of the bitrate from the one asked for.
+    uint32_t fdev_hz;
+    uint16_t beta_percent;      // 2 * FDEV / BR, times 100.
+    uint32_t rx_bw_hz;
+    uint32_t dcc_hz;
+    uint32_t afc_bw_hz;
+    uint32_t low_beta_offset_hz;
+    uint8_t error;              // profileRFM69CheckModulation().
+};
+
+constexpr uint16_t profileRFM69SolveBitrate(uint32_t bps){
+    return (bps > RFM69_PROFILE_FXOSC / (RFM69_PROFILE_FXOSC / 300000 + 1)) ? RFM69_PROFILE_FXOSC / 300000 + 1 :
+           (bps < RFM69_PROFILE_FXOSC / 0xFFFF + 1) ? 0xFFFF :
+           (RFM69_PROFILE_FXOSC + bps / 2) / bps;
+}
+/*
+    RegBitrate nearest to bps; at most 300 kbps, the check reports those
+    below 1.2 kbps.
+*/
+
+constexpr uint16_t profileRFM69SolveFdev(uint16_t bitrate, uint16_t beta_percent){
+    return ((((uint64_t) beta_percent * RFM69_PROFILE_FXOSC / bitrate / 200) << 9) + 15625) / 31250 >
+           (((uint64_t) 500000 - profileRFM69BitrateHz(bitrate) / 2) << 9) / 31250 ?
+           (((uint64_t) 500000 - profileRFM69BitrateHz(bitrate) / 2) << 9) / 31250 :
+           ((((uint64_t) beta_percent * RFM69_PROFILE_FXOSC / bitrate / 200) << 9) + 15625) / 31250;
+}
+/*
+    RegFdev nearest to beta * BR / 2, limited such that FDEV + BR/2 <= 500 kHz.
+*/
+
+constexpr uint8_t profileRFM69BandwidthStep(uint8_t dcc_freq, uint8_t i){
+    return profileRFM69Bandwidth(dcc_freq, 2 - i % 3, 7 - i / 3);
+}
+/*
+    The 24 bandwidths in increasing order, from 2.6 kHz at zero to 500 kHz.
+*/
+
+constexpr uint8_t profileRFM69SolveBandwidth(uint32_t hz, uint8_t dcc_freq, uint8_t i=0){
+    return ((i == 23) || (profileRFM69BandwidthHz(profileRFM69BandwidthStep(dcc_freq, i)) >= hz)) ?
+           profileRFM69BandwidthStep(dcc_freq, i) : profileRFM69SolveBandwidth(hz, dcc_freq, i + 1);
+}
+/*
+    The narrowest bandwidth of at least hz, or the widest.
+*/
+
+constexpr uint8_t profileRFM69SolveShaping(uint16_t bitrate, uint8_t shaping){
+    return (shaping != RFM69_PROFILE_SHAPING_AUTO) ? shaping :
+           (profileRFM69BitrateHz(bitrate) < 50000) ? RFM69_DATAMODUL_SHAPING_GFSK_NONE :
+           (profileRFM69BitrateHz(bitrate) < 200000) ? RFM69_DATAMODUL_SHAPING_GFSK_BT_0_5 :
+           RFM69_DATAMODUL_SHAPING_GFSK_BT_1_0;
+}
+/*
+    As the baud methods: no shaping at low bitrates, BT = 0.5 from 50 kbps and
+    BT = 1.0 from 200 kbps, where the spectrum nears the widest filter.
+*/
+
+constexpr uint8_t profileRFM69SolveOffset(uint16_t beta_percent, uint8_t afc_bw){
+    return (beta_percent >= 200) ? 0 :
+           (profileRFM69DccHz(afc_bw) / 488 + 1 > 127) ? 127 : profileRFM69DccHz(afc_bw) / 488 + 1;
+}
+/*
+    With a modulation index below 2 the low beta AFC is used, with the
+    smallest offset above the cut-off of the DC canceller.
+*/
+
+constexpr profileRFM69Modulation profileRFM69SolveWith(uint16_t bitrate, uint16_t fdev, uint16_t beta_percent, uint8_t shaping, uint32_t offset_hz){
+    return profileRFM69Modulation{bitrate, fdev,
+        profileRFM69SolveBandwidth(profileRFM69FdevHz(fdev) + profileRFM69BitrateHz(bitrate) / 2 + offset_hz, 0b010),
+        profileRFM69SolveBandwidth(profileRFM69FdevHz(fdev) + profileRFM69BitrateHz(bitrate) / 2 + offset_hz, 0b100),
+        profileRFM69SolveShaping(bitrate, shaping),
+        profileRFM69SolveOffset(beta_percent, profileRFM69SolveBandwidth(profileRFM69FdevHz(fdev) + profileRFM69BitrateHz(bitrate) / 2 + offset_hz, 0b100))};
+}
+
+constexpr profileRFM69Modulation profileRFM69Solve(uint32_t bps, uint16_t beta_percent=200, uint8_t shaping=RFM69_PROFILE_SHAPING_AUTO, uint32_t offset_hz=0){
+    return profileRFM69SolveWith(profileRFM69SolveBitrate(bps), profileRFM69SolveFdev(profileRFM69SolveBitrate(bps), beta_percent), beta_percent, shaping, offset_hz);
+}
+/*
+    The modulation for bps bits per second, instead of the four baud methods:
+
+        constexpr profileRFM69Modulation m = profileRFM69Solve(38400);
+        static_assert(profileRFM69CheckModulation(m) == RFM69_PROFILE_OK, "38400");
+        rfm.setProfile(profileRFM69Make(868000000, m, profileRFM69Packet(true, false, false)));
+
+    beta_percent is the modulation index 2 * FDEV / BR times 100. The receiver
+    takes the narrowest bandwidth that holds FDEV + BR/2 + offset_hz, where
+    offset_hz is the difference in frequency between the radios to allow for,
+    twice the tolerance of the crystals at the carrier; 20 ppm at 868 MHz is
+    17 kHz. The DC canceller is at about 4% of it, as recommended, the AFC
+    bandwidth is the same with DccFreqAfc at its default. The shaping is
+    chosen from the bitrate unless given, see profileRFM69SolveShaping().
+    Below 1.2 kbps, or with beta below 0.5, the check fails.
+*/
+
+constexpr profileRFM69Solution profileRFM69Describe(const profileRFM69Modulation& m, uint32_t bps){
+    return profileRFM69Solution{profileRFM69BitrateHz(m.bitrate),
+        (int32_t) (((int64_t) RFM69_PROFILE_FXOSC * 1000000 / m.bitrate - (int64_t) bps * 1000000) / bps),
+        profileRFM69FdevHz(m.fdev),
+        (uint16_t) ((uint64_t) 200 * profileRFM69FdevHz(m.fdev) * m.bitrate / RFM69_PROFILE_FXOSC),
+        profileRFM69BandwidthHz(m.rx_bw),
+        profileRFM69DccHz(m.rx_bw),
+        profileRFM69BandwidthHz(m.afc_bw),
+        (uint32_t) m.low_beta_offset * 488,
+        profileRFM69CheckModulation(m)};
+}
+/*
+    What the modulation gives, against the bitrate bps that was asked for.
+*/
+
+//PROFILE_RFM69_H
+#endif
@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "pulseRFM69.h"
+
+static uint16_t limitWidth(uint32_t width){
+    return (width > 0xFFFF) ? 0xFFFF : width;
+}
+
+static uint32_t difference(uint16_t a, uint16_t b){
+    return (a > b) ? (a - b) : (b - a);
+}
+
+
+
+/*
+        Public Methods
+*/
+
+bool pulseRFM69::addProtocol(const pulseRFM69Protocol& protocol){
+    if ((this->protocol_count == RFM69_PULSE_MAX_PROTOCOLS) || (protocol.bits > RFM69_PULSE_MAX_BITS) || (protocol.sync_low == 0)){
+        return false;
+    }
+    uint8_t index = this->protocol_count++;
+    this->protocols[index] = protocol;
+
+    // the base is unknown until the sync, accept half to double its width.
+    decoder_t* d = &(this->decoders[index]);
+    uint32_t high = (uint32_t) protocol.base * protocol.sync_high;
+    uint32_t low = (uint32_t) protocol.base * protocol.sync_low;
+    d->sync_high_min = limitWidth(high / 2);
+    d->sync_high_max = limitWidth(high * 2);
+    d->sync_low_min = limitWidth(low / 2);
+    d->sync_low_max = limitWidth(low * 2);
+    d->active = false;
+    return true;
+}
+
+void pulseRFM69::edge(uint32_t now, bool level){
+    if (level == this->level){
+        return; // no change.
+    }
+
+    if (((now - this->last_edge) < RFM69_PULSE_MIN_WIDTH) && this->pending){
+        // the pulse since last_edge is a spike, the previous pulse continues.
+        this->level = level;
+        this->last_edge = this->pending_edge;
+        this->pending = false;
+        return;
+    }
+
+    if (this->pending){
+        // the previous pulse is followed by a pulse that is not a spike.
+        uint8_t next = (this->ring_write + 1) & RFM69_PULSE_RING_MASK;
+        if (next == this->ring_read){
+            this->overruns++;
+        } else {
+            uint32_t width = this->last_edge - this->pending_edge;
+            if (width > RFM69_PULSE_MAX_WIDTH){
+                width = RFM69_PULSE_MAX_WIDTH;
+            }
+            this->ring[this->ring_write] = (width << 1) | (this->level ? 0 : 1);
+            this->ring_write = next;
+        }
+    }
+    this->pending = true;
+    this->pending_edge = this->last_edge;
+    this->level = level;
+    this->last_edge = now;
+}
+
+bool pulseRFM69::read(pulseRFM69Frame* frame){
+    while (this->ring_read != this->ring_write){
+        uint16_t entry = this->ring[this->ring_read];
+        this->ring_read = (this->ring_read + 1) & RFM69_PULSE_RING_MASK;
+
+        if (entry & 1){
+            this->high = entry >> 1;
+            continue;
+        }
+        if (this->high == 0){
+            continue; // low without its high, for example the first pulse.
+        }
+
+        // every decoder sees every pair, at most one of them completes.
+        bool complete = false;
+        for (uint8_t i=0; i < this->protocol_count; i++){
+            complete |= this->decode(i, this->high, entry >> 1, frame);
+        }
+        this->high = 0;
+        if (complete){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+bool pulseRFM69::decode(uint8_t index, uint16_t high, uint16_t low, pulseRFM69Frame* frame){
+    const pulseRFM69Protocol* p = &(this->protocols[index]);
+    decoder_t* d = &(this->decoders[index]);
+
+    if ((high >= d->sync_high_min) && (high <= d->sync_high_max) && (low >= d->sync_low_min) && (low <= d->sync_low_max)){
+        // measure the base on the long low pulse and derive the bits from it.
+        d->base = low / p->sync_low;
+        d->zero_high = d->base * p->zero_high;
+        d->zero_low = d->base * p->zero_low;
+        d->one_high = d->base * p->one_high;
+        d->one_low = d->base * p->one_low;
+        // a quarter of the period of a bit.
+        d->tolerance = (d->zero_high + d->zero_low) >> 2;
+        d->count = 0;
+        memset(d->data, 0, sizeof(d->data));
+        d->active = true;
+        return false;
+    }
+
+    if (!d->active){
+        return false;
+    }
+
+    uint32_t zero = difference(high, d->zero_high) + difference(low, d->zero_low);
+    uint32_t one = difference(high, d->one_high) + difference(low, d->one_low);
+    bool bit = one < zero;
+    if (((bit) ? one : zero) > d->tolerance){
+        d->active = false;
+        return false;
+    }
+
+    if (bit){
+        d->data[d->count >> 3] |= 0x80 >> (d->count & 7);
+    }
+
+    if (++(d->count) < p->bits){
+        return false;
+    }
+
+    d->active = false;
+    frame->protocol = index;
+    frame->bits = d->count;
+    frame->base = d->base;
+    memcpy(frame->data, d->data, sizeof(frame->data));
+    return true;
+}
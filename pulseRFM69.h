@@ -0,0 +1,188 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef PULSE_RFM69_H
+#define PULSE_RFM69_H
+
+/*
+    Decodes the pulse width codes of 433 MHz remote controls and sensors,
+    received with continuousRFM69::ookSensor() on the DATA pin.
+
+    The interrupt on the edges of the DATA pin only stores the width of the
+    pulse that ended in a ring, decoding happens in read(), from loop():
+
+        void interrupt_edge(){
+            pulses.edge(micros(), digitalRead(DATA_PIN));
+        }
+        attachInterrupt(DATA_PIN, interrupt_edge, CHANGE);
+
+    Pulses shorter than RFM69_PULSE_MIN_WIDTH are noise spikes, they are
+    removed and the pulse they interrupted continues. Hence a pulse is only
+    stored at the edge that ends the pulse after it.
+
+    A protocol is a sync pulse followed by a number of bits, every bit and
+    the sync being a high and a low pulse, with widths as a multiple of a
+    base width. For example, the EV1527 and PT2262 chips (rc-switch protocol
+    1) send 24 bits, a 0 as 1 high and 3 low, a 1 as 3 high and 1 low, with
+    a sync of 1 high and 31 low, each unit being 350 us.
+
+    Cheap transmitters have a poor clock, so the base width is measured on
+    every sync pulse and the bits are matched relative to it, such that no
+    tolerance is needed between transmitters. Each pair of pulses is matched
+    to the nearest of the 0 and 1 bit with a few subtractions, no division
+    is done outside the sync pulse.
+
+    Transmitters repeat the code, with the sync between them; the first
+    code is not received if it is preceded by the sync instead of followed
+    by it, the repeats are. Several protocols can be decoded at once.
+*/
+
+// number of pulses buffered between the interrupt and read(), power of two
+// up to 256.
+#ifndef RFM69_PULSE_RING_SIZE
+#define RFM69_PULSE_RING_SIZE 64
+#endif
+
+#define RFM69_PULSE_RING_MASK (RFM69_PULSE_RING_SIZE - 1)
+
+#ifndef RFM69_PULSE_MAX_PROTOCOLS
+#define RFM69_PULSE_MAX_PROTOCOLS 4
+#endif
+
+// longest code in bits.
+#ifndef RFM69_PULSE_MAX_BITS
+#define RFM69_PULSE_MAX_BITS 64
+#endif
+
+#define RFM69_PULSE_MAX_BYTES ((RFM69_PULSE_MAX_BITS + 7) / 8)
+
+// in microseconds, shorter pulses are noise.
+#ifndef RFM69_PULSE_MIN_WIDTH
+#define RFM69_PULSE_MIN_WIDTH 60
+#endif
+
+// pulses are stored up to this width in microseconds.
+#define RFM69_PULSE_MAX_WIDTH 0x7FFF
+
+// {base (us), sync high, sync low, 0 high, 0 low, 1 high, 1 low, bits}
+
+// EV1527, PT2262 and compatible (rc-switch protocol 1).
+#define RFM69_PULSE_PROTOCOL_EV1527 {350, 1, 31, 1, 3, 3, 1, 24}
+
+// HX2262 and compatible (rc-switch protocol 2).
+#define RFM69_PULSE_PROTOCOL_HX2262 {650, 1, 10, 1, 2, 2, 1, 24}
+
+typedef struct {
+    uint16_t base; // width of one unit in microseconds.
+    uint8_t sync_high;
+    uint8_t sync_low;
+    uint8_t zero_high;
+    uint8_t zero_low;
+    uint8_t one_high;
+    uint8_t one_low;
+    uint8_t bits;
+} pulseRFM69Protocol;
+
+typedef struct {
+    uint8_t protocol; // index in the order of addProtocol().
+    uint8_t bits;
+    uint16_t base; // measured on the sync pulse, in microseconds.
+    uint8_t data[RFM69_PULSE_MAX_BYTES]; // first bit in the MSB of data[0].
+} pulseRFM69Frame;
+
+class pulseRFM69{
+    protected:
+        typedef struct {
+            // sync windows, from the nominal base.
+            uint16_t sync_high_min;
+            uint16_t sync_high_max;
+            uint16_t sync_low_min;
+            uint16_t sync_low_max;
+
+            // bit widths, from the base measured on the sync.
+            uint16_t base;
+            uint16_t zero_high;
+            uint16_t zero_low;
+            uint16_t one_high;
+            uint16_t one_low;
+            uint16_t tolerance;
+
+            bool active;
+            uint8_t count;
+            uint8_t data[RFM69_PULSE_MAX_BYTES];
+        } decoder_t;
+
+        pulseRFM69Protocol protocols[RFM69_PULSE_MAX_PROTOCOLS];
+        decoder_t decoders[RFM69_PULSE_MAX_PROTOCOLS];
+        uint8_t protocol_count;
+
+        // width << 1 | level of every pulse.
+        uint16_t ring[RFM69_PULSE_RING_SIZE];
+        volatile uint8_t ring_read;
+        volatile uint8_t ring_write;
+        volatile uint16_t overruns;
+
+        uint32_t last_edge;
+        bool level; // of the pulse since last_edge.
+
+        // the pulse before last_edge is stored once the pulse after it
+        // turns out not to be a spike.
+        uint32_t pending_edge;
+        bool pending;
+
+        uint16_t high; // width of the high pulse awaiting its low, or 0.
+
+        bool decode(uint8_t index, uint16_t high, uint16_t low, pulseRFM69Frame* frame);
+        /*
+            Feeds a pair of pulses to the decoder of a protocol, returns true
+            and fills frame if a code is complete.
+        */
+
+    public:
+        pulseRFM69(){
+            this->protocol_count = 0;
+            this->ring_read = 0;
+            this->ring_write = 0;
+            this->overruns = 0;
+            this->last_edge = 0;
+            this->level = false;
+            this->pending_edge = 0;
+            this->pending = false;
+            this->high = 0;
+        };
+
+        bool addProtocol(const pulseRFM69Protocol& protocol);
+        /*
+            Adds a protocol to decode, for example:
+                pulseRFM69Protocol ev1527 = RFM69_PULSE_PROTOCOL_EV1527;
+                pulses.addProtocol(ev1527);
+            Returns false if RFM69_PULSE_MAX_PROTOCOLS are added already or
+            the number of bits exceeds RFM69_PULSE_MAX_BITS.
+        */
+
+        void edge(uint32_t now, bool level);
+        /*
+            To be called on every edge of the DATA pin, with the time in
+            microseconds and the level after the edge.
+        */
+
+        bool read(pulseRFM69Frame* frame);
+        /*
+            Decodes the stored pulses, returns true at the first complete
+            code, false if the ring is empty. Call until it returns false.
+        */
+
+        uint16_t getOverruns(){return this->overruns;};
+        /*
+            Pulses lost because read() was not called often enough.
+        */
+};
+
+//PULSE_RFM69_H
+#endif
@@ -0,0 +1,211 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "secureRFM69.h"
+
+#define RFM69_SECURE_ROTL(x, b) (uint32_t)(((x) << (b)) | ((x) >> (32 - (b))))
+
+static uint32_t secureRFM69Load(const uint8_t* p){
+    return ((uint32_t) p[0]) | (((uint32_t) p[1]) << 8) | (((uint32_t) p[2]) << 16) | (((uint32_t) p[3]) << 24);
+}
+
+static void secureRFM69Store(uint8_t* p, uint32_t v){
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+
+
+/*
+        Public Methods
+*/
+
+void secureRFM69::setKey(const uint8_t* key){
+    for (uint8_t i=0; i < 4; i++){
+        this->key[i] = secureRFM69Load(&(key[i*4]));
+    }
+    times2(this->key1, this->key);
+    times2(this->key2, this->key1);
+
+    // keystream key, the permutation of the key with the last word inverted,
+    // such that it never equals a MAC state.
+    uint32_t v[4] = {this->key[0], this->key[1], this->key[2], ~(this->key[3])};
+    permute(v);
+    for (uint8_t i=0; i < 4; i++){
+        this->stream_key[i] = v[i] ^ this->key[i];
+    }
+}
+
+uint8_t secureRFM69::seal(const void* payload, uint8_t len, uint8_t* packet){
+    packet[0] = this->address;
+    secureRFM69Store(&(packet[1]), this->counter);
+    memcpy(&(packet[RFM69_SECURE_HEADER]), payload, len);
+
+    if (this->use_keystream){
+        this->keystream(this->address, this->counter, &(packet[RFM69_SECURE_HEADER]), len);
+    }
+    this->counter++;
+
+    // the tag is computed as a whole block, only its start is sent.
+    uint8_t full_tag[16];
+    this->tag(packet, RFM69_SECURE_HEADER + len, full_tag);
+    memcpy(&(packet[RFM69_SECURE_HEADER + len]), full_tag, RFM69_SECURE_TAG_LENGTH);
+    return len + RFM69_SECURE_OVERHEAD;
+}
+
+bool secureRFM69::open(uint8_t* packet, uint8_t len, secureRFM69Message* message){
+    if (len < RFM69_SECURE_OVERHEAD){
+        this->rejected_tag++;
+        return false;
+    }
+    uint8_t sender = packet[0];
+    uint32_t counter = secureRFM69Load(&(packet[1]));
+    uint8_t payload_len = len - RFM69_SECURE_OVERHEAD;
+
+    // cheap replay check first, the window is only updated after the tag is
+    // verified.
+    secureRFM69Peer* peer = this->findPeer(sender);
+    if (peer == 0){
+        this->rejected_replay++;
+        return false;
+    }
+    uint32_t behind = peer->counter - counter;
+    if (peer->used && ((int32_t) behind >= 0)){
+        if ((behind >= RFM69_SECURE_WINDOW) || (peer->window & (((uint32_t) 1) << behind))){
+            this->rejected_replay++;
+            return false;
+        }
+    }
+
+    // compare the complete tag, without an early exit.
+    uint8_t expected[16];
+    this->tag(packet, RFM69_SECURE_HEADER + payload_len, expected);
+    uint8_t difference = 0;
+    for (uint8_t i=0; i < RFM69_SECURE_TAG_LENGTH; i++){
+        difference |= expected[i] ^ packet[RFM69_SECURE_HEADER + payload_len + i];
+    }
+    if (difference){
+        this->rejected_tag++;
+        return false;
+    }
+
+    // valid, accept the counter.
+    if (!peer->used){
+        peer->used = true;
+        peer->address = sender;
+        peer->counter = counter;
+        peer->window = 1;
+    } else if ((int32_t) behind < 0){
+        uint32_t ahead = counter - peer->counter;
+        peer->window = (ahead >= RFM69_SECURE_WINDOW) ? 0 : (peer->window << ahead);
+        peer->window |= 1;
+        peer->counter = counter;
+    } else {
+        peer->window |= ((uint32_t) 1) << behind;
+    }
+
+    if (this->use_keystream){
+        this->keystream(sender, counter, &(packet[RFM69_SECURE_HEADER]), payload_len);
+    }
+
+    message->sender = sender;
+    message->counter = counter;
+    message->length = payload_len;
+    message->payload = &(packet[RFM69_SECURE_HEADER]);
+    return true;
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+void secureRFM69::permute(uint32_t* v){
+    // Chaskey-12, 12 rounds of the Chaskey permutation.
+    for (uint8_t i=0; i < 12; i++){
+        v[0] += v[1]; v[1] = RFM69_SECURE_ROTL(v[1], 5);  v[1] ^= v[0]; v[0] = RFM69_SECURE_ROTL(v[0], 16);
+        v[2] += v[3]; v[3] = RFM69_SECURE_ROTL(v[3], 8);  v[3] ^= v[2];
+        v[0] += v[3]; v[3] = RFM69_SECURE_ROTL(v[3], 13); v[3] ^= v[0];
+        v[2] += v[1]; v[1] = RFM69_SECURE_ROTL(v[1], 7);  v[1] ^= v[2]; v[2] = RFM69_SECURE_ROTL(v[2], 16);
+    }
+}
+
+void secureRFM69::times2(uint32_t* out, const uint32_t* in){
+    // multiplication by x in GF(2^128), without a branch on the key.
+    uint32_t carry = (uint32_t) (-(int32_t) (in[3] >> 31)) & 0x87;
+    out[3] = (in[3] << 1) | (in[2] >> 31);
+    out[2] = (in[2] << 1) | (in[1] >> 31);
+    out[1] = (in[1] << 1) | (in[0] >> 31);
+    out[0] = (in[0] << 1) ^ carry;
+}
+
+void secureRFM69::tag(const uint8_t* data, uint8_t len, uint8_t* out){
+    uint32_t v[4] = {this->key[0], this->key[1], this->key[2], this->key[3]};
+
+    // all blocks but the last one.
+    while (len > 16){
+        for (uint8_t i=0; i < 4; i++){
+            v[i] ^= secureRFM69Load(&(data[i*4]));
+        }
+        permute(v);
+        data += 16;
+        len -= 16;
+    }
+
+    // the last block, padded with 0x01 and zeros if it is incomplete.
+    uint8_t last[16];
+    memset(last, 0, sizeof(last));
+    memcpy(last, data, len);
+    const uint32_t* subkey = this->key1;
+    if (len < 16){
+        last[len] = 0x01;
+        subkey = this->key2;
+    }
+    for (uint8_t i=0; i < 4; i++){
+        v[i] ^= secureRFM69Load(&(last[i*4])) ^ subkey[i];
+    }
+    permute(v);
+    for (uint8_t i=0; i < 4; i++){
+        secureRFM69Store(&(out[i*4]), v[i] ^ subkey[i]);
+    }
+}
+
+void secureRFM69::keystream(uint8_t sender, uint32_t counter, uint8_t* data, uint8_t len){
+    // Even-Mansour with the Chaskey permutation on (sender, counter, block).
+    uint8_t block = 0;
+    while (len){
+        uint32_t v[4] = {sender ^ this->stream_key[0], counter ^ this->stream_key[1], block ^ this->stream_key[2], this->stream_key[3]};
+        permute(v);
+        uint8_t stream[16];
+        for (uint8_t i=0; i < 4; i++){
+            secureRFM69Store(&(stream[i*4]), v[i] ^ this->stream_key[i]);
+        }
+        uint8_t n = (len < 16) ? len : 16;
+        for (uint8_t i=0; i < n; i++){
+            data[i] ^= stream[i];
+        }
+        data += n;
+        len -= n;
+        block++;
+    }
+}
+
+secureRFM69Peer* secureRFM69::findPeer(uint8_t address){
+    // returns the peer with this address, or a free one, or zero if full.
+    secureRFM69Peer* free = 0;
+    for (uint8_t i=0; i < RFM69_SECURE_MAX_PEERS; i++){
+        if (this->peers[i].used && (this->peers[i].address == address)){
+            return &(this->peers[i]);
+        }
+        if ((!this->peers[i].used) && (free == 0)){
+            free = &(this->peers[i]);
+        }
+    }
+    return free;
+}
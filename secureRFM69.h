@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef SECURE_RFM69_H
+#define SECURE_RFM69_H
+
+/*
+    Authenticated packets with replay protection.
+
+    The AES engine of the radio uses ECB mode (see check_crypto_mode.py), so
+    identical blocks of plaintext result in identical ciphertext and a captured
+    packet can be sent again at any time. This layer adds a per packet counter,
+    a message authentication code and a replay window per sender on top of it.
+    The radio's AES can stay enabled, the counter in the first block makes
+    every packet differ on the air.
+
+    Packet layout, multi byte values are little endian:
+        0       address of the sender.
+        1-4     counter of the sender, incremented for every packet.
+        5...    payload, optionally encrypted with the keystream.
+        last    tag, RFM69_SECURE_TAG_LENGTH bytes.
+
+    The tag is a Chaskey-12 MAC over the sender, counter and payload, truncated
+    to RFM69_SECURE_TAG_LENGTH bytes. With setKeystream(true) the payload is
+    also encrypted in software, by XOR'ing it with the Chaskey permutation in
+    counter mode, with the sender and counter as nonce. Without it the payload
+    is only encrypted by the radio's AES, if enabled, and blocks after the
+    first one still reveal repetitions.
+
+    Chaskey only uses 32 bit additions, rotations and XOR's, there are no
+    tables or data dependent branches, so the timing does not depend on the
+    key or the data. The 16 byte key should differ from the AES key of the
+    radio.
+
+    The destination address byte of plainRFM69, if used, is not part of the
+    tag; put the destination in the payload if it should be authenticated.
+
+    The counter must never be reused with the same key, store it in EEPROM
+    every so often and restore it with setCounter() after a reset, with a
+    margin for the packets sent since it was stored.
+*/
+
+#ifndef RFM69_SECURE_TAG_LENGTH
+    #define RFM69_SECURE_TAG_LENGTH 4
+#endif
+
+#ifndef RFM69_SECURE_MAX_PEERS
+    #define RFM69_SECURE_MAX_PEERS 8
+#endif
+
+#define RFM69_SECURE_HEADER 5
+#define RFM69_SECURE_OVERHEAD (RFM69_SECURE_HEADER + RFM69_SECURE_TAG_LENGTH)
+
+// size of the replay window, counters this far behind the newest are rejected.
+#define RFM69_SECURE_WINDOW 32
+
+struct secureRFM69Message {
+    uint8_t sender;
+    uint32_t counter;
+    uint8_t length;
+    const uint8_t* payload;
+};
+
+struct secureRFM69Peer {
+    uint8_t address;
+    bool used;
+    uint32_t counter; // highest counter accepted.
+    uint32_t window; // bit n set if counter - n was accepted.
+};
+
+class secureRFM69{
+    protected:
+        uint32_t key[4];
+        uint32_t key1[4]; // Chaskey subkeys for the MAC.
+        uint32_t key2[4];
+        uint32_t stream_key[4]; // derived key for the keystream.
+
+        uint8_t address;
+        uint32_t counter;
+        bool use_keystream;
+
+        secureRFM69Peer peers[RFM69_SECURE_MAX_PEERS];
+
+        uint16_t rejected_tag;
+        uint16_t rejected_replay;
+
+        static void permute(uint32_t* v);
+        static void times2(uint32_t* out, const uint32_t* in);
+
+        void tag(const uint8_t* data, uint8_t len, uint8_t* out); // writes 16 bytes.
+        void keystream(uint8_t sender, uint32_t counter, uint8_t* data, uint8_t len);
+
+        secureRFM69Peer* findPeer(uint8_t address);
+
+    public:
+        secureRFM69(uint8_t address){
+            this->address = address;
+            this->counter = 0;
+            this->use_keystream = false;
+            this->rejected_tag = 0;
+            this->rejected_replay = 0;
+            memset(this->peers, 0, sizeof(this->peers));
+            const uint8_t zero[16] = {0};
+            this->setKey(zero);
+        };
+
+        void setKey(const uint8_t* key);
+        /*
+            Sets the 16 byte key shared by all nodes.
+        */
+
+        void setKeystream(bool use_keystream){this->use_keystream = use_keystream;};
+        /*
+            Enables encryption of the payload in software, all nodes should
+            use the same setting.
+        */
+
+        void setCounter(uint32_t counter){this->counter = counter;};
+        uint32_t getCounter(){return this->counter;};
+        /*
+            The counter used for the next packet, see the counter remark at
+            the top of this file.
+        */
+
+        uint8_t seal(const void* payload, uint8_t len, uint8_t* packet);
+        /*
+            Writes the packet for len bytes of payload to packet, which should
+            hold len + RFM69_SECURE_OVERHEAD bytes. Returns the length of the
+            packet, which can be sent with sendVariable().
+        */
+
+        bool open(uint8_t* packet, uint8_t len, secureRFM69Message* message);
+        /*
+            Verifies the packet and checks the replay window of its sender.
+            Returns true if the packet is valid and new, message then holds the
+            sender, counter and payload, which points into packet. The payload
+            is decrypted in place.
+
+            Senders are remembered in the order they are first seen, up to
+            RFM69_SECURE_MAX_PEERS of them; packets from further senders are
+            rejected as a replay, since their window can not be kept.
+        */
+
+        void forgetPeers(){memset(this->peers, 0, sizeof(this->peers));};
+        /*
+            Clears the replay windows, for example when the key is changed.
+        */
+
+        uint16_t getRejectedTag(){return this->rejected_tag;};
+        uint16_t getRejectedReplay(){return this->rejected_replay;};
+        /*
+            Number of packets rejected for an invalid tag and for a replayed or
+            too old counter.
+        */
+
+};
+
+//SECURE_RFM69_H
+#endif
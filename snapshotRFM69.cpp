@@ -0,0 +1,311 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "snapshotRFM69.h"
+#include <string.h>
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#define RFM69_SNAPSHOT_TABLE PROGMEM
+#define RFM69_SNAPSHOT_COPY(destination, source, size) memcpy_P(destination, source, size)
+#else
+#define RFM69_SNAPSHOT_TABLE
+#define RFM69_SNAPSHOT_COPY(destination, source, size) memcpy(destination, source, size)
+#endif
+
+struct snapshotRFM69Entry {
+    uint8_t reg;
+    uint8_t shift;
+    uint8_t width;
+    char name[RFM69_SNAPSHOT_NAME];
+};
+
+// the fields as named in the datasheet, in the order of the registers. The AES
+// key can not be read, it is left out.
+static const snapshotRFM69Entry snapshotRFM69Fields[] RFM69_SNAPSHOT_TABLE = {
+    {RFM69_OPMODE, 7, 1, "SequencerOff"},
+    {RFM69_OPMODE, 6, 1, "ListenOn"},
+    {RFM69_OPMODE, 5, 1, "ListenAbort"},
+    {RFM69_OPMODE, 2, 3, "Mode"},
+    {RFM69_DATA_MODUL, 5, 2, "DataMode"},
+    {RFM69_DATA_MODUL, 3, 2, "ModulationType"},
+    {RFM69_DATA_MODUL, 0, 2, "ModulationShaping"},
+    {RFM69_BITRATE_MSB, 0, 16, "BitRate"},
+    {RFM69_FDEV_MSB, 0, 14, "Fdev"},
+    {RFM69_FRF_MSB, 0, 24, "Frf"},
+    {RFM69_OSC1, 7, 1, "RcCalStart"},
+    {RFM69_OSC1, 6, 1, "RcCalDone"},
+    {RFM69_AFC_CTRL, 5, 1, "AfcLowBetaOn"},
+    {RFM69_LISTEN1, 6, 2, "ListenResolIdle"},
+    {RFM69_LISTEN1, 4, 2, "ListenResolRx"},
+    {RFM69_LISTEN1, 3, 1, "ListenCriteria"},
+    {RFM69_LISTEN1, 1, 2, "ListenEnd"},
+    {RFM69_LISTEN2, 0, 8, "ListenCoefIdle"},
+    {RFM69_LISTEN3, 0, 8, "ListenCoefRx"},
+    {RFM69_VERSION, 0, 8, "Version"},
+    {RFM69_PA_LEVEL, 7, 1, "Pa0On"},
+    {RFM69_PA_LEVEL, 6, 1, "Pa1On"},
+    {RFM69_PA_LEVEL, 5, 1, "Pa2On"},
+    {RFM69_PA_LEVEL, 0, 5, "OutputPower"},
+    {RFM69_PA_RAMP, 0, 4, "PaRamp"},
+    {RFM69_OCP, 4, 1, "OcpOn"},
+    {RFM69_OCP, 0, 4, "OcpTrim"},
+    {RFM69_LNA, 7, 1, "LnaZin"},
+    {RFM69_LNA, 3, 3, "LnaCurrentGain"},
+    {RFM69_LNA, 0, 3, "LnaGainSelect"},
+    {RFM69_RX_BW, 5, 3, "DccFreq"},
+    {RFM69_RX_BW, 3, 2, "RxBwMant"},
+    {RFM69_RX_BW, 0, 3, "RxBwExp"},
+    {RFM69_AFC_BW, 5, 3, "DccFreqAfc"},
+    {RFM69_AFC_BW, 3, 2, "RxBwMantAfc"},
+    {RFM69_AFC_BW, 0, 3, "RxBwExpAfc"},
+    {RFM69_OOK_PEAK, 6, 2, "OokThreshType"},
+    {RFM69_OOK_PEAK, 3, 3, "OokPeakThreshStep"},
+    {RFM69_OOK_PEAK, 0, 3, "OokPeakThreshDec"},
+    {RFM69_OOK_AVG, 6, 2, "OokAverageThreshFilt"},
+    {RFM69_OOK_FIX, 0, 8, "OokFixedThresh"},
+    {RFM69_AFC_FEI, 6, 1, "FeiDone"},
+    {RFM69_AFC_FEI, 5, 1, "FeiStart"},
+    {RFM69_AFC_FEI, 4, 1, "AfcDone"},
+    {RFM69_AFC_FEI, 3, 1, "AfcAutoclearOn"},
+    {RFM69_AFC_FEI, 2, 1, "AfcAutoOn"},
+    {RFM69_AFC_FEI, 1, 1, "AfcClear"},
+    {RFM69_AFC_FEI, 0, 1, "AfcStart"},
+    {RFM69_AFC_MSB, 0, 16, "AfcValue"},
+    {RFM69_FEI_MSB, 0, 16, "FeiValue"},
+    {RFM69_RSSI_CONFIG, 1, 1, "RssiDone"},
+    {RFM69_RSSI_CONFIG, 0, 1, "RssiStart"},
+    {RFM69_RSSI_VALUE, 0, 8, "RssiValue"},
+    {RFM69_DIO_MAPPING1, 6, 2, "Dio0Mapping"},
+    {RFM69_DIO_MAPPING1, 4, 2, "Dio1Mapping"},
+    {RFM69_DIO_MAPPING1, 2, 2, "Dio2Mapping"},
+    {RFM69_DIO_MAPPING1, 0, 2, "Dio3Mapping"},
+    {RFM69_DIO_MAPPING2, 6, 2, "Dio4Mapping"},
+    {RFM69_DIO_MAPPING2, 4, 2, "Dio5Mapping"},
+    {RFM69_DIO_MAPPING2, 0, 3, "ClkOut"},
+    {RFM69_IRQ_FLAGS1, 7, 1, "ModeReady"},
+    {RFM69_IRQ_FLAGS1, 6, 1, "RxReady"},
+    {RFM69_IRQ_FLAGS1, 5, 1, "TxReady"},
+    {RFM69_IRQ_FLAGS1, 4, 1, "PllLock"},
+    {RFM69_IRQ_FLAGS1, 3, 1, "Rssi"},
+    {RFM69_IRQ_FLAGS1, 2, 1, "Timeout"},
+    {RFM69_IRQ_FLAGS1, 1, 1, "AutoMode"},
+    {RFM69_IRQ_FLAGS1, 0, 1, "SyncAddressMatch"},
+    {RFM69_IRQ_FLAGS2, 7, 1, "FifoFull"},
+    {RFM69_IRQ_FLAGS2, 6, 1, "FifoNotEmpty"},
+    {RFM69_IRQ_FLAGS2, 5, 1, "FifoLevel"},
+    {RFM69_IRQ_FLAGS2, 4, 1, "FifoOverrun"},
+    {RFM69_IRQ_FLAGS2, 3, 1, "PacketSent"},
+    {RFM69_IRQ_FLAGS2, 2, 1, "PayloadReady"},
+    {RFM69_IRQ_FLAGS2, 1, 1, "CrcOk"},
+    {RFM69_RSSI_THRESH, 0, 8, "RssiThreshold"},
+    {RFM69_RX_TIMEOUT1, 0, 8, "TimeoutRxStart"},
+    {RFM69_RX_TIMEOUT2, 0, 8, "TimeoutRssiThresh"},
+    {RFM69_PREAMBLE_MSB, 0, 16, "PreambleSize"},
+    {RFM69_SYNC_CONFIG, 7, 1, "SyncOn"},
+    {RFM69_SYNC_CONFIG, 6, 1, "FifoFillCondition"},
+    {RFM69_SYNC_CONFIG, 3, 3, "SyncSize"},
+    {RFM69_SYNC_CONFIG, 0, 3, "SyncTol"},
+    {RFM69_SYNC_VALUE1, 0, 8, "SyncValue1"},
+    {RFM69_SYNC_VALUE2, 0, 8, "SyncValue2"},
+    {RFM69_SYNC_VALUE3, 0, 8, "SyncValue3"},
+    {RFM69_SYNC_VALUE4, 0, 8, "SyncValue4"},
+    {RFM69_SYNC_VALUE5, 0, 8, "SyncValue5"},
+    {RFM69_SYNC_VALUE6, 0, 8, "SyncValue6"},
+    {RFM69_SYNC_VALUE7, 0, 8, "SyncValue7"},
+    {RFM69_SYNC_VALUE8, 0, 8, "SyncValue8"},
+    {RFM69_PACKET_CONFIG1, 7, 1, "PacketFormat"},
+    {RFM69_PACKET_CONFIG1, 5, 2, "DcFree"},
+    {RFM69_PACKET_CONFIG1, 4, 1, "CrcOn"},
+    {RFM69_PACKET_CONFIG1, 3, 1, "CrcAutoClearOff"},
+    {RFM69_PACKET_CONFIG1, 1, 2, "AddressFiltering"},
+    {RFM69_PAYLOAD_LENGTH, 0, 8, "PayloadLength"},
+    {RFM69_NODE_ADRESS, 0, 8, "NodeAddress"},
+    {RFM69_BROADCAST_ADRESS, 0, 8, "BroadcastAddress"},
+    {RFM69_AUTO_MODES, 5, 3, "EnterCondition"},
+    {RFM69_AUTO_MODES, 2, 3, "ExitCondition"},
+    {RFM69_AUTO_MODES, 0, 2, "IntermediateMode"},
+    {RFM69_FIFO_THRESH, 7, 1, "TxStartCondition"},
+    {RFM69_FIFO_THRESH, 0, 7, "FifoThreshold"},
+    {RFM69_PACKET_CONFIG2, 4, 4, "InterPacketRxDelay"},
+    {RFM69_PACKET_CONFIG2, 2, 1, "RestartRx"},
+    {RFM69_PACKET_CONFIG2, 1, 1, "AutoRxRestartOn"},
+    {RFM69_PACKET_CONFIG2, 0, 1, "AesOn"},
+    {RFM69_TEMP1, 3, 1, "TempMeasStart"},
+    {RFM69_TEMP1, 2, 1, "TempMeasRunning"},
+    {RFM69_TEMP2, 0, 8, "TempValue"},
+    {RFM69_TEST_LNA, 0, 8, "SensitivityBoost"},
+    {RFM69_TEST_PA1, 0, 8, "Pa20dBm1"},
+    {RFM69_TEST_PA2, 0, 8, "Pa20dBm2"},
+    {RFM69_TEST_DAGC, 0, 8, "ContinuousDagc"},
+    {RFM69_TEST_AFC, 0, 8, "LowBetaAfcOffset"},
+};
+
+#define RFM69_SNAPSHOT_FIELDS (sizeof(snapshotRFM69Fields) / sizeof(snapshotRFM69Entry))
+
+//#############################################################################
+// Protected Methods
+//#############################################################################
+
+bool snapshotRFM69::differs(const snapshotRFM69* other, uint8_t reg) const {
+    if (other == 0){
+        return true;
+    }
+    return ((this->get(reg) ^ other->get(reg)) & snapshotRFM69::getWritableBits(reg)) != 0;
+}
+
+//#############################################################################
+// Public Methods
+//#############################################################################
+
+snapshotRFM69::snapshotRFM69(){
+    memset(this->regs, 0, sizeof(this->regs));
+}
+
+void snapshotRFM69::read(bareRFM69* rfm){
+    rfm->readRawRegisters(RFM69_SNAPSHOT_FIRST, this->regs, RFM69_SNAPSHOT_SIZE);
+}
+
+uint8_t snapshotRFM69::restore(bareRFM69* rfm, const snapshotRFM69* current){
+    uint8_t buffer[RFM69_SNAPSHOT_SIZE];
+    uint8_t bursts = 0;
+    bareRFM69Batch batch;
+    rfm->beginBatch(&batch);
+
+    // RegOpMode is written last, the registers after it in bursts.
+    uint8_t reg = RFM69_SNAPSHOT_FIRST + 1;
+    while (reg <= RFM69_SNAPSHOT_LAST){
+        if ((snapshotRFM69::getWritableBits(reg) == 0) || !this->differs(current, reg)){
+            reg++;
+            continue;
+        }
+
+        // extend the burst over equal registers, up to the gap.
+        uint8_t end = reg;
+        for (uint8_t next = reg + 1; (next <= RFM69_SNAPSHOT_LAST) && (next - end <= RFM69_SNAPSHOT_GAP + 1); next++){
+            if (snapshotRFM69::getWritableBits(next) == 0){
+                break;
+            }
+            if (this->differs(current, next)){
+                end = next;
+            }
+        }
+
+        uint8_t len = end - reg + 1;
+        for (uint8_t i=0; i < len; i++){
+            buffer[i] = this->get(reg + i) & snapshotRFM69::getWritableBits(reg + i);
+        }
+        rfm->writeRawRegisters(reg, buffer, len);
+        bursts++;
+        reg = end + 1;
+    }
+
+    if (this->differs(current, RFM69_OPMODE)){
+        buffer[0] = this->get(RFM69_OPMODE) & snapshotRFM69::getWritableBits(RFM69_OPMODE);
+        rfm->writeRawRegisters(RFM69_OPMODE, buffer, 1);
+        bursts++;
+    }
+
+    rfm->submitBatch();
+    return bursts;
+}
+
+uint8_t snapshotRFM69::get(uint8_t reg) const {
+    if ((reg < RFM69_SNAPSHOT_FIRST) || (reg > RFM69_SNAPSHOT_LAST)){
+        return 0;
+    }
+    return this->regs[reg - RFM69_SNAPSHOT_FIRST];
+}
+
+void snapshotRFM69::set(uint8_t reg, uint8_t value){
+    if ((reg < RFM69_SNAPSHOT_FIRST) || (reg > RFM69_SNAPSHOT_LAST)){
+        return;
+    }
+    this->regs[reg - RFM69_SNAPSHOT_FIRST] = value;
+}
+
+uint8_t snapshotRFM69::getWritableBits(uint8_t reg){
+    switch (reg){
+        // without the triggers, the bits that are set by the radio and the
+        // reserved bits.
+        case (RFM69_OPMODE): return 0xDC;           // not ListenAbort.
+        case (RFM69_AFC_CTRL): return 0x20;
+        case (RFM69_LNA): return 0x87;              // not LnaCurrentGain.
+        case (RFM69_AFC_FEI): return 0x0C;          // AfcAutoclearOn and AfcAutoOn.
+        case (RFM69_PACKET_CONFIG2): return 0xFB;   // not RestartRx.
+
+        case (RFM69_OSC1):
+        case (RFM69_VERSION):
+        case (RFM69_RSSI_CONFIG):
+            return 0x00;
+    }
+    if (((reg >= RFM69_DATA_MODUL) && (reg <= RFM69_LISTEN3)) ||
+        ((reg >= RFM69_PA_LEVEL) && (reg <= RFM69_OCP)) ||
+        ((reg >= RFM69_LNA) && (reg <= RFM69_OOK_FIX)) ||
+        (reg == RFM69_DIO_MAPPING1) || (reg == RFM69_DIO_MAPPING2) ||
+        ((reg >= RFM69_RSSI_THRESH) && (reg <= RFM69_FIFO_THRESH)) ||
+        (reg == RFM69_TEST_LNA) || (reg == RFM69_TEST_PA1) || (reg == RFM69_TEST_PA2) ||
+        (reg == RFM69_TEST_DAGC) || (reg == RFM69_TEST_AFC)){
+        return 0xFF;
+    }
+    return 0x00;
+}
+
+uint8_t snapshotRFM69::diff(const snapshotRFM69& other, uint8_t* changed, uint8_t max) const {
+    uint8_t count = 0;
+    for (uint8_t reg=RFM69_SNAPSHOT_FIRST; reg <= RFM69_SNAPSHOT_LAST; reg++){
+        if (this->get(reg) == other.get(reg)){
+            continue;
+        }
+        if (count < max){
+            changed[count] = reg;
+        }
+        count++;
+    }
+    return count;
+}
+
+uint8_t snapshotRFM69::getFieldCount(){
+    return RFM69_SNAPSHOT_FIELDS;
+}
+
+bool snapshotRFM69::field(uint8_t index, snapshotRFM69Field* field) const {
+    if (index >= RFM69_SNAPSHOT_FIELDS){
+        return false;
+    }
+    snapshotRFM69Entry entry;
+    RFM69_SNAPSHOT_COPY(&entry, &(snapshotRFM69Fields[index]), sizeof(entry));
+    field->reg = entry.reg;
+    field->shift = entry.shift;
+    field->width = entry.width;
+    memcpy(field->name, entry.name, sizeof(field->name));
+
+    // fields wider than a register continue in the next ones.
+    uint32_t raw = 0;
+    for (uint8_t i=0; i < (entry.shift + entry.width + 7) / 8; i++){
+        raw = (raw << 8) | this->get(entry.reg + i);
+    }
+    field->value = (raw >> entry.shift) & ((1UL << entry.width) - 1);
+    return true;
+}
+
+uint8_t snapshotRFM69::diffFields(const snapshotRFM69& other, uint8_t* changed, uint8_t max) const {
+    uint8_t count = 0;
+    snapshotRFM69Field mine;
+    snapshotRFM69Field theirs;
+    for (uint8_t i=0; i < RFM69_SNAPSHOT_FIELDS; i++){
+        this->field(i, &mine);
+        other.field(i, &theirs);
+        if (mine.value == theirs.value){
+            continue;
+        }
+        if (count < max){
+            changed[count] = i;
+        }
+        count++;
+    }
+    return count;
+}
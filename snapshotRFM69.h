@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <bareRFM69.h>
+
+#ifndef SNAPSHOT_RFM69_H
+#define SNAPSHOT_RFM69_H
+
+/*
+    A copy of the register map of the radio, for diagnostics and for a warm
+    restore after a reset of the radio.
+
+        snapshotRFM69 configured;
+        configured.read(&rfm);          // one burst over all registers.
+
+        bareRFM69::reset(RESET_PIN);    // later, the radio lost its settings.
+        snapshotRFM69 now;
+        now.read(&rfm);
+        configured.restore(&rfm, &now); // only writes what differs.
+        rfm.receive();
+
+    restore() writes the registers that differ in as few bursts as possible:
+    registers in between that are equal are written along if that is cheaper
+    than starting a new burst, see RFM69_SNAPSHOT_GAP. The bursts are one
+    bareRFM69Batch; RegOpMode goes last, after the configuration it needs.
+    Only the bits that can be written are compared and restored: not the IRQ
+    flags, RSSI, AFC and FEI values, nor the start and done bits of the
+    measurements. The AES key can not be read, set it again after a reset.
+    plainRFM69 keeps its own copy of the mode, call receive() after it.
+
+    field() decodes the registers into the fields of the datasheet, by their
+    name there; diff() and diffFields() list what differs between two
+    snapshots:
+
+        uint8_t changed[8];
+        uint8_t n = now.diffFields(configured, changed, sizeof(changed));
+        snapshotRFM69Field f;
+        for (uint8_t i=0; i < n; i++){
+            now.field(changed[i], &f);
+            Serial.print(f.name); Serial.print(" = "); Serial.println(f.value);
+        }
+
+    The table of fields is in flash on AVR.
+*/
+
+#define RFM69_SNAPSHOT_FIRST RFM69_OPMODE
+#define RFM69_SNAPSHOT_LAST RFM69_TEST_AFC
+#define RFM69_SNAPSHOT_SIZE (RFM69_SNAPSHOT_LAST - RFM69_SNAPSHOT_FIRST + 1)
+
+// equal registers written along in a burst rather than starting a new one; a
+// burst costs the address byte and a chip select.
+#ifndef RFM69_SNAPSHOT_GAP
+#define RFM69_SNAPSHOT_GAP 2
+#endif
+
+#define RFM69_SNAPSHOT_NAME 21
+
+struct snapshotRFM69Field {
+    uint8_t reg;        // first register of the field.
+    uint8_t shift;
+    uint8_t width;      // in bits, most significant byte first if above 8.
+    char name[RFM69_SNAPSHOT_NAME];
+    uint32_t value;
+};
+
+class snapshotRFM69 {
+    protected:
+        uint8_t regs[RFM69_SNAPSHOT_SIZE];
+
+        bool differs(const snapshotRFM69* other, uint8_t reg) const;
+        /*
+            Whether the writable bits of reg differ, always true without
+            other.
+        */
+
+    public:
+        snapshotRFM69();
+        /*
+            All registers zero.
+        */
+
+        void read(bareRFM69* rfm);
+        /*
+            Reads RegOpMode up to RegTestAfc in a single transaction.
+        */
+
+        uint8_t restore(bareRFM69* rfm, const snapshotRFM69* current=0);
+        /*
+            Writes the registers into the radio; with current, a snapshot of
+            what is in the radio now, only those that differ. Returns the
+            number of bursts.
+        */
+
+        uint8_t get(uint8_t reg) const;
+        void set(uint8_t reg, uint8_t value);
+        /*
+            Registers outside the snapshot read as zero.
+        */
+
+        static uint8_t getWritableBits(uint8_t reg);
+        /*
+            The bits of reg that restore() writes, zero if it skips reg.
+        */
+
+        uint8_t diff(const snapshotRFM69& other, uint8_t* changed, uint8_t max) const;
+        /*
+            Writes up to max registers whose value differs into changed, and
+            returns how many differ in total.
+        */
+
+        static uint8_t getFieldCount();
+        bool field(uint8_t index, snapshotRFM69Field* field) const;
+        /*
+            Decodes field index, in the order of the registers. Returns false
+            if index is out of range.
+        */
+
+        uint8_t diffFields(const snapshotRFM69& other, uint8_t* changed, uint8_t max) const;
+        /*
+            As diff(), with the indices of the fields that differ.
+        */
+};
+
+//SNAPSHOT_RFM69_H
+#endif
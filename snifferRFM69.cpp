@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "snifferRFM69.h"
+
+
+
+/*
+        Public Methods
+*/
+
+void snifferRFM69::setSniffer(bool variable_length){
+    // sets the packet type, FIFO threshold and AES like any other radio.
+    this->setPacketType(variable_length, false);
+
+    // then keep failed frames and accept all addresses.
+    uint8_t flags = RFM69_PACKET_CONFIG_DC_FREE_WHITENING | RFM69_PACKET_CONFIG_CRC_ON | RFM69_PACKET_CONFIG_CRC_FAIL_KEEP;
+    flags |= variable_length ? RFM69_PACKET_CONFIG_LENGTH_VARIABLE : RFM69_PACKET_CONFIG_LENGTH_FIXED;
+    flags |= RFM69_PACKET_CONFIG_ADDRESS_FILTER_NONE;
+    this->setPacketConfig1(flags);
+
+    this->setAfcFei(RFM69_AFC_FEI_AFC_AUTOCLEAR_ON | RFM69_AFC_FEI_AFC_AUTO_ON);
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+uint16_t snifferRFM69::encodeSlot(uint8_t index, uint8_t* out, uint16_t space){
+    uint8_t* slot = this->packet_buffer[index];
+
+    frameRFM69Raw raw;
+    raw.timestamp = this->packet_time[index];
+    raw.rssi = this->packet_rssi[index];
+    raw.flags = this->packet_flags[index];
+    raw.fei = this->packet_fei[index];
+    raw.frame = slot;
+
+    // the frame as stored, with its length byte.
+    raw.length = this->packet_length;
+    if (this->use_variable_length){
+        raw.length = ((slot[0] > this->packet_length) ? this->packet_length : slot[0]) + 1;
+    }
+
+    if (RFM69_FRAME_MAX_ENCODED(RFM69_FRAME_RAW_HEADER + raw.length) > space){
+        return 0;
+    }
+    return frameRFM69EncodeRaw(&raw, out);
+}
+
+void snifferRFM69::readPacket(){
+    uint8_t index = this->buffer_write_index;
+
+    // FEI, RssiConfig, RssiValue, DioMapping1, DioMapping2, IrqFlags1 and
+    // IrqFlags2 in one transaction; the CrcOk flag is cleared with the FIFO.
+    uint8_t diagnostics[RFM69_IRQ_FLAGS2 - RFM69_FEI_MSB + 1];
+    this->readRawRegisters(RFM69_FEI_MSB, diagnostics, sizeof(diagnostics));
+    uint8_t flags2 = diagnostics[RFM69_IRQ_FLAGS2 - RFM69_FEI_MSB];
+
+    this->packet_time[index] = micros();
+    this->packet_rssi[index] = diagnostics[RFM69_RSSI_VALUE - RFM69_FEI_MSB];
+    this->packet_fei[index] = (int16_t) ((diagnostics[0] << 8) | diagnostics[1]);
+    this->packet_flags[index] = (flags2 & RFM69_IRQ2_CRCOK) ? RFM69_FRAME_FLAG_CRC_OK : 0;
+
+    // The FIFO has to be emptied to return to Rx. If the buffer is full, the
+    // frame is read into the slot regardless, but commitSlot() drops it.
+    uint8_t* slot = this->packet_buffer[index];
+    if (this->use_variable_length){
+        this->readVariableFIFO(slot, this->packet_length + 1);
+        if (slot[0] > this->packet_length){
+            // longer than the slot, discard the rest.
+            this->packet_flags[index] |= RFM69_FRAME_FLAG_TRUNCATED;
+            while (this->getIRQ2Flags() & RFM69_IRQ2_FIFONOTEMPTY){
+                this->readRawRegister(RFM69_FIFO);
+            }
+        }
+    } else {
+        this->readFIFO(slot, this->packet_length);
+    }
+
+    this->commitSlot();
+}
+
+void snifferRFM69::setRawPacketLength(){
+    gatewayRFM69::setRawPacketLength();
+    this->packet_flags = (uint8_t*) malloc(this->buffer_size);
+    this->packet_fei = (int16_t*) malloc(this->buffer_size * sizeof(int16_t));
+
+    if (this->use_variable_length){
+        // the radio discards frames with a larger length byte, accept all.
+        this->setPayloadLength(0xFF);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <Arduino.h>
+#include <plainRFM69.h>
+#include <gatewayRFM69.h>
+
+#ifndef SNIFFER_RFM69_H
+#define SNIFFER_RFM69_H
+
+/*
+    The snifferRFM69 object captures every frame the radio receives, also
+    those that plainRFM69 never sees: frames with a failed CRC, frames for
+    other addresses and, with variable length, frames longer than the packet
+    length.
+
+    The frames are kept raw, with the length and address byte, together with
+    the CRC status, RSSI, frequency error (FEI) and a timestamp. These
+    diagnostics are read in a single SPI transaction before the FIFO, since
+    the CRC status is lost when the FIFO is emptied.
+
+    The frames are forwarded to the host with bridge(), as raw records (see
+    frameRFM69.h), extras/host/gateway_dump prints them.
+
+    Frames longer than the FIFO (66 bytes) can not be captured, as the FIFO
+    is only read when the frame is complete.
+*/
+
+class snifferRFM69 : public gatewayRFM69{
+    protected:
+
+        // RFM69_FRAME_FLAG_* and FEI per Rx buffer slot.
+        uint8_t* packet_flags;
+        int16_t* packet_fei;
+
+        virtual uint16_t encodeSlot(uint8_t index, uint8_t* out, uint16_t space);
+        /*
+            Encodes the slot as raw record.
+        */
+
+        virtual void readPacket();
+        /*
+            Reads the diagnostics and the frame, discards the part of the
+            frame that does not fit in the slot.
+        */
+
+        virtual void setRawPacketLength();
+        /*
+            Also allocates the diagnostics for every buffer slot, and accepts
+            any length byte.
+        */
+
+    public:
+
+        snifferRFM69(uint8_t cs_pin) : gatewayRFM69(cs_pin){
+            this->packet_flags = 0;
+            this->packet_fei = 0;
+        };
+
+        void setSniffer(bool variable_length);
+        /*
+            Use instead of setPacketType(), before setPacketLength(). Disables
+            address filtering and keeps frames with a failed CRC. The packet
+            length should be the maximum frame length, without the length
+            byte; 65 captures everything that fits in the FIFO.
+
+            Also enables AFC on every Rx start, such that the FEI is measured
+            for every frame.
+        */
+
+        uint16_t getDropped(){return this->overflows;};
+        /*
+            Number of frames lost because bridge() was not called often
+            enough, the same as getOverflows(). Frames are dropped as a whole,
+            the Rx buffer is never overwritten.
+        */
+};
+
+//SNIFFER_RFM69_H
+#endif
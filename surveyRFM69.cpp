@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include "surveyRFM69.h"
+
+
+
+/*
+        Public Methods
+*/
+
+void surveyRFM69::setChannels(uint32_t base_freq, uint32_t spacing, uint8_t count){
+    this->base_freq = base_freq;
+    this->spacing = spacing;
+    this->channel_count = count;
+    this->occupancy = (uint8_t*) malloc(count);
+    this->average = (uint8_t*) malloc(count);
+}
+
+void surveyRFM69::sweep(uint8_t samples){
+    // remember the frequency to return to.
+    uint32_t original_frf = ((uint32_t) this->radio->readRawRegister(RFM69_FRF_MSB) << 16) |
+                            ((uint32_t) this->radio->readRawRegister(RFM69_FRF_MID) << 8) |
+                            this->radio->readRawRegister(RFM69_FRF_LSB);
+
+    // the AutoMode should not interfere with the mode changes.
+    this->radio->setAutoMode(RFM69_AUTOMODE_ENTER_NONE_AUTOMODES_OFF, RFM69_AUTOMODE_EXIT_NONE_AUTOMODES_OFF, RFM69_AUTOMODE_INTERMEDIATEMODE_STANDBY);
+    this->radio->setMode(RFM69_MODE_SEQUENCER_ON | RFM69_MODE_RECEIVER);
+
+    uint32_t start_time = micros();
+
+    for (uint8_t channel=0; channel < this->channel_count; channel++){
+        this->radio->hopFrf(this->getChannelFrf(channel), RFM69_MODE_SEQUENCER_ON | RFM69_MODE_RECEIVER);
+
+        // wait until the receiver has settled, RSSI is sampled from here on.
+        uint8_t tries = 255;
+        while ((!(this->radio->getIRQ1Flags() & RFM69_IRQ1_RXREADY)) && (--tries)){
+        }
+
+        uint8_t occupied = 0;
+        uint16_t sum = 0;
+        for (uint8_t i=0; i < samples; i++){
+            uint8_t value = this->sampleRssi();
+            sum += value;
+            occupied += (value < this->threshold);
+        }
+
+        this->occupancy[channel] = (samples) ? (((uint16_t) occupied * 255) / samples) : 0;
+        this->average[channel] = (samples) ? (sum / samples) : 0;
+    }
+
+    this->sweep_duration = micros() - start_time;
+
+    this->radio->setMode(RFM69_MODE_SEQUENCER_ON | RFM69_MODE_STANDBY);
+    this->radio->setFrf(original_frf);
+}
+
+uint8_t surveyRFM69::quietestChannel(){
+    uint8_t best = 0;
+    for (uint8_t channel=1; channel < this->channel_count; channel++){
+        if ((this->occupancy[channel] < this->occupancy[best]) ||
+            ((this->occupancy[channel] == this->occupancy[best]) && (this->average[channel] > this->average[best]))){
+            best = channel;
+        }
+    }
+    return best;
+}
+
+uint32_t surveyRFM69::channelsPerSecond(){
+    if (this->sweep_duration == 0){
+        return 0;
+    }
+    return ((uint32_t) this->channel_count * 1000000UL) / this->sweep_duration;
+}
+
+
+
+/*
+        Protected Methods
+*/
+
+uint8_t surveyRFM69::sampleRssi(){
+    this->radio->startRssi();
+    uint8_t tries = 255;
+    while ((!this->radio->completedRssi()) && (--tries)){
+    }
+    return this->radio->getRssiValue();
+}
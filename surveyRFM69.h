@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <Arduino.h>
+#include <bareRFM69.h>
+#include <bareRFM69_const.h>
+
+#ifndef SURVEY_RFM69_H
+#define SURVEY_RFM69_H
+
+/*
+    The surveyRFM69 object performs a channel survey with the RSSI engine of
+    the radio. It sweeps over a range of channels and samples the RSSI several
+    times on each channel.
+
+    Per channel it keeps:
+        occupancy: the fraction of the samples which was stronger than the
+                   threshold, scaled to 0-255.
+        average:   the average RssiValue of the samples, the signal strength
+                   is -average/2 dBm, so a higher value is a quieter channel.
+
+    Retuning between channels uses bareRFM69::hopFrf(), so only the PLL is
+    relocked. The duration of the last sweep is kept, such that the sweep speed
+    can be checked with channelsPerSecond().
+
+    The sweep uses the radio, so it can not receive packets during the sweep.
+    If used with plainRFM69, call receive() after sweep() to return to the
+    normal receiving state, the original frequency is restored by sweep().
+
+    Usage:
+        surveyRFM69 survey = surveyRFM69(&rfm);
+        survey.setChannels((uint32_t) 433100000, 200000, 8);
+        survey.sweep(16);
+        rfm.setFrf(survey.getChannelFrf(survey.quietestChannel()));
+        rfm.receive();
+*/
+
+class surveyRFM69 {
+    protected:
+        bareRFM69* radio;
+
+        uint32_t base_freq;
+        uint32_t spacing;
+        uint8_t channel_count;
+
+        // per channel statistics of the last sweep.
+        uint8_t* occupancy;
+        uint8_t* average;
+
+        // samples with a RssiValue below this are counted as occupied.
+        uint8_t threshold;
+
+        uint32_t sweep_duration;
+
+        uint8_t sampleRssi();
+        /*
+            Performs a single RSSI measurement and returns the RssiValue.
+        */
+
+    public:
+        surveyRFM69(bareRFM69* radio){
+            this->radio = radio;
+            this->channel_count = 0;
+            this->occupancy = 0;
+            this->average = 0;
+            this->threshold = 0xb4; // -90 dBm
+            this->sweep_duration = 0;
+        };
+
+        void setChannels(uint32_t base_freq, uint32_t spacing, uint8_t count);
+        /*
+            Sets the channels to survey, at base_freq + channel * spacing Hz.
+            Allocates the statistics, so should only be called once.
+        */
+
+        void setThreshold(uint8_t rssi_value){this->threshold = rssi_value;};
+        /*
+            Samples stronger than -rssi_value/2 dBm are counted as occupied.
+            Defaults to 0xb4; -90 dBm.
+        */
+
+        void sweep(uint8_t samples);
+        /*
+            Sweeps all channels, takes 'samples' RSSI measurements per channel.
+            The AutoMode is disabled and the radio is in standby mode on the
+            original frequency afterwards.
+        */
+
+        uint8_t getOccupancy(uint8_t channel){return this->occupancy[channel];};
+        // occupied fraction of the samples on this channel, 255 is always.
+
+        uint8_t getAverageRssi(uint8_t channel){return this->average[channel];};
+        // average RssiValue on this channel, RSSI = -value/2 dBm.
+
+        uint32_t getChannelFrf(uint8_t channel){
+            return bareRFM69::frequencyToFrf(this->base_freq + channel * this->spacing);};
+        // returns the Frf value of this channel, for bareRFM69::setFrf.
+
+        uint8_t quietestChannel();
+        /*
+            Returns the channel with the lowest occupancy, on equal occupancy
+            the one with the lowest average signal strength.
+        */
+
+        uint32_t getSweepDuration(){return this->sweep_duration;};
+        // duration of the last sweep in microseconds.
+
+        uint32_t channelsPerSecond();
+        // sweep speed of the last sweep.
+};
+
+//SURVEY_RFM69_H
+#endif
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+#include "traceRFM69.h"
+
+/*
+    The indices are loaded with acquire and stored with release, such that
+    an entry is complete before the other side sees the index that covers it.
+    On a single core this only keeps the compiler from reordering, a byte is
+    written at once; on the Linux backend poll() runs in its own thread. The
+    writer, record(), is in the header.
+*/
+
+uint8_t traceRFM69::available(){
+    uint8_t write_index = __atomic_load_n(&(this->write_index), __ATOMIC_ACQUIRE);
+    return (write_index - this->read_index) & (RFM69_TRACE_SIZE - 1);
+}
+
+bool traceRFM69::read(traceRFM69Entry* entry){
+    uint8_t index = this->read_index;
+    if (index == __atomic_load_n(&(this->write_index), __ATOMIC_ACQUIRE)){
+        return false;
+    }
+    *entry = this->entries[index];
+    __atomic_store_n(&(this->read_index), (index + 1) & (RFM69_TRACE_SIZE - 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+uint8_t traceRFM69::drain(traceRFM69Entry* entries, uint8_t max_count){
+    uint8_t count = 0;
+    while ((count < max_count) && this->read(&(entries[count]))){
+        count++;
+    }
+    return count;
+}
+
+uint16_t traceRFM69::dump(uint8_t* out){
+    uint8_t packed[RFM69_TRACE_DUMP * RFM69_FRAME_TRACE_ENTRY];
+    traceRFM69Entry entry;
+    frameRFM69Trace trace;
+    trace.count = 0;
+    while ((trace.count < RFM69_TRACE_DUMP) && this->read(&entry)){
+        traceRFM69::pack(&entry, &(packed[trace.count * RFM69_FRAME_TRACE_ENTRY]));
+        trace.count++;
+    }
+    if (trace.count == 0){
+        return 0;
+    }
+    trace.dropped = this->dropped;
+    trace.entries = packed;
+    return frameRFM69EncodeTrace(&trace, out);
+}
+
+void traceRFM69::pack(const traceRFM69Entry* entry, uint8_t* out){
+    out[0] = entry->time;
+    out[1] = entry->time >> 8;
+    out[2] = entry->time >> 16;
+    out[3] = entry->time >> 24;
+    out[4] = entry->type;
+    out[5] = entry->state;
+    out[6] = entry->flags;
+    out[7] = entry->value;
+}
+
+void traceRFM69::unpack(const uint8_t* in, traceRFM69Entry* entry){
+    entry->time = (uint32_t) in[0] | ((uint32_t) in[1] << 8) |
+                  ((uint32_t) in[2] << 16) | ((uint32_t) in[3] << 24);
+    entry->type = in[4];
+    entry->state = in[5];
+    entry->flags = in[6];
+    entry->value = in[7];
+}
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2014, Ivor Wanders
+ *  MIT License, see the LICENSE.md file in the root folder.
+*/
+
+
+#include <stdint.h>
+#include <frameRFM69.h>
+
+#ifndef TRACE_RFM69_H
+#define TRACE_RFM69_H
+
+/*
+    A ring of small binary entries, written by plainRFM69 from poll() in the
+    interrupt and read from loop(), see plainRFM69::setTrace(). Unlike
+    printing from poll(), recording an entry takes a handful of instructions
+    and no serial port, so the timing that is traced is hardly changed by it.
+
+    Every entry holds a timestamp, the state of plainRFM69 and two bytes that
+    depend on the type of the entry:
+
+        type                        flags               value
+        RFM69_TRACE_EDGE            0                   0
+            traceEdge(), the DIO pin changed; recorded by the next poll(),
+            with the time of the edge.
+        RFM69_TRACE_POLL            0                   0
+            poll() started.
+        RFM69_TRACE_DONE            RegIrqFlags1        0
+            poll() returns, with the flags it read at the start; the state
+            is the one it leaves.
+        RFM69_TRACE_RX_FIFO         0                   bytes read
+            A packet was read from the FIFO into the Rx buffer.
+        RFM69_TRACE_DISCARD         0                   bytes read
+            A packet was read from the FIFO and dropped; CRC error or a full
+            Rx buffer.
+        RFM69_TRACE_TX_FIFO         0                   bytes written
+            A packet was written to the FIFO.
+        RFM69_TRACE_STATE           0                   new state
+            The state changed, the entry holds the previous one.
+
+    The time between EDGE and POLL is the latency of poll() after the edge,
+    between POLL and DONE the time spent in it.
+
+    The ring has one writer and one reader, it needs no locks: the writer
+    only moves the write index, after the entry is written, the reader only
+    the read index. An entry that does not fit is dropped and counted, the
+    entries in the ring are never overwritten. Entries are written by one
+    context at a time; plainRFM69 writes from poll(), and elsewhere with the
+    interrupts disabled.
+*/
+
+// entries in the ring, one less than this fits; a power of two up to 128.
+#ifndef RFM69_TRACE_SIZE
+#define RFM69_TRACE_SIZE 32
+#endif
+
+#if ((RFM69_TRACE_SIZE & (RFM69_TRACE_SIZE - 1)) != 0) || (RFM69_TRACE_SIZE > 128)
+#error "RFM69_TRACE_SIZE should be a power of two, up to 128."
+#endif
+
+// entries in one record written by dump().
+#ifndef RFM69_TRACE_DUMP
+#define RFM69_TRACE_DUMP 8
+#endif
+
+#define RFM69_TRACE_EDGE 0x01
+#define RFM69_TRACE_POLL 0x02
+#define RFM69_TRACE_DONE 0x03
+#define RFM69_TRACE_RX_FIFO 0x04
+#define RFM69_TRACE_DISCARD 0x05
+#define RFM69_TRACE_TX_FIFO 0x06
+#define RFM69_TRACE_STATE 0x07
+
+// the size of a record from dump() with count entries, including the delimiter.
+#define RFM69_TRACE_DUMP_ENCODED(count) RFM69_FRAME_MAX_ENCODED(RFM69_FRAME_TRACE_HEADER + (count) * RFM69_FRAME_TRACE_ENTRY)
+
+struct traceRFM69Entry {
+    uint32_t time;
+    uint8_t type;
+    uint8_t state;
+    uint8_t flags;
+    uint8_t value;
+};
+
+class traceRFM69{
+    protected:
+        traceRFM69Entry entries[RFM69_TRACE_SIZE];
+        uint8_t read_index;
+        uint8_t write_index;
+
+        // entries that did not fit, written by the writer only.
+        volatile uint16_t dropped;
+
+    public:
+        traceRFM69(){
+            this->read_index = 0;
+            this->write_index = 0;
+            this->dropped = 0;
+        };
+
+        void record(uint32_t time, uint8_t type, uint8_t state, uint8_t flags, uint8_t value){
+            // the entry is complete before the reader sees the index.
+            uint8_t index = this->write_index;
+            uint8_t next = (index + 1) & (RFM69_TRACE_SIZE - 1);
+            if (next == __atomic_load_n(&(this->read_index), __ATOMIC_ACQUIRE)){
+                this->dropped = this->dropped + 1;
+                return; // full, the entries in the ring are kept.
+            }
+            traceRFM69Entry* entry = &(this->entries[index]);
+            entry->time = time;
+            entry->type = type;
+            entry->state = state;
+            entry->flags = flags;
+            entry->value = value;
+            __atomic_store_n(&(this->write_index), next, __ATOMIC_RELEASE);
+        };
+        /*
+            Adds an entry, called by the writer. Drops it if the ring is full.
+            Defined here, such that poll() does not call it.
+        */
+
+        uint8_t available();
+        /*
+            Number of entries waiting to be read.
+        */
+
+        bool read(traceRFM69Entry* entry);
+        uint8_t drain(traceRFM69Entry* entries, uint8_t max_count);
+        /*
+            Copies the oldest entry, or up to max_count entries, out of the
+            ring and frees them; called by the reader. Return whether there
+            was one, or the number copied.
+        */
+
+        uint16_t dump(uint8_t* out);
+        /*
+            Drains up to RFM69_TRACE_DUMP entries into a trace record, see
+            frameRFM69.h, and encodes it into out. Returns the number of bytes
+            written, zero if there were no entries. The buffer should hold
+            RFM69_TRACE_DUMP_ENCODED(RFM69_TRACE_DUMP) bytes, for example:
+                uint8_t out[RFM69_TRACE_DUMP_ENCODED(RFM69_TRACE_DUMP)];
+                uint16_t len;
+                while ((len = trace.dump(out)) != 0){
+                    Serial.write(out, len);
+                }
+        */
+
+        uint16_t getDropped(){return this->dropped;};
+        /*
+            Number of entries dropped because the ring was full, since it was
+            constructed. Also in the records of dump().
+        */
+
+        static void pack(const traceRFM69Entry* entry, uint8_t* out);
+        static void unpack(const uint8_t* in, traceRFM69Entry* entry);
+        /*
+            The RFM69_FRAME_TRACE_ENTRY bytes of an entry in a trace record.
+        */
+};
+
+//TRACE_RFM69_H
+#endif